@@ -69,6 +69,34 @@ CheckBounds (
   return EFI_SUCCESS;
 }
 
+/**
+ * Add an area of the local copy of the Frame Buffer to the area that needs to be sent in the next screen update.
+ * @param UsbDisplayLinkDev
+ * @param X
+ * @param Y
+ * @param Width
+ * @param Height
+ */
+STATIC VOID
+MarkDirty (
+  IN  USB_DISPLAYLINK_DEV                     *UsbDisplayLinkDev,
+  IN  UINTN                                   X,
+  IN  UINTN                                   Y,
+  IN  UINTN                                   Width,
+  IN  UINTN                                   Height
+)
+{
+  if (Y < UsbDisplayLinkDev->LastY1) {
+    UsbDisplayLinkDev->LastY1 = Y;
+  }
+  if ((Y + Height) > UsbDisplayLinkDev->LastY2) {
+    UsbDisplayLinkDev->LastY2 = Y + Height;
+  }
+  if ((X + Width) > UsbDisplayLinkDev->LastX2) {
+    UsbDisplayLinkDev->LastX2 = X + Width;
+  }
+}
+
 /**
  * Update the local copy of the Frame Buffer. This local copy is periodically transmitted to the
  * DisplayLink device (via DlGopSendScreenUpdate)
@@ -100,7 +128,10 @@ BuildBackBuffer (
 )
 {
   UINTN H;
-  UINTN W;
+  UINTN RowSize;
+
+  RowSize = Width * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL);
+
   switch (BltOperation) {
   case EfiBltVideoToBltBuffer:
   {
@@ -110,11 +141,9 @@ BuildBackBuffer (
     SrcB = UsbDisplayLinkDev->Screen + SourceY * PixelsPerScanLine + SourceX;
 
     for (H = 0; H < Height; H++) {
-      for (W = 0; W < Width; W++) {
-        Blt[W] = *SrcB++;
-      }
+      CopyMem (Blt, SrcB, RowSize);
       Blt = (EFI_GRAPHICS_OUTPUT_BLT_PIXEL*)(((UINT8*)Blt) + BltBufferStride);
-      SrcB += PixelsPerScanLine - Width;
+      SrcB += PixelsPerScanLine;
     }
   }
   break;
@@ -122,12 +151,7 @@ BuildBackBuffer (
   case EfiBltBufferToVideo:
   {
     // Update the store of the area of the screen that is "dirty" - that we need to send in the next screen update.
-    if (DestinationY < UsbDisplayLinkDev->LastY1) {
-      UsbDisplayLinkDev->LastY1 = DestinationY;
-    }
-    if ((DestinationY + Height) > UsbDisplayLinkDev->LastY2) {
-      UsbDisplayLinkDev->LastY2 = DestinationY + Height;
-    }
+    MarkDirty (UsbDisplayLinkDev, DestinationX, DestinationY, Width, Height);
 
     EFI_GRAPHICS_OUTPUT_BLT_PIXEL* Blt;
     EFI_GRAPHICS_OUTPUT_BLT_PIXEL* DstB;
@@ -135,41 +159,49 @@ BuildBackBuffer (
     DstB = UsbDisplayLinkDev->Screen + DestinationY * PixelsPerScanLine + DestinationX;
 
     for (H = 0; H < Height; H++) {
-      for (W = 0; W < Width; W++) {
-        *DstB++ = Blt[W];
-      }
+      CopyMem (DstB, Blt, RowSize);
       Blt = (EFI_GRAPHICS_OUTPUT_BLT_PIXEL*)(((UINT8*)Blt) + BltBufferStride);
-      DstB += PixelsPerScanLine - Width;
+      DstB += PixelsPerScanLine;
     }
   }
   break;
 
   case EfiBltVideoToVideo:
   {
+    MarkDirty (UsbDisplayLinkDev, DestinationX, DestinationY, Width, Height);
+
     EFI_GRAPHICS_OUTPUT_BLT_PIXEL* SrcB;
     EFI_GRAPHICS_OUTPUT_BLT_PIXEL* DstB;
     SrcB = UsbDisplayLinkDev->Screen + SourceY * PixelsPerScanLine + SourceX;
     DstB = UsbDisplayLinkDev->Screen + DestinationY * PixelsPerScanLine + DestinationX;
 
-    for (H = 0; H < Height; H++) {
-      for (W = 0; W < Width; W++) {
-        *DstB++ = *SrcB++;
+    if (DestinationY > SourceY) {
+      // The areas may overlap (e.g. scrolling down): copy the rows bottom up so that we don't overwrite source rows
+      // before they have been copied. CopyMem takes care of overlap within a row.
+      for (H = Height; H > 0; H--) {
+        CopyMem (DstB + (H - 1) * PixelsPerScanLine, SrcB + (H - 1) * PixelsPerScanLine, RowSize);
+      }
+    } else {
+      for (H = 0; H < Height; H++) {
+        CopyMem (DstB, SrcB, RowSize);
+        SrcB += PixelsPerScanLine;
+        DstB += PixelsPerScanLine;
       }
-      SrcB += PixelsPerScanLine - Width;
-      DstB += PixelsPerScanLine - Width;
     }
   }
   break;
 
   case EfiBltVideoFill:
   {
+    MarkDirty (UsbDisplayLinkDev, DestinationX, DestinationY, Width, Height);
+
     EFI_GRAPHICS_OUTPUT_BLT_PIXEL* DstB;
+    UINT32 FillValue;
+    CopyMem (&FillValue, BltBuffer, sizeof (FillValue));
     DstB = UsbDisplayLinkDev->Screen + DestinationY * PixelsPerScanLine + DestinationX;
     for (H = 0; H < Height; H++) {
-      for (W = 0; W < Width; W++) {
-        *DstB++ = *BltBuffer;
-      }
-      DstB += PixelsPerScanLine - Width;
+      SetMem32 (DstB, RowSize, FillValue);
+      DstB += PixelsPerScanLine;
     }
   }
   break;
@@ -252,7 +284,96 @@ DlGopSendTestPattern (
 
 
 /**
- * Transfer the latest copy of the Blt buffer over USB to the DisplayLink device
+ * Convert pixels from the BLT format (B, G, R, Reserved) to the 24 bit R, G, B the DisplayLink device expects.
+ * @param Destination
+ * @param Source
+ * @param Pixels          Number of pixels to convert
+ */
+STATIC VOID
+ConvertBltPixelsToRgb (
+    OUT UINT8* Destination,
+    IN CONST EFI_GRAPHICS_OUTPUT_BLT_PIXEL* Source,
+    IN UINTN Pixels
+    )
+{
+  CONST UINT32* Src;
+  UINT32 Rgb0;
+  UINT32 Rgb1;
+  UINT32 Rgb2;
+  UINT32 Rgb3;
+
+  // Swap round the R and B bytes of a pixel, giving R, G, B, 0 in memory order.
+#define BLT_PIXEL_TO_RGB(Pixel) ((((Pixel) >> 16) & 0xFF) | ((Pixel) & 0xFF00) | (((Pixel) & 0xFF) << 16))
+
+  // Pack 4 pixels at a time into 3 words, rather than storing them byte by byte.
+  Src = (CONST UINT32*)Source;
+  while (Pixels >= 4) {
+    Rgb0 = BLT_PIXEL_TO_RGB (Src[0]);
+    Rgb1 = BLT_PIXEL_TO_RGB (Src[1]);
+    Rgb2 = BLT_PIXEL_TO_RGB (Src[2]);
+    Rgb3 = BLT_PIXEL_TO_RGB (Src[3]);
+    WriteUnaligned32 ((UINT32*)&Destination[0], Rgb0 | (Rgb1 << 24));
+    WriteUnaligned32 ((UINT32*)&Destination[4], (Rgb1 >> 8) | (Rgb2 << 16));
+    WriteUnaligned32 ((UINT32*)&Destination[8], (Rgb2 >> 16) | (Rgb3 << 8));
+    Src += 4;
+    Destination += 12;
+    Pixels -= 4;
+  }
+
+  while (Pixels > 0) {
+    Rgb0 = BLT_PIXEL_TO_RGB (Src[0]);
+    Destination[0] = (UINT8)Rgb0;
+    Destination[1] = (UINT8)(Rgb0 >> 8);
+    Destination[2] = (UINT8)(Rgb0 >> 16);
+    Src++;
+    Destination += 3;
+    Pixels--;
+  }
+
+#undef BLT_PIXEL_TO_RGB
+}
+
+/**
+ * Number of bytes of a line to send in a screen update.
+ *
+ * The DisplayLink device starts a new line after each short USB packet, so a line can be cut short
+ * after its rightmost dirty pixel but cannot start part way across. Lines above the dirty band are
+ * sent as a single (unchanged) pixel, just to move on to the next line.
+ * @param UsbDisplayLinkDev
+ * @param Line            Line number
+ * @param Y1              First dirty line
+ * @param X2              Rightmost dirty column (exclusive)
+ * @return
+ */
+STATIC UINTN
+DlGopLineLength (
+    IN USB_DISPLAYLINK_DEV* UsbDisplayLinkDev,
+    IN UINTN Line,
+    IN UINTN Y1,
+    IN UINTN X2
+    )
+{
+  UINTN Pixels;
+  UINTN MaxPacketSize;
+
+  MaxPacketSize = UsbDisplayLinkDev->BulkOutEndpointDescriptor.MaxPacketSize;
+  Pixels = (Line < Y1) ? 1 : X2;
+
+  if (((Pixels * 3) & (MaxPacketSize - 1)) != 0) {
+    return Pixels * 3;
+  }
+
+  // The line must end with a short packet. Send one more (unchanged) pixel if there is one, otherwise
+  // 2 spare bytes that will just get written into the (invisible) stride area.
+  // Note that the API doesn't let us do a bulk write of 0.
+  if (Pixels < UsbDisplayLinkDev->GraphicsOutputProtocol.Mode->Info->HorizontalResolution) {
+    return (Pixels + 1) * 3;
+  }
+  return Pixels * 3 + 2;
+}
+
+/**
+ * Transfer the parts of the Blt buffer that have changed since the last update over USB to the DisplayLink device
  * @param UsbDisplayLinkDev
  * @return
  */
@@ -263,83 +384,112 @@ DlGopSendScreenUpdate (
 {
   EFI_STATUS Status;
   UINT32 USBStatus;
+  EFI_TPL OriginalTPL;
+  UINTN Width;
+  UINTN Height;
+  UINTN Y1;
+  UINTN Y2;
+  UINTN X2;
+  UINTN Line;
+  UINTN BatchEnd;
+  UINTN BatchLen;
+  UINTN DataLen;
+  UINTN Pixels;
+  UINT8* DstPtr;
+
   Status = EFI_SUCCESS;
 
+  if (UsbDisplayLinkDev->TransferBuffer == NULL) {
+    return EFI_NOT_READY;
+  }
+
+  Width = UsbDisplayLinkDev->GraphicsOutputProtocol.Mode->Info->HorizontalResolution;
+  Height = UsbDisplayLinkDev->GraphicsOutputProtocol.Mode->Info->VerticalResolution;
+
+  // Take the dirty area, so that BLTs made while we are sending start the next one.
+  OriginalTPL = gBS->RaiseTPL (TPL_NOTIFY);
+
   // If it has been a while since we sent an update, send a full screen.
   // This allows us to update a hot-plugged monitor quickly.
   if (UsbDisplayLinkDev->TimeSinceLastScreenUpdate > DISPLAYLINK_FULL_SCREEN_UPDATE_PERIOD) {
     UsbDisplayLinkDev->LastY1 = 0;
-    UsbDisplayLinkDev->LastY2 = UsbDisplayLinkDev->GraphicsOutputProtocol.Mode->Info->HorizontalResolution - 1;
+    UsbDisplayLinkDev->LastY2 = Height;
+    UsbDisplayLinkDev->LastX2 = Width;
   }
 
   // If there has been no BLT since the last update/poll, drop out quietly.
-  if (UsbDisplayLinkDev->LastY2 < UsbDisplayLinkDev->LastY1) {
+  if (UsbDisplayLinkDev->LastY2 <= UsbDisplayLinkDev->LastY1) {
     UsbDisplayLinkDev->TimeSinceLastScreenUpdate += (DISPLAYLINK_SCREEN_UPDATE_TIMER_PERIOD / 1000);  // Convert us to ms
+    gBS->RestoreTPL (OriginalTPL);
     return EFI_SUCCESS;
   }
 
   UsbDisplayLinkDev->TimeSinceLastScreenUpdate = 0;
 
-  EFI_TPL OriginalTPL = gBS->RaiseTPL (TPL_NOTIFY);
+  Y1 = UsbDisplayLinkDev->LastY1;
+  Y2 = MIN (UsbDisplayLinkDev->LastY2, Height);
+  X2 = MIN (UsbDisplayLinkDev->LastX2, Width);
+  UsbDisplayLinkDev->LastY2 = 0;
+  UsbDisplayLinkDev->LastY1 = (UINTN)-1;
+  UsbDisplayLinkDev->LastX2 = 0;
 
-  UINTN DataLen;
-  UINTN Width;
-  UINTN Height;
-  EFI_GRAPHICS_OUTPUT_BLT_PIXEL* SrcPtr;
-  UINT8* DstPtr;
-  UINT8 DstBuffer[1920 * 3]; // Get rid of the magic numbers at some point
-                             // Could also use a buffer allocated at runtime to store the line, stored in the USB_DISPLAYLINK_DEV structure.
-  UINTN H;
+  gBS->RestoreTPL (OriginalTPL);
 
-  DataLen = UsbDisplayLinkDev->GraphicsOutputProtocol.Mode->Info->HorizontalResolution * 3; // Send 1 line @ 24 bits per pixel
-  Width = UsbDisplayLinkDev->GraphicsOutputProtocol.Mode->Info->HorizontalResolution;
-  Height = UsbDisplayLinkDev->GraphicsOutputProtocol.Mode->Info->VerticalResolution;
-  SrcPtr = UsbDisplayLinkDev->Screen;
-  DstPtr = DstBuffer;
-
-  for (H = 0; H < Height; H++) {
-    DstPtr = DstBuffer;
-
-    UINTN W;
-    for (W = 0; W < Width; W++) {
-      // Need to swap round the RGB values
-      DstPtr[0] = ((UINT8 *)SrcPtr)[2];
-      DstPtr[1] = ((UINT8 *)SrcPtr)[1];
-      DstPtr[2] = ((UINT8 *)SrcPtr)[0];
-      SrcPtr++;
-      DstPtr += 3;
-    }
+  // Lines below the dirty band are not sent at all: the frame is terminated after the last dirty line.
+  for (Line = 0; Line < Y2; Line = BatchEnd) {
+    // Convert as many lines as fit in the transfer buffer, locking out BLTs only while reading the back buffer.
+    OriginalTPL = gBS->RaiseTPL (TPL_NOTIFY);
 
-    Status = DlUsbBulkWrite (UsbDisplayLinkDev, DstBuffer, DataLen, &USBStatus);
+    BatchLen = 0;
+    for (BatchEnd = Line; BatchEnd < Y2; BatchEnd++) {
+      DataLen = DlGopLineLength (UsbDisplayLinkDev, BatchEnd, Y1, X2);
+      if (BatchLen + DataLen > UsbDisplayLinkDev->TransferBufferSize) {
+        break;
+      }
 
-    // USBStatus values defined in usbio.h, e.g. EFI_USB_ERR_TIMEOUT 0x40
-    if (EFI_ERROR (Status)) {
-      DEBUG ((DEBUG_ERROR, "Screen update - USB bulk transfer of pixel data failed. Line %d len %d, failure code %r USB status x%x\n", H, DataLen, Status, USBStatus));
-      break;
+      DstPtr = UsbDisplayLinkDev->TransferBuffer + BatchLen;
+      Pixels = DataLen / 3;
+      ConvertBltPixelsToRgb (DstPtr, UsbDisplayLinkDev->Screen + BatchEnd * Width, Pixels);
+      if ((DataLen % 3) != 0) {
+        ZeroMem (DstPtr + Pixels * 3, DataLen % 3);
+      }
+      BatchLen += DataLen;
     }
-    // Need an extra DlUsbBulkWrite if the data length is divisible by USB MaxPacketSize. This spare data will just get written into the (invisible) stride area.
-    // Note that the API doesn't let us do a bulk write of 0.
-    if ((DataLen & (UsbDisplayLinkDev->BulkOutEndpointDescriptor.MaxPacketSize - 1)) == 0) {
-      Status = DlUsbBulkWrite (UsbDisplayLinkDev, DstBuffer, 2, &USBStatus);
+
+    gBS->RestoreTPL (OriginalTPL);
+
+    // Each line has to be its own bulk transfer, as the device relies on the short packet at the end of it.
+    DstPtr = UsbDisplayLinkDev->TransferBuffer;
+    for (; Line < BatchEnd; Line++) {
+      DataLen = DlGopLineLength (UsbDisplayLinkDev, Line, Y1, X2);
+      Status = DlUsbBulkWrite (UsbDisplayLinkDev, DstPtr, DataLen, &USBStatus);
+
+      // USBStatus values defined in usbio.h, e.g. EFI_USB_ERR_TIMEOUT 0x40
       if (EFI_ERROR (Status)) {
-        DEBUG ((DEBUG_ERROR, "Screen update - USB bulk transfer of pixel data failed. Line %d len %d, failure code %r USB status x%x\n", H, DataLen, Status, USBStatus));
+        DEBUG ((DEBUG_ERROR, "Screen update - USB bulk transfer of pixel data failed. Line %d len %d, failure code %r USB status x%x\n", Line, DataLen, Status, USBStatus));
         break;
       }
+      UsbDisplayLinkDev->DataSent += DataLen;
+      DstPtr += DataLen;
+    }
+
+    if (EFI_ERROR (Status)) {
+      break;
     }
   }
 
-  if (!EFI_ERROR (Status)) {
-    // If we've successfully transmitted the frame, reset the values that store which area of the screen has been BLTted to.
-    // If we haven't succeeded, this will mean we'll try to resend it after the next poll period.
-    UsbDisplayLinkDev->LastY2 = 0;
-    UsbDisplayLinkDev->LastY1 = (UINTN)-1;
+  if (EFI_ERROR (Status)) {
+    // If we haven't succeeded, add the area back so that we'll try to resend it after the next poll period.
+    OriginalTPL = gBS->RaiseTPL (TPL_NOTIFY);
+    UsbDisplayLinkDev->LastY1 = MIN (UsbDisplayLinkDev->LastY1, Y1);
+    UsbDisplayLinkDev->LastY2 = MAX (UsbDisplayLinkDev->LastY2, Y2);
+    UsbDisplayLinkDev->LastX2 = MAX (UsbDisplayLinkDev->LastX2, X2);
+    gBS->RestoreTPL (OriginalTPL);
   }
 
   // Payload with length of 1 to terminate the frame
   // We need to do this even if we had an error, to indicate to the DL device that it should now expect a new frame.
-  DlUsbBulkWrite (UsbDisplayLinkDev, DstBuffer, 1, &USBStatus);
-
-  gBS->RestoreTPL (OriginalTPL);
+  DlUsbBulkWrite (UsbDisplayLinkDev, UsbDisplayLinkDev->TransferBuffer, 1, &USBStatus);
 
   return Status;
 }
@@ -486,6 +636,22 @@ DisplayLinkSetMode (
     return EFI_OUT_OF_RESOURCES;
   }
 
+  //
+  // Allocate the buffer the screen updates are converted into, big enough for at least one line
+  //
+  if (UsbDisplayLinkDev->TransferBuffer != NULL) {
+    FreePool (UsbDisplayLinkDev->TransferBuffer);
+  }
+
+  UsbDisplayLinkDev->TransferBufferSize = MAX (USB_TRANSFER_LENGTH, Gop->Mode->Info->HorizontalResolution * 3 + 2);
+  UsbDisplayLinkDev->TransferBuffer = AllocatePool (UsbDisplayLinkDev->TransferBufferSize);
+
+  if (UsbDisplayLinkDev->TransferBuffer == NULL) {
+    FreePool (UsbDisplayLinkDev->Screen);
+    UsbDisplayLinkDev->Screen = NULL;
+    return EFI_OUT_OF_RESOURCES;
+  }
+
   DEBUG ((DEBUG_INFO, "Video mode %d selected by BIOS - %d x %d.\n", ModeNumber, VideoMode->HActive, VideoMode->VActive));
   // Wait until we are sure that we can set the video mode before we tell the firmware
   Status = DlUsbSendControlWriteMessage (UsbDisplayLinkDev, SET_VIDEO_MODE, 0, VideoMode, sizeof (struct VideoMode));
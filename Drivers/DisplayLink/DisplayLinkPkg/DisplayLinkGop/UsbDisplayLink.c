@@ -161,6 +161,7 @@ InitializeUsbDisplayLinkDevice (
   // Prevent DlGopSendScreenUpdate from running until we are sure that the video mode is set
   UsbDisplayLinkDev->LastY2 = 0;
   UsbDisplayLinkDev->LastY1 = (UINTN)-1;
+  UsbDisplayLinkDev->LastX2 = 0;
 
   return EFI_SUCCESS;
 }
@@ -1065,6 +1066,11 @@ UsbDisplayLinkDriverBindingStop (
     UsbDisplayLinkDev->Screen = NULL;
   }
 
+  if (UsbDisplayLinkDev->TransferBuffer != NULL) {
+    FreePool (UsbDisplayLinkDev->TransferBuffer);
+    UsbDisplayLinkDev->TransferBuffer = NULL;
+  }
+
   if (UsbDisplayLinkDev->GraphicsOutputProtocol.Mode) {
     if (UsbDisplayLinkDev->GraphicsOutputProtocol.Mode->Info) {
       FreePool (UsbDisplayLinkDev->GraphicsOutputProtocol.Mode->Info);
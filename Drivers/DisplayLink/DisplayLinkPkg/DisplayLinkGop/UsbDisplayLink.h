@@ -20,6 +20,7 @@
 #include <Protocol/GraphicsOutput.h>
 #include <Protocol/UsbIo.h>
 
+#include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
 #include <Library/MemoryAllocationLib.h>
@@ -85,9 +86,11 @@ typedef struct {
   EFI_EVENT                     DriverExitBootServicesEvent;
   BOOLEAN                       ShowBandwidth;                 /** Debugging - show the bandwidth on the screen */
   BOOLEAN                       ShowTestPattern;               /** Show a colourbar pattern instead of the BLTd contents of the framebuffer */
+  UINT8                         *TransferBuffer;               /** Staging buffer for the pixel data of a screen update */
+  UINTN                         TransferBufferSize;
   UINTN                         LastY1;                        /** Used to track if we can do a partial screen update */
   UINTN                         LastY2;
-  UINTN                         LastWidth;
+  UINTN                         LastX2;                        /** Rightmost dirty column (exclusive) */
   UINTN                         TimeSinceLastScreenUpdate;     /** Do a full screen update every (x) seconds */
 } USB_DISPLAYLINK_DEV;
 
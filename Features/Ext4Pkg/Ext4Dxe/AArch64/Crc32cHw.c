@@ -0,0 +1,36 @@
+/** @file
+  CRC32C instruction support detection for AARCH64
+
+  Copyright (c) 2021 - 2023 Pedro Falcato All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include "../Ext4Dxe.h"
+
+// ID_AA64ISAR0_EL1.CRC32, bits [19:16]: 0b0001 if CRC32 and CRC32C are implemented
+#define ID_AA64ISAR0_CRC32_SHIFT  16
+#define ID_AA64ISAR0_CRC32_MASK   0xFULL
+
+/**
+   Reads the ID_AA64ISAR0_EL1 system register.
+
+   @return The value of ID_AA64ISAR0_EL1.
+**/
+UINT64
+EFIAPI
+Ext4ReadIdAa64Isar0 (
+  VOID
+  );
+
+/**
+   Checks if the CPU supports the CRC32C instructions used by Ext4Crc32cHw.
+
+   @return TRUE if supported, FALSE otherwise.
+**/
+BOOLEAN
+Ext4Crc32cHwSupported (
+  VOID
+  )
+{
+  return ((Ext4ReadIdAa64Isar0 () >> ID_AA64ISAR0_CRC32_SHIFT) & ID_AA64ISAR0_CRC32_MASK) != 0;
+}
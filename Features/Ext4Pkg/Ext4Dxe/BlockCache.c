@@ -0,0 +1,242 @@
+/** @file
+  Metadata block cache
+
+  Copyright (c) 2021 - 2023 Pedro Falcato All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+  Inode table blocks, extent tree nodes, block map indirect blocks and directory
+  blocks are all read through a small, per-partition cache of filesystem blocks.
+  The cache is a fixed pool of block buffers, indexed by a hash table (keyed by
+  block number) and kept in LRU order for eviction. Since the driver never writes
+  to the disk, cached blocks never need to be written back or invalidated.
+**/
+
+#include "Ext4Dxe.h"
+
+// If the cache can't hold at least this many blocks, it's not worth having one.
+#define EXT4_BLOCK_CACHE_MIN_ENTRIES  4
+
+/**
+   Returns the hash bucket for a given block number.
+
+   @param[in]      Cache         Pointer to the block cache.
+   @param[in]      Block         Block number.
+
+   @return Pointer to the head of the bucket's list.
+**/
+STATIC
+LIST_ENTRY *
+Ext4BlockCacheBucket (
+  IN CONST EXT4_BLOCK_CACHE  *Cache,
+  IN EXT4_BLOCK_NR           Block
+  )
+{
+  // NumberBuckets is a power of two. Neighbouring blocks (the common case for
+  // inode tables and directories) land in different buckets.
+  return &Cache->Buckets[(UINTN)Block & (Cache->NumberBuckets - 1)];
+}
+
+/**
+   Looks up a block in the cache.
+
+   @param[in]      Cache         Pointer to the block cache.
+   @param[in]      Block         Block number.
+
+   @return Pointer to the cached block, or NULL if the block isn't cached.
+**/
+STATIC
+EXT4_CACHED_BLOCK *
+Ext4BlockCacheLookup (
+  IN CONST EXT4_BLOCK_CACHE  *Cache,
+  IN EXT4_BLOCK_NR           Block
+  )
+{
+  LIST_ENTRY         *Bucket;
+  LIST_ENTRY         *Entry;
+  EXT4_CACHED_BLOCK  *Cached;
+
+  Bucket = Ext4BlockCacheBucket (Cache, Block);
+
+  BASE_LIST_FOR_EACH (Entry, Bucket) {
+    Cached = EXT4_CACHED_BLOCK_FROM_HASH_NODE (Entry);
+
+    if (Cached->Block == Block) {
+      return Cached;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+   Initialises the partition's block cache.
+   The size of the cache is controlled by PcdExt4BlockCacheSize. If the cache can't be
+   set up, the partition is left without one and all reads go straight to the disk.
+
+   @param[in out]  Partition     Pointer to the opened EXT4 partition, with a valid BlockSize.
+
+   @retval EFI_SUCCESS           The cache was initialised.
+   @retval EFI_UNSUPPORTED       The cache is disabled, or too small for the partition's block size.
+   @retval EFI_OUT_OF_RESOURCES  Failed to allocate the cache.
+**/
+EFI_STATUS
+Ext4InitBlockCache (
+  IN OUT EXT4_PARTITION  *Partition
+  )
+{
+  EXT4_BLOCK_CACHE   *Cache;
+  EXT4_CACHED_BLOCK  *Cached;
+  UINTN              NumberEntries;
+  UINTN              Index;
+
+  Cache = &Partition->BlockCache;
+  ZeroMem (Cache, sizeof (*Cache));
+  InitializeListHead (&Cache->Lru);
+
+  NumberEntries = PcdGet32 (PcdExt4BlockCacheSize) / Partition->BlockSize;
+
+  if (NumberEntries < EXT4_BLOCK_CACHE_MIN_ENTRIES) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Cache->NumberBuckets = GetPowerOfTwo32 ((UINT32)NumberEntries);
+  Cache->Buckets       = AllocatePool (Cache->NumberBuckets * sizeof (LIST_ENTRY));
+  Cache->Entries       = AllocatePool (NumberEntries * sizeof (EXT4_CACHED_BLOCK));
+  Cache->Data          = AllocatePool (NumberEntries * Partition->BlockSize);
+
+  if ((Cache->Buckets == NULL) || (Cache->Entries == NULL) || (Cache->Data == NULL)) {
+    Ext4FreeBlockCache (Partition);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  for (Index = 0; Index < Cache->NumberBuckets; Index++) {
+    InitializeListHead (&Cache->Buckets[Index]);
+  }
+
+  // All the entries start out empty: on the LRU list, but not hashed.
+  for (Index = 0; Index < NumberEntries; Index++) {
+    Cached        = &Cache->Entries[Index];
+    Cached->Block = EXT4_BLOCK_FILE_HOLE;
+    Cached->Data  = (UINT8 *)Cache->Data + Index * Partition->BlockSize;
+    InitializeListHead (&Cached->HashNode);
+    InsertTailList (&Cache->Lru, &Cached->LruNode);
+  }
+
+  Cache->NumberEntries = NumberEntries;
+
+  return EFI_SUCCESS;
+}
+
+/**
+   Frees the partition's block cache, if any.
+
+   @param[in out]  Partition     Pointer to the opened EXT4 partition.
+**/
+VOID
+Ext4FreeBlockCache (
+  IN OUT EXT4_PARTITION  *Partition
+  )
+{
+  EXT4_BLOCK_CACHE  *Cache;
+
+  Cache = &Partition->BlockCache;
+
+  if (Cache->NumberEntries != 0) {
+    DEBUG ((
+      DEBUG_INFO,
+      "[ext4] Block cache: %Lu hits, %Lu misses (%Lu blocks of %u bytes)\n",
+      Cache->Hits,
+      Cache->Misses,
+      (UINT64)Cache->NumberEntries,
+      Partition->BlockSize
+      ));
+  }
+
+  if (Cache->Buckets != NULL) {
+    FreePool (Cache->Buckets);
+  }
+
+  if (Cache->Entries != NULL) {
+    FreePool (Cache->Entries);
+  }
+
+  if (Cache->Data != NULL) {
+    FreePool (Cache->Data);
+  }
+
+  ZeroMem (Cache, sizeof (*Cache));
+  InitializeListHead (&Cache->Lru);
+}
+
+/**
+   Reads (part of) a filesystem block, through the partition's block cache.
+   This is meant for metadata, which tends to be re-read often; file data should
+   be read using Ext4ReadDiskIo directly.
+
+   @param[in]      Partition     Pointer to the opened EXT4 partition.
+   @param[in]      Block         Block number.
+   @param[in]      Offset        Offset inside the block, in bytes.
+   @param[in]      Length        Length of the read, in bytes.
+   @param[out]     Buffer        Pointer to the destination buffer.
+
+   @retval EFI_SUCCESS           The read was successful.
+   @retval EFI_INVALID_PARAMETER The requested range does not fit in a single block.
+   @retval others                The underlying disk read failed.
+**/
+EFI_STATUS
+Ext4ReadCachedBlock (
+  IN EXT4_PARTITION  *Partition,
+  IN EXT4_BLOCK_NR   Block,
+  IN UINT32          Offset,
+  IN UINTN           Length,
+  OUT VOID           *Buffer
+  )
+{
+  EXT4_BLOCK_CACHE   *Cache;
+  EXT4_CACHED_BLOCK  *Cached;
+  EFI_STATUS         Status;
+
+  if ((Offset > Partition->BlockSize) || (Length > Partition->BlockSize - Offset)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Cache = &Partition->BlockCache;
+
+  if (Cache->NumberEntries == 0) {
+    return Ext4ReadDiskIo (Partition, Buffer, Length, EXT4_BLOCK_TO_BYTES (Partition, Block) + Offset);
+  }
+
+  Cached = Ext4BlockCacheLookup (Cache, Block);
+
+  if (Cached != NULL) {
+    Cache->Hits++;
+  } else {
+    Cache->Misses++;
+
+    // Recycle the least recently used entry
+    Cached = EXT4_CACHED_BLOCK_FROM_LRU_NODE (GetPreviousNode (&Cache->Lru, &Cache->Lru));
+
+    if (!IsListEmpty (&Cached->HashNode)) {
+      RemoveEntryList (&Cached->HashNode);
+      InitializeListHead (&Cached->HashNode);
+    }
+
+    Status = Ext4ReadBlocks (Partition, Cached->Data, 1, Block);
+
+    if (EFI_ERROR (Status)) {
+      // The entry stays at the tail of the LRU list, so it gets reused first.
+      return Status;
+    }
+
+    Cached->Block = Block;
+    InsertHeadList (Ext4BlockCacheBucket (Cache, Block), &Cached->HashNode);
+  }
+
+  // Move it to the front of the LRU list
+  RemoveEntryList (&Cached->LruNode);
+  InsertHeadList (&Cache->Lru, &Cached->LruNode);
+
+  CopyMem (Buffer, Cached->Data + Offset, Length);
+
+  return EFI_SUCCESS;
+}
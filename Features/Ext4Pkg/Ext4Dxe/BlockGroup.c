@@ -48,6 +48,8 @@ Ext4ReadInode (
   EXT4_INODE             *Inode;
   EXT4_BLOCK_GROUP_DESC  *BlockGroup;
   EXT4_BLOCK_NR          InodeTableStart;
+  UINT64                 InodeBlock;
+  UINT32                 InodeBlockOff;
   EFI_STATUS             Status;
 
   if (!EXT4_IS_VALID_INODE_NR (Partition, InodeNum)) {
@@ -72,6 +74,11 @@ Ext4ReadInode (
     return EFI_OUT_OF_RESOURCES;
   }
 
+  if (Ext4LookupCachedInode (Partition, InodeNum, Inode)) {
+    *OutIno = Inode;
+    return EFI_SUCCESS;
+  }
+
   BlockGroup = Ext4GetBlockGroupDesc (Partition, BlockGroupNumber);
 
   // Note: We'll need to check INODE_UNINIT and friends when/if we add write support
@@ -82,12 +89,31 @@ Ext4ReadInode (
                       BlockGroup->bg_inode_table_hi
                       );
 
-  Status = Ext4ReadDiskIo (
-             Partition,
-             Inode,
-             Partition->InodeSize,
-             EXT4_BLOCK_TO_BYTES (Partition, InodeTableStart) + MultU64x32 (InodeOffset, Partition->InodeSize)
-             );
+  InodeBlock = DivU64x32Remainder (
+                 MultU64x32 (InodeOffset, Partition->InodeSize),
+                 Partition->BlockSize,
+                 &InodeBlockOff
+                 );
+
+  // Inode table blocks hold many inodes and get read over and over again during path
+  // resolution, so read them through the block cache. Inode sizes that aren't a power
+  // of two may leave an inode straddling two blocks; those are read straight from the disk.
+  if (InodeBlockOff + Partition->InodeSize <= Partition->BlockSize) {
+    Status = Ext4ReadCachedBlock (
+               Partition,
+               InodeTableStart + InodeBlock,
+               InodeBlockOff,
+               Partition->InodeSize,
+               Inode
+               );
+  } else {
+    Status = Ext4ReadDiskIo (
+               Partition,
+               Inode,
+               Partition->InodeSize,
+               EXT4_BLOCK_TO_BYTES (Partition, InodeTableStart) + MultU64x32 (InodeOffset, Partition->InodeSize)
+               );
+  }
 
   if (EFI_ERROR (Status)) {
     DEBUG ((
@@ -114,6 +140,8 @@ Ext4ReadInode (
     return EFI_VOLUME_CORRUPTED;
   }
 
+  Ext4CacheInode (Partition, InodeNum, Inode);
+
   *OutIno = Inode;
   return EFI_SUCCESS;
 }
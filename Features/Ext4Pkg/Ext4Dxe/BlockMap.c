@@ -199,6 +199,51 @@ Ext4GetExtentInBlockMap (
   Extent->ee_len      = Count;
 }
 
+/**
+   Describes a hole in a block map, caused by a missing indirect block, as an
+   uninitialized extent.
+
+   @param[in]  Partition       Pointer to the opened EXT4 partition.
+   @param[in]  BlockPath       Block path of the logical block.
+   @param[in]  BlockPathLength Length of BlockPath.
+   @param[in]  HoleIndex       Index, in BlockPath, of the missing block pointer.
+   @param[in out] Extent       Pointer to the resulting EXT4_EXTENT. ee_block must already be set.
+**/
+STATIC
+VOID
+Ext4GetHoleInBlockMap (
+  IN     CONST EXT4_PARTITION  *Partition,
+  IN     CONST EXT2_BLOCK_NR   *BlockPath,
+  IN     UINTN                 BlockPathLength,
+  IN     UINTN                 HoleIndex,
+  IN OUT EXT4_EXTENT           *Extent
+  )
+{
+  UINT64  Entries;
+  UINT64  Count;
+  UINT64  Multiplier;
+  UINTN   Index;
+
+  Entries    = Partition->BlockSize / sizeof (UINT32);
+  Count      = 1;
+  Multiplier = 1;
+
+  // Count the blocks from the current one to the end of the missing block's subtree
+  for (Index = BlockPathLength - 1; Index > HoleIndex; Index--) {
+    Count      += (Entries - 1 - BlockPath[Index]) * Multiplier;
+    Multiplier *= Entries;
+
+    if (Count >= EXT4_EXTENT_MAX_INITIALIZED - 1) {
+      Count = EXT4_EXTENT_MAX_INITIALIZED - 1;
+      break;
+    }
+  }
+
+  Extent->ee_start_hi = 0;
+  Extent->ee_start_lo = EXT4_BLOCK_FILE_HOLE;
+  Extent->ee_len      = (UINT16)(EXT4_EXTENT_MAX_INITIALIZED + Count);
+}
+
 /**
    Retrieves an extent from an EXT2/3 inode (with a blockmap).
    @param[in]      Partition     Pointer to the opened EXT4 partition.
@@ -261,10 +306,12 @@ Ext4GetBlocks (
 
     if (Block == EXT4_BLOCK_FILE_HOLE) {
       FreePool (Buffer);
-      return EFI_NO_MAPPING;
+      // Everything under this block pointer is a hole
+      Ext4GetHoleInBlockMap (Partition, BlockPath, BlockPathLength, Index, Extent);
+      return EFI_SUCCESS;
     }
 
-    Status = Ext4ReadBlocks (Partition, Buffer, 1, Block);
+    Status = Ext4ReadCachedBlock (Partition, Block, 0, Partition->BlockSize, Buffer);
 
     if (EFI_ERROR (Status)) {
       FreePool (Buffer);
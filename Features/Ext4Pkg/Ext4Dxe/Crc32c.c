@@ -0,0 +1,47 @@
+/** @file
+  CRC32C for metadata checksums
+
+  Copyright (c) 2021 - 2023 Pedro Falcato All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+  metadata_csum checksums every inode, block group descriptor, extent block and
+  directory block that gets read, so the CRC32C shows up in the time it takes to
+  open files. When the CPU has CRC32C instructions (SSE4.2 on X64, the ARMv8 CRC32
+  extension on AARCH64) those are used; otherwise we fall back to BaseLib's
+  table-driven CalculateCrc32c.
+**/
+
+#include "Ext4Dxe.h"
+
+STATIC BOOLEAN  mCrc32cProbed;
+STATIC BOOLEAN  mCrc32cHwSupported;
+
+/**
+   Calculates the CRC32C of the given buffer, ext4-style: the CRC is neither
+   pre- nor post-inverted.
+
+   @param[in]      Buffer        Pointer to the buffer.
+   @param[in]      Length        Length of the buffer, in bytes.
+   @param[in]      Crc           Initial value of the CRC.
+
+   @return The CRC32C.
+**/
+UINT32
+Ext4CalculateCrc32c (
+  IN CONST VOID  *Buffer,
+  IN UINTN       Length,
+  IN UINT32      Crc
+  )
+{
+  if (!mCrc32cProbed) {
+    mCrc32cHwSupported = Ext4Crc32cHwSupported ();
+    mCrc32cProbed      = TRUE;
+    DEBUG ((DEBUG_INFO, "[ext4] Using %a CRC32C\n", mCrc32cHwSupported ? "hardware" : "table"));
+  }
+
+  if (mCrc32cHwSupported) {
+    return Ext4Crc32cHw (Crc, Buffer, Length);
+  }
+
+  return ~CalculateCrc32c (Buffer, Length, ~Crc);
+}
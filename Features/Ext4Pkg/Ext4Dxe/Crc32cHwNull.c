@@ -0,0 +1,43 @@
+/** @file
+  CRC32C instructions are not supported on this architecture
+
+  Copyright (c) 2021 - 2023 Pedro Falcato All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include "Ext4Dxe.h"
+
+/**
+   Checks if the CPU supports the CRC32C instructions used by Ext4Crc32cHw.
+
+   @return TRUE if supported, FALSE otherwise.
+**/
+BOOLEAN
+Ext4Crc32cHwSupported (
+  VOID
+  )
+{
+  return FALSE;
+}
+
+/**
+   Calculates the CRC32C of the given buffer using the CPU's CRC32C instructions.
+   The CRC is neither pre- nor post-inverted.
+
+   @param[in]      Crc           Initial value of the CRC.
+   @param[in]      Buffer        Pointer to the buffer.
+   @param[in]      Length        Length of the buffer, in bytes.
+
+   @return The CRC32C.
+**/
+UINT32
+EFIAPI
+Ext4Crc32cHw (
+  IN UINT32      Crc,
+  IN CONST VOID  *Buffer,
+  IN UINTN       Length
+  )
+{
+  ASSERT (FALSE);
+  return ~CalculateCrc32c (Buffer, Length, ~Crc);
+}
@@ -90,36 +90,350 @@ Ext4ValidDirent (
 }
 
 /**
-   Retrieves a directory entry.
+   Searches a single directory block for a directory entry.
 
-   @param[in]      Directory   Pointer to the opened directory.
-   @param[in]      NameUnicode Pointer to the UCS-2 formatted filename.
+   @param[in]      Buf         Pointer to the directory block.
+   @param[in]      Name        Pointer to the UCS-2 formatted filename.
    @param[in]      Partition   Pointer to the ext4 partition.
    @param[out]     Result      Pointer to the destination directory entry.
 
-   @return The result of the operation.
+   @retval EFI_SUCCESS           The entry was found.
+   @retval EFI_NOT_FOUND         The entry is not in this block.
+   @retval EFI_VOLUME_CORRUPTED  The directory block is corrupted.
+   @retval !EFI_SUCCESS          Failure.
 **/
+STATIC
 EFI_STATUS
-Ext4RetrieveDirent (
-  IN EXT4_FILE        *Directory,
+Ext4SearchDirBlock (
+  IN CONST CHAR8      *Buf,
   IN CONST CHAR16     *Name,
   IN EXT4_PARTITION   *Partition,
   OUT EXT4_DIR_ENTRY  *Result
   )
 {
   EFI_STATUS      Status;
-  CHAR8           *Buf;
-  UINT64          Off;
-  EXT4_INODE      *Inode;
-  UINT64          DirInoSize;
-  UINT32          BlockRemainder;
-  UINTN           Length;
   EXT4_DIR_ENTRY  *Entry;
   UINTN           RemainingBlock;
   CHAR16          DirentUcs2Name[EXT4_NAME_MAX + 1];
   UINTN           ToCopy;
   UINTN           BlockOffset;
 
+  for (BlockOffset = 0; BlockOffset < Partition->BlockSize; ) {
+    Entry          = (EXT4_DIR_ENTRY *)(Buf + BlockOffset);
+    RemainingBlock = Partition->BlockSize - BlockOffset;
+    // Check if the minimum directory entry fits inside [BlockOffset, EndOfBlock]
+    if (RemainingBlock < EXT4_MIN_DIR_ENTRY_LEN) {
+      return EFI_VOLUME_CORRUPTED;
+    }
+
+    if (!Ext4ValidDirent (Entry)) {
+      return EFI_VOLUME_CORRUPTED;
+    }
+
+    if ((Entry->name_len > RemainingBlock) || (Entry->rec_len > RemainingBlock)) {
+      // Corrupted filesystem
+      return EFI_VOLUME_CORRUPTED;
+    }
+
+    // Unused entry
+    if (Entry->inode == 0) {
+      BlockOffset += Entry->rec_len;
+      continue;
+    }
+
+    Status = Ext4GetUcs2DirentName (Entry, DirentUcs2Name);
+
+    /* In theory, this should never fail.
+     * In reality, it's quite possible that it can fail, considering filenames in
+     * Linux (and probably other nixes) are just null-terminated bags of bytes, and don't
+     * need to form valid ASCII/UTF-8 sequences.
+     */
+    if (EFI_ERROR (Status)) {
+      if (Status == EFI_INVALID_PARAMETER) {
+        // If we error out due to a bad UTF-8 sequence (see Ext4GetUcs2DirentName), skip this entry.
+        // I'm not sure if this is correct behaviour, but I don't think there's a precedent here.
+        BlockOffset += Entry->rec_len;
+        continue;
+      }
+
+      // Other sorts of errors should just error out.
+      return Status;
+    }
+
+    if ((Entry->name_len == StrLen (Name)) &&
+        !Ext4StrCmpInsensitive (DirentUcs2Name, (CHAR16 *)Name))
+    {
+      ToCopy = MIN (Entry->rec_len, sizeof (EXT4_DIR_ENTRY));
+
+      CopyMem (Result, Entry, ToCopy);
+      return EFI_SUCCESS;
+    }
+
+    BlockOffset += Entry->rec_len;
+  }
+
+  return EFI_NOT_FOUND;
+}
+
+/**
+   Reads a whole (logical) block of a directory.
+
+   @param[in]      Partition   Pointer to the ext4 partition.
+   @param[in]      Directory   Pointer to the opened directory.
+   @param[in]      Block       Logical block number inside the directory.
+   @param[out]     Buf         Pointer to a buffer of Partition->BlockSize bytes.
+
+   @return The result of the operation.
+**/
+STATIC
+EFI_STATUS
+Ext4ReadDirBlock (
+  IN EXT4_PARTITION  *Partition,
+  IN EXT4_FILE       *Directory,
+  IN UINT32          Block,
+  OUT CHAR8          *Buf
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Length;
+
+  Length = Partition->BlockSize;
+
+  Status = Ext4Read (Partition, Directory, Buf, MultU64x32 (Block, Partition->BlockSize), &Length);
+
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  // Directory inodes have block aligned sizes, so a short read means the block is past the end
+  if (Length != Partition->BlockSize) {
+    return EFI_VOLUME_CORRUPTED;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+   Calculates the maximum number of EXT4_DX_ENTRYs that fit in a hash tree node.
+
+   @param[in]      Partition     Pointer to the ext4 partition.
+   @param[in]      EntriesOffset Offset of the first entry inside the node's block.
+
+   @return The maximum number of entries.
+**/
+STATIC
+UINT32
+Ext4DxMaxEntries (
+  IN EXT4_PARTITION  *Partition,
+  IN UINTN           EntriesOffset
+  )
+{
+  UINTN  Space;
+
+  Space = Partition->BlockSize - EntriesOffset;
+
+  if (EXT4_HAS_METADATA_CSUM (Partition)) {
+    Space -= sizeof (EXT4_DX_TAIL);
+  }
+
+  return (UINT32)(Space / sizeof (EXT4_DX_ENTRY));
+}
+
+/**
+   Retrieves a directory entry from a hash tree (htree) indexed directory,
+   by walking the index down to the leaf block that covers the name's hash.
+
+   @param[in]      Directory   Pointer to the opened directory.
+   @param[in]      Name        Pointer to the UCS-2 formatted filename.
+   @param[in]      Partition   Pointer to the ext4 partition.
+   @param[in]      Buf         Pointer to a scratch buffer of Partition->BlockSize bytes.
+   @param[out]     Result      Pointer to the destination directory entry.
+
+   @retval EFI_SUCCESS          The entry was found.
+   @retval EFI_NOT_FOUND        The entry was not found in the leaf block(s) for the hash.
+   @retval EFI_UNSUPPORTED      The index can't be used; the caller should do a linear scan.
+   @retval !EFI_SUCCESS         Failure.
+**/
+STATIC
+EFI_STATUS
+Ext4HtreeRetrieveDirent (
+  IN EXT4_FILE        *Directory,
+  IN CONST CHAR16     *Name,
+  IN EXT4_PARTITION   *Partition,
+  IN CHAR8            *Buf,
+  OUT EXT4_DIR_ENTRY  *Result
+  )
+{
+  EFI_STATUS           Status;
+  CHAR8                *Utf8Name;
+  CHAR8                *LeafBuf;
+  EXT4_DX_ROOT         *Root;
+  EXT4_DX_ENTRY        *Entries;
+  EXT4_DX_ENTRY        *At;
+  EXT4_DX_ENTRY        *Low;
+  EXT4_DX_ENTRY        *High;
+  EXT4_DX_ENTRY        *Mid;
+  EXT4_DX_COUNT_LIMIT  *CountLimit;
+  UINTN                EntriesOffset;
+  UINT32               Hash;
+  UINT32               Levels;
+  UINT32               MaxLevels;
+
+  LeafBuf  = NULL;
+  Utf8Name = NULL;
+
+  // Names are hashed in their on-disk (UTF-8) form.
+  if (UCS2StrToUTF8 ((CHAR16 *)Name, &Utf8Name) != EFI_SUCCESS) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Status = Ext4ReadDirBlock (Partition, Directory, 0, Buf);
+
+  if (EFI_ERROR (Status)) {
+    goto Out;
+  }
+
+  Root          = (EXT4_DX_ROOT *)Buf;
+  EntriesOffset = OFFSET_OF (EXT4_DX_ROOT, info) + Root->info.info_length;
+  MaxLevels     = EXT4_HAS_INCOMPAT (Partition, EXT4_FEATURE_INCOMPAT_LARGEDIR) ?
+                  EXT4_DX_MAX_LEVELS_LARGE : EXT4_DX_MAX_LEVELS;
+
+  if ((Root->info.reserved_zero != 0) ||
+      (Root->info.info_length < sizeof (EXT4_DX_ROOT_INFO)) ||
+      ((Root->info.unused_flags & 1) != 0) ||
+      (Root->info.indirect_levels >= MaxLevels) ||
+      (EntriesOffset + sizeof (EXT4_DX_ENTRY) > Partition->BlockSize))
+  {
+    DEBUG ((DEBUG_WARN, "[ext4] Bad htree root in directory inode %u, doing a linear lookup\n", Directory->InodeNum));
+    Status = EFI_UNSUPPORTED;
+    goto Out;
+  }
+
+  Status = Ext4CalculateDirHash (Partition, Root->info.hash_version, Utf8Name, AsciiStrLen (Utf8Name), &Hash);
+
+  if (EFI_ERROR (Status)) {
+    goto Out;
+  }
+
+  Levels = Root->info.indirect_levels;
+
+  while (TRUE) {
+    Entries    = (EXT4_DX_ENTRY *)(Buf + EntriesOffset);
+    CountLimit = (EXT4_DX_COUNT_LIMIT *)Entries;
+
+    if ((CountLimit->count == 0) || (CountLimit->count > CountLimit->limit) ||
+        (CountLimit->limit > Ext4DxMaxEntries (Partition, EntriesOffset)))
+    {
+      Status = EFI_VOLUME_CORRUPTED;
+      goto Out;
+    }
+
+    // Entries[0] has no hash (it covers everything below Entries[1].hash), so
+    // binary search the rest for the last entry whose hash is <= Hash.
+    Low  = Entries + 1;
+    High = Entries + CountLimit->count - 1;
+
+    while (Low <= High) {
+      Mid = Low + (High - Low) / 2;
+
+      if (Mid->hash > Hash) {
+        High = Mid - 1;
+      } else {
+        Low = Mid + 1;
+      }
+    }
+
+    At = Low - 1;
+
+    if (Levels == 0) {
+      break;
+    }
+
+    Levels--;
+
+    Status = Ext4ReadDirBlock (Partition, Directory, At->block & EXT4_DX_BLOCK_MASK, Buf);
+
+    if (EFI_ERROR (Status)) {
+      goto Out;
+    }
+
+    EntriesOffset = sizeof (EXT4_DX_NODE);
+  }
+
+  LeafBuf = AllocatePool (Partition->BlockSize);
+
+  if (LeafBuf == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Out;
+  }
+
+  while (TRUE) {
+    Status = Ext4ReadDirBlock (Partition, Directory, At->block & EXT4_DX_BLOCK_MASK, LeafBuf);
+
+    if (EFI_ERROR (Status)) {
+      goto Out;
+    }
+
+    Status = Ext4SearchDirBlock (LeafBuf, Name, Partition, Result);
+
+    if (Status != EFI_NOT_FOUND) {
+      goto Out;
+    }
+
+    // Names with the same hash may spill over into the next leaf, in which case the
+    // next index entry has the same hash with the collision bit set.
+    At++;
+
+    if ((At >= Entries + CountLimit->count) ||
+        ((At->hash & EXT4_DX_HASH_COLLISION) == 0) ||
+        ((At->hash & ~EXT4_DX_HASH_COLLISION) != Hash))
+    {
+      break;
+    }
+  }
+
+  Status = EFI_NOT_FOUND;
+
+Out:
+  if (LeafBuf != NULL) {
+    FreePool (LeafBuf);
+  }
+
+  FreePool (Utf8Name);
+  return Status;
+}
+
+/**
+   Retrieves a directory entry.
+
+   @param[in]      Directory   Pointer to the opened directory.
+   @param[in]      NameUnicode Pointer to the UCS-2 formatted filename.
+   @param[in]      Partition   Pointer to the ext4 partition.
+   @param[out]     Result      Pointer to the destination directory entry.
+
+   @return The result of the operation.
+**/
+EFI_STATUS
+Ext4RetrieveDirent (
+  IN EXT4_FILE        *Directory,
+  IN CONST CHAR16     *Name,
+  IN EXT4_PARTITION   *Partition,
+  OUT EXT4_DIR_ENTRY  *Result
+  )
+{
+  EFI_STATUS  Status;
+  CHAR8       *Buf;
+  UINT64      Off;
+  EXT4_INODE  *Inode;
+  UINT64      DirInoSize;
+  UINT32      BlockRemainder;
+  UINTN       Length;
+
+  // Repeated lookups of the same name (found or not) are served from the cache
+  if (Ext4LookupCachedDirent (Partition, Directory->InodeNum, Name, Result, &Status)) {
+    return Status;
+  }
+
   Buf = AllocatePool (Partition->BlockSize);
 
   if (Buf == NULL) {
@@ -138,6 +452,19 @@ Ext4RetrieveDirent (
     goto Out;
   }
 
+  if (((Inode->i_flags & EXT4_INDEX_FL) != 0) &&
+      EXT4_HAS_COMPAT (Partition, EXT4_FEATURE_COMPAT_DIR_INDEX))
+  {
+    Status = Ext4HtreeRetrieveDirent (Directory, Name, Partition, Buf, Result);
+
+    // Note that names are compared case-insensitively while the hash is computed over
+    // the exact name, so not finding the name in the hashed leaf doesn't mean it doesn't
+    // exist; in that case (or if the index is unusable) fall back to the linear scan.
+    if ((Status != EFI_NOT_FOUND) && (Status != EFI_UNSUPPORTED)) {
+      goto Out;
+    }
+  }
+
   while (Off < DirInoSize) {
     Length = Partition->BlockSize;
 
@@ -147,63 +474,10 @@ Ext4RetrieveDirent (
       goto Out;
     }
 
-    for (BlockOffset = 0; BlockOffset < Partition->BlockSize; ) {
-      Entry          = (EXT4_DIR_ENTRY *)(Buf + BlockOffset);
-      RemainingBlock = Partition->BlockSize - BlockOffset;
-      // Check if the minimum directory entry fits inside [BlockOffset, EndOfBlock]
-      if (RemainingBlock < EXT4_MIN_DIR_ENTRY_LEN) {
-        Status = EFI_VOLUME_CORRUPTED;
-        goto Out;
-      }
-
-      if (!Ext4ValidDirent (Entry)) {
-        Status = EFI_VOLUME_CORRUPTED;
-        goto Out;
-      }
-
-      if ((Entry->name_len > RemainingBlock) || (Entry->rec_len > RemainingBlock)) {
-        // Corrupted filesystem
-        Status = EFI_VOLUME_CORRUPTED;
-        goto Out;
-      }
-
-      // Unused entry
-      if (Entry->inode == 0) {
-        BlockOffset += Entry->rec_len;
-        continue;
-      }
-
-      Status = Ext4GetUcs2DirentName (Entry, DirentUcs2Name);
-
-      /* In theory, this should never fail.
-       * In reality, it's quite possible that it can fail, considering filenames in
-       * Linux (and probably other nixes) are just null-terminated bags of bytes, and don't
-       * need to form valid ASCII/UTF-8 sequences.
-       */
-      if (EFI_ERROR (Status)) {
-        if (Status == EFI_INVALID_PARAMETER) {
-          // If we error out due to a bad UTF-8 sequence (see Ext4GetUcs2DirentName), skip this entry.
-          // I'm not sure if this is correct behaviour, but I don't think there's a precedent here.
-          BlockOffset += Entry->rec_len;
-          continue;
-        }
-
-        // Other sorts of errors should just error out.
-        FreePool (Buf);
-        return Status;
-      }
-
-      if ((Entry->name_len == StrLen (Name)) &&
-          !Ext4StrCmpInsensitive (DirentUcs2Name, (CHAR16 *)Name))
-      {
-        ToCopy = MIN (Entry->rec_len, sizeof (EXT4_DIR_ENTRY));
-
-        CopyMem (Result, Entry, ToCopy);
-        Status = EFI_SUCCESS;
-        goto Out;
-      }
+    Status = Ext4SearchDirBlock (Buf, Name, Partition, Result);
 
-      BlockOffset += Entry->rec_len;
+    if (Status != EFI_NOT_FOUND) {
+      goto Out;
     }
 
     Off += Partition->BlockSize;
@@ -212,6 +486,10 @@ Ext4RetrieveDirent (
   Status = EFI_NOT_FOUND;
 
 Out:
+  if ((Status == EFI_SUCCESS) || (Status == EFI_NOT_FOUND)) {
+    Ext4CacheDirent (Partition, Directory->InodeNum, Name, Status == EFI_SUCCESS ? Result : NULL);
+  }
+
   FreePool (Buf);
   return Status;
 }
@@ -427,6 +705,235 @@ Ext4OpenVolume (
   return EFI_SUCCESS;
 }
 
+/**
+   Checks if a directory entry should be returned by ReadDir().
+
+   @param[in]      Entry       Pointer to the directory entry.
+
+   @return TRUE if it should be skipped, else FALSE.
+**/
+STATIC
+BOOLEAN
+Ext4ReadDirShouldSkip (
+  IN CONST EXT4_DIR_ENTRY  *Entry
+  )
+{
+  BOOLEAN  IsDotOrDotDot;
+
+  // We don't care about passing . or .. entries to the caller of ReadDir(),
+  // since they're generally useless entries *and* may break things if too
+  // many callers assume FAT32.
+
+  // Entry->name_len may be 0 if it's a nameless entry, like an unused entry
+  // or a checksum at the end of the directory block.
+  // memcmp (and CompareMem) return 0 when the passed length is 0.
+
+  // We must bound name_len as > 0 and <= 2 to avoid any out-of-bounds accesses or bad detection of
+  // "." and "..".
+  IsDotOrDotDot = Entry->name_len > 0 && Entry->name_len <= 2 &&
+                  CompareMem (Entry->name, "..", Entry->name_len) == 0;
+
+  // When inode = 0, it's unused. When name_len == 0, it's a nameless entry
+  // (which we should not expose to ReadDir).
+  return Entry->inode == 0 || Entry->name_len == 0 || IsDotOrDotDot;
+}
+
+/**
+   Frees the inodes held by the directory's ReadDir cursor and forgets its block.
+
+   @param[in out]  Cursor      Pointer to the ReadDir cursor.
+**/
+STATIC
+VOID
+Ext4ResetDirCursor (
+  IN OUT EXT4_DIR_CURSOR  *Cursor
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < Cursor->NumberEntries; Index++) {
+    if (Cursor->Entries[Index].Inode != NULL) {
+      FreePool (Cursor->Entries[Index].Inode);
+    }
+  }
+
+  Cursor->NumberEntries = 0;
+
+  if (Cursor->Block != NULL) {
+    FreePool (Cursor->Block);
+    Cursor->Block = NULL;
+  }
+}
+
+/**
+   Frees the directory's ReadDir cursor.
+
+   @param[in out]  File          Pointer to the opened directory.
+**/
+VOID
+Ext4FreeDirCursor (
+  IN OUT EXT4_FILE  *File
+  )
+{
+  Ext4ResetDirCursor (&File->DirCursor);
+
+  if (File->DirCursor.Entries != NULL) {
+    FreePool (File->DirCursor.Entries);
+    File->DirCursor.Entries = NULL;
+  }
+}
+
+/**
+   Reads the inodes of the entries held by the ReadDir cursor.
+   Inodes are read in inode number order, which is inode table order, so
+   entries that share an inode table block are read back to back and the
+   block only needs to be fetched from the disk once.
+
+   @param[in]      Partition   Pointer to the ext4 partition.
+   @param[in out]  Cursor      Pointer to the ReadDir cursor.
+   @param[in]      Order       Scratch array of Cursor->NumberEntries UINTNs.
+**/
+STATIC
+VOID
+Ext4ReadDirCursorInodes (
+  IN     EXT4_PARTITION   *Partition,
+  IN OUT EXT4_DIR_CURSOR  *Cursor,
+  IN     UINTN            *Order
+  )
+{
+  EXT4_DIR_CURSOR_ENTRY  *Entries;
+  UINTN                  Index;
+  UINTN                  Insert;
+  UINTN                  Current;
+
+  Entries = Cursor->Entries;
+
+  // Insertion sort, since a block's entries are usually (almost) sorted already:
+  // new files tend to get increasing inode numbers.
+  for (Index = 0; Index < Cursor->NumberEntries; Index++) {
+    Current = Index;
+
+    for (Insert = Index; Insert > 0; Insert--) {
+      if (Entries[Order[Insert - 1]].InodeNum <= Entries[Current].InodeNum) {
+        break;
+      }
+
+      Order[Insert] = Order[Insert - 1];
+    }
+
+    Order[Insert] = Current;
+  }
+
+  for (Index = 0; Index < Cursor->NumberEntries; Index++) {
+    Current                 = Order[Index];
+    Entries[Current].Status = Ext4ReadInode (Partition, Entries[Current].InodeNum, &Entries[Current].Inode);
+
+    if (EFI_ERROR (Entries[Current].Status)) {
+      Entries[Current].Inode = NULL;
+    }
+  }
+}
+
+/**
+   Loads a directory block into the directory's ReadDir cursor, and reads the
+   inodes of the entries that ReadDir() will return.
+
+   @param[in]      Partition   Pointer to the ext4 partition.
+   @param[in]      File        Pointer to the open directory.
+   @param[in]      BlockOffset Offset of the block inside the directory, in bytes.
+
+   @return Result of the operation.
+**/
+STATIC
+EFI_STATUS
+Ext4LoadDirCursor (
+  IN EXT4_PARTITION  *Partition,
+  IN EXT4_FILE       *File,
+  IN UINT64          BlockOffset
+  )
+{
+  EXT4_DIR_CURSOR  *Cursor;
+  EXT4_DIR_ENTRY   *Entry;
+  UINTN            MaxEntries;
+  UINTN            *Order;
+  UINT32           Offset;
+  UINT32           RemainingBlock;
+  EFI_STATUS       Status;
+
+  Cursor = &File->DirCursor;
+  Ext4ResetDirCursor (Cursor);
+
+  // Every entry takes at least EXT4_MIN_DIR_ENTRY_LEN bytes
+  MaxEntries = Partition->BlockSize / EXT4_MIN_DIR_ENTRY_LEN;
+
+  if (Cursor->Entries == NULL) {
+    Cursor->Entries = AllocatePool (MaxEntries * sizeof (EXT4_DIR_CURSOR_ENTRY));
+
+    if (Cursor->Entries == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+  }
+
+  Cursor->Block = AllocatePool (Partition->BlockSize);
+  Order         = AllocatePool (MaxEntries * sizeof (UINTN));
+
+  if ((Cursor->Block == NULL) || (Order == NULL)) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Error;
+  }
+
+  Status = Ext4ReadDirBlock (
+             Partition,
+             File,
+             (UINT32)DivU64x32 (BlockOffset, Partition->BlockSize),
+             Cursor->Block
+             );
+
+  if (EFI_ERROR (Status)) {
+    goto Error;
+  }
+
+  Cursor->BlockOffset     = BlockOffset;
+  Cursor->CorruptedOffset = Partition->BlockSize;
+
+  // Corruption is only reported once ReadDir() gets to the bad entry, so the
+  // entries before it can still be listed.
+  for (Offset = 0; Offset < Partition->BlockSize; Offset += Entry->rec_len) {
+    Entry          = (EXT4_DIR_ENTRY *)(Cursor->Block + Offset);
+    RemainingBlock = Partition->BlockSize - Offset;
+
+    if ((RemainingBlock < EXT4_MIN_DIR_ENTRY_LEN) || !Ext4ValidDirent (Entry) ||
+        (Entry->rec_len > RemainingBlock))
+    {
+      DEBUG ((DEBUG_ERROR, "[ext4] Invalid dirent at offset %lu\n", BlockOffset + Offset));
+      Cursor->CorruptedOffset = Offset;
+      break;
+    }
+
+    if (Ext4ReadDirShouldSkip (Entry)) {
+      continue;
+    }
+
+    Cursor->Entries[Cursor->NumberEntries].Offset   = Offset;
+    Cursor->Entries[Cursor->NumberEntries].InodeNum = Entry->inode;
+    Cursor->Entries[Cursor->NumberEntries].Inode    = NULL;
+    Cursor->NumberEntries++;
+  }
+
+  Ext4ReadDirCursorInodes (Partition, Cursor, Order);
+
+  FreePool (Order);
+  return EFI_SUCCESS;
+
+Error:
+  if (Order != NULL) {
+    FreePool (Order);
+  }
+
+  Ext4ResetDirCursor (Cursor);
+  return Status;
+}
+
 /**
    Reads a directory entry.
 
@@ -448,20 +955,21 @@ Ext4ReadDir (
   IN OUT UINTN       *OutLength
   )
 {
-  EXT4_INODE      *DirIno;
-  EFI_STATUS      Status;
-  UINT64          DirInoSize;
-  UINTN           Len;
-  UINT32          BlockRemainder;
-  EXT4_DIR_ENTRY  Entry;
-  EXT4_FILE       *TempFile;
-  BOOLEAN         ShouldSkip;
-  BOOLEAN         IsDotOrDotDot;
-  CHAR16          DirentUcs2Name[EXT4_NAME_MAX + 1];
+  EXT4_INODE             *DirIno;
+  EFI_STATUS             Status;
+  UINT64                 DirInoSize;
+  UINT32                 BlockRemainder;
+  UINT64                 BlockOffset;
+  UINTN                  Index;
+  EXT4_DIR_CURSOR        *Cursor;
+  EXT4_DIR_CURSOR_ENTRY  *CursorEntry;
+  EXT4_DIR_ENTRY         *Entry;
+  EXT4_FILE              InfoFile;
+  CHAR16                 DirentUcs2Name[EXT4_NAME_MAX + 1];
 
   DirIno     = File->Inode;
-  Status     = EFI_SUCCESS;
   DirInoSize = EXT4_INODE_SIZE (DirIno);
+  Cursor     = &File->DirCursor;
 
   DivU64x32Remainder (DirInoSize, Partition->BlockSize, &BlockRemainder);
   if (BlockRemainder != 0) {
@@ -470,97 +978,74 @@ Ext4ReadDir (
   }
 
   while (TRUE) {
-    TempFile = NULL;
-
-    // We (try to) read the maximum size of a directory entry at a time
-    // Note that we don't need to read any padding that may exist after it.
-    Len    = sizeof (Entry);
-    Status = Ext4Read (Partition, File, &Entry, Offset, &Len);
-
-    if (EFI_ERROR (Status)) {
-      goto Out;
-    }
-
-    if (Len == 0) {
+    if (Offset >= DirInoSize) {
       *OutLength = 0;
-      Status     = EFI_SUCCESS;
-      goto Out;
+      return EFI_SUCCESS;
     }
 
-    if (Len < EXT4_MIN_DIR_ENTRY_LEN) {
-      Status = EFI_VOLUME_CORRUPTED;
-      goto Out;
-    }
+    DivU64x32Remainder (Offset, Partition->BlockSize, &BlockRemainder);
+    BlockOffset = Offset - BlockRemainder;
 
-    // Invalid directory entry length
-    if (!Ext4ValidDirent (&Entry)) {
-      DEBUG ((DEBUG_ERROR, "[ext4] Invalid dirent at offset %lu\n", Offset));
-      Status = EFI_VOLUME_CORRUPTED;
-      goto Out;
-    }
+    if ((Cursor->Block == NULL) || (Cursor->BlockOffset != BlockOffset)) {
+      Status = Ext4LoadDirCursor (Partition, File, BlockOffset);
 
-    // Check if the entire dir entry length fits in Len
-    if (Len < (UINTN)(EXT4_MIN_DIR_ENTRY_LEN + Entry.name_len)) {
-      Status = EFI_VOLUME_CORRUPTED;
-      goto Out;
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
     }
 
-    // We don't care about passing . or .. entries to the caller of ReadDir(),
-    // since they're generally useless entries *and* may break things if too
-    // many callers assume FAT32.
-
-    // Entry.name_len may be 0 if it's a nameless entry, like an unused entry
-    // or a checksum at the end of the directory block.
-    // memcmp (and CompareMem) return 0 when the passed length is 0.
-
-    // We must bound name_len as > 0 and <= 2 to avoid any out-of-bounds accesses or bad detection of
-    // "." and "..".
-    IsDotOrDotDot = Entry.name_len > 0 && Entry.name_len <= 2 &&
-                    CompareMem (Entry.name, "..", Entry.name_len) == 0;
+    // Find the first entry we may return, at or after Offset
+    for (Index = 0; Index < Cursor->NumberEntries; Index++) {
+      if (Cursor->Entries[Index].Offset >= BlockRemainder) {
+        break;
+      }
+    }
 
-    // When inode = 0, it's unused. When name_len == 0, it's a nameless entry
-    // (which we should not expose to ReadDir).
-    ShouldSkip = Entry.inode == 0 || Entry.name_len == 0 || IsDotOrDotDot;
+    if (Index == Cursor->NumberEntries) {
+      if (Cursor->CorruptedOffset != Partition->BlockSize) {
+        return EFI_VOLUME_CORRUPTED;
+      }
 
-    if (ShouldSkip) {
-      Offset += Entry.rec_len;
+      // Nothing left in this block
+      Offset = BlockOffset + Partition->BlockSize;
       continue;
     }
 
-    // Test if the dirent is valid utf-8. This is already done inside Ext4OpenDirent but EFI_INVALID_PARAMETER
-    // has the danger of its meaning being overloaded in many places, so we can't skip according to that.
-    // So test outside of it, explicitly.
-    Status = Ext4GetUcs2DirentName (&Entry, DirentUcs2Name);
+    CursorEntry = &Cursor->Entries[Index];
+    Entry       = (EXT4_DIR_ENTRY *)(Cursor->Block + CursorEntry->Offset);
+
+    // Test if the dirent is valid utf-8. EFI_INVALID_PARAMETER has the danger of its meaning
+    // being overloaded in many places, so we test for it explicitly before anything else.
+    Status = Ext4GetUcs2DirentName (Entry, DirentUcs2Name);
 
     if (EFI_ERROR (Status)) {
       if (Status == EFI_INVALID_PARAMETER) {
         // Bad UTF-8, skip.
-        Offset += Entry.rec_len;
+        Offset = BlockOffset + CursorEntry->Offset + Entry->rec_len;
         continue;
       }
 
-      goto Out;
+      return Status;
     }
 
-    Status = Ext4OpenDirent (Partition, EFI_FILE_MODE_READ, &TempFile, &Entry, File);
-
-    if (EFI_ERROR (Status)) {
-      goto Out;
+    if (CursorEntry->Inode == NULL) {
+      return CursorEntry->Status;
     }
 
-    Status = Ext4GetFileInfo (TempFile, Buffer, OutLength);
+    // Ext4FillFileInfo only needs the partition and the inode, so there's
+    // no need to set up (and tear down) a whole opened file.
+    ZeroMem (&InfoFile, sizeof (InfoFile));
+    InfoFile.Partition = Partition;
+    InfoFile.Inode     = CursorEntry->Inode;
+    InfoFile.InodeNum  = CursorEntry->InodeNum;
+
+    Status = Ext4FillFileInfo (&InfoFile, DirentUcs2Name, Buffer, OutLength);
     if (!EFI_ERROR (Status)) {
-      File->Position = Offset + Entry.rec_len;
+      File->Position = BlockOffset + CursorEntry->Offset + Entry->rec_len;
     }
 
-    Ext4CloseInternal (TempFile);
-
-    goto Out;
+    return Status;
   }
-
-  Status = EFI_SUCCESS;
-Out:
-  return Status;
 }
 
 /**
@@ -68,7 +68,8 @@
           mostly-list of EXT4_DIR_ENTRY.
        2) Hash tree directories: These are used for larger directories, with
           hundreds of entries, and are designed in a backwards compatible way.
-          These are not yet implemented in the Ext4Dxe driver.
+          Ext4Dxe uses the hash tree index (when present) to speed up lookups,
+          but otherwise treats these directories as classical linear ones.
 
   7) Journal
      Ext3/4 filesystems have a journal to help protect the filesystem against
@@ -173,7 +174,9 @@
 #define EXT4_NOCOMPR_FL       0x00000400
 #define EXT4_ENCRYPT_FL       0x00000800
 #define EXT4_BTREE_FL         0x00001000
-#define EXT4_INDEX_FL         0x00002000
+// Note: EXT4_INDEX_FL shares its value with (the never used) EXT4_BTREE_FL
+#define EXT4_INDEX_FL         0x00001000
+#define EXT4_IMAGIC_FL        0x00002000
 #define EXT4_JOURNAL_DATA_FL  0x00004000
 #define EXT4_NOTAIL_FL        0x00008000
 #define EXT4_DIRSYNC_FL       0x00010000
@@ -424,6 +427,97 @@ typedef struct {
 
 #define EXT4_MIN_DIR_ENTRY_LEN  8
 
+/* Superblock s_flags */
+#define EXT4_FLAGS_SIGNED_HASH    0x0001
+#define EXT4_FLAGS_UNSIGNED_HASH  0x0002
+#define EXT4_FLAGS_TEST_FILESYS   0x0004
+
+/* Directory hash versions (dx_root_info.hash_version and s_def_hash_version) */
+#define EXT4_DX_HASH_LEGACY             0
+#define EXT4_DX_HASH_HALF_MD4           1
+#define EXT4_DX_HASH_TEA                2
+#define EXT4_DX_HASH_LEGACY_UNSIGNED    3
+#define EXT4_DX_HASH_HALF_MD4_UNSIGNED  4
+#define EXT4_DX_HASH_TEA_UNSIGNED       5
+#define EXT4_DX_HASH_SIPHASH            6
+
+// Hash tree directories (htree, or dx_dir) keep a small B-tree-like index keyed by
+// the hash of the name in the directory's blocks. The index blocks are disguised as
+// regular directory blocks that contain a single (unused or "."/"..") entry that spans
+// the whole block, which keeps them backwards compatible with the linear format.
+
+typedef struct {
+  // Hash of the first name covered by this entry. For the first entry of a node,
+  // this field overlaps with the EXT4_DX_COUNT_LIMIT structure.
+  UINT32    hash;
+  // Logical block (in the directory) that covers names starting at 'hash'
+  UINT32    block;
+} EXT4_DX_ENTRY;
+
+typedef struct {
+  // Maximum number of entries that fit in this node
+  UINT16    limit;
+  // Number of entries in this node (including the count/limit entry)
+  UINT16    count;
+} EXT4_DX_COUNT_LIMIT;
+
+typedef struct {
+  // Always 0
+  UINT32    reserved_zero;
+  // One of EXT4_DX_HASH_*
+  UINT8     hash_version;
+  // Length of this structure, usually 8
+  UINT8     info_length;
+  // Depth of the tree, not counting the root
+  UINT8     indirect_levels;
+  UINT8     unused_flags;
+} EXT4_DX_ROOT_INFO;
+
+// The root of the tree lives in the directory's first block, right after "." and "..".
+typedef struct {
+  UINT32               dot_inode;
+  UINT16               dot_rec_len;
+  UINT8                dot_name_len;
+  UINT8                dot_file_type;
+  CHAR8                dot_name[4];
+  UINT32               dotdot_inode;
+  UINT16               dotdot_rec_len;
+  UINT8                dotdot_name_len;
+  UINT8                dotdot_file_type;
+  CHAR8                dotdot_name[4];
+  EXT4_DX_ROOT_INFO    info;
+  // EXT4_DX_ENTRY entries[] follow, at offsetof(info) + info.info_length
+} EXT4_DX_ROOT;
+
+STATIC_ASSERT (
+  sizeof (EXT4_DX_ROOT) == 32,
+  "ext4 dx_root struct has incorrect size"
+  );
+
+// Interior nodes have a fake, unused directory entry that spans the whole block.
+typedef struct {
+  UINT32    fake_inode;
+  UINT16    fake_rec_len;
+  UINT8     name_len;
+  UINT8     file_type;
+  // EXT4_DX_ENTRY entries[] follow
+} EXT4_DX_NODE;
+
+// With metadata_csum, dx nodes end in a tail with the checksum of the node.
+typedef struct {
+  UINT32    dt_reserved;
+  UINT32    dt_checksum;
+} EXT4_DX_TAIL;
+
+// The lowest bit of an EXT4_DX_ENTRY's hash is used as a "hash collision continues in
+// the next block" flag, and the top 4 bits of its block number are reserved.
+#define EXT4_DX_HASH_COLLISION  0x1
+#define EXT4_DX_BLOCK_MASK      0x0FFFFFFF
+
+// Maximum htree depth; largedir filesystems may have 3 levels, others 2.
+#define EXT4_DX_MAX_LEVELS        2
+#define EXT4_DX_MAX_LEVELS_LARGE  3
+
 // This on-disk structure is present at the bottom of the extent tree
 typedef struct {
   // First logical block
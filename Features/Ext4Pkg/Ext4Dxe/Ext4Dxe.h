@@ -77,6 +77,117 @@ Ext4OpenPartition (
 typedef struct _Ext4File     EXT4_FILE;
 typedef struct _Ext4_Dentry  EXT4_DENTRY;
 
+/**
+   A filesystem block held in the partition's block cache.
+   Valid entries are linked into one of the cache's hash buckets; every entry,
+   valid or not, is on the cache's LRU list.
+**/
+typedef struct {
+  LIST_ENTRY       HashNode;
+  LIST_ENTRY       LruNode;
+  EXT4_BLOCK_NR    Block;
+  UINT8            *Data;
+} EXT4_CACHED_BLOCK;
+
+#define EXT4_CACHED_BLOCK_FROM_HASH_NODE(Node)  BASE_CR(Node, EXT4_CACHED_BLOCK, HashNode)
+#define EXT4_CACHED_BLOCK_FROM_LRU_NODE(Node)   BASE_CR(Node, EXT4_CACHED_BLOCK, LruNode)
+
+/**
+   Per-partition cache of metadata blocks (see BlockCache.c).
+   NumberEntries == 0 means the cache is disabled.
+**/
+typedef struct {
+  UINTN                NumberEntries;
+  EXT4_CACHED_BLOCK    *Entries;
+  VOID                 *Data;
+
+  UINTN                NumberBuckets;
+  LIST_ENTRY           *Buckets;
+
+  // Most recently used blocks are at the head
+  LIST_ENTRY           Lru;
+
+  UINT64               Hits;
+  UINT64               Misses;
+} EXT4_BLOCK_CACHE;
+
+/**
+   A cached directory lookup. Negative entries record names that don't exist.
+**/
+typedef struct {
+  LIST_ENTRY        HashNode;
+  LIST_ENTRY        LruNode;
+  EXT4_INO_NR       Directory;
+  BOOLEAN           Negative;
+  CHAR16            Name[EXT4_NAME_MAX + 1];
+  EXT4_DIR_ENTRY    Entry;
+} EXT4_CACHED_DIRENT;
+
+#define EXT4_CACHED_DIRENT_FROM_HASH_NODE(Node)  BASE_CR(Node, EXT4_CACHED_DIRENT, HashNode)
+#define EXT4_CACHED_DIRENT_FROM_LRU_NODE(Node)   BASE_CR(Node, EXT4_CACHED_DIRENT, LruNode)
+
+/**
+   A cached inode.
+**/
+typedef struct {
+  LIST_ENTRY     HashNode;
+  LIST_ENTRY     LruNode;
+  EXT4_INO_NR    InodeNum;
+  EXT4_INODE     *Inode;
+} EXT4_CACHED_INODE;
+
+#define EXT4_CACHED_INODE_FROM_HASH_NODE(Node)  BASE_CR(Node, EXT4_CACHED_INODE, HashNode)
+#define EXT4_CACHED_INODE_FROM_LRU_NODE(Node)   BASE_CR(Node, EXT4_CACHED_INODE, LruNode)
+
+/**
+   Per-partition directory entry cache (see LookupCache.c).
+   NumberEntries == 0 means the cache is disabled.
+**/
+typedef struct {
+  UINTN                 NumberEntries;
+  EXT4_CACHED_DIRENT    *Entries;
+
+  UINTN                 NumberBuckets;
+  LIST_ENTRY            *Buckets;
+
+  // Most recently used entries are at the head
+  LIST_ENTRY            Lru;
+
+  UINT64                Hits;
+  UINT64                Misses;
+} EXT4_DIRENT_CACHE;
+
+/**
+   Per-partition inode cache (see LookupCache.c).
+   NumberEntries == 0 means the cache is disabled.
+**/
+typedef struct {
+  UINTN                NumberEntries;
+  EXT4_CACHED_INODE    *Entries;
+  VOID                 *Data;
+
+  UINTN                NumberBuckets;
+  LIST_ENTRY           *Buckets;
+
+  // Most recently used entries are at the head
+  LIST_ENTRY           Lru;
+
+  UINT64               Hits;
+  UINT64               Misses;
+} EXT4_INODE_CACHE;
+
+/**
+   Disk I/O statistics of a partition, reported when it's unmounted.
+   These make it possible to compare the cost of a workload across changes
+   to the read path.
+**/
+typedef struct {
+  UINT64    DiskReads;
+  UINT64    BytesRead;
+  UINT64    AsyncDiskReads;
+  UINT64    AsyncBytesRead;
+} EXT4_IO_STATS;
+
 typedef struct _Ext4_PARTITION {
   EFI_SIMPLE_FILE_SYSTEM_PROTOCOL    Interface;
   EFI_DISK_IO_PROTOCOL               *DiskIo;
@@ -104,6 +215,12 @@ typedef struct _Ext4_PARTITION {
   LIST_ENTRY                         OpenFiles;
 
   EXT4_DENTRY                        *RootDentry;
+
+  EXT4_BLOCK_CACHE                   BlockCache;
+  EXT4_DIRENT_CACHE                  DirentCache;
+  EXT4_INODE_CACHE                   InodeCache;
+
+  EXT4_IO_STATS                      IoStats;
 } EXT4_PARTITION;
 
 /**
@@ -264,6 +381,150 @@ Ext4AllocAndReadBlocks (
   IN EXT4_BLOCK_NR   BlockNumber
   );
 
+/**
+   Initialises the partition's block cache.
+   The size of the cache is controlled by PcdExt4BlockCacheSize. If the cache can't be
+   set up, the partition is left without one and all reads go straight to the disk.
+
+   @param[in out]  Partition     Pointer to the opened EXT4 partition, with a valid BlockSize.
+
+   @retval EFI_SUCCESS           The cache was initialised.
+   @retval EFI_UNSUPPORTED       The cache is disabled, or too small for the partition's block size.
+   @retval EFI_OUT_OF_RESOURCES  Failed to allocate the cache.
+**/
+EFI_STATUS
+Ext4InitBlockCache (
+  IN OUT EXT4_PARTITION  *Partition
+  );
+
+/**
+   Frees the partition's block cache, if any.
+
+   @param[in out]  Partition     Pointer to the opened EXT4 partition.
+**/
+VOID
+Ext4FreeBlockCache (
+  IN OUT EXT4_PARTITION  *Partition
+  );
+
+/**
+   Reads (part of) a filesystem block, through the partition's block cache.
+   This is meant for metadata, which tends to be re-read often; file data should
+   be read using Ext4ReadDiskIo directly.
+
+   @param[in]      Partition     Pointer to the opened EXT4 partition.
+   @param[in]      Block         Block number.
+   @param[in]      Offset        Offset inside the block, in bytes.
+   @param[in]      Length        Length of the read, in bytes.
+   @param[out]     Buffer        Pointer to the destination buffer.
+
+   @retval EFI_SUCCESS           The read was successful.
+   @retval EFI_INVALID_PARAMETER The requested range does not fit in a single block.
+   @retval others                The underlying disk read failed.
+**/
+EFI_STATUS
+Ext4ReadCachedBlock (
+  IN EXT4_PARTITION  *Partition,
+  IN EXT4_BLOCK_NR   Block,
+  IN UINT32          Offset,
+  IN UINTN           Length,
+  OUT VOID           *Buffer
+  );
+
+/**
+   Initialises the partition's directory entry and inode caches.
+   Their sizes are controlled by PcdExt4DirentCacheEntries and PcdExt4InodeCacheEntries.
+   A cache that can't be set up is left disabled.
+
+   @param[in out]  Partition     Pointer to the opened EXT4 partition, with a valid InodeSize.
+
+   @retval EFI_SUCCESS           The caches were initialised.
+   @retval EFI_OUT_OF_RESOURCES  Failed to allocate (one of) the caches.
+**/
+EFI_STATUS
+Ext4InitLookupCaches (
+  IN OUT EXT4_PARTITION  *Partition
+  );
+
+/**
+   Frees the partition's directory entry and inode caches.
+
+   @param[in out]  Partition     Pointer to the opened EXT4 partition.
+**/
+VOID
+Ext4FreeLookupCaches (
+  IN OUT EXT4_PARTITION  *Partition
+  );
+
+/**
+   Looks up a directory entry in the partition's directory entry cache.
+
+   @param[in]      Partition     Pointer to the opened EXT4 partition.
+   @param[in]      Directory     Inode number of the directory.
+   @param[in]      Name          Pointer to the UCS-2 formatted filename.
+   @param[out]     Result        Pointer to the destination directory entry.
+   @param[out]     Status        Pointer to the cached result of the lookup: EFI_SUCCESS if
+                                 the entry exists (and was copied to Result), else EFI_NOT_FOUND.
+
+   @return TRUE if the lookup was cached, else FALSE.
+**/
+BOOLEAN
+Ext4LookupCachedDirent (
+  IN  EXT4_PARTITION  *Partition,
+  IN  EXT4_INO_NR     Directory,
+  IN  CONST CHAR16    *Name,
+  OUT EXT4_DIR_ENTRY  *Result,
+  OUT EFI_STATUS      *Status
+  );
+
+/**
+   Adds the result of a directory lookup to the partition's directory entry cache.
+
+   @param[in]      Partition     Pointer to the opened EXT4 partition.
+   @param[in]      Directory     Inode number of the directory.
+   @param[in]      Name          Pointer to the UCS-2 formatted filename.
+   @param[in]      Entry         Pointer to the directory entry that was found, or NULL
+                                 if the lookup failed with EFI_NOT_FOUND.
+**/
+VOID
+Ext4CacheDirent (
+  IN EXT4_PARTITION        *Partition,
+  IN EXT4_INO_NR           Directory,
+  IN CONST CHAR16          *Name,
+  IN CONST EXT4_DIR_ENTRY  *Entry  OPTIONAL
+  );
+
+/**
+   Looks up an inode in the partition's inode cache.
+
+   @param[in]      Partition     Pointer to the opened EXT4 partition.
+   @param[in]      InodeNum      Inode number.
+   @param[out]     Inode         Pointer to the destination inode, at least Partition->InodeSize bytes long.
+
+   @return TRUE if the inode was cached (and copied to Inode), else FALSE.
+**/
+BOOLEAN
+Ext4LookupCachedInode (
+  IN  EXT4_PARTITION  *Partition,
+  IN  EXT4_INO_NR     InodeNum,
+  OUT EXT4_INODE      *Inode
+  );
+
+/**
+   Adds an inode to the partition's inode cache.
+   The inode must have been validated (i.e its checksum checked) beforehand.
+
+   @param[in]      Partition     Pointer to the opened EXT4 partition.
+   @param[in]      InodeNum      Inode number.
+   @param[in]      Inode         Pointer to the inode.
+**/
+VOID
+Ext4CacheInode (
+  IN EXT4_PARTITION    *Partition,
+  IN EXT4_INO_NR       InodeNum,
+  IN CONST EXT4_INODE  *Inode
+  );
+
 /**
    Checks if the opened partition has the 64-bit feature (see
 EXT4_FEATURE_INCOMPAT_64BIT).
@@ -360,6 +621,74 @@ Ext4Read (
   IN OUT UINTN           *Length
   );
 
+/**
+   Finds the longest run of file data, starting at a given offset, that can be read
+   with a single operation: either a run of physically contiguous blocks, or a run
+   of file holes (and uninitialized extents), that reads as zeroes.
+
+   @param[in]      Partition     Pointer to the opened EXT4 partition.
+   @param[in]      File          Pointer to the opened file.
+   @param[in]      Offset        Offset of the start of the run, in bytes.
+   @param[in]      MaxLength     Maximum length of the run, in bytes. Must not be 0.
+   @param[out]     IsHole        TRUE if the run reads as zeroes, FALSE if it's backed by disk blocks.
+   @param[out]     DiskOffset    Disk offset of the start of the run, if IsHole is FALSE.
+   @param[out]     Length        Length of the run, in bytes.
+
+   @return Status of the extent lookups.
+**/
+EFI_STATUS
+Ext4GetReadRun (
+  IN  EXT4_PARTITION  *Partition,
+  IN  EXT4_FILE       *File,
+  IN  UINT64          Offset,
+  IN  UINTN           MaxLength,
+  OUT BOOLEAN         *IsHole,
+  OUT UINT64          *DiskOffset,
+  OUT UINTN           *Length
+  );
+
+/**
+   Reads from a regular file, using (and feeding) the file's read-ahead window.
+   This has the same semantics as Ext4Read.
+
+   @param[in]      Partition     Pointer to the opened EXT4 partition.
+   @param[in]      File          Pointer to the opened file.
+   @param[out]     Buffer        Pointer to the buffer.
+   @param[in]      Offset        Offset of the read.
+   @param[in out]  Length        Pointer to the length of the buffer, in bytes.
+                                 After a successful read, it's updated to the number of read bytes.
+
+   @return Status of the read operation.
+**/
+EFI_STATUS
+Ext4ReadWithReadAhead (
+  IN     EXT4_PARTITION  *Partition,
+  IN     EXT4_FILE       *File,
+  OUT    VOID            *Buffer,
+  IN     UINT64          Offset,
+  IN OUT UINTN           *Length
+  );
+
+/**
+   Frees the file's read-ahead window, waiting for any in-flight request.
+
+   @param[in out]  File          Pointer to the opened file.
+**/
+VOID
+Ext4FreeReadAhead (
+  IN OUT EXT4_FILE  *File
+  );
+
+/**
+   Frees the directory's ReadDir cursor.
+
+   @param[in out]  File          Pointer to the opened directory.
+**/
+VOID
+Ext4FreeDirCursor (
+  IN OUT EXT4_FILE  *File
+  );
+
 /**
    Retrieves the size of the inode.
 
@@ -390,6 +719,59 @@ Ext4GetExtent (
   OUT EXT4_EXTENT    *Extent
   );
 
+/**
+   Read-ahead state of an opened regular file (see ReadAhead.c).
+**/
+typedef struct {
+  // Where the next read is expected, if the file is being read sequentially
+  UINT64                NextOffset;
+  UINTN                 SequentialReads;
+
+  VOID                  *Buffer;
+  UINTN                 BufferSize;
+
+  // Range of the file that is held in (or being read into) Buffer
+  UINT64                Offset;
+  UINTN                 Length;
+
+  BOOLEAN               InFlight;
+  EFI_DISK_IO2_TOKEN    Token;
+} EXT4_READ_AHEAD;
+
+/**
+   A visible entry of the directory block held in an EXT4_DIR_CURSOR.
+**/
+typedef struct {
+  // Offset of the entry inside the block
+  UINT32         Offset;
+  EXT4_INO_NR    InodeNum;
+
+  // Result of reading the entry's inode; Inode is NULL if it failed
+  EFI_STATUS     Status;
+  EXT4_INODE     *Inode;
+} EXT4_DIR_CURSOR_ENTRY;
+
+/**
+   ReadDir state of an opened directory (see Directory.c).
+   Holds the directory block that is currently being read, together with the
+   inodes of its entries, so that listing a directory costs one read per directory
+   block instead of a few reads per entry.
+   Block == NULL means no block is loaded.
+**/
+typedef struct {
+  CHAR8                    *Block;
+
+  // Offset of Block inside the directory, in bytes
+  UINT64                   BlockOffset;
+
+  // Entries are sorted by offset
+  EXT4_DIR_CURSOR_ENTRY    *Entries;
+  UINTN                    NumberEntries;
+
+  // Offset inside the block where a corrupted entry was found, or BlockSize if none
+  UINT32                   CorruptedOffset;
+} EXT4_DIR_CURSOR;
+
 struct _Ext4File {
   EFI_FILE_PROTOCOL     Protocol;
   EXT4_INODE            *Inode;
@@ -407,6 +789,10 @@ struct _Ext4File {
 
   // Owning reference to this file's directory entry.
   EXT4_DENTRY           *Dentry;
+
+  EXT4_READ_AHEAD       ReadAhead;
+
+  EXT4_DIR_CURSOR       DirCursor;
 };
 
 #define EXT4_FILE_FROM_THIS(This)  BASE_CR ((This), EXT4_FILE, Protocol)
@@ -432,6 +818,27 @@ Ext4RetrieveDirent (
   OUT EXT4_DIR_ENTRY  *Result
   );
 
+/**
+   Calculates the directory hash of a name, as used by hash tree directories.
+
+   @param[in]      Partition     Pointer to the opened EXT4 partition.
+   @param[in]      HashVersion   Hash version, as stored in the directory's dx_root.
+   @param[in]      Name          Pointer to the name (not null terminated).
+   @param[in]      Length        Length of the name, in bytes.
+   @param[out]     Hash          Pointer to the resulting (major) hash.
+
+   @retval EFI_SUCCESS        The hash was calculated.
+   @retval EFI_UNSUPPORTED    The hash version is not supported.
+**/
+EFI_STATUS
+Ext4CalculateDirHash (
+  IN CONST EXT4_PARTITION  *Partition,
+  IN UINT8                 HashVersion,
+  IN CONST CHAR8           *Name,
+  IN UINTN                 Length,
+  OUT UINT32               *Hash
+  );
+
 /**
    Opens a file.
 
@@ -997,6 +1404,25 @@ Ext4GetFileInfo (
   IN OUT UINTN       *BufferSize
   );
 
+/**
+   Stores information about a file in the EFI_FILE_INFO format, using the given filename.
+   Only File->Partition and File->Inode need to be valid.
+
+   @param[in]      File           Pointer to the file.
+   @param[in]      FileName       Pointer to the null terminated filename.
+   @param[out]     Info           Pointer to a EFI_FILE_INFO.
+   @param[in out]  BufferSize     Pointer to the buffer size
+
+   @return Status of the file information request.
+**/
+EFI_STATUS
+Ext4FillFileInfo (
+  IN EXT4_FILE       *File,
+  IN CONST CHAR16    *FileName,
+  OUT EFI_FILE_INFO  *Info,
+  IN OUT UINTN       *BufferSize
+  );
+
 /**
    Reads a directory entry.
 
@@ -1057,6 +1483,53 @@ Ext4CalculateChecksum (
   IN UINT32                InitialValue
   );
 
+/**
+   Calculates the CRC32C of the given buffer, ext4-style: the CRC is neither
+   pre- nor post-inverted.
+
+   @param[in]      Buffer        Pointer to the buffer.
+   @param[in]      Length        Length of the buffer, in bytes.
+   @param[in]      Crc           Initial value of the CRC.
+
+   @return The CRC32C.
+**/
+UINT32
+Ext4CalculateCrc32c (
+  IN CONST VOID  *Buffer,
+  IN UINTN       Length,
+  IN UINT32      Crc
+  );
+
+/**
+   Checks if the CPU supports the CRC32C instructions used by Ext4Crc32cHw.
+
+   @return TRUE if supported, FALSE otherwise.
+**/
+BOOLEAN
+Ext4Crc32cHwSupported (
+  VOID
+  );
+
+/**
+   Calculates the CRC32C of the given buffer using the CPU's CRC32C instructions.
+   The CRC is neither pre- nor post-inverted.
+
+   Must only be called if Ext4Crc32cHwSupported returned TRUE.
+
+   @param[in]      Crc           Initial value of the CRC.
+   @param[in]      Buffer        Pointer to the buffer.
+   @param[in]      Length        Length of the buffer, in bytes.
+
+   @return The CRC32C.
+**/
+UINT32
+EFIAPI
+Ext4Crc32cHw (
+  IN UINT32      Crc,
+  IN CONST VOID  *Buffer,
+  IN UINTN       Length
+  );
+
 /**
    Calculates the checksum of the given inode.
    @param[in]      Partition     Pointer to the opened EXT4 partition.
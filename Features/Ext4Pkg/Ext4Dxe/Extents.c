@@ -229,6 +229,51 @@ Ext4ExtentIdxLeafBlock (
 // Results of sizeof(i_data) / sizeof(extent) - 1 = 4
 #define EXT4_NR_INLINE_EXTENTS  4
 
+/**
+   Builds (and caches) an extent describing a file hole.
+   Holes are represented as uninitialized extents with no physical blocks, which
+   readers already treat as zeroes.
+
+   @param[in]      File          Pointer to the opened file.
+   @param[in]      LogicalBlock  Block number which the hole must cover.
+   @param[in]      HoleStart     First logical block of the hole.
+   @param[in]      HoleEnd       Logical block right after the end of the hole.
+   @param[out]     Extent        Pointer to the output buffer, where the extent will be copied to.
+**/
+STATIC
+VOID
+Ext4CacheHole (
+  IN  EXT4_FILE    *File,
+  IN  UINT32       LogicalBlock,
+  IN  UINT64       HoleStart,
+  IN  UINT64       HoleEnd,
+  OUT EXT4_EXTENT  *Extent
+  )
+{
+  UINT64  Length;
+
+  // The bounds come from the extent tree, which may be corrupted (e.g unsorted).
+  // Don't trust them further than the block we were asked for.
+  if ((HoleStart > LogicalBlock) || (HoleEnd <= LogicalBlock)) {
+    HoleStart = LogicalBlock;
+    HoleEnd   = (UINT64)LogicalBlock + 1;
+  }
+
+  // An uninitialized extent can't be larger than EXT4_EXTENT_MAX_INITIALIZED - 1 blocks
+  if (LogicalBlock - HoleStart >= EXT4_EXTENT_MAX_INITIALIZED - 1) {
+    HoleStart = LogicalBlock;
+  }
+
+  Length = MIN (HoleEnd - HoleStart, EXT4_EXTENT_MAX_INITIALIZED - 1);
+
+  Extent->ee_block    = (UINT32)HoleStart;
+  Extent->ee_len      = (UINT16)(EXT4_EXTENT_MAX_INITIALIZED + Length);
+  Extent->ee_start_hi = 0;
+  Extent->ee_start_lo = EXT4_BLOCK_FILE_HOLE;
+
+  Ext4CacheExtents (File, Extent, 1);
+}
+
 /**
    Retrieves an extent from an EXT4 inode.
    @param[in]      Partition     Pointer to the opened EXT4 partition.
@@ -236,7 +281,8 @@ Ext4ExtentIdxLeafBlock (
    @param[in]      LogicalBlock  Block number which the returned extent must cover.
    @param[out]     Extent        Pointer to the output buffer, where the extent will be copied to.
 
-   @retval EFI_SUCCESS        Retrieval was successful.
+   @retval EFI_SUCCESS        Retrieval was successful. File holes are returned (and cached)
+                              as uninitialized extents that span the whole hole.
    @retval EFI_NO_MAPPING     Block has no mapping.
 **/
 EFI_STATUS
@@ -256,11 +302,18 @@ Ext4GetExtent (
   EFI_STATUS          Status;
   UINT32              MaxExtentsPerNode;
   EXT4_BLOCK_NR       BlockNumber;
+  UINT64              HoleStart;
+  UINT64              HoleEnd;
 
   Inode  = File->Inode;
   Ext    = NULL;
   Buffer = NULL;
 
+  // Range of logical blocks covered by the part of the tree we're looking at.
+  // If LogicalBlock turns out to be in a hole, the hole can't extend past it.
+  HoleStart = 0;
+  HoleEnd   = (UINT64)MAX_UINT32 + 1;
+
   DEBUG ((DEBUG_FS, "[ext4] Looking up extent for block %lu\n", LogicalBlock));
 
   // ext4 does not have support for logical block numbers bigger than UINT32_MAX
@@ -268,8 +321,7 @@ Ext4GetExtent (
     return EFI_NO_MAPPING;
   }
 
-  // Note: Right now, holes are the single biggest reason for cache misses
-  // We should find a way to get (or cache) holes
+  // Note: Holes are cached as well (see Ext4CacheHole)
   if ((Ext = Ext4GetExtentFromMap (File, (UINT32)LogicalBlock)) != NULL) {
     *Extent = *Ext;
 
@@ -315,6 +367,16 @@ Ext4GetExtent (
     Index       = Ext4BinsearchExtentIndex (ExtHeader, LogicalBlock);
     BlockNumber = Ext4ExtentIdxLeafBlock (Index);
 
+    if (LogicalBlock < Index->ei_block) {
+      HoleEnd = MIN (HoleEnd, Index->ei_block);
+    } else {
+      HoleStart = MAX (HoleStart, Index->ei_block);
+
+      if (Index + 1 < (EXT4_EXTENT_INDEX *)(ExtHeader + 1) + ExtHeader->eh_entries) {
+        HoleEnd = MIN (HoleEnd, Index[1].ei_block);
+      }
+    }
+
     // Check that block isn't file hole
     if (BlockNumber == EXT4_BLOCK_FILE_HOLE) {
       if (Buffer != NULL) {
@@ -333,7 +395,7 @@ Ext4GetExtent (
 
     // Read the leaf block onto the previously-allocated buffer.
 
-    Status = Ext4ReadBlocks (Partition, Buffer, 1, BlockNumber);
+    Status = Ext4ReadCachedBlock (Partition, BlockNumber, 0, Partition->BlockSize, Buffer);
     if (EFI_ERROR (Status)) {
       FreePool (Buffer);
       return Status;
@@ -367,25 +429,27 @@ Ext4GetExtent (
 
   Ext = Ext4BinsearchExtentExt (ExtHeader, LogicalBlock);
 
-  if (!Ext) {
-    if (Buffer != NULL) {
-      FreePool (Buffer);
-    }
-
-    return EFI_NO_MAPPING;
-  }
-
-  if (!((LogicalBlock >= Ext->ee_block) && (Ext->ee_block + Ext4GetExtentLength (Ext) > LogicalBlock))) {
-    // This extent does not cover the block
-    if (Buffer != NULL) {
-      FreePool (Buffer);
+  if ((Ext != NULL) && (LogicalBlock >= Ext->ee_block) && (Ext->ee_block + Ext4GetExtentLength (Ext) > LogicalBlock)) {
+    *Extent = *Ext;
+  } else {
+    // No extent covers the block, so it's in a hole. Find out where the hole ends using
+    // the neighbouring extents, and cache it, so reads of the rest of the hole don't need
+    // to walk the tree again.
+    if (Ext != NULL) {
+      if (LogicalBlock < Ext->ee_block) {
+        HoleEnd = MIN (HoleEnd, Ext->ee_block);
+      } else {
+        HoleStart = MAX (HoleStart, Ext->ee_block + Ext4GetExtentLength (Ext));
+
+        if (Ext + 1 < (EXT4_EXTENT *)(ExtHeader + 1) + ExtHeader->eh_entries) {
+          HoleEnd = MIN (HoleEnd, Ext[1].ee_block);
+        }
+      }
     }
 
-    return EFI_NO_MAPPING;
+    Ext4CacheHole (File, (UINT32)LogicalBlock, HoleStart, HoleEnd, Extent);
   }
 
-  *Extent = *Ext;
-
   if (Buffer != NULL) {
     FreePool (Buffer);
   }
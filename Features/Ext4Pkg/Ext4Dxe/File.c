@@ -435,6 +435,8 @@ Ext4CloseInternal (
 
   DEBUG ((DEBUG_FS, "[ext4] Closed file %p (inode %lu)\n", File, File->InodeNum));
   RemoveEntryList (&File->OpenFilesListNode);
+  Ext4FreeReadAhead (File);
+  Ext4FreeDirCursor (File);
   FreePool (File->Inode);
   Ext4FreeExtentsMap (File);
   Ext4UnrefDentry (File->Dentry);
@@ -501,7 +503,7 @@ Ext4ReadFile (
   ASSERT (Ext4FileIsOpenable (File));
 
   if (Ext4FileIsReg (File)) {
-    Status = Ext4Read (Partition, File, Buffer, File->Position, BufferSize);
+    Status = Ext4ReadWithReadAhead (Partition, File, Buffer, File->Position, BufferSize);
     if (Status == EFI_SUCCESS) {
       File->Position += *BufferSize;
     }
@@ -642,9 +644,6 @@ Ext4GetFileInfo (
   IN OUT UINTN       *BufferSize
   )
 {
-  UINTN         FileNameLen;
-  UINTN         FileNameSize;
-  UINTN         NeededLength;
   CONST CHAR16  *FileName;
 
   if (File->InodeNum == EXT4_ROOT_INODE_NR) {
@@ -654,6 +653,32 @@ Ext4GetFileInfo (
     FileName = File->Dentry->Name;
   }
 
+  return Ext4FillFileInfo (File, FileName, Info, BufferSize);
+}
+
+/**
+   Stores information about a file in the EFI_FILE_INFO format, using the given filename.
+   Only File->Partition and File->Inode need to be valid.
+
+   @param[in]      File           Pointer to the file.
+   @param[in]      FileName       Pointer to the null terminated filename.
+   @param[out]     Info           Pointer to a EFI_FILE_INFO.
+   @param[in out]  BufferSize     Pointer to the buffer size
+
+   @return Status of the file information request.
+**/
+EFI_STATUS
+Ext4FillFileInfo (
+  IN EXT4_FILE       *File,
+  IN CONST CHAR16    *FileName,
+  OUT EFI_FILE_INFO  *Info,
+  IN OUT UINTN       *BufferSize
+  )
+{
+  UINTN  FileNameLen;
+  UINTN  FileNameSize;
+  UINTN  NeededLength;
+
   FileNameLen  = StrLen (FileName);
   FileNameSize = StrSize (FileName);
 
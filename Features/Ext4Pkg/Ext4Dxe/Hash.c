@@ -0,0 +1,311 @@
+/** @file
+  Directory hashing routines, used by hash tree (htree) directories
+
+  Copyright (c) 2021 - 2023 Pedro Falcato All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+  The hash functions below follow the ones used by the Linux kernel
+  (fs/ext4/hash.c), which define the on-disk format.
+**/
+
+#include "Ext4Dxe.h"
+
+#define EXT4_TEA_DELTA  0x9E3779B9U
+
+// Half-MD4 round functions and constants
+#define EXT4_MD4_F(x, y, z)  ((z) ^ ((x) & ((y) ^ (z))))
+#define EXT4_MD4_G(x, y, z)  (((x) & (y)) + (((x) ^ (y)) & (z)))
+#define EXT4_MD4_H(x, y, z)  ((x) ^ (y) ^ (z))
+
+#define EXT4_MD4_K1  0U
+#define EXT4_MD4_K2  013240474631U
+#define EXT4_MD4_K3  015666365641U
+
+#define EXT4_MD4_ROUND(f, a, b, c, d, x, s)                                    \
+  do {                                                                         \
+    (a) += f ((b), (c), (d)) + (x);                                            \
+    (a)  = ((a) << (s)) | ((a) >> (32 - (s)));                                 \
+  } while (FALSE)
+
+// Largest possible hash; it's reserved as an end-of-directory marker.
+#define EXT4_HTREE_EOF_32BIT  0x7FFFFFFFU
+
+/**
+   Runs the TEA transform over a 16 byte block of input.
+
+   @param[in out]  Buf     Pointer to the 4 word hash state.
+   @param[in]      In      Pointer to the 4 word input block.
+**/
+STATIC
+VOID
+Ext4TeaTransform (
+  IN OUT UINT32    Buf[4],
+  IN CONST UINT32  In[4]
+  )
+{
+  UINT32  Sum;
+  UINT32  B0;
+  UINT32  B1;
+  UINTN   Round;
+
+  Sum = 0;
+  B0  = Buf[0];
+  B1  = Buf[1];
+
+  for (Round = 0; Round < 16; Round++) {
+    Sum += EXT4_TEA_DELTA;
+    B0  += ((B1 << 4) + In[0]) ^ (B1 + Sum) ^ ((B1 >> 5) + In[1]);
+    B1  += ((B0 << 4) + In[2]) ^ (B0 + Sum) ^ ((B0 >> 5) + In[3]);
+  }
+
+  Buf[0] += B0;
+  Buf[1] += B1;
+}
+
+/**
+   Runs the (cut down) MD4 transform over a 32 byte block of input.
+
+   @param[in out]  Buf     Pointer to the 4 word hash state.
+   @param[in]      In      Pointer to the 8 word input block.
+**/
+STATIC
+VOID
+Ext4HalfMd4Transform (
+  IN OUT UINT32    Buf[4],
+  IN CONST UINT32  In[8]
+  )
+{
+  UINT32  A;
+  UINT32  B;
+  UINT32  C;
+  UINT32  D;
+
+  A = Buf[0];
+  B = Buf[1];
+  C = Buf[2];
+  D = Buf[3];
+
+  // Round 1
+  EXT4_MD4_ROUND (EXT4_MD4_F, A, B, C, D, In[0] + EXT4_MD4_K1, 3);
+  EXT4_MD4_ROUND (EXT4_MD4_F, D, A, B, C, In[1] + EXT4_MD4_K1, 7);
+  EXT4_MD4_ROUND (EXT4_MD4_F, C, D, A, B, In[2] + EXT4_MD4_K1, 11);
+  EXT4_MD4_ROUND (EXT4_MD4_F, B, C, D, A, In[3] + EXT4_MD4_K1, 19);
+  EXT4_MD4_ROUND (EXT4_MD4_F, A, B, C, D, In[4] + EXT4_MD4_K1, 3);
+  EXT4_MD4_ROUND (EXT4_MD4_F, D, A, B, C, In[5] + EXT4_MD4_K1, 7);
+  EXT4_MD4_ROUND (EXT4_MD4_F, C, D, A, B, In[6] + EXT4_MD4_K1, 11);
+  EXT4_MD4_ROUND (EXT4_MD4_F, B, C, D, A, In[7] + EXT4_MD4_K1, 19);
+
+  // Round 2
+  EXT4_MD4_ROUND (EXT4_MD4_G, A, B, C, D, In[1] + EXT4_MD4_K2, 3);
+  EXT4_MD4_ROUND (EXT4_MD4_G, D, A, B, C, In[3] + EXT4_MD4_K2, 5);
+  EXT4_MD4_ROUND (EXT4_MD4_G, C, D, A, B, In[5] + EXT4_MD4_K2, 9);
+  EXT4_MD4_ROUND (EXT4_MD4_G, B, C, D, A, In[7] + EXT4_MD4_K2, 13);
+  EXT4_MD4_ROUND (EXT4_MD4_G, A, B, C, D, In[0] + EXT4_MD4_K2, 3);
+  EXT4_MD4_ROUND (EXT4_MD4_G, D, A, B, C, In[2] + EXT4_MD4_K2, 5);
+  EXT4_MD4_ROUND (EXT4_MD4_G, C, D, A, B, In[4] + EXT4_MD4_K2, 9);
+  EXT4_MD4_ROUND (EXT4_MD4_G, B, C, D, A, In[6] + EXT4_MD4_K2, 13);
+
+  // Round 3
+  EXT4_MD4_ROUND (EXT4_MD4_H, A, B, C, D, In[3] + EXT4_MD4_K3, 3);
+  EXT4_MD4_ROUND (EXT4_MD4_H, D, A, B, C, In[7] + EXT4_MD4_K3, 9);
+  EXT4_MD4_ROUND (EXT4_MD4_H, C, D, A, B, In[2] + EXT4_MD4_K3, 11);
+  EXT4_MD4_ROUND (EXT4_MD4_H, B, C, D, A, In[6] + EXT4_MD4_K3, 15);
+  EXT4_MD4_ROUND (EXT4_MD4_H, A, B, C, D, In[1] + EXT4_MD4_K3, 3);
+  EXT4_MD4_ROUND (EXT4_MD4_H, D, A, B, C, In[5] + EXT4_MD4_K3, 9);
+  EXT4_MD4_ROUND (EXT4_MD4_H, C, D, A, B, In[0] + EXT4_MD4_K3, 11);
+  EXT4_MD4_ROUND (EXT4_MD4_H, B, C, D, A, In[4] + EXT4_MD4_K3, 15);
+
+  Buf[0] += A;
+  Buf[1] += B;
+  Buf[2] += C;
+  Buf[3] += D;
+}
+
+/**
+   Computes the legacy ("dx_hack") hash of a name.
+
+   @param[in]      Name        Pointer to the name (not null terminated).
+   @param[in]      Length      Length of the name, in bytes.
+   @param[in]      Unsigned    TRUE if the name's bytes are to be treated as unsigned.
+
+   @return The hash of the name.
+**/
+STATIC
+UINT32
+Ext4LegacyHash (
+  IN CONST CHAR8  *Name,
+  IN UINTN        Length,
+  IN BOOLEAN      Unsigned
+  )
+{
+  UINT32  Hash;
+  UINT32  Hash0;
+  UINT32  Hash1;
+  INT32   Char;
+
+  Hash0 = 0x12A3FE2D;
+  Hash1 = 0x37ABE8F9;
+
+  while (Length-- != 0) {
+    Char = Unsigned ? (INT32)(UINT8)*Name : (INT32)(INT8)*Name;
+    Name++;
+
+    Hash = Hash1 + (Hash0 ^ (UINT32)(Char * 7152373));
+
+    if ((Hash & 0x80000000) != 0) {
+      Hash -= 0x7FFFFFFF;
+    }
+
+    Hash1 = Hash0;
+    Hash0 = Hash;
+  }
+
+  return Hash0 << 1;
+}
+
+/**
+   Converts (part of) a name into an array of words, padded with a length-derived value.
+
+   @param[in]      Name        Pointer to the name (not null terminated).
+   @param[in]      Length      Remaining length of the name, in bytes.
+   @param[out]     Buf         Pointer to the output array of words.
+   @param[in]      Num         Number of words in Buf.
+   @param[in]      Unsigned    TRUE if the name's bytes are to be treated as unsigned.
+**/
+STATIC
+VOID
+Ext4StrToHashBuf (
+  IN CONST CHAR8  *Name,
+  IN UINTN        Length,
+  OUT UINT32      *Buf,
+  IN UINTN        Num,
+  IN BOOLEAN      Unsigned
+  )
+{
+  UINT32  Pad;
+  UINT32  Val;
+  UINTN   Index;
+  INT32   Char;
+
+  Pad  = (UINT32)Length | ((UINT32)Length << 8);
+  Pad |= Pad << 16;
+
+  Val = Pad;
+
+  if (Length > Num * 4) {
+    Length = Num * 4;
+  }
+
+  for (Index = 0; Index < Length; Index++) {
+    Char = Unsigned ? (INT32)(UINT8)Name[Index] : (INT32)(INT8)Name[Index];
+    Val  = (UINT32)Char + (Val << 8);
+
+    if ((Index % 4) == 3) {
+      *Buf++ = Val;
+      Val    = Pad;
+      Num--;
+    }
+  }
+
+  if (Num != 0) {
+    *Buf++ = Val;
+    Num--;
+  }
+
+  while (Num != 0) {
+    *Buf++ = Pad;
+    Num--;
+  }
+}
+
+/**
+   Calculates the directory hash of a name, as used by hash tree directories.
+
+   @param[in]      Partition     Pointer to the opened EXT4 partition.
+   @param[in]      HashVersion   Hash version, as stored in the directory's dx_root.
+   @param[in]      Name          Pointer to the name (not null terminated).
+   @param[in]      Length        Length of the name, in bytes.
+   @param[out]     Hash          Pointer to the resulting (major) hash.
+
+   @retval EFI_SUCCESS        The hash was calculated.
+   @retval EFI_UNSUPPORTED    The hash version is not supported.
+**/
+EFI_STATUS
+Ext4CalculateDirHash (
+  IN CONST EXT4_PARTITION  *Partition,
+  IN UINT8                 HashVersion,
+  IN CONST CHAR8           *Name,
+  IN UINTN                 Length,
+  OUT UINT32               *Hash
+  )
+{
+  UINT32   Buf[4];
+  UINT32   In[8];
+  UINT32   Result;
+  BOOLEAN  Unsigned;
+  UINTN    Index;
+
+  // Signed hash versions are remapped to unsigned ones if the filesystem was
+  // created on a platform where char is unsigned.
+  if ((HashVersion <= EXT4_DX_HASH_TEA) &&
+      ((Partition->SuperBlock.s_flags & EXT4_FLAGS_UNSIGNED_HASH) != 0))
+  {
+    HashVersion += EXT4_DX_HASH_LEGACY_UNSIGNED;
+  }
+
+  Buf[0] = 0x67452301;
+  Buf[1] = 0xEFCDAB89;
+  Buf[2] = 0x98BADCFE;
+  Buf[3] = 0x10325476;
+
+  // An all-zeroes seed means "use the default seed"
+  for (Index = 0; Index < 4; Index++) {
+    if (Partition->SuperBlock.s_hash_seed[Index] != 0) {
+      CopyMem (Buf, Partition->SuperBlock.s_hash_seed, sizeof (Buf));
+      break;
+    }
+  }
+
+  Unsigned = HashVersion >= EXT4_DX_HASH_LEGACY_UNSIGNED;
+
+  switch (HashVersion) {
+    case EXT4_DX_HASH_LEGACY:
+    case EXT4_DX_HASH_LEGACY_UNSIGNED:
+      Result = Ext4LegacyHash (Name, Length, Unsigned);
+      break;
+    case EXT4_DX_HASH_HALF_MD4:
+    case EXT4_DX_HASH_HALF_MD4_UNSIGNED:
+      while (Length != 0) {
+        Ext4StrToHashBuf (Name, Length, In, 8, Unsigned);
+        Ext4HalfMd4Transform (Buf, In);
+        Name   += 32;
+        Length -= MIN (Length, 32);
+      }
+
+      Result = Buf[1];
+      break;
+    case EXT4_DX_HASH_TEA:
+    case EXT4_DX_HASH_TEA_UNSIGNED:
+      while (Length != 0) {
+        Ext4StrToHashBuf (Name, Length, In, 4, Unsigned);
+        Ext4TeaTransform (Buf, In);
+        Name   += 16;
+        Length -= MIN (Length, 16);
+      }
+
+      Result = Buf[0];
+      break;
+    default:
+      // SipHash is only used by casefolded + encrypted directories, which we don't support.
+      return EFI_UNSUPPORTED;
+  }
+
+  Result &= ~EXT4_DX_HASH_COLLISION;
+
+  if (Result == (EXT4_HTREE_EOF_32BIT << 1)) {
+    Result = (EXT4_HTREE_EOF_32BIT - 1) << 1;
+  }
+
+  *Hash = Result;
+  return EFI_SUCCESS;
+}
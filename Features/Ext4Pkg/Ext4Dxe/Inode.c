@@ -69,6 +69,93 @@ Ext4CalculateInodeChecksum (
   return Crc;
 }
 
+/**
+   Finds the longest run of file data, starting at a given offset, that can be read
+   with a single operation: either a run of physically contiguous blocks, or a run
+   of file holes (and uninitialized extents), that reads as zeroes.
+
+   @param[in]      Partition     Pointer to the opened EXT4 partition.
+   @param[in]      File          Pointer to the opened file.
+   @param[in]      Offset        Offset of the start of the run, in bytes.
+   @param[in]      MaxLength     Maximum length of the run, in bytes. Must not be 0.
+   @param[out]     IsHole        TRUE if the run reads as zeroes, FALSE if it's backed by disk blocks.
+   @param[out]     DiskOffset    Disk offset of the start of the run, if IsHole is FALSE.
+   @param[out]     Length        Length of the run, in bytes.
+
+   @return Status of the extent lookups.
+**/
+EFI_STATUS
+Ext4GetReadRun (
+  IN  EXT4_PARTITION  *Partition,
+  IN  EXT4_FILE       *File,
+  IN  UINT64          Offset,
+  IN  UINTN           MaxLength,
+  OUT BOOLEAN         *IsHole,
+  OUT UINT64          *DiskOffset,
+  OUT UINTN           *Length
+  )
+{
+  EXT4_EXTENT  Extent;
+  EFI_STATUS   Status;
+  UINT32       BlockOff;
+  BOOLEAN      Hole;
+  UINT64       CurrentSeek;
+  UINT64       ExtentStartBytes;
+  UINT64       ExtentLogicalBytes;
+  UINT64       ExtentEndBytes;
+  UINT64       RunLength;
+
+  *Length = 0;
+
+  while (*Length < MaxLength) {
+    CurrentSeek = Offset + *Length;
+
+    Status = Ext4GetExtent (
+               Partition,
+               File,
+               DivU64x32Remainder (CurrentSeek, Partition->BlockSize, &BlockOff),
+               &Extent
+               );
+
+    if ((Status != EFI_SUCCESS) && (Status != EFI_NO_MAPPING)) {
+      // Return what we've got so far; the error will be reported by the next lookup.
+      return *Length != 0 ? EFI_SUCCESS : Status;
+    }
+
+    if (Status == EFI_NO_MAPPING) {
+      Hole             = TRUE;
+      ExtentStartBytes = 0;
+      ExtentEndBytes   = CurrentSeek - BlockOff + Partition->BlockSize;
+    } else {
+      // Uninitialized extents behave exactly the same as file holes, except they may have
+      // blocks already allocated to them.
+      Hole               = EXT4_EXTENT_IS_UNINITIALIZED (&Extent);
+      ExtentLogicalBytes = MultU64x32 ((UINT64)Extent.ee_block, Partition->BlockSize);
+      ExtentEndBytes     = ExtentLogicalBytes + MultU64x32 (Ext4GetExtentLength (&Extent), Partition->BlockSize);
+      ExtentStartBytes   = MultU64x32 (
+                             LShiftU64 (Extent.ee_start_hi, 32) | Extent.ee_start_lo,
+                             Partition->BlockSize
+                             ) + (CurrentSeek - ExtentLogicalBytes);
+    }
+
+    if (*Length == 0) {
+      *IsHole = Hole;
+
+      if (!Hole) {
+        *DiskOffset = ExtentStartBytes;
+      }
+    } else if ((Hole != *IsHole) || (!Hole && (ExtentStartBytes != *DiskOffset + *Length))) {
+      // This extent isn't a continuation of the run
+      break;
+    }
+
+    RunLength = ExtentEndBytes - CurrentSeek;
+    *Length  += (UINTN)MIN (RunLength, MaxLength - *Length);
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
    Reads from an EXT4 inode.
    @param[in]      Partition     Pointer to the opened EXT4 partition.
@@ -89,31 +176,25 @@ Ext4Read (
   IN OUT UINTN           *Length
   )
 {
-  EXT4_INODE   *Inode;
-  UINT64       InodeSize;
-  UINT64       CurrentSeek;
-  UINTN        RemainingRead;
-  UINTN        BeenRead;
-  UINTN        WasRead;
-  EXT4_EXTENT  Extent;
-  UINT32       BlockOff;
-  EFI_STATUS   Status;
-  BOOLEAN      HasBackingExtent;
-  UINT32       HoleOff;
-  UINT64       HoleLen;
-  UINT64       ExtentStartBytes;
-  UINT64       ExtentLengthBytes;
-  UINT64       ExtentLogicalBytes;
-
-  // Our extent offset is the difference between CurrentSeek and ExtentLogicalBytes
-  UINT64  ExtentOffset;
-  UINTN   ExtentMayRead;
+  EXT4_INODE  *Inode;
+  UINT64      InodeSize;
+  UINT64      CurrentSeek;
+  UINTN       RemainingRead;
+  UINTN       BeenRead;
+  UINTN       WasRead;
+  UINTN       MayRead;
+  UINT32      BlockOff;
+  EFI_STATUS  Status;
+  BOOLEAN     IsHole;
+  UINT64      DiskOffset;
+  BOOLEAN     IsDir;
 
   Inode         = File->Inode;
   InodeSize     = EXT4_INODE_SIZE (Inode);
   CurrentSeek   = Offset;
   RemainingRead = *Length;
   BeenRead      = 0;
+  IsDir         = Ext4FileIsDir (File);
 
   DEBUG ((DEBUG_FS, "[ext4] Ext4Read(%s, Offset %lu, Length %lu)\n", File->Dentry->Name, Offset, *Length));
 
@@ -126,61 +207,45 @@ Ext4Read (
   }
 
   while (RemainingRead != 0) {
-    WasRead = 0;
-
-    // The algorithm here is to get the extent corresponding to the current block
-    // and then read as much as we can from the current extent.
+    // The algorithm here is to find the longest run of either physically contiguous blocks
+    // or holes starting at the current position, and read (or zero) it in one go.
+    MayRead = RemainingRead;
+
+    if (IsDir) {
+      // Directory blocks are re-read on every lookup, so they go through the block cache,
+      // one block at a time.
+      DivU64x32Remainder (CurrentSeek, Partition->BlockSize, &BlockOff);
+      MayRead = MIN (MayRead, Partition->BlockSize - BlockOff);
+    }
 
-    Status = Ext4GetExtent (
-               Partition,
-               File,
-               DivU64x32Remainder (CurrentSeek, Partition->BlockSize, &BlockOff),
-               &Extent
-               );
+    Status = Ext4GetReadRun (Partition, File, CurrentSeek, MayRead, &IsHole, &DiskOffset, &WasRead);
 
-    if ((Status != EFI_SUCCESS) && (Status != EFI_NO_MAPPING)) {
+    if (EFI_ERROR (Status)) {
       return Status;
     }
 
-    HasBackingExtent = Status != EFI_NO_MAPPING;
-
-    if (!HasBackingExtent || EXT4_EXTENT_IS_UNINITIALIZED (&Extent)) {
-      HoleOff = BlockOff;
-
-      if (!HasBackingExtent) {
-        HoleLen = Partition->BlockSize - HoleOff;
-      } else {
-        // Uninitialized extents behave exactly the same as file holes, except they have
-        // blocks already allocated to them.
-        HoleLen = MultU64x32 (Ext4GetExtentLength (&Extent), Partition->BlockSize) - HoleOff;
-      }
-
-      WasRead = HoleLen > RemainingRead ? RemainingRead : (UINTN)HoleLen;
-      // Potential improvement: In the future, we could get the file hole's total
-      // size and memset all that
+    if (IsHole) {
       ZeroMem (Buffer, WasRead);
     } else {
-      ExtentStartBytes = MultU64x32 (
-                           LShiftU64 (Extent.ee_start_hi, 32) |
-                           Extent.ee_start_lo,
-                           Partition->BlockSize
-                           );
-      ExtentLengthBytes  = Extent.ee_len * Partition->BlockSize;
-      ExtentLogicalBytes = MultU64x32 ((UINT64)Extent.ee_block, Partition->BlockSize);
-      ExtentOffset       = CurrentSeek - ExtentLogicalBytes;
-      ExtentMayRead      = (UINTN)(ExtentLengthBytes - ExtentOffset);
-
-      WasRead = ExtentMayRead > RemainingRead ? RemainingRead : ExtentMayRead;
-
-      Status = Ext4ReadDiskIo (Partition, Buffer, WasRead, ExtentStartBytes + ExtentOffset);
+      if (IsDir) {
+        Status = Ext4ReadCachedBlock (
+                   Partition,
+                   DivU64x32Remainder (DiskOffset, Partition->BlockSize, &BlockOff),
+                   BlockOff,
+                   WasRead,
+                   Buffer
+                   );
+      } else {
+        Status = Ext4ReadDiskIo (Partition, Buffer, WasRead, DiskOffset);
+      }
 
       if (EFI_ERROR (Status)) {
         DEBUG ((
           DEBUG_ERROR,
           "[ext4] Error %r reading [%lu, %lu]\n",
           Status,
-          ExtentStartBytes + ExtentOffset,
-          ExtentStartBytes + ExtentOffset + WasRead - 1
+          DiskOffset,
+          DiskOffset + WasRead - 1
           ));
         return Status;
       }
@@ -0,0 +1,491 @@
+/** @file
+  Directory entry and inode caches
+
+  Copyright (c) 2021 - 2023 Pedro Falcato All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+  Bootloaders tend to open the same paths over and over again (probing for
+  configuration files, kernels, etc). To avoid going through the directory and
+  the inode table every time, each partition keeps:
+
+  1) A directory entry cache, keyed by (directory inode, name). Lookups that fail
+     are cached too (negative entries), since probing for files that don't exist
+     is just as common.
+
+  2) An inode cache, keyed by inode number, which holds inodes that have already
+     been read and had their checksum verified.
+
+  Both caches have a fixed number of entries, are indexed by a hash table and
+  evict in LRU order. Since the driver never writes to the disk, they never need
+  to be invalidated.
+**/
+
+#include "Ext4Dxe.h"
+
+#define EXT4_FNV_OFFSET_BASIS  0x811C9DC5U
+#define EXT4_FNV_PRIME         0x01000193U
+
+/**
+   Hashes a (directory, name) pair.
+
+   @param[in]      Directory     Inode number of the directory.
+   @param[in]      Name          Pointer to the UCS-2 formatted filename.
+
+   @return The hash.
+**/
+STATIC
+UINT32
+Ext4DirentCacheHash (
+  IN EXT4_INO_NR   Directory,
+  IN CONST CHAR16  *Name
+  )
+{
+  UINT32  Hash;
+
+  Hash = (EXT4_FNV_OFFSET_BASIS ^ Directory) * EXT4_FNV_PRIME;
+
+  while (*Name != L'\0') {
+    Hash = (Hash ^ *Name) * EXT4_FNV_PRIME;
+    Name++;
+  }
+
+  return Hash;
+}
+
+/**
+   Finds a directory entry in the cache.
+
+   @param[in]      Cache         Pointer to the directory entry cache.
+   @param[in]      Directory     Inode number of the directory.
+   @param[in]      Name          Pointer to the UCS-2 formatted filename.
+
+   @return Pointer to the cached entry, or NULL if it isn't cached.
+**/
+STATIC
+EXT4_CACHED_DIRENT *
+Ext4DirentCacheFind (
+  IN CONST EXT4_DIRENT_CACHE  *Cache,
+  IN EXT4_INO_NR              Directory,
+  IN CONST CHAR16             *Name
+  )
+{
+  LIST_ENTRY          *Bucket;
+  LIST_ENTRY          *Entry;
+  EXT4_CACHED_DIRENT  *Cached;
+
+  Bucket = &Cache->Buckets[Ext4DirentCacheHash (Directory, Name) & (Cache->NumberBuckets - 1)];
+
+  BASE_LIST_FOR_EACH (Entry, Bucket) {
+    Cached = EXT4_CACHED_DIRENT_FROM_HASH_NODE (Entry);
+
+    if ((Cached->Directory == Directory) && (StrCmp (Cached->Name, Name) == 0)) {
+      return Cached;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+   Finds an inode in the cache.
+
+   @param[in]      Cache         Pointer to the inode cache.
+   @param[in]      InodeNum      Inode number.
+
+   @return Pointer to the cached inode, or NULL if it isn't cached.
+**/
+STATIC
+EXT4_CACHED_INODE *
+Ext4InodeCacheFind (
+  IN CONST EXT4_INODE_CACHE  *Cache,
+  IN EXT4_INO_NR             InodeNum
+  )
+{
+  LIST_ENTRY         *Bucket;
+  LIST_ENTRY         *Entry;
+  EXT4_CACHED_INODE  *Cached;
+
+  Bucket = &Cache->Buckets[InodeNum & (Cache->NumberBuckets - 1)];
+
+  BASE_LIST_FOR_EACH (Entry, Bucket) {
+    Cached = EXT4_CACHED_INODE_FROM_HASH_NODE (Entry);
+
+    if (Cached->InodeNum == InodeNum) {
+      return Cached;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+   Removes a cache entry from its hash bucket, if it's in one.
+
+   @param[in out]  HashNode      Pointer to the entry's hash list node.
+**/
+STATIC
+VOID
+Ext4LookupCacheUnhash (
+  IN OUT LIST_ENTRY  *HashNode
+  )
+{
+  if (!IsListEmpty (HashNode)) {
+    RemoveEntryList (HashNode);
+    InitializeListHead (HashNode);
+  }
+}
+
+/**
+   Moves a cache entry to the front of an LRU list.
+
+   @param[in out]  Lru           Pointer to the head of the LRU list.
+   @param[in out]  LruNode       Pointer to the entry's LRU list node.
+**/
+STATIC
+VOID
+Ext4LookupCacheTouch (
+  IN OUT LIST_ENTRY  *Lru,
+  IN OUT LIST_ENTRY  *LruNode
+  )
+{
+  RemoveEntryList (LruNode);
+  InsertHeadList (Lru, LruNode);
+}
+
+/**
+   Allocates and initialises the hash buckets of a cache.
+
+   @param[in]      NumberEntries  Number of entries of the cache. Must not be 0.
+   @param[out]     NumberBuckets  Pointer to the resulting number of buckets.
+
+   @return Pointer to the array of buckets, or NULL if we ran out of memory.
+**/
+STATIC
+LIST_ENTRY *
+Ext4LookupCacheAllocateBuckets (
+  IN  UINTN  NumberEntries,
+  OUT UINTN  *NumberBuckets
+  )
+{
+  LIST_ENTRY  *Buckets;
+  UINTN       Index;
+
+  *NumberBuckets = GetPowerOfTwo32 ((UINT32)NumberEntries);
+  Buckets        = AllocatePool (*NumberBuckets * sizeof (LIST_ENTRY));
+
+  if (Buckets == NULL) {
+    return NULL;
+  }
+
+  for (Index = 0; Index < *NumberBuckets; Index++) {
+    InitializeListHead (&Buckets[Index]);
+  }
+
+  return Buckets;
+}
+
+/**
+   Initialises the partition's directory entry and inode caches.
+   Their sizes are controlled by PcdExt4DirentCacheEntries and PcdExt4InodeCacheEntries.
+   A cache that can't be set up is left disabled.
+
+   @param[in out]  Partition     Pointer to the opened EXT4 partition, with a valid InodeSize.
+
+   @retval EFI_SUCCESS           The caches were initialised.
+   @retval EFI_OUT_OF_RESOURCES  Failed to allocate (one of) the caches.
+**/
+EFI_STATUS
+Ext4InitLookupCaches (
+  IN OUT EXT4_PARTITION  *Partition
+  )
+{
+  EXT4_DIRENT_CACHE   *DirentCache;
+  EXT4_INODE_CACHE    *InodeCache;
+  EXT4_CACHED_DIRENT  *CachedDirent;
+  EXT4_CACHED_INODE   *CachedInode;
+  UINTN               NumberEntries;
+  UINTN               Index;
+
+  DirentCache = &Partition->DirentCache;
+  InodeCache  = &Partition->InodeCache;
+
+  ZeroMem (DirentCache, sizeof (*DirentCache));
+  ZeroMem (InodeCache, sizeof (*InodeCache));
+  InitializeListHead (&DirentCache->Lru);
+  InitializeListHead (&InodeCache->Lru);
+
+  NumberEntries = PcdGet32 (PcdExt4DirentCacheEntries);
+
+  if (NumberEntries != 0) {
+    DirentCache->Buckets = Ext4LookupCacheAllocateBuckets (NumberEntries, &DirentCache->NumberBuckets);
+    DirentCache->Entries = AllocatePool (NumberEntries * sizeof (EXT4_CACHED_DIRENT));
+
+    if ((DirentCache->Buckets == NULL) || (DirentCache->Entries == NULL)) {
+      Ext4FreeLookupCaches (Partition);
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    for (Index = 0; Index < NumberEntries; Index++) {
+      CachedDirent = &DirentCache->Entries[Index];
+      InitializeListHead (&CachedDirent->HashNode);
+      InsertTailList (&DirentCache->Lru, &CachedDirent->LruNode);
+    }
+
+    DirentCache->NumberEntries = NumberEntries;
+  }
+
+  NumberEntries = PcdGet32 (PcdExt4InodeCacheEntries);
+
+  if (NumberEntries != 0) {
+    InodeCache->Buckets = Ext4LookupCacheAllocateBuckets (NumberEntries, &InodeCache->NumberBuckets);
+    InodeCache->Entries = AllocatePool (NumberEntries * sizeof (EXT4_CACHED_INODE));
+    InodeCache->Data    = AllocatePool (NumberEntries * Partition->InodeSize);
+
+    if ((InodeCache->Buckets == NULL) || (InodeCache->Entries == NULL) || (InodeCache->Data == NULL)) {
+      Ext4FreeLookupCaches (Partition);
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    for (Index = 0; Index < NumberEntries; Index++) {
+      CachedInode        = &InodeCache->Entries[Index];
+      CachedInode->Inode = (EXT4_INODE *)((UINT8 *)InodeCache->Data + Index * Partition->InodeSize);
+      InitializeListHead (&CachedInode->HashNode);
+      InsertTailList (&InodeCache->Lru, &CachedInode->LruNode);
+    }
+
+    InodeCache->NumberEntries = NumberEntries;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+   Frees the partition's directory entry and inode caches.
+
+   @param[in out]  Partition     Pointer to the opened EXT4 partition.
+**/
+VOID
+Ext4FreeLookupCaches (
+  IN OUT EXT4_PARTITION  *Partition
+  )
+{
+  EXT4_DIRENT_CACHE  *DirentCache;
+  EXT4_INODE_CACHE   *InodeCache;
+
+  DirentCache = &Partition->DirentCache;
+  InodeCache  = &Partition->InodeCache;
+
+  if ((DirentCache->NumberEntries != 0) || (InodeCache->NumberEntries != 0)) {
+    DEBUG ((
+      DEBUG_INFO,
+      "[ext4] Dirent cache: %Lu hits, %Lu misses; inode cache: %Lu hits, %Lu misses\n",
+      DirentCache->Hits,
+      DirentCache->Misses,
+      InodeCache->Hits,
+      InodeCache->Misses
+      ));
+  }
+
+  if (DirentCache->Buckets != NULL) {
+    FreePool (DirentCache->Buckets);
+  }
+
+  if (DirentCache->Entries != NULL) {
+    FreePool (DirentCache->Entries);
+  }
+
+  if (InodeCache->Buckets != NULL) {
+    FreePool (InodeCache->Buckets);
+  }
+
+  if (InodeCache->Entries != NULL) {
+    FreePool (InodeCache->Entries);
+  }
+
+  if (InodeCache->Data != NULL) {
+    FreePool (InodeCache->Data);
+  }
+
+  ZeroMem (DirentCache, sizeof (*DirentCache));
+  ZeroMem (InodeCache, sizeof (*InodeCache));
+  InitializeListHead (&DirentCache->Lru);
+  InitializeListHead (&InodeCache->Lru);
+}
+
+/**
+   Looks up a directory entry in the partition's directory entry cache.
+
+   @param[in]      Partition     Pointer to the opened EXT4 partition.
+   @param[in]      Directory     Inode number of the directory.
+   @param[in]      Name          Pointer to the UCS-2 formatted filename.
+   @param[out]     Result        Pointer to the destination directory entry.
+   @param[out]     Status        Pointer to the cached result of the lookup: EFI_SUCCESS if
+                                 the entry exists (and was copied to Result), else EFI_NOT_FOUND.
+
+   @return TRUE if the lookup was cached, else FALSE.
+**/
+BOOLEAN
+Ext4LookupCachedDirent (
+  IN  EXT4_PARTITION  *Partition,
+  IN  EXT4_INO_NR     Directory,
+  IN  CONST CHAR16    *Name,
+  OUT EXT4_DIR_ENTRY  *Result,
+  OUT EFI_STATUS      *Status
+  )
+{
+  EXT4_DIRENT_CACHE   *Cache;
+  EXT4_CACHED_DIRENT  *Cached;
+
+  Cache = &Partition->DirentCache;
+
+  if (Cache->NumberEntries == 0) {
+    return FALSE;
+  }
+
+  Cached = Ext4DirentCacheFind (Cache, Directory, Name);
+
+  if (Cached == NULL) {
+    Cache->Misses++;
+    return FALSE;
+  }
+
+  Cache->Hits++;
+  Ext4LookupCacheTouch (&Cache->Lru, &Cached->LruNode);
+
+  if (Cached->Negative) {
+    *Status = EFI_NOT_FOUND;
+  } else {
+    CopyMem (Result, &Cached->Entry, sizeof (EXT4_DIR_ENTRY));
+    *Status = EFI_SUCCESS;
+  }
+
+  return TRUE;
+}
+
+/**
+   Adds the result of a directory lookup to the partition's directory entry cache.
+
+   @param[in]      Partition     Pointer to the opened EXT4 partition.
+   @param[in]      Directory     Inode number of the directory.
+   @param[in]      Name          Pointer to the UCS-2 formatted filename.
+   @param[in]      Entry         Pointer to the directory entry that was found, or NULL
+                                 if the lookup failed with EFI_NOT_FOUND.
+**/
+VOID
+Ext4CacheDirent (
+  IN EXT4_PARTITION        *Partition,
+  IN EXT4_INO_NR           Directory,
+  IN CONST CHAR16          *Name,
+  IN CONST EXT4_DIR_ENTRY  *Entry  OPTIONAL
+  )
+{
+  EXT4_DIRENT_CACHE   *Cache;
+  EXT4_CACHED_DIRENT  *Cached;
+  UINT32              Hash;
+
+  Cache = &Partition->DirentCache;
+
+  if ((Cache->NumberEntries == 0) || (StrnLenS (Name, EXT4_NAME_MAX + 1) > EXT4_NAME_MAX)) {
+    return;
+  }
+
+  Cached = Ext4DirentCacheFind (Cache, Directory, Name);
+
+  if (Cached == NULL) {
+    // Recycle the least recently used entry
+    Cached = EXT4_CACHED_DIRENT_FROM_LRU_NODE (GetPreviousNode (&Cache->Lru, &Cache->Lru));
+    Ext4LookupCacheUnhash (&Cached->HashNode);
+
+    Cached->Directory = Directory;
+    StrCpyS (Cached->Name, ARRAY_SIZE (Cached->Name), Name);
+
+    Hash = Ext4DirentCacheHash (Directory, Name);
+    InsertHeadList (&Cache->Buckets[Hash & (Cache->NumberBuckets - 1)], &Cached->HashNode);
+  }
+
+  Cached->Negative = Entry == NULL;
+
+  if (Entry != NULL) {
+    CopyMem (&Cached->Entry, Entry, sizeof (EXT4_DIR_ENTRY));
+  }
+
+  Ext4LookupCacheTouch (&Cache->Lru, &Cached->LruNode);
+}
+
+/**
+   Looks up an inode in the partition's inode cache.
+
+   @param[in]      Partition     Pointer to the opened EXT4 partition.
+   @param[in]      InodeNum      Inode number.
+   @param[out]     Inode         Pointer to the destination inode, at least Partition->InodeSize bytes long.
+
+   @return TRUE if the inode was cached (and copied to Inode), else FALSE.
+**/
+BOOLEAN
+Ext4LookupCachedInode (
+  IN  EXT4_PARTITION  *Partition,
+  IN  EXT4_INO_NR     InodeNum,
+  OUT EXT4_INODE      *Inode
+  )
+{
+  EXT4_INODE_CACHE   *Cache;
+  EXT4_CACHED_INODE  *Cached;
+
+  Cache = &Partition->InodeCache;
+
+  if (Cache->NumberEntries == 0) {
+    return FALSE;
+  }
+
+  Cached = Ext4InodeCacheFind (Cache, InodeNum);
+
+  if (Cached == NULL) {
+    Cache->Misses++;
+    return FALSE;
+  }
+
+  Cache->Hits++;
+  Ext4LookupCacheTouch (&Cache->Lru, &Cached->LruNode);
+  CopyMem (Inode, Cached->Inode, Partition->InodeSize);
+
+  return TRUE;
+}
+
+/**
+   Adds an inode to the partition's inode cache.
+   The inode must have been validated (i.e its checksum checked) beforehand.
+
+   @param[in]      Partition     Pointer to the opened EXT4 partition.
+   @param[in]      InodeNum      Inode number.
+   @param[in]      Inode         Pointer to the inode.
+**/
+VOID
+Ext4CacheInode (
+  IN EXT4_PARTITION    *Partition,
+  IN EXT4_INO_NR       InodeNum,
+  IN CONST EXT4_INODE  *Inode
+  )
+{
+  EXT4_INODE_CACHE   *Cache;
+  EXT4_CACHED_INODE  *Cached;
+
+  Cache = &Partition->InodeCache;
+
+  if (Cache->NumberEntries == 0) {
+    return;
+  }
+
+  Cached = Ext4InodeCacheFind (Cache, InodeNum);
+
+  if (Cached == NULL) {
+    // Recycle the least recently used entry
+    Cached = EXT4_CACHED_INODE_FROM_LRU_NODE (GetPreviousNode (&Cache->Lru, &Cache->Lru));
+    Ext4LookupCacheUnhash (&Cached->HashNode);
+
+    Cached->InodeNum = InodeNum;
+    InsertHeadList (&Cache->Buckets[InodeNum & (Cache->NumberBuckets - 1)], &Cached->HashNode);
+  }
+
+  CopyMem (Cached->Inode, Inode, Partition->InodeSize);
+  Ext4LookupCacheTouch (&Cache->Lru, &Cached->LruNode);
+}
@@ -58,6 +58,8 @@ Ext4OpenPartition (
                                       );
 
   if (EFI_ERROR (Status)) {
+    Ext4FreeBlockCache (Part);
+    Ext4FreeLookupCaches (Part);
     FreePool (Part);
     return Status;
   }
@@ -125,6 +127,17 @@ Ext4UnmountAndFreePartition (
     DEBUG ((DEBUG_ERROR, "[ext4] Failed to delete root dentry - resource leak present.\n"));
   }
 
+  DEBUG ((
+    DEBUG_INFO,
+    "[ext4] Disk I/O: %Lu reads (%Lu bytes), %Lu async reads (%Lu bytes)\n",
+    Partition->IoStats.DiskReads,
+    Partition->IoStats.BytesRead,
+    Partition->IoStats.AsyncDiskReads,
+    Partition->IoStats.AsyncBytesRead
+    ));
+
+  Ext4FreeBlockCache (Partition);
+  Ext4FreeLookupCaches (Partition);
   FreePool (Partition->BlockGroups);
   FreePool (Partition);
 
@@ -0,0 +1,283 @@
+/** @file
+  Asynchronous read-ahead for regular files
+
+  Copyright (c) 2021 - 2023 Pedro Falcato All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+  When a file is read sequentially and the disk supports EFI_DISK_IO2_PROTOCOL,
+  the data following the last read is prefetched into a per-file window using an
+  asynchronous request. The disk then works on the next chunk of the file while
+  the caller is busy with the previous one, and the next Ext4ReadFile call is
+  served from memory.
+**/
+
+#include "Ext4Dxe.h"
+
+// Number of back-to-back sequential reads after which we start reading ahead
+#define EXT4_READ_AHEAD_MIN_SEQUENTIAL  2
+
+/**
+   Checks if we can use asynchronous requests at the current TPL.
+   Asynchronous requests are completed by the disk drivers' timer callbacks, so we
+   can only (busy) wait for them at TPL_APPLICATION.
+
+   @return TRUE if read-ahead can be used, else FALSE.
+**/
+STATIC
+BOOLEAN
+Ext4ReadAheadAllowed (
+  VOID
+  )
+{
+  EFI_TPL  OldTpl;
+
+  OldTpl = gBS->RaiseTPL (TPL_HIGH_LEVEL);
+  gBS->RestoreTPL (OldTpl);
+
+  return OldTpl == TPL_APPLICATION;
+}
+
+/**
+   Checks if the read-ahead window holds (or will hold) the data at a given offset.
+
+   @param[in]      ReadAhead     Pointer to the read-ahead state.
+   @param[in]      Offset        Offset in the file, in bytes.
+
+   @return TRUE if it does, else FALSE.
+**/
+STATIC
+BOOLEAN
+Ext4ReadAheadCovers (
+  IN CONST EXT4_READ_AHEAD  *ReadAhead,
+  IN UINT64                 Offset
+  )
+{
+  return (ReadAhead->Length != 0) && (Offset >= ReadAhead->Offset) &&
+         (Offset - ReadAhead->Offset < ReadAhead->Length);
+}
+
+/**
+   Waits for the in-flight read-ahead request, if any, to complete.
+   If the request failed, the window is discarded.
+
+   @param[in out]  ReadAhead     Pointer to the read-ahead state.
+
+   @return Status of the request.
+**/
+STATIC
+EFI_STATUS
+Ext4ReadAheadWait (
+  IN OUT EXT4_READ_AHEAD  *ReadAhead
+  )
+{
+  if (!ReadAhead->InFlight) {
+    return EFI_SUCCESS;
+  }
+
+  while (gBS->CheckEvent (ReadAhead->Token.Event) == EFI_NOT_READY) {
+    CpuPause ();
+  }
+
+  ReadAhead->InFlight = FALSE;
+
+  if (EFI_ERROR (ReadAhead->Token.TransactionStatus)) {
+    DEBUG ((DEBUG_WARN, "[ext4] Read-ahead failed: %r\n", ReadAhead->Token.TransactionStatus));
+    ReadAhead->Length = 0;
+  }
+
+  return ReadAhead->Token.TransactionStatus;
+}
+
+/**
+   Starts reading ahead from ReadAhead->NextOffset, if needed.
+   Failures are not fatal, they just mean the next read will be synchronous.
+
+   @param[in]      Partition     Pointer to the opened EXT4 partition.
+   @param[in out]  File          Pointer to the opened file.
+**/
+STATIC
+VOID
+Ext4ReadAheadStart (
+  IN     EXT4_PARTITION  *Partition,
+  IN OUT EXT4_FILE       *File
+  )
+{
+  EXT4_READ_AHEAD  *ReadAhead;
+  UINT64           FileSize;
+  UINTN            MaxLength;
+  BOOLEAN          IsHole;
+  UINT64           DiskOffset;
+  UINTN            Length;
+  EFI_STATUS       Status;
+
+  ReadAhead = &File->ReadAhead;
+  FileSize  = EXT4_INODE_SIZE (File->Inode);
+
+  if ((ReadAhead->NextOffset >= FileSize) || Ext4ReadAheadCovers (ReadAhead, ReadAhead->NextOffset)) {
+    return;
+  }
+
+  // We're about to reuse the buffer
+  Ext4ReadAheadWait (ReadAhead);
+  ReadAhead->Length = 0;
+
+  if (ReadAhead->Buffer == NULL) {
+    ReadAhead->BufferSize = PcdGet32 (PcdExt4ReadAheadSize);
+    ReadAhead->Buffer     = AllocatePool (ReadAhead->BufferSize);
+
+    if (ReadAhead->Buffer == NULL) {
+      return;
+    }
+
+    Status = gBS->CreateEvent (0, TPL_CALLBACK, NULL, NULL, &ReadAhead->Token.Event);
+
+    if (EFI_ERROR (Status)) {
+      FreePool (ReadAhead->Buffer);
+      ReadAhead->Buffer = NULL;
+      return;
+    }
+  }
+
+  MaxLength = (UINTN)MIN (ReadAhead->BufferSize, FileSize - ReadAhead->NextOffset);
+
+  // A single request can only cover physically contiguous blocks.
+  // Holes are not worth reading ahead, since they're just zeroed.
+  Status = Ext4GetReadRun (Partition, File, ReadAhead->NextOffset, MaxLength, &IsHole, &DiskOffset, &Length);
+
+  if (EFI_ERROR (Status) || IsHole) {
+    return;
+  }
+
+  ReadAhead->Token.TransactionStatus = EFI_NOT_READY;
+
+  Status = EXT4_DISK_IO2 (Partition)->ReadDiskEx (
+                                        EXT4_DISK_IO2 (Partition),
+                                        EXT4_MEDIA_ID (Partition),
+                                        DiskOffset,
+                                        &ReadAhead->Token,
+                                        Length,
+                                        ReadAhead->Buffer
+                                        );
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "[ext4] Failed to start read-ahead: %r\n", Status));
+    return;
+  }
+
+  Partition->IoStats.AsyncDiskReads++;
+  Partition->IoStats.AsyncBytesRead += Length;
+
+  ReadAhead->Offset   = ReadAhead->NextOffset;
+  ReadAhead->Length   = Length;
+  ReadAhead->InFlight = TRUE;
+}
+
+/**
+   Reads from a regular file, using (and feeding) the file's read-ahead window.
+   This has the same semantics as Ext4Read.
+
+   @param[in]      Partition     Pointer to the opened EXT4 partition.
+   @param[in]      File          Pointer to the opened file.
+   @param[out]     Buffer        Pointer to the buffer.
+   @param[in]      Offset        Offset of the read.
+   @param[in out]  Length        Pointer to the length of the buffer, in bytes.
+                                 After a successful read, it's updated to the number of read bytes.
+
+   @return Status of the read operation.
+**/
+EFI_STATUS
+Ext4ReadWithReadAhead (
+  IN     EXT4_PARTITION  *Partition,
+  IN     EXT4_FILE       *File,
+  OUT    VOID            *Buffer,
+  IN     UINT64          Offset,
+  IN OUT UINTN           *Length
+  )
+{
+  EXT4_READ_AHEAD  *ReadAhead;
+  UINT64           FileSize;
+  UINTN            RemainingRead;
+  UINTN            BeenRead;
+  UINTN            WasRead;
+  EFI_STATUS       Status;
+
+  ReadAhead = &File->ReadAhead;
+
+  if ((EXT4_DISK_IO2 (Partition) == NULL) || (PcdGet32 (PcdExt4ReadAheadSize) == 0) || !Ext4ReadAheadAllowed ()) {
+    return Ext4Read (Partition, File, Buffer, Offset, Length);
+  }
+
+  FileSize = EXT4_INODE_SIZE (File->Inode);
+
+  if (Offset > FileSize) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  RemainingRead = (UINTN)MIN (*Length, FileSize - Offset);
+  BeenRead      = 0;
+
+  if (Offset == ReadAhead->NextOffset) {
+    if (ReadAhead->SequentialReads < EXT4_READ_AHEAD_MIN_SEQUENTIAL) {
+      ReadAhead->SequentialReads++;
+    }
+  } else {
+    ReadAhead->SequentialReads = 1;
+  }
+
+  // Serve as much as we can from the window...
+  if ((RemainingRead != 0) && Ext4ReadAheadCovers (ReadAhead, Offset)) {
+    Status = Ext4ReadAheadWait (ReadAhead);
+
+    if (!EFI_ERROR (Status)) {
+      BeenRead = (UINTN)MIN (RemainingRead, ReadAhead->Offset + ReadAhead->Length - Offset);
+      CopyMem (Buffer, (UINT8 *)ReadAhead->Buffer + (Offset - ReadAhead->Offset), BeenRead);
+    }
+  }
+
+  // ...and read the rest from the disk.
+  if (BeenRead < RemainingRead) {
+    WasRead = RemainingRead - BeenRead;
+    Status  = Ext4Read (Partition, File, (UINT8 *)Buffer + BeenRead, Offset + BeenRead, &WasRead);
+
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    BeenRead += WasRead;
+  }
+
+  *Length               = BeenRead;
+  ReadAhead->NextOffset = Offset + BeenRead;
+
+  if (ReadAhead->SequentialReads >= EXT4_READ_AHEAD_MIN_SEQUENTIAL) {
+    Ext4ReadAheadStart (Partition, File);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+   Frees the file's read-ahead window, waiting for any in-flight request.
+
+   @param[in out]  File          Pointer to the opened file.
+**/
+VOID
+Ext4FreeReadAhead (
+  IN OUT EXT4_FILE  *File
+  )
+{
+  EXT4_READ_AHEAD  *ReadAhead;
+
+  ReadAhead = &File->ReadAhead;
+
+  if (ReadAhead->Buffer == NULL) {
+    return;
+  }
+
+  // The disk may still be writing to the buffer
+  Ext4ReadAheadWait (ReadAhead);
+
+  gBS->CloseEvent (ReadAhead->Token.Event);
+  FreePool (ReadAhead->Buffer);
+  ZeroMem (ReadAhead, sizeof (*ReadAhead));
+}
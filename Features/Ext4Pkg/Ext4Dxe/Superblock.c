@@ -21,7 +21,7 @@ STATIC CONST UINT32  gSupportedIncompatFeat =
   EXT4_FEATURE_INCOMPAT_MMP | EXT4_FEATURE_INCOMPAT_RECOVER | EXT4_FEATURE_INCOMPAT_CSUM_SEED;
 
 // Future features that may be nice additions in the future:
-// 1) Btree support: Required for write support and would speed up lookups in large directories.
+// 1) Btree support: Required for write support (lookups in large directories already use the index).
 // 2) meta_bg: Required to mount meta_bg-enabled partitions.
 
 // Note: We ignore MMP because it's impossible that it's mapped elsewhere,
@@ -287,6 +287,17 @@ Ext4OpenSuperblock (
     return EFI_VOLUME_CORRUPTED;
   }
 
+  // Not having a block cache isn't fatal, it just makes metadata reads slower.
+  Status = Ext4InitBlockCache (Partition);
+  if (EFI_ERROR (Status) && (Status != EFI_UNSUPPORTED)) {
+    DEBUG ((DEBUG_WARN, "[ext4] Failed to set up the block cache: %r\n", Status));
+  }
+
+  Status = Ext4InitLookupCaches (Partition);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "[ext4] Failed to set up the lookup caches: %r\n", Status));
+  }
+
   NrBlocks = (UINTN)DivU64x32Remainder (
                       MultU64x32 (Partition->NumberBlockGroups, Partition->DescSize),
                       Partition->BlockSize,
@@ -300,6 +311,8 @@ Ext4OpenSuperblock (
   Partition->BlockGroups = Ext4AllocAndReadBlocks (Partition, NrBlocks, Partition->BlockSize == 1024 ? 2 : 1);
 
   if (Partition->BlockGroups == NULL) {
+    Ext4FreeBlockCache (Partition);
+    Ext4FreeLookupCaches (Partition);
     return EFI_OUT_OF_RESOURCES;
   }
 
@@ -307,6 +320,8 @@ Ext4OpenSuperblock (
     Desc = Ext4GetBlockGroupDesc (Partition, Index);
     if (!Ext4VerifyBlockGroupDescChecksum (Partition, Desc, Index)) {
       DEBUG ((DEBUG_ERROR, "[ext4] Block group descriptor %u has an invalid checksum\n", Index));
+      Ext4FreeBlockCache (Partition);
+      Ext4FreeLookupCaches (Partition);
       FreePool (Partition->BlockGroups);
       return EFI_VOLUME_CORRUPTED;
     }
@@ -316,6 +331,8 @@ Ext4OpenSuperblock (
   Partition->RootDentry = Ext4CreateDentry (L"\\", NULL);
 
   if (Partition->RootDentry == NULL) {
+    Ext4FreeBlockCache (Partition);
+    Ext4FreeLookupCaches (Partition);
     FreePool (Partition->BlockGroups);
     return EFI_OUT_OF_RESOURCES;
   }
@@ -325,6 +342,8 @@ Ext4OpenSuperblock (
 
   if (EFI_ERROR (Status)) {
     Ext4UnrefDentry (Partition->RootDentry);
+    Ext4FreeBlockCache (Partition);
+    Ext4FreeLookupCaches (Partition);
     FreePool (Partition->BlockGroups);
   }
 
@@ -355,7 +374,7 @@ Ext4CalculateChecksum (
   switch (Partition->SuperBlock.s_checksum_type) {
     case EXT4_CHECKSUM_CRC32C:
       // For some reason, EXT4 really likes non-inverted CRC32C checksums, so we stick to that here.
-      return ~CalculateCrc32c(Buffer, Length, ~InitialValue);
+      return Ext4CalculateCrc32c (Buffer, Length, InitialValue);
     default:
       ASSERT (FALSE);
       return 0;
@@ -0,0 +1,389 @@
+/** @file
+  Host-based unit test of the CRC32C used for ext4 metadata checksums.
+
+  Runs known test vectors, and every length and alignment from 0 to a few hundred
+  bytes, through BaseLib's table-driven CRC32C (the fallback), Ext4CalculateCrc32c
+  and, when the host CPU has CRC32C instructions, Ext4Crc32cHw; all of them are
+  checked against a bit-at-a-time reference.
+
+  Copyright (c) 2021 - 2023 Pedro Falcato All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#if defined (_MSC_VER) && defined (_M_X64)
+  #include <intrin.h>
+#endif
+
+#include "../Ext4Dxe.h"
+
+#include <Library/UnitTestLib.h>
+
+#if defined (MDE_CPU_X64)
+  #include <Register/Intel/Cpuid.h>
+#endif
+
+#define UNIT_TEST_NAME     "Ext4Dxe CRC32C unit test"
+#define UNIT_TEST_VERSION  "0.1"
+
+// CRC32C (Castagnoli) polynomial, bit-reflected
+#define EXT4_TEST_CRC32C_POLY  0x82F63B78
+
+// Lengths and buffer offsets that are tested exhaustively; this covers the
+// head, body and tail of the accelerated implementations.
+#define EXT4_TEST_MAX_LENGTH  300
+#define EXT4_TEST_MAX_OFFSET  16
+
+#define EXT4_TEST_BUFFER_SIZE  (SIZE_4KB + EXT4_TEST_MAX_OFFSET)
+
+typedef
+UINT32
+(*EXT4_TEST_CRC32C_FUNCTION) (
+  IN CONST VOID  *Buffer,
+  IN UINTN       Length,
+  IN UINT32      Crc
+  );
+
+typedef struct {
+  CHAR8                        *Name;
+  EXT4_TEST_CRC32C_FUNCTION    Calculate;
+} EXT4_TEST_CRC32C_IMPL;
+
+typedef struct {
+  CHAR8          *Name;
+  CONST UINT8    *Data;
+  UINTN          Length;
+  // CRC32C as it's usually specified, i.e pre- and post-inverted
+  UINT32         Crc;
+} EXT4_TEST_CRC32C_VECTOR;
+
+//
+// Test vectors from RFC 3720, B.4, plus the customary "123456789" check value.
+//
+STATIC CONST UINT8  mCheckString[] = {
+  '1', '2', '3', '4', '5', '6', '7', '8', '9'
+};
+
+STATIC CONST UINT8  mZeros[32] = { 0 };
+
+STATIC CONST UINT8  mOnes[32] = {
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
+STATIC CONST UINT8  mIncrementing[32] = {
+  0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F,
+  0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F
+};
+
+STATIC CONST UINT8  mDecrementing[32] = {
+  0x1F, 0x1E, 0x1D, 0x1C, 0x1B, 0x1A, 0x19, 0x18, 0x17, 0x16, 0x15, 0x14, 0x13, 0x12, 0x11, 0x10,
+  0x0F, 0x0E, 0x0D, 0x0C, 0x0B, 0x0A, 0x09, 0x08, 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01, 0x00
+};
+
+STATIC CONST EXT4_TEST_CRC32C_VECTOR  mVectors[] = {
+  { "\"123456789\"",     mCheckString,  sizeof (mCheckString),  0xE3069283 },
+  { "32 bytes of 0x00",  mZeros,        sizeof (mZeros),        0x8A9136AA },
+  { "32 bytes of 0xFF",  mOnes,         sizeof (mOnes),         0x62A8AB43 },
+  { "32 incrementing",   mIncrementing, sizeof (mIncrementing), 0x46DD794E },
+  { "32 decrementing",   mDecrementing, sizeof (mDecrementing), 0x113FDB5C },
+};
+
+// Initial CRCs used for the exhaustive tests
+STATIC CONST UINT32  mSeeds[] = {
+  0, 0xFFFFFFFF, 0x12345678
+};
+
+STATIC UINT8  mBuffer[EXT4_TEST_BUFFER_SIZE];
+
+/**
+   Calculates the CRC32C of the given buffer, one bit at a time.
+   The CRC is neither pre- nor post-inverted.
+
+   @param[in]      Buffer        Pointer to the buffer.
+   @param[in]      Length        Length of the buffer, in bytes.
+   @param[in]      Crc           Initial value of the CRC.
+
+   @return The CRC32C.
+**/
+STATIC
+UINT32
+Ext4TestCrc32cReference (
+  IN CONST VOID  *Buffer,
+  IN UINTN       Length,
+  IN UINT32      Crc
+  )
+{
+  CONST UINT8  *Data;
+  UINTN        Index;
+  UINTN        Bit;
+
+  Data = Buffer;
+
+  for (Index = 0; Index < Length; Index++) {
+    Crc ^= Data[Index];
+
+    for (Bit = 0; Bit < 8; Bit++) {
+      Crc = (Crc >> 1) ^ ((Crc & 1) != 0 ? EXT4_TEST_CRC32C_POLY : 0);
+    }
+  }
+
+  return Crc;
+}
+
+/**
+   Calculates the CRC32C of the given buffer with BaseLib's table-driven
+   implementation, the way Ext4CalculateCrc32c does when there's no hardware support.
+
+   @param[in]      Buffer        Pointer to the buffer.
+   @param[in]      Length        Length of the buffer, in bytes.
+   @param[in]      Crc           Initial value of the CRC.
+
+   @return The CRC32C.
+**/
+STATIC
+UINT32
+Ext4TestCrc32cTable (
+  IN CONST VOID  *Buffer,
+  IN UINTN       Length,
+  IN UINT32      Crc
+  )
+{
+  return ~CalculateCrc32c (Buffer, Length, ~Crc);
+}
+
+/**
+   Calculates the CRC32C of the given buffer with Ext4Crc32cHw.
+
+   @param[in]      Buffer        Pointer to the buffer.
+   @param[in]      Length        Length of the buffer, in bytes.
+   @param[in]      Crc           Initial value of the CRC.
+
+   @return The CRC32C.
+**/
+STATIC
+UINT32
+Ext4TestCrc32cHw (
+  IN CONST VOID  *Buffer,
+  IN UINTN       Length,
+  IN UINT32      Crc
+  )
+{
+  return Ext4Crc32cHw (Crc, Buffer, Length);
+}
+
+STATIC EXT4_TEST_CRC32C_IMPL  mImplementations[] = {
+  { "Table",               Ext4TestCrc32cTable },
+  { "Ext4CalculateCrc32c", Ext4CalculateCrc32c },
+  { "Ext4Crc32cHw",        Ext4TestCrc32cHw    },
+};
+
+/**
+   Checks if the host CPU has the CRC32C instructions used by Ext4Crc32cHw.
+
+   On X64, the host BaseLib's AsmCpuid doesn't execute CPUID (and so
+   Ext4CalculateCrc32c always takes the table path there), so ask the compiler instead.
+
+   @return TRUE if supported, FALSE otherwise.
+**/
+STATIC
+BOOLEAN
+Ext4TestHostHasCrc32c (
+  VOID
+  )
+{
+ #if defined (MDE_CPU_X64)
+  #if defined (_MSC_VER)
+  INT32  Registers[4];
+
+  __cpuid (Registers, CPUID_VERSION_INFO);
+  return (Registers[2] & BIT20) != 0;
+  #else
+  return __builtin_cpu_supports ("sse4.2") != 0;
+  #endif
+ #else
+  return Ext4Crc32cHwSupported ();
+ #endif
+}
+
+/**
+   Skips the Ext4Crc32cHw tests if the host CPU can't run them.
+
+   @param[in]      Context       The EXT4_TEST_CRC32C_IMPL under test.
+
+   @retval UNIT_TEST_PASSED      The implementation can be tested.
+   @retval UNIT_TEST_SKIPPED     The host CPU doesn't have CRC32C instructions.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+Ext4TestHwSupported (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  if (!Ext4TestHostHasCrc32c ()) {
+    UT_LOG_INFO ("The host CPU doesn't have CRC32C instructions\n");
+    return UNIT_TEST_SKIPPED;
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+   Checks an implementation against the known test vectors.
+
+   @param[in]      Context       The EXT4_TEST_CRC32C_IMPL under test.
+
+   @retval UNIT_TEST_PASSED                All the vectors matched.
+   @retval UNIT_TEST_ERROR_TEST_FAILED     A vector didn't match.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+Ext4TestKnownVectors (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EXT4_TEST_CRC32C_IMPL  *Impl;
+  UINTN                  Index;
+  UINT32                 Crc;
+
+  Impl = Context;
+
+  for (Index = 0; Index < ARRAY_SIZE (mVectors); Index++) {
+    Crc = ~Impl->Calculate (mVectors[Index].Data, mVectors[Index].Length, 0xFFFFFFFF);
+
+    if (Crc != mVectors[Index].Crc) {
+      UT_LOG_ERROR ("%a: got %08x, expected %08x\n", mVectors[Index].Name, Crc, mVectors[Index].Crc);
+    }
+
+    UT_ASSERT_EQUAL (Crc, mVectors[Index].Crc);
+  }
+
+  // An empty buffer leaves the CRC untouched
+  UT_ASSERT_EQUAL (Impl->Calculate (mBuffer, 0, 0x12345678), 0x12345678);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+   Checks an implementation against the reference for every length up to
+   EXT4_TEST_MAX_LENGTH at every offset up to EXT4_TEST_MAX_OFFSET, plus a
+   few odd-length multi-KB buffers.
+
+   @param[in]      Context       The EXT4_TEST_CRC32C_IMPL under test.
+
+   @retval UNIT_TEST_PASSED                All the CRCs matched.
+   @retval UNIT_TEST_ERROR_TEST_FAILED     A CRC didn't match.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+Ext4TestLengthsAndOffsets (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST UINTN     LargeLengths[] = { 1021, 2047, SIZE_4KB - 1, SIZE_4KB };
+  EXT4_TEST_CRC32C_IMPL  *Impl;
+  UINTN                  Seed;
+  UINTN                  Offset;
+  UINTN                  Length;
+  UINTN                  Index;
+  UINT32                 Crc;
+  UINT32                 Expected;
+
+  Impl = Context;
+
+  for (Seed = 0; Seed < ARRAY_SIZE (mSeeds); Seed++) {
+    for (Offset = 0; Offset < EXT4_TEST_MAX_OFFSET; Offset++) {
+      for (Length = 0; Length <= EXT4_TEST_MAX_LENGTH; Length++) {
+        Crc      = Impl->Calculate (mBuffer + Offset, Length, mSeeds[Seed]);
+        Expected = Ext4TestCrc32cReference (mBuffer + Offset, Length, mSeeds[Seed]);
+
+        if (Crc != Expected) {
+          UT_LOG_ERROR (
+            "Offset %u, length %u, seed %08x: got %08x, expected %08x\n",
+            (UINT32)Offset,
+            (UINT32)Length,
+            mSeeds[Seed],
+            Crc,
+            Expected
+            );
+        }
+
+        UT_ASSERT_EQUAL (Crc, Expected);
+      }
+
+      for (Index = 0; Index < ARRAY_SIZE (LargeLengths); Index++) {
+        Length   = LargeLengths[Index];
+        Crc      = Impl->Calculate (mBuffer + Offset, Length, mSeeds[Seed]);
+        Expected = Ext4TestCrc32cReference (mBuffer + Offset, Length, mSeeds[Seed]);
+        UT_ASSERT_EQUAL (Crc, Expected);
+      }
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+   Fills the test buffer and runs the tests against every implementation.
+
+   @param[in]      argc          Number of arguments.
+   @param[in]      argv          Arguments.
+
+   @return 0 on success, non-zero on failure.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      Suite;
+  UNIT_TEST_PREREQUISITE      Prerequisite;
+  UINT32                      Random;
+  UINTN                       Index;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  // Fill the buffer with something that isn't periodic
+  Random = 0x2545F491;
+  for (Index = 0; Index < sizeof (mBuffer); Index++) {
+    Random         = Random * 1103515245 + 12345;
+    mBuffer[Index] = (UINT8)(Random >> 24);
+  }
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  for (Index = 0; Index < ARRAY_SIZE (mImplementations); Index++) {
+    Status = CreateUnitTestSuite (&Suite, Framework, mImplementations[Index].Name, "Ext4Dxe.Crc32c", NULL, NULL);
+
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite. Status = %r\n", Status));
+      goto EXIT;
+    }
+
+    Prerequisite = (mImplementations[Index].Calculate == Ext4TestCrc32cHw) ? Ext4TestHwSupported : NULL;
+
+    AddTestCase (Suite, "Known vectors", "KnownVectors", Ext4TestKnownVectors, Prerequisite, NULL, &mImplementations[Index]);
+    AddTestCase (Suite, "Lengths and offsets", "LengthsAndOffsets", Ext4TestLengthsAndOffsets, Prerequisite, NULL, &mImplementations[Index]);
+  }
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework != NULL) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return EFI_ERROR (Status) ? 1 : 0;
+}
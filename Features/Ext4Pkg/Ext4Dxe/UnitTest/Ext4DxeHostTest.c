@@ -0,0 +1,540 @@
+/** @file
+  Host-based benchmark of the Ext4Dxe read path.
+
+  Mounts a synthetic ext4 image (see Ext4HostImage.c) with Ext4OpenPartition, over
+  stub EFI_DISK_IO(2)_PROTOCOLs, and runs the deep path, huge directory, fragmented
+  file and sparse file workloads through the driver's EFI_FILE_PROTOCOL.
+  For each workload, the number of DiskIo calls, the bytes they read and the wall
+  time spent in the driver are reported; the data that's read back is checked.
+
+  Copyright (c) 2021 - 2023 Pedro Falcato All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <time.h>
+
+#include "Ext4DxeHostTest.h"
+
+#define UNIT_TEST_NAME     "Ext4Dxe read path benchmark"
+#define UNIT_TEST_VERSION  "0.1"
+
+// Number of times the file at the bottom of the deep path is opened and read
+#define EXT4_HOST_DEEP_PATH_OPENS  16
+
+// Number of names looked up in each huge directory, and how many of them don't exist
+#define EXT4_HOST_HUGE_DIR_LOOKUPS  512
+#define EXT4_HOST_HUGE_DIR_MISSES   64
+
+#define EXT4_HOST_FILE_INFO_SIZE  (SIZE_OF_EFI_FILE_INFO + (EXT4_NAME_MAX + 1) * sizeof (CHAR16))
+
+typedef
+UNIT_TEST_STATUS
+(*EXT4_HOST_WORKLOAD_FUNCTION) (
+  IN EFI_FILE_PROTOCOL  *Root,
+  IN CONST CHAR16       *Path
+  );
+
+typedef struct {
+  CHAR8                          *Name;
+  EXT4_HOST_WORKLOAD_FUNCTION    Run;
+  CONST CHAR16                   *Path;
+} EXT4_HOST_WORKLOAD;
+
+STATIC EXT4_HOST_DISK  mDisk;
+STATIC EFI_HANDLE      mDiskHandle = (EFI_HANDLE)&mDisk;
+STATIC UINT64          mDriverTime;
+
+/**
+   Returns the wall clock time.
+
+   @return Time in nanoseconds.
+**/
+STATIC
+UINT64
+Ext4HostNow (
+  VOID
+  )
+{
+  struct timespec  Now;
+
+  timespec_get (&Now, TIME_UTC);
+  return (UINT64)Now.tv_sec * 1000000000ULL + (UINT64)Now.tv_nsec;
+}
+
+/**
+   Opens a file, accounting for the time spent in the driver.
+
+   @param[in]      Parent        Pointer to the opened directory.
+   @param[out]     File          Pointer to the opened file.
+   @param[in]      Path          Path of the file, relative to Parent.
+
+   @return Status of the open.
+**/
+STATIC
+EFI_STATUS
+Ext4HostOpen (
+  IN  EFI_FILE_PROTOCOL  *Parent,
+  OUT EFI_FILE_PROTOCOL  **File,
+  IN  CONST CHAR16       *Path
+  )
+{
+  EFI_STATUS  Status;
+  UINT64      Start;
+
+  Start        = Ext4HostNow ();
+  Status       = Parent->Open (Parent, File, (CHAR16 *)Path, EFI_FILE_MODE_READ, 0);
+  mDriverTime += Ext4HostNow () - Start;
+  return Status;
+}
+
+/**
+   Reads from a file, accounting for the time spent in the driver.
+
+   @param[in]      File          Pointer to the opened file.
+   @param[in out]  Size          Size of the buffer; bytes read on return.
+   @param[out]     Buffer        Pointer to the buffer.
+
+   @return Status of the read.
+**/
+STATIC
+EFI_STATUS
+Ext4HostRead (
+  IN     EFI_FILE_PROTOCOL  *File,
+  IN OUT UINTN              *Size,
+  OUT    VOID               *Buffer
+  )
+{
+  EFI_STATUS  Status;
+  UINT64      Start;
+
+  Start        = Ext4HostNow ();
+  Status       = File->Read (File, Size, Buffer);
+  mDriverTime += Ext4HostNow () - Start;
+  return Status;
+}
+
+/**
+   Returns the byte a file is expected to hold at a given offset.
+
+   @param[in]      Offset        Offset in the file, in bytes.
+   @param[in]      Sparse        TRUE if the file is laid out as gExt4HostSparseExtents says,
+                                 FALSE if it has no holes.
+
+   @return The expected byte.
+**/
+STATIC
+UINT8
+Ext4HostExpectedByte (
+  IN UINT64   Offset,
+  IN BOOLEAN  Sparse
+  )
+{
+  CONST EXT4_HOST_SPARSE_EXTENT  *Extent;
+  UINT64                         Block;
+  UINTN                          Index;
+
+  if (!Sparse) {
+    return Ext4HostPattern (Offset);
+  }
+
+  Block = Offset / EXT4_HOST_BLOCK_SIZE;
+
+  for (Index = 0; Index < gExt4HostSparseExtentCount; Index++) {
+    Extent = &gExt4HostSparseExtents[Index];
+
+    if ((Block >= Extent->LogicalBlock) && (Block < (UINT64)Extent->LogicalBlock + Extent->Length)) {
+      return Extent->Uninitialized ? 0 : Ext4HostPattern (Offset);
+    }
+  }
+
+  return 0;
+}
+
+/**
+   Reads a whole file in chunks, and checks its size and contents.
+
+   @param[in]      File          Pointer to the opened file.
+   @param[in]      ReadSize      Size of each read, in bytes.
+   @param[in]      ExpectedSize  Expected size of the file, in bytes.
+   @param[in]      Sparse        TRUE if the file is laid out as gExt4HostSparseExtents says.
+
+   @retval UNIT_TEST_PASSED      The file read back as expected.
+   @retval !UNIT_TEST_PASSED     Failure.
+**/
+STATIC
+UNIT_TEST_STATUS
+Ext4HostReadAndCheck (
+  IN EFI_FILE_PROTOCOL  *File,
+  IN UINTN              ReadSize,
+  IN UINT64             ExpectedSize,
+  IN BOOLEAN            Sparse
+  )
+{
+  UINT8       *Buffer;
+  UINT64      Offset;
+  UINTN       Size;
+  UINTN       Index;
+  EFI_STATUS  Status;
+
+  Buffer = AllocatePool (ReadSize);
+  UT_ASSERT_NOT_NULL (Buffer);
+
+  Offset = 0;
+
+  do {
+    Size   = ReadSize;
+    Status = Ext4HostRead (File, &Size, Buffer);
+
+    if (EFI_ERROR (Status)) {
+      FreePool (Buffer);
+      UT_ASSERT_NOT_EFI_ERROR (Status);
+    }
+
+    for (Index = 0; Index < Size; Index++) {
+      if (Buffer[Index] != Ext4HostExpectedByte (Offset + Index, Sparse)) {
+        UT_LOG_ERROR ("Bad data at offset %Lu\n", Offset + Index);
+        FreePool (Buffer);
+        return UNIT_TEST_ERROR_TEST_FAILED;
+      }
+    }
+
+    Offset += Size;
+  } while (Size != 0);
+
+  FreePool (Buffer);
+
+  UT_ASSERT_EQUAL (Offset, ExpectedSize);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+   Deep path workload: repeatedly opens and reads the file at the bottom of
+   EXT4_HOST_DEEP_PATH_DEPTH nested directories, by its full path.
+
+   @param[in]      Root          Pointer to the root directory.
+   @param[in]      Path          Unused.
+
+   @retval UNIT_TEST_PASSED      Success.
+   @retval !UNIT_TEST_PASSED     Failure.
+**/
+STATIC
+UNIT_TEST_STATUS
+Ext4HostDeepPath (
+  IN EFI_FILE_PROTOCOL  *Root,
+  IN CONST CHAR16       *Path
+  )
+{
+  CHAR16             FullPath[EXT4_HOST_DEEP_PATH_DEPTH * 8 + 16];
+  EFI_FILE_PROTOCOL  *File;
+  UNIT_TEST_STATUS   TestStatus;
+  EFI_STATUS         Status;
+  UINTN              Level;
+  UINTN              Iteration;
+
+  FullPath[0] = L'\0';
+
+  for (Level = 0; Level < EXT4_HOST_DEEP_PATH_DEPTH; Level++) {
+    UnicodeSPrint (
+      FullPath + StrLen (FullPath),
+      sizeof (FullPath) - StrLen (FullPath) * sizeof (CHAR16),
+      L"level%02u\\",
+      (UINT32)Level
+      );
+  }
+
+  StrCatS (FullPath, ARRAY_SIZE (FullPath), L"leaf.bin");
+
+  for (Iteration = 0; Iteration < EXT4_HOST_DEEP_PATH_OPENS; Iteration++) {
+    Status = Ext4HostOpen (Root, &File, FullPath);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+
+    TestStatus = Ext4HostReadAndCheck (File, EXT4_HOST_BLOCK_SIZE, EXT4_HOST_DEEP_FILE_SIZE, FALSE);
+    File->Close (File);
+
+    if (TestStatus != UNIT_TEST_PASSED) {
+      return TestStatus;
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+   Huge directory workload: looks up names spread over a directory with
+   EXT4_HOST_HUGE_DIR_ENTRIES entries (and some that aren't there), then lists it.
+
+   @param[in]      Root          Pointer to the root directory.
+   @param[in]      Path          Path of the directory.
+
+   @retval UNIT_TEST_PASSED      Success.
+   @retval !UNIT_TEST_PASSED     Failure.
+**/
+STATIC
+UNIT_TEST_STATUS
+Ext4HostHugeDir (
+  IN EFI_FILE_PROTOCOL  *Root,
+  IN CONST CHAR16       *Path
+  )
+{
+  EFI_FILE_PROTOCOL  *Dir;
+  EFI_FILE_PROTOCOL  *File;
+  EFI_FILE_INFO      *Info;
+  CHAR16             Name[16];
+  UINTN              Index;
+  UINTN              Entries;
+  UINTN              Size;
+  EFI_STATUS         Status;
+
+  Status = Ext4HostOpen (Root, &Dir, Path);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  for (Index = 0; Index < EXT4_HOST_HUGE_DIR_LOOKUPS; Index++) {
+    // Spread the lookups over the whole directory, in no particular order
+    UnicodeSPrint (Name, sizeof (Name), L"file%05u", (UINT32)((Index * 7919) % EXT4_HOST_HUGE_DIR_ENTRIES));
+
+    Status = Ext4HostOpen (Dir, &File, Name);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    File->Close (File);
+  }
+
+  for (Index = 0; Index < EXT4_HOST_HUGE_DIR_MISSES; Index++) {
+    UnicodeSPrint (Name, sizeof (Name), L"missing%05u", (UINT32)Index);
+
+    Status = Ext4HostOpen (Dir, &File, Name);
+    UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+  }
+
+  Info = AllocatePool (EXT4_HOST_FILE_INFO_SIZE);
+  UT_ASSERT_NOT_NULL (Info);
+
+  Entries = 0;
+
+  while (TRUE) {
+    Size   = EXT4_HOST_FILE_INFO_SIZE;
+    Status = Ext4HostRead (Dir, &Size, Info);
+
+    if (EFI_ERROR (Status) || (Size == 0)) {
+      break;
+    }
+
+    Entries++;
+  }
+
+  FreePool (Info);
+  Dir->Close (Dir);
+
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (Entries, EXT4_HOST_HUGE_DIR_ENTRIES);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+   File workload: reads a whole file sequentially.
+
+   @param[in]      Root          Pointer to the root directory.
+   @param[in]      Path          Path of the file.
+   @param[in]      ReadSize      Size of each read, in bytes.
+   @param[in]      Size          Expected size of the file, in bytes.
+   @param[in]      Sparse        TRUE if the file is laid out as gExt4HostSparseExtents says.
+
+   @retval UNIT_TEST_PASSED      Success.
+   @retval !UNIT_TEST_PASSED     Failure.
+**/
+STATIC
+UNIT_TEST_STATUS
+Ext4HostReadFile (
+  IN EFI_FILE_PROTOCOL  *Root,
+  IN CONST CHAR16       *Path,
+  IN UINTN              ReadSize,
+  IN UINT64             Size,
+  IN BOOLEAN            Sparse
+  )
+{
+  EFI_FILE_PROTOCOL  *File;
+  UNIT_TEST_STATUS   TestStatus;
+  EFI_STATUS         Status;
+
+  Status = Ext4HostOpen (Root, &File, Path);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  TestStatus = Ext4HostReadAndCheck (File, ReadSize, Size, Sparse);
+  File->Close (File);
+  return TestStatus;
+}
+
+/**
+   Fragmented file workload: reads a file made of EXT4_HOST_FRAGMENTS
+   non-contiguous single block extents, 64KiB at a time.
+
+   @param[in]      Root          Pointer to the root directory.
+   @param[in]      Path          Path of the file.
+
+   @retval UNIT_TEST_PASSED      Success.
+   @retval !UNIT_TEST_PASSED     Failure.
+**/
+STATIC
+UNIT_TEST_STATUS
+Ext4HostFragmentedFile (
+  IN EFI_FILE_PROTOCOL  *Root,
+  IN CONST CHAR16       *Path
+  )
+{
+  return Ext4HostReadFile (Root, Path, SIZE_64KB, (UINT64)EXT4_HOST_FRAGMENTS * EXT4_HOST_BLOCK_SIZE, FALSE);
+}
+
+/**
+   Sparse file workload: reads a mostly-hole file, 1MiB at a time.
+
+   @param[in]      Root          Pointer to the root directory.
+   @param[in]      Path          Path of the file.
+
+   @retval UNIT_TEST_PASSED      Success.
+   @retval !UNIT_TEST_PASSED     Failure.
+**/
+STATIC
+UNIT_TEST_STATUS
+Ext4HostSparseFile (
+  IN EFI_FILE_PROTOCOL  *Root,
+  IN CONST CHAR16       *Path
+  )
+{
+  return Ext4HostReadFile (Root, Path, SIZE_1MB, EXT4_HOST_SPARSE_FILE_SIZE, TRUE);
+}
+
+STATIC EXT4_HOST_WORKLOAD  mWorkloads[] = {
+  { "Deep path",                  Ext4HostDeepPath,       NULL              },
+  { "Huge directory (linear)",    Ext4HostHugeDir,        L"linear"         },
+  { "Huge directory (htree)",     Ext4HostHugeDir,        L"htree"          },
+  { "Fragmented file",            Ext4HostFragmentedFile, L"fragmented.bin" },
+  { "Sparse file",                Ext4HostSparseFile,     L"sparse.bin"     }
+};
+
+/**
+   Mounts the image, runs a workload against a cold mount and reports its DiskIo
+   calls, bytes read and the wall time spent in the driver.
+
+   @param[in]      Context       Pointer to the EXT4_HOST_WORKLOAD.
+
+   @retval UNIT_TEST_PASSED      Success.
+   @retval !UNIT_TEST_PASSED     Failure.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+Ext4HostRunWorkload (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EXT4_HOST_WORKLOAD               *Workload;
+  EFI_SIMPLE_FILE_SYSTEM_PROTOCOL  *FileSystem;
+  EFI_FILE_PROTOCOL                *Root;
+  EXT4_HOST_DISK_STATS             Stats;
+  UNIT_TEST_STATUS                 TestStatus;
+  EFI_STATUS                       Status;
+
+  Workload = Context;
+
+  Status = Ext4OpenPartition (mDiskHandle, &mDisk.DiskIo, &mDisk.DiskIo2, &mDisk.BlockIo);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  FileSystem = Ext4HostGetFileSystem ();
+  UT_ASSERT_NOT_NULL (FileSystem);
+
+  Status = FileSystem->OpenVolume (FileSystem, &Root);
+
+  if (EFI_ERROR (Status)) {
+    Ext4UnmountAndFreePartition ((EXT4_PARTITION *)FileSystem);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+  }
+
+  ZeroMem (&mDisk.Stats, sizeof (mDisk.Stats));
+  mDriverTime = 0;
+
+  TestStatus = Workload->Run (Root, Workload->Path);
+
+  CopyMem (&Stats, &mDisk.Stats, sizeof (Stats));
+
+  // Closes anything the workload left open, too
+  Ext4UnmountAndFreePartition ((EXT4_PARTITION *)FileSystem);
+
+  UT_LOG_INFO (
+    "%a: %Lu DiskIo reads (%Lu bytes), %Lu DiskIo2 reads (%Lu bytes), %Lu us\n",
+    Workload->Name,
+    Stats.DiskReads,
+    Stats.BytesRead,
+    Stats.AsyncDiskReads,
+    Stats.AsyncBytesRead,
+    mDriverTime / 1000
+    );
+
+  return TestStatus;
+}
+
+/**
+   Builds the image and runs every workload against it.
+
+   @param[in]      argc          Number of arguments.
+   @param[in]      argv          Arguments.
+
+   @return 0 on success, non-zero on failure.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      Suite;
+  UINT8                       *Image;
+  UINTN                       ImageSize;
+  UINTN                       Index;
+
+  Framework = NULL;
+  Image     = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  Ext4HostInstallBootServices ();
+
+  Status = Ext4HostBuildImage (&Image, &ImageSize);
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed to build the ext4 image. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Ext4HostInitDisk (&mDisk, Image, ImageSize);
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&Suite, Framework, "Ext4Dxe read path workloads", "Ext4Dxe.Workloads", NULL, NULL);
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  for (Index = 0; Index < ARRAY_SIZE (mWorkloads); Index++) {
+    AddTestCase (Suite, mWorkloads[Index].Name, "Workload", Ext4HostRunWorkload, NULL, NULL, &mWorkloads[Index]);
+  }
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework != NULL) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  if (Image != NULL) {
+    FreePool (Image);
+  }
+
+  return EFI_ERROR (Status) ? 1 : 0;
+}
@@ -0,0 +1,124 @@
+/** @file
+  Host-based benchmark of the Ext4Dxe read path: shared definitions
+
+  Copyright (c) 2021 - 2023 Pedro Falcato All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#ifndef EXT4_DXE_HOST_TEST_H_
+#define EXT4_DXE_HOST_TEST_H_
+
+#include "../Ext4Dxe.h"
+
+#include <Library/PrintLib.h>
+#include <Library/UnitTestLib.h>
+
+//
+// Geometry of the synthetic filesystem: one block group of 4KiB blocks.
+// Only the blocks that are actually used are backed by memory, the rest of the
+// (EXT4_HOST_BLOCKS blocks long) disk reads as zeroes.
+//
+#define EXT4_HOST_BLOCK_SIZE      4096
+#define EXT4_HOST_LOG_BLOCK_SIZE  2
+#define EXT4_HOST_BLOCKS          (8 * EXT4_HOST_BLOCK_SIZE)
+#define EXT4_HOST_MEDIA_SIZE      ((UINT64)EXT4_HOST_BLOCKS * EXT4_HOST_BLOCK_SIZE)
+
+//
+// Workload parameters
+//
+#define EXT4_HOST_DEEP_PATH_DEPTH   32
+#define EXT4_HOST_DEEP_FILE_SIZE    (3 * EXT4_HOST_BLOCK_SIZE + 100)
+#define EXT4_HOST_HUGE_DIR_ENTRIES  10000
+#define EXT4_HOST_FRAGMENTS         1024
+#define EXT4_HOST_SPARSE_FILE_SIZE  SIZE_64MB
+
+typedef struct {
+  UINT32     LogicalBlock;
+  UINT16     Length;
+  BOOLEAN    Uninitialized;
+} EXT4_HOST_SPARSE_EXTENT;
+
+extern CONST EXT4_HOST_SPARSE_EXTENT  gExt4HostSparseExtents[];
+extern CONST UINTN                    gExt4HostSparseExtentCount;
+
+typedef struct {
+  UINT64    DiskReads;
+  UINT64    BytesRead;
+  UINT64    AsyncDiskReads;
+  UINT64    AsyncBytesRead;
+} EXT4_HOST_DISK_STATS;
+
+//
+// In-memory disk, exposed through EFI_DISK_IO(2)_PROTOCOL and EFI_BLOCK_IO_PROTOCOL
+//
+typedef struct {
+  UINT8                    *Image;
+  UINTN                    ImageSize;
+  EFI_BLOCK_IO_MEDIA       Media;
+  EFI_BLOCK_IO_PROTOCOL    BlockIo;
+  EFI_DISK_IO_PROTOCOL     DiskIo;
+  EFI_DISK_IO2_PROTOCOL    DiskIo2;
+  EXT4_HOST_DISK_STATS     Stats;
+} EXT4_HOST_DISK;
+
+/**
+   Returns the contents of the synthetic files' data blocks at a given file offset.
+
+   @param[in]      Offset        Offset in the file, in bytes.
+
+   @return The byte at that offset.
+**/
+UINT8
+Ext4HostPattern (
+  IN UINT64  Offset
+  );
+
+/**
+   Builds the synthetic ext4 filesystem that the workloads run against.
+
+   @param[out]     Image         Pointer to the image, allocated from the pool.
+   @param[out]     ImageSize     Size of the image, in bytes.
+
+   @retval EFI_SUCCESS           The image was built.
+   @retval !EFI_SUCCESS          Failure.
+**/
+EFI_STATUS
+Ext4HostBuildImage (
+  OUT UINT8  **Image,
+  OUT UINTN  *ImageSize
+  );
+
+/**
+   Sets up an in-memory disk over an ext4 image.
+
+   @param[out]     Disk          Pointer to the disk.
+   @param[in]      Image         Pointer to the image.
+   @param[in]      ImageSize     Size of the image, in bytes.
+**/
+VOID
+Ext4HostInitDisk (
+  OUT EXT4_HOST_DISK  *Disk,
+  IN  UINT8           *Image,
+  IN  UINTN           ImageSize
+  );
+
+/**
+   Points gBS at the boot services stubs needed by the driver.
+**/
+VOID
+Ext4HostInstallBootServices (
+  VOID
+  );
+
+/**
+   Returns the EFI_SIMPLE_FILE_SYSTEM_PROTOCOL installed by the driver since the
+   last call, if any.
+
+   @return Pointer to the protocol, or NULL if none was installed.
+**/
+EFI_SIMPLE_FILE_SYSTEM_PROTOCOL *
+Ext4HostGetFileSystem (
+  VOID
+  );
+
+#endif
@@ -0,0 +1,1092 @@
+/** @file
+  Synthetic ext4 filesystem for the Ext4Dxe host benchmark
+
+  The image holds one tree per workload, off the root directory:
+    level00\level01\...\level31\leaf.bin   - deep path
+    linear\file00000 ... file09999         - huge classic (linear) directory
+    htree\file00000 ... file09999          - huge hash tree (htree) indexed directory
+    fragmented.bin                         - file made of single block extents
+    sparse.bin                             - mostly-hole file, with an uninitialized extent
+
+  Copyright (c) 2021 - 2023 Pedro Falcato All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include "Ext4DxeHostTest.h"
+
+#define EXT4_HOST_INODES_PER_GROUP  128
+#define EXT4_HOST_INODE_SIZE        256
+#define EXT4_HOST_BGDT_BLOCK        1
+#define EXT4_HOST_BLOCK_BITMAP      2
+#define EXT4_HOST_INODE_BITMAP      3
+#define EXT4_HOST_INODE_TABLE       4
+#define EXT4_HOST_FIRST_FREE_BLOCK  \
+  (EXT4_HOST_INODE_TABLE + EXT4_HOST_INODES_PER_GROUP * EXT4_HOST_INODE_SIZE / EXT4_HOST_BLOCK_SIZE)
+
+// Number of blocks backed by memory, needs to cover everything the workloads allocate
+#define EXT4_HOST_IMAGE_BLOCKS  4096
+
+// Garbage that must never be returned by a read
+#define EXT4_HOST_STALE_BYTE  0xCC
+
+CONST EXT4_HOST_SPARSE_EXTENT  gExt4HostSparseExtents[] = {
+  { 0,     8,  FALSE },
+  { 4000,  8,  FALSE },
+  { 9000,  16, FALSE },
+  { 12000, 8,  TRUE  },
+  { 16000, 4,  FALSE }
+};
+
+CONST UINTN  gExt4HostSparseExtentCount = ARRAY_SIZE (gExt4HostSparseExtents);
+
+typedef struct {
+  UINT8            *Data;
+  EXT4_BLOCK_NR    NextBlock;
+  EXT4_INO_NR      NextInode;
+  UINT16           Directories;
+  // Used to hash the names in indexed directories
+  EXT4_PARTITION   *Partition;
+} EXT4_HOST_IMAGE;
+
+typedef struct {
+  CONST CHAR8    *Name;
+  EXT4_INO_NR    Inode;
+  UINT8          FileType;
+  UINT32         Hash;
+} EXT4_HOST_DIRENT;
+
+/**
+   Returns the contents of the synthetic files' data blocks at a given file offset.
+
+   @param[in]      Offset        Offset in the file, in bytes.
+
+   @return The byte at that offset.
+**/
+UINT8
+Ext4HostPattern (
+  IN UINT64  Offset
+  )
+{
+  return (UINT8)(Offset ^ (Offset >> 8) ^ (Offset >> 16) ^ 0x5A);
+}
+
+/**
+   Returns a pointer to a block of the image.
+
+   @param[in]      Img           Pointer to the image.
+   @param[in]      Block         Block number.
+
+   @return Pointer to the block.
+**/
+STATIC
+UINT8 *
+Ext4HostBlock (
+  IN EXT4_HOST_IMAGE  *Img,
+  IN EXT4_BLOCK_NR    Block
+  )
+{
+  return Img->Data + (UINTN)Block * EXT4_HOST_BLOCK_SIZE;
+}
+
+/**
+   Allocates contiguous blocks.
+
+   @param[in out]  Img           Pointer to the image.
+   @param[in]      Count         Number of blocks.
+
+   @return The first block, or EXT4_BLOCK_FILE_HOLE if the image is full.
+**/
+STATIC
+EXT4_BLOCK_NR
+Ext4HostAllocBlocks (
+  IN OUT EXT4_HOST_IMAGE  *Img,
+  IN     UINTN            Count
+  )
+{
+  EXT4_BLOCK_NR  Block;
+
+  if (Count > EXT4_HOST_IMAGE_BLOCKS - Img->NextBlock) {
+    return EXT4_BLOCK_FILE_HOLE;
+  }
+
+  Block           = Img->NextBlock;
+  Img->NextBlock += Count;
+  return Block;
+}
+
+/**
+   Returns a pointer to an inode of the image.
+
+   @param[in]      Img           Pointer to the image.
+   @param[in]      Ino           Inode number.
+
+   @return Pointer to the inode.
+**/
+STATIC
+EXT4_INODE *
+Ext4HostInode (
+  IN EXT4_HOST_IMAGE  *Img,
+  IN EXT4_INO_NR      Ino
+  )
+{
+  return (EXT4_INODE *)(Ext4HostBlock (Img, EXT4_HOST_INODE_TABLE) + (Ino - 1) * EXT4_HOST_INODE_SIZE);
+}
+
+/**
+   Sets up an empty inode, with an empty extent tree.
+
+   @param[in out]  Img           Pointer to the image.
+   @param[in]      Ino           Inode number.
+   @param[in]      Type          One of EXT4_INO_TYPE_DIR or EXT4_INO_TYPE_REGFILE.
+**/
+STATIC
+VOID
+Ext4HostInitInode (
+  IN OUT EXT4_HOST_IMAGE  *Img,
+  IN     EXT4_INO_NR      Ino,
+  IN     UINT16           Type
+  )
+{
+  EXT4_INODE          *Inode;
+  EXT4_EXTENT_HEADER  *Header;
+
+  Inode = Ext4HostInode (Img, Ino);
+
+  Inode->i_mode        = Type | (Type == EXT4_INO_TYPE_DIR ? 0755 : 0644);
+  Inode->i_flags       = EXT4_EXTENTS_FL;
+  Inode->i_extra_isize = sizeof (EXT4_INODE) - EXT4_GOOD_OLD_INODE_SIZE;
+
+  Header             = (EXT4_EXTENT_HEADER *)Inode->i_data;
+  Header->eh_magic   = EXT4_EXTENT_HEADER_MAGIC;
+  Header->eh_max     = (sizeof (Inode->i_data) - sizeof (EXT4_EXTENT_HEADER)) / sizeof (EXT4_EXTENT);
+  Header->eh_depth   = 0;
+  Header->eh_entries = 0;
+
+  if (Type == EXT4_INO_TYPE_DIR) {
+    Img->Directories++;
+  }
+}
+
+/**
+   Allocates and sets up an empty inode.
+
+   @param[in out]  Img           Pointer to the image.
+   @param[in]      Type          One of EXT4_INO_TYPE_DIR or EXT4_INO_TYPE_REGFILE.
+
+   @return The inode number.
+**/
+STATIC
+EXT4_INO_NR
+Ext4HostNewInode (
+  IN OUT EXT4_HOST_IMAGE  *Img,
+  IN     UINT16           Type
+  )
+{
+  EXT4_INO_NR  Ino;
+
+  Ino = Img->NextInode++;
+  ASSERT (Ino <= EXT4_HOST_INODES_PER_GROUP);
+
+  Ext4HostInitInode (Img, Ino, Type);
+  return Ino;
+}
+
+/**
+   Fills data blocks with the pattern returned by Ext4HostPattern().
+
+   @param[in out]  Img           Pointer to the image.
+   @param[in]      Block         First physical block.
+   @param[in]      LogicalBlock  First logical block.
+   @param[in]      Count         Number of blocks.
+**/
+STATIC
+VOID
+Ext4HostFillBlocks (
+  IN OUT EXT4_HOST_IMAGE  *Img,
+  IN     EXT4_BLOCK_NR    Block,
+  IN     UINT32           LogicalBlock,
+  IN     UINTN            Count
+  )
+{
+  UINT8   *Data;
+  UINT64  Offset;
+  UINTN   Index;
+
+  Data   = Ext4HostBlock (Img, Block);
+  Offset = (UINT64)LogicalBlock * EXT4_HOST_BLOCK_SIZE;
+
+  for (Index = 0; Index < Count * EXT4_HOST_BLOCK_SIZE; Index++) {
+    Data[Index] = Ext4HostPattern (Offset + Index);
+  }
+}
+
+/**
+   Fills out an extent.
+
+   @param[out]     Extent        Pointer to the extent.
+   @param[in]      LogicalBlock  First logical block.
+   @param[in]      Length        Length of the extent, in blocks.
+   @param[in]      Block         First physical block.
+   @param[in]      Uninitialized TRUE if the extent is uninitialized.
+**/
+STATIC
+VOID
+Ext4HostSetExtent (
+  OUT EXT4_EXTENT    *Extent,
+  IN  UINT32         LogicalBlock,
+  IN  UINT16         Length,
+  IN  EXT4_BLOCK_NR  Block,
+  IN  BOOLEAN        Uninitialized
+  )
+{
+  Extent->ee_block    = LogicalBlock;
+  Extent->ee_len      = Uninitialized ? (UINT16)(EXT4_EXTENT_MAX_INITIALIZED + Length) : Length;
+  Extent->ee_start_hi = (UINT16)(Block >> 32);
+  Extent->ee_start_lo = (UINT32)Block;
+}
+
+/**
+   Sets an inode's extents and size. Up to 4 extents fit in the inode itself,
+   more than that go in leaf blocks under a depth 1 tree.
+
+   @param[in out]  Img           Pointer to the image.
+   @param[in]      Ino           Inode number.
+   @param[in]      Extents       Extents, sorted by logical block.
+   @param[in]      Count         Number of extents.
+   @param[in]      Size          Size of the file, in bytes.
+
+   @retval EFI_SUCCESS           The extents were set.
+   @retval EFI_UNSUPPORTED       The extents need a deeper tree.
+   @retval EFI_OUT_OF_RESOURCES  The image is full.
+**/
+STATIC
+EFI_STATUS
+Ext4HostSetExtents (
+  IN OUT EXT4_HOST_IMAGE    *Img,
+  IN     EXT4_INO_NR        Ino,
+  IN     CONST EXT4_EXTENT  *Extents,
+  IN     UINTN              Count,
+  IN     UINT64             Size
+  )
+{
+  EXT4_INODE          *Inode;
+  EXT4_EXTENT_HEADER  *Header;
+  EXT4_EXTENT_HEADER  *LeafHeader;
+  EXT4_EXTENT_INDEX   *Index;
+  EXT4_BLOCK_NR       LeafBlock;
+  UINTN               PerLeaf;
+  UINTN               Leaves;
+  UINTN               Leaf;
+  UINTN               Extent;
+  UINT64              Blocks;
+
+  Inode  = Ext4HostInode (Img, Ino);
+  Header = (EXT4_EXTENT_HEADER *)Inode->i_data;
+  Blocks = 0;
+
+  for (Extent = 0; Extent < Count; Extent++) {
+    Blocks += Ext4GetExtentLength (&Extents[Extent]);
+  }
+
+  if (Count <= Header->eh_max) {
+    CopyMem (Header + 1, Extents, Count * sizeof (EXT4_EXTENT));
+    Header->eh_entries = (UINT16)Count;
+  } else {
+    PerLeaf = (EXT4_HOST_BLOCK_SIZE - sizeof (EXT4_EXTENT_HEADER)) / sizeof (EXT4_EXTENT);
+    Leaves  = (Count + PerLeaf - 1) / PerLeaf;
+
+    if (Leaves > Header->eh_max) {
+      return EFI_UNSUPPORTED;
+    }
+
+    LeafBlock = Ext4HostAllocBlocks (Img, Leaves);
+
+    if (LeafBlock == EXT4_BLOCK_FILE_HOLE) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    Index = (EXT4_EXTENT_INDEX *)(Header + 1);
+
+    for (Leaf = 0; Leaf < Leaves; Leaf++) {
+      LeafHeader             = (EXT4_EXTENT_HEADER *)Ext4HostBlock (Img, LeafBlock + Leaf);
+      LeafHeader->eh_magic   = EXT4_EXTENT_HEADER_MAGIC;
+      LeafHeader->eh_max     = (UINT16)PerLeaf;
+      LeafHeader->eh_depth   = 0;
+      LeafHeader->eh_entries = (UINT16)MIN (PerLeaf, Count - Leaf * PerLeaf);
+      CopyMem (LeafHeader + 1, Extents + Leaf * PerLeaf, LeafHeader->eh_entries * sizeof (EXT4_EXTENT));
+
+      Index[Leaf].ei_block   = Extents[Leaf * PerLeaf].ee_block;
+      Index[Leaf].ei_leaf_lo = (UINT32)(LeafBlock + Leaf);
+      Index[Leaf].ei_leaf_hi = (UINT16)((LeafBlock + Leaf) >> 32);
+    }
+
+    Header->eh_depth   = 1;
+    Header->eh_entries = (UINT16)Leaves;
+    Blocks            += Leaves;
+  }
+
+  Inode->i_size_lo = (UINT32)Size;
+  Inode->i_size_hi = (UINT32)(Size >> 32);
+  Inode->i_blocks  = (UINT32)(Blocks * (EXT4_HOST_BLOCK_SIZE / 512));
+  return EFI_SUCCESS;
+}
+
+/**
+   Creates a regular file with contiguous data blocks.
+
+   @param[in out]  Img           Pointer to the image.
+   @param[in]      Size          Size of the file, in bytes.
+   @param[out]     Ino           Inode number of the file.
+
+   @retval EFI_SUCCESS           The file was created.
+   @retval EFI_OUT_OF_RESOURCES  The image is full.
+**/
+STATIC
+EFI_STATUS
+Ext4HostAddFile (
+  IN OUT EXT4_HOST_IMAGE  *Img,
+  IN     UINT32           Size,
+  OUT    EXT4_INO_NR      *Ino
+  )
+{
+  EXT4_EXTENT    Extent;
+  EXT4_BLOCK_NR  Block;
+  UINTN          Count;
+
+  *Ino  = Ext4HostNewInode (Img, EXT4_INO_TYPE_REGFILE);
+  Count = (Size + EXT4_HOST_BLOCK_SIZE - 1) / EXT4_HOST_BLOCK_SIZE;
+
+  if (Count == 0) {
+    return EFI_SUCCESS;
+  }
+
+  Block = Ext4HostAllocBlocks (Img, Count);
+
+  if (Block == EXT4_BLOCK_FILE_HOLE) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Ext4HostFillBlocks (Img, Block, 0, Count);
+  Ext4HostSetExtent (&Extent, 0, (UINT16)Count, Block, FALSE);
+  return Ext4HostSetExtents (Img, *Ino, &Extent, 1, Size);
+}
+
+/**
+   Packs directory entries in directory blocks, classic (linear) style.
+
+   @param[out]     Buffer        Pointer to the blocks, or NULL to only count them.
+   @param[in]      Entries       Directory entries.
+   @param[in]      Count         Number of entries.
+   @param[out]     FirstEntry    Index of the first entry in each block. Optional.
+
+   @return Number of blocks used.
+**/
+STATIC
+UINTN
+Ext4HostPackDirents (
+  OUT UINT8                   *Buffer OPTIONAL,
+  IN  CONST EXT4_HOST_DIRENT  *Entries,
+  IN  UINTN                   Count,
+  OUT UINTN                   *FirstEntry OPTIONAL
+  )
+{
+  EXT4_DIR_ENTRY  *Dirent;
+  EXT4_DIR_ENTRY  *Last;
+  UINTN           Blocks;
+  UINTN           Used;
+  UINTN           Length;
+  UINTN           Index;
+
+  Blocks = 0;
+  Used   = EXT4_HOST_BLOCK_SIZE;
+  Last   = NULL;
+
+  for (Index = 0; Index < Count; Index++) {
+    Length = ALIGN_VALUE (EXT4_MIN_DIR_ENTRY_LEN + AsciiStrLen (Entries[Index].Name), 4);
+
+    if (Used + Length > EXT4_HOST_BLOCK_SIZE) {
+      // The last entry of a block spans the rest of it
+      if (Last != NULL) {
+        Last->rec_len += (UINT16)(EXT4_HOST_BLOCK_SIZE - Used);
+      }
+
+      if (FirstEntry != NULL) {
+        FirstEntry[Blocks] = Index;
+      }
+
+      Blocks++;
+      Used = 0;
+    }
+
+    if (Buffer != NULL) {
+      Dirent            = (EXT4_DIR_ENTRY *)(Buffer + (Blocks - 1) * EXT4_HOST_BLOCK_SIZE + Used);
+      Dirent->inode     = Entries[Index].Inode;
+      Dirent->rec_len   = (UINT16)Length;
+      Dirent->name_len  = (UINT8)AsciiStrLen (Entries[Index].Name);
+      Dirent->file_type = Entries[Index].FileType;
+      CopyMem (Dirent->name, Entries[Index].Name, Dirent->name_len);
+      Last = Dirent;
+    }
+
+    Used += Length;
+  }
+
+  if (Last != NULL) {
+    Last->rec_len += (UINT16)(EXT4_HOST_BLOCK_SIZE - Used);
+  }
+
+  return Blocks;
+}
+
+/**
+   Bumps the link count of every inode referenced by a directory.
+
+   @param[in out]  Img           Pointer to the image.
+   @param[in]      Entries       Directory entries.
+   @param[in]      Count         Number of entries.
+**/
+STATIC
+VOID
+Ext4HostLinkDirents (
+  IN OUT EXT4_HOST_IMAGE         *Img,
+  IN     CONST EXT4_HOST_DIRENT  *Entries,
+  IN     UINTN                   Count
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < Count; Index++) {
+    Ext4HostInode (Img, Entries[Index].Inode)->i_links++;
+  }
+}
+
+/**
+   Writes a classic (linear) directory.
+
+   @param[in out]  Img           Pointer to the image.
+   @param[in]      Dir           Inode number of the directory.
+   @param[in]      Parent        Inode number of the parent directory.
+   @param[in]      Children      Directory entries, other than "." and "..".
+   @param[in]      Count         Number of entries.
+
+   @retval EFI_SUCCESS           The directory was written.
+   @retval EFI_OUT_OF_RESOURCES  The image is full.
+**/
+STATIC
+EFI_STATUS
+Ext4HostWriteDir (
+  IN OUT EXT4_HOST_IMAGE         *Img,
+  IN     EXT4_INO_NR             Dir,
+  IN     EXT4_INO_NR             Parent,
+  IN     CONST EXT4_HOST_DIRENT  *Children,
+  IN     UINTN                   Count
+  )
+{
+  EXT4_HOST_DIRENT  *Entries;
+  EXT4_EXTENT       Extent;
+  EXT4_BLOCK_NR     Block;
+  UINTN             Blocks;
+  EFI_STATUS        Status;
+
+  Entries = AllocateZeroPool ((Count + 2) * sizeof (EXT4_HOST_DIRENT));
+
+  if (Entries == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Entries[0].Name     = ".";
+  Entries[0].Inode    = Dir;
+  Entries[0].FileType = EXT4_FT_DIR;
+  Entries[1].Name     = "..";
+  Entries[1].Inode    = Parent;
+  Entries[1].FileType = EXT4_FT_DIR;
+  CopyMem (Entries + 2, Children, Count * sizeof (EXT4_HOST_DIRENT));
+
+  Blocks = Ext4HostPackDirents (NULL, Entries, Count + 2, NULL);
+  Block  = Ext4HostAllocBlocks (Img, Blocks);
+
+  if (Block == EXT4_BLOCK_FILE_HOLE) {
+    FreePool (Entries);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Ext4HostPackDirents (Ext4HostBlock (Img, Block), Entries, Count + 2, NULL);
+  Ext4HostLinkDirents (Img, Entries, Count + 2);
+
+  Ext4HostSetExtent (&Extent, 0, (UINT16)Blocks, Block, FALSE);
+  Status = Ext4HostSetExtents (Img, Dir, &Extent, 1, (UINT64)Blocks * EXT4_HOST_BLOCK_SIZE);
+
+  FreePool (Entries);
+  return Status;
+}
+
+/**
+   Orders directory entries by hash, then by name.
+
+   @param[in]      Buffer1       Pointer to the first EXT4_HOST_DIRENT.
+   @param[in]      Buffer2       Pointer to the second EXT4_HOST_DIRENT.
+
+   @return <0, 0 or >0 if the first entry goes before, with or after the second one.
+**/
+STATIC
+INTN
+EFIAPI
+Ext4HostCompareDirentHashes (
+  IN CONST VOID  *Buffer1,
+  IN CONST VOID  *Buffer2
+  )
+{
+  CONST EXT4_HOST_DIRENT  *Entry1;
+  CONST EXT4_HOST_DIRENT  *Entry2;
+
+  Entry1 = Buffer1;
+  Entry2 = Buffer2;
+
+  if (Entry1->Hash != Entry2->Hash) {
+    return Entry1->Hash < Entry2->Hash ? -1 : 1;
+  }
+
+  return AsciiStrCmp (Entry1->Name, Entry2->Name);
+}
+
+/**
+   Writes a hash tree (htree) indexed directory, with a single level index:
+   block 0 holds "." and ".." and the dx root, the leaves follow, sorted by hash.
+
+   @param[in out]  Img           Pointer to the image.
+   @param[in]      Dir           Inode number of the directory.
+   @param[in]      Parent        Inode number of the parent directory.
+   @param[in]      Children      Directory entries, other than "." and "..".
+   @param[in]      Count         Number of entries.
+
+   @retval EFI_SUCCESS           The directory was written.
+   @retval EFI_UNSUPPORTED       The directory needs a deeper index.
+   @retval EFI_OUT_OF_RESOURCES  The image is full.
+**/
+STATIC
+EFI_STATUS
+Ext4HostWriteIndexedDir (
+  IN OUT EXT4_HOST_IMAGE         *Img,
+  IN     EXT4_INO_NR             Dir,
+  IN     EXT4_INO_NR             Parent,
+  IN     CONST EXT4_HOST_DIRENT  *Children,
+  IN     UINTN                   Count
+  )
+{
+  EXT4_HOST_DIRENT     *Entries;
+  EXT4_HOST_DIRENT     Scratch;
+  UINTN                *FirstEntry;
+  EXT4_DX_ROOT         *Root;
+  EXT4_DX_COUNT_LIMIT  *CountLimit;
+  EXT4_DX_ENTRY        *DxEntries;
+  EXT4_EXTENT          Extent;
+  EXT4_BLOCK_NR        Block;
+  UINTN                Leaves;
+  UINTN                Leaf;
+  UINTN                Index;
+  UINT32               Limit;
+  EFI_STATUS           Status;
+
+  FirstEntry = NULL;
+  Entries    = AllocateCopyPool (Count * sizeof (EXT4_HOST_DIRENT), Children);
+
+  if (Entries == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  for (Index = 0; Index < Count; Index++) {
+    Status = Ext4CalculateDirHash (
+               Img->Partition,
+               EXT4_DX_HASH_HALF_MD4,
+               Entries[Index].Name,
+               AsciiStrLen (Entries[Index].Name),
+               &Entries[Index].Hash
+               );
+
+    if (EFI_ERROR (Status)) {
+      goto Out;
+    }
+  }
+
+  QuickSort (Entries, Count, sizeof (EXT4_HOST_DIRENT), Ext4HostCompareDirentHashes, &Scratch);
+
+  Leaves = Ext4HostPackDirents (NULL, Entries, Count, NULL);
+  Limit  = (EXT4_HOST_BLOCK_SIZE - sizeof (EXT4_DX_ROOT)) / sizeof (EXT4_DX_ENTRY);
+
+  if (Leaves > Limit) {
+    Status = EFI_UNSUPPORTED;
+    goto Out;
+  }
+
+  FirstEntry = AllocatePool (Leaves * sizeof (UINTN));
+  Block      = Ext4HostAllocBlocks (Img, Leaves + 1);
+
+  if ((FirstEntry == NULL) || (Block == EXT4_BLOCK_FILE_HOLE)) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Out;
+  }
+
+  Ext4HostPackDirents (Ext4HostBlock (Img, Block + 1), Entries, Count, FirstEntry);
+
+  // ".." spans the rest of block 0, hiding the index from linear lookups
+  Root                    = (EXT4_DX_ROOT *)Ext4HostBlock (Img, Block);
+  Root->dot_inode         = Dir;
+  Root->dot_rec_len       = 12;
+  Root->dot_name_len      = 1;
+  Root->dot_file_type     = EXT4_FT_DIR;
+  Root->dot_name[0]       = '.';
+  Root->dotdot_inode      = Parent;
+  Root->dotdot_rec_len    = EXT4_HOST_BLOCK_SIZE - 12;
+  Root->dotdot_name_len   = 2;
+  Root->dotdot_file_type  = EXT4_FT_DIR;
+  Root->dotdot_name[0]    = '.';
+  Root->dotdot_name[1]    = '.';
+  Root->info.hash_version = EXT4_DX_HASH_HALF_MD4;
+  Root->info.info_length  = sizeof (EXT4_DX_ROOT_INFO);
+
+  DxEntries          = (EXT4_DX_ENTRY *)(Root + 1);
+  CountLimit         = (EXT4_DX_COUNT_LIMIT *)DxEntries;
+  CountLimit->limit  = (UINT16)Limit;
+  CountLimit->count  = (UINT16)Leaves;
+  DxEntries[0].block = 1;
+
+  for (Leaf = 1; Leaf < Leaves; Leaf++) {
+    Index                 = FirstEntry[Leaf];
+    DxEntries[Leaf].hash  = Entries[Index].Hash;
+    DxEntries[Leaf].block = (UINT32)(Leaf + 1);
+
+    // Names with this hash continue from the previous leaf
+    if (Entries[Index - 1].Hash == Entries[Index].Hash) {
+      DxEntries[Leaf].hash |= EXT4_DX_HASH_COLLISION;
+    }
+  }
+
+  Ext4HostInode (Img, Dir)->i_links++;
+  Ext4HostInode (Img, Parent)->i_links++;
+  Ext4HostLinkDirents (Img, Entries, Count);
+
+  Ext4HostSetExtent (&Extent, 0, (UINT16)(Leaves + 1), Block, FALSE);
+  Status = Ext4HostSetExtents (Img, Dir, &Extent, 1, (UINT64)(Leaves + 1) * EXT4_HOST_BLOCK_SIZE);
+
+  Ext4HostInode (Img, Dir)->i_flags |= EXT4_INDEX_FL;
+
+Out:
+  if (FirstEntry != NULL) {
+    FreePool (FirstEntry);
+  }
+
+  FreePool (Entries);
+  return Status;
+}
+
+/**
+   Creates the deep path workload: EXT4_HOST_DEEP_PATH_DEPTH nested directories
+   and a file at the bottom.
+
+   @param[in out]  Img           Pointer to the image.
+   @param[in]      Parent        Inode number of the parent directory.
+   @param[out]     Top           Inode number of the topmost directory.
+
+   @retval EFI_SUCCESS           The tree was created.
+   @retval EFI_OUT_OF_RESOURCES  The image is full.
+**/
+STATIC
+EFI_STATUS
+Ext4HostAddDeepPath (
+  IN OUT EXT4_HOST_IMAGE  *Img,
+  IN     EXT4_INO_NR      Parent,
+  OUT    EXT4_INO_NR      *Top
+  )
+{
+  EXT4_INO_NR       Dirs[EXT4_HOST_DEEP_PATH_DEPTH];
+  CHAR8             Names[EXT4_HOST_DEEP_PATH_DEPTH][8];
+  EXT4_HOST_DIRENT  Child;
+  EXT4_INO_NR       File;
+  UINTN             Level;
+  EFI_STATUS        Status;
+
+  for (Level = 0; Level < EXT4_HOST_DEEP_PATH_DEPTH; Level++) {
+    Dirs[Level] = Ext4HostNewInode (Img, EXT4_INO_TYPE_DIR);
+    AsciiSPrint (Names[Level], sizeof (Names[Level]), "level%02u", (UINT32)Level);
+  }
+
+  Status = Ext4HostAddFile (Img, EXT4_HOST_DEEP_FILE_SIZE, &File);
+
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Child.Name     = "leaf.bin";
+  Child.Inode    = File;
+  Child.FileType = EXT4_FT_REG_FILE;
+
+  Level = EXT4_HOST_DEEP_PATH_DEPTH;
+
+  while (Level > 0) {
+    Level--;
+    Status = Ext4HostWriteDir (Img, Dirs[Level], Level == 0 ? Parent : Dirs[Level - 1], &Child, 1);
+
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Child.Name     = Names[Level];
+    Child.Inode    = Dirs[Level];
+    Child.FileType = EXT4_FT_DIR;
+  }
+
+  *Top = Dirs[0];
+  return EFI_SUCCESS;
+}
+
+/**
+   Creates the huge directory workload: a linear and an indexed directory, each with
+   EXT4_HOST_HUGE_DIR_ENTRIES hard links to the same empty file.
+
+   @param[in out]  Img           Pointer to the image.
+   @param[in]      Parent        Inode number of the parent directory.
+   @param[out]     Linear        Inode number of the linear directory.
+   @param[out]     Indexed       Inode number of the indexed directory.
+
+   @retval EFI_SUCCESS           The directories were created.
+   @retval !EFI_SUCCESS          Failure.
+**/
+STATIC
+EFI_STATUS
+Ext4HostAddHugeDirs (
+  IN OUT EXT4_HOST_IMAGE  *Img,
+  IN     EXT4_INO_NR      Parent,
+  OUT    EXT4_INO_NR      *Linear,
+  OUT    EXT4_INO_NR      *Indexed
+  )
+{
+  EXT4_HOST_DIRENT  *Entries;
+  CHAR8             *Names;
+  EXT4_INO_NR       File;
+  UINTN             Index;
+  EFI_STATUS        Status;
+
+  Entries = AllocateZeroPool (EXT4_HOST_HUGE_DIR_ENTRIES * sizeof (EXT4_HOST_DIRENT));
+  Names   = AllocateZeroPool (EXT4_HOST_HUGE_DIR_ENTRIES * 16);
+
+  if ((Entries == NULL) || (Names == NULL)) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Out;
+  }
+
+  *Linear  = Ext4HostNewInode (Img, EXT4_INO_TYPE_DIR);
+  *Indexed = Ext4HostNewInode (Img, EXT4_INO_TYPE_DIR);
+
+  Status = Ext4HostAddFile (Img, 0, &File);
+
+  if (EFI_ERROR (Status)) {
+    goto Out;
+  }
+
+  for (Index = 0; Index < EXT4_HOST_HUGE_DIR_ENTRIES; Index++) {
+    AsciiSPrint (Names + Index * 16, 16, "file%05u", (UINT32)Index);
+    Entries[Index].Name     = Names + Index * 16;
+    Entries[Index].Inode    = File;
+    Entries[Index].FileType = EXT4_FT_REG_FILE;
+  }
+
+  Status = Ext4HostWriteDir (Img, *Linear, Parent, Entries, EXT4_HOST_HUGE_DIR_ENTRIES);
+
+  if (EFI_ERROR (Status)) {
+    goto Out;
+  }
+
+  Status = Ext4HostWriteIndexedDir (Img, *Indexed, Parent, Entries, EXT4_HOST_HUGE_DIR_ENTRIES);
+
+Out:
+  if (Entries != NULL) {
+    FreePool (Entries);
+  }
+
+  if (Names != NULL) {
+    FreePool (Names);
+  }
+
+  return Status;
+}
+
+/**
+   Creates the fragmented file workload: EXT4_HOST_FRAGMENTS single block extents,
+   with a block of stale data between each of them.
+
+   @param[in out]  Img           Pointer to the image.
+   @param[out]     Ino           Inode number of the file.
+
+   @retval EFI_SUCCESS           The file was created.
+   @retval !EFI_SUCCESS          Failure.
+**/
+STATIC
+EFI_STATUS
+Ext4HostAddFragmentedFile (
+  IN OUT EXT4_HOST_IMAGE  *Img,
+  OUT    EXT4_INO_NR      *Ino
+  )
+{
+  EXT4_EXTENT    *Extents;
+  EXT4_BLOCK_NR  Block;
+  UINT32         Index;
+  EFI_STATUS     Status;
+
+  Extents = AllocatePool (EXT4_HOST_FRAGMENTS * sizeof (EXT4_EXTENT));
+
+  if (Extents == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  *Ino = Ext4HostNewInode (Img, EXT4_INO_TYPE_REGFILE);
+
+  for (Index = 0; Index < EXT4_HOST_FRAGMENTS; Index++) {
+    Block = Ext4HostAllocBlocks (Img, 2);
+
+    if (Block == EXT4_BLOCK_FILE_HOLE) {
+      FreePool (Extents);
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    Ext4HostFillBlocks (Img, Block, Index, 1);
+    SetMem (Ext4HostBlock (Img, Block + 1), EXT4_HOST_BLOCK_SIZE, EXT4_HOST_STALE_BYTE);
+    Ext4HostSetExtent (&Extents[Index], Index, 1, Block, FALSE);
+  }
+
+  Status = Ext4HostSetExtents (Img, *Ino, Extents, EXT4_HOST_FRAGMENTS, (UINT64)EXT4_HOST_FRAGMENTS * EXT4_HOST_BLOCK_SIZE);
+
+  FreePool (Extents);
+  return Status;
+}
+
+/**
+   Creates the sparse file workload, laid out as gExt4HostSparseExtents says.
+   The blocks of the uninitialized extent hold stale data.
+
+   @param[in out]  Img           Pointer to the image.
+   @param[out]     Ino           Inode number of the file.
+
+   @retval EFI_SUCCESS           The file was created.
+   @retval !EFI_SUCCESS          Failure.
+**/
+STATIC
+EFI_STATUS
+Ext4HostAddSparseFile (
+  IN OUT EXT4_HOST_IMAGE  *Img,
+  OUT    EXT4_INO_NR      *Ino
+  )
+{
+  EXT4_EXTENT                    Extents[ARRAY_SIZE (gExt4HostSparseExtents)];
+  CONST EXT4_HOST_SPARSE_EXTENT  *Sparse;
+  EXT4_BLOCK_NR                  Block;
+  UINTN                          Index;
+
+  *Ino = Ext4HostNewInode (Img, EXT4_INO_TYPE_REGFILE);
+
+  for (Index = 0; Index < gExt4HostSparseExtentCount; Index++) {
+    Sparse = &gExt4HostSparseExtents[Index];
+    Block  = Ext4HostAllocBlocks (Img, Sparse->Length);
+
+    if (Block == EXT4_BLOCK_FILE_HOLE) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    if (Sparse->Uninitialized) {
+      SetMem (Ext4HostBlock (Img, Block), Sparse->Length * EXT4_HOST_BLOCK_SIZE, EXT4_HOST_STALE_BYTE);
+    } else {
+      Ext4HostFillBlocks (Img, Block, Sparse->LogicalBlock, Sparse->Length);
+    }
+
+    Ext4HostSetExtent (&Extents[Index], Sparse->LogicalBlock, Sparse->Length, Block, Sparse->Uninitialized);
+  }
+
+  return Ext4HostSetExtents (Img, *Ino, Extents, gExt4HostSparseExtentCount, EXT4_HOST_SPARSE_FILE_SIZE);
+}
+
+/**
+   Sets the first Count bits of a bitmap.
+
+   @param[out]     Bitmap        Pointer to the bitmap.
+   @param[in]      Count         Number of bits to set.
+**/
+STATIC
+VOID
+Ext4HostSetBits (
+  OUT UINT8  *Bitmap,
+  IN  UINTN  Count
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < Count; Index++) {
+    Bitmap[Index / 8] |= (UINT8)(1 << (Index % 8));
+  }
+}
+
+/**
+   Writes the superblock. The free counts are filled in by Ext4HostFinishImage().
+
+   @param[in out]  Img           Pointer to the image.
+
+   @return Pointer to the superblock.
+**/
+STATIC
+EXT4_SUPERBLOCK *
+Ext4HostWriteSuperblock (
+  IN OUT EXT4_HOST_IMAGE  *Img
+  )
+{
+  EXT4_SUPERBLOCK  *Sb;
+
+  Sb = (EXT4_SUPERBLOCK *)(Img->Data + EXT4_SUPERBLOCK_OFFSET);
+
+  Sb->s_inodes_count      = EXT4_HOST_INODES_PER_GROUP;
+  Sb->s_blocks_count      = EXT4_HOST_BLOCKS;
+  Sb->s_first_data_block  = 0;
+  Sb->s_log_block_size    = EXT4_HOST_LOG_BLOCK_SIZE;
+  Sb->s_log_frag_size     = EXT4_HOST_LOG_BLOCK_SIZE;
+  Sb->s_blocks_per_group  = EXT4_HOST_BLOCKS;
+  Sb->s_frags_per_group   = EXT4_HOST_BLOCKS;
+  Sb->s_inodes_per_group  = EXT4_HOST_INODES_PER_GROUP;
+  Sb->s_magic             = EXT4_SIGNATURE;
+  Sb->s_state             = EXT4_FS_STATE_UNMOUNTED;
+  Sb->s_errors            = EXT4_ERRORS_CONTINUE;
+  Sb->s_creator_os        = EXT4_LINUX_ID;
+  Sb->s_rev_level         = EXT4_DYNAMIC_REV;
+  Sb->s_first_ino         = EXT4_GOOD_OLD_FIRST_INODE_NR;
+  Sb->s_inode_size        = EXT4_HOST_INODE_SIZE;
+  Sb->s_feature_compat    = EXT4_FEATURE_COMPAT_DIR_INDEX;
+  Sb->s_feature_incompat  = EXT4_FEATURE_INCOMPAT_FILETYPE | EXT4_FEATURE_INCOMPAT_EXTENTS;
+  Sb->s_feature_ro_compat = EXT4_FEATURE_RO_COMPAT_EXTRA_ISIZE;
+  Sb->s_def_hash_version  = EXT4_DX_HASH_HALF_MD4;
+  Sb->s_flags             = EXT4_FLAGS_SIGNED_HASH;
+  Sb->s_min_extra_isize   = sizeof (EXT4_INODE) - EXT4_GOOD_OLD_INODE_SIZE;
+  Sb->s_want_extra_isize  = sizeof (EXT4_INODE) - EXT4_GOOD_OLD_INODE_SIZE;
+  AsciiStrCpyS ((CHAR8 *)Sb->s_volume_name, sizeof (Sb->s_volume_name), "Ext4HostTest");
+
+  return Sb;
+}
+
+/**
+   Writes the block group descriptor, the bitmaps and the free counts.
+
+   @param[in out]  Img           Pointer to the image.
+   @param[in out]  Sb            Pointer to the superblock.
+**/
+STATIC
+VOID
+Ext4HostFinishImage (
+  IN OUT EXT4_HOST_IMAGE  *Img,
+  IN OUT EXT4_SUPERBLOCK  *Sb
+  )
+{
+  EXT4_BLOCK_GROUP_DESC  *Desc;
+  UINT32                 UsedInodes;
+
+  UsedInodes = Img->NextInode - 1;
+
+  Desc                          = (EXT4_BLOCK_GROUP_DESC *)Ext4HostBlock (Img, EXT4_HOST_BGDT_BLOCK);
+  Desc->bg_block_bitmap_lo      = EXT4_HOST_BLOCK_BITMAP;
+  Desc->bg_inode_bitmap_lo      = EXT4_HOST_INODE_BITMAP;
+  Desc->bg_inode_table_lo       = EXT4_HOST_INODE_TABLE;
+  Desc->bg_free_blocks_count_lo = (UINT16)(EXT4_HOST_BLOCKS - Img->NextBlock);
+  Desc->bg_free_inodes_count_lo = (UINT16)(EXT4_HOST_INODES_PER_GROUP - UsedInodes);
+  Desc->bg_used_dirs_count_lo   = Img->Directories;
+
+  Ext4HostSetBits (Ext4HostBlock (Img, EXT4_HOST_BLOCK_BITMAP), (UINTN)Img->NextBlock);
+  Ext4HostSetBits (Ext4HostBlock (Img, EXT4_HOST_INODE_BITMAP), UsedInodes);
+
+  Sb->s_free_blocks_count = (UINT32)(EXT4_HOST_BLOCKS - Img->NextBlock);
+  Sb->s_free_inodes_count = EXT4_HOST_INODES_PER_GROUP - UsedInodes;
+}
+
+/**
+   Builds the synthetic ext4 filesystem that the workloads run against.
+
+   @param[out]     Image         Pointer to the image, allocated from the pool.
+   @param[out]     ImageSize     Size of the image, in bytes.
+
+   @retval EFI_SUCCESS           The image was built.
+   @retval !EFI_SUCCESS          Failure.
+**/
+EFI_STATUS
+Ext4HostBuildImage (
+  OUT UINT8  **Image,
+  OUT UINTN  *ImageSize
+  )
+{
+  EXT4_HOST_IMAGE   Img;
+  EXT4_SUPERBLOCK   *Sb;
+  EXT4_HOST_DIRENT  RootEntries[5];
+  EFI_STATUS        Status;
+
+  ZeroMem (&Img, sizeof (Img));
+  ZeroMem (RootEntries, sizeof (RootEntries));
+
+  Img.Data      = AllocateZeroPool (EXT4_HOST_IMAGE_BLOCKS * EXT4_HOST_BLOCK_SIZE);
+  Img.Partition = AllocateZeroPool (sizeof (EXT4_PARTITION));
+
+  if ((Img.Data == NULL) || (Img.Partition == NULL)) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Error;
+  }
+
+  Img.NextBlock = EXT4_HOST_FIRST_FREE_BLOCK;
+  Img.NextInode = EXT4_GOOD_OLD_FIRST_INODE_NR;
+
+  Sb = Ext4HostWriteSuperblock (&Img);
+  CopyMem (&Img.Partition->SuperBlock, Sb, sizeof (EXT4_SUPERBLOCK));
+
+  Ext4HostInitInode (&Img, EXT4_ROOT_INODE_NR, EXT4_INO_TYPE_DIR);
+
+  RootEntries[0].Name     = "level00";
+  RootEntries[0].FileType = EXT4_FT_DIR;
+  RootEntries[1].Name     = "linear";
+  RootEntries[1].FileType = EXT4_FT_DIR;
+  RootEntries[2].Name     = "htree";
+  RootEntries[2].FileType = EXT4_FT_DIR;
+  RootEntries[3].Name     = "fragmented.bin";
+  RootEntries[3].FileType = EXT4_FT_REG_FILE;
+  RootEntries[4].Name     = "sparse.bin";
+  RootEntries[4].FileType = EXT4_FT_REG_FILE;
+
+  Status = Ext4HostAddDeepPath (&Img, EXT4_ROOT_INODE_NR, &RootEntries[0].Inode);
+
+  if (!EFI_ERROR (Status)) {
+    Status = Ext4HostAddHugeDirs (&Img, EXT4_ROOT_INODE_NR, &RootEntries[1].Inode, &RootEntries[2].Inode);
+  }
+
+  if (!EFI_ERROR (Status)) {
+    Status = Ext4HostAddFragmentedFile (&Img, &RootEntries[3].Inode);
+  }
+
+  if (!EFI_ERROR (Status)) {
+    Status = Ext4HostAddSparseFile (&Img, &RootEntries[4].Inode);
+  }
+
+  if (!EFI_ERROR (Status)) {
+    Status = Ext4HostWriteDir (&Img, EXT4_ROOT_INODE_NR, EXT4_ROOT_INODE_NR, RootEntries, ARRAY_SIZE (RootEntries));
+  }
+
+  if (EFI_ERROR (Status)) {
+    goto Error;
+  }
+
+  Ext4HostFinishImage (&Img, Sb);
+  FreePool (Img.Partition);
+
+  *Image     = Img.Data;
+  *ImageSize = (UINTN)Img.NextBlock * EXT4_HOST_BLOCK_SIZE;
+  return EFI_SUCCESS;
+
+Error:
+  if (Img.Data != NULL) {
+    FreePool (Img.Data);
+  }
+
+  if (Img.Partition != NULL) {
+    FreePool (Img.Partition);
+  }
+
+  return Status;
+}
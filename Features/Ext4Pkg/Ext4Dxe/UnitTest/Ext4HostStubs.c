@@ -0,0 +1,439 @@
+/** @file
+  Boot services, disk and Unicode collation stubs for the Ext4Dxe host benchmark
+
+  Copyright (c) 2021 - 2023 Pedro Falcato All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include "Ext4DxeHostTest.h"
+
+#define EXT4_HOST_SECTOR_SIZE  512
+
+#define EXT4_HOST_DISK_FROM_DISK_IO(This)   BASE_CR (This, EXT4_HOST_DISK, DiskIo)
+#define EXT4_HOST_DISK_FROM_DISK_IO2(This)  BASE_CR (This, EXT4_HOST_DISK, DiskIo2)
+
+//
+// Events only need to remember if they were signalled, since the disk stubs
+// complete every request before returning.
+//
+typedef struct {
+  BOOLEAN    Signalled;
+} EXT4_HOST_EVENT;
+
+EFI_BOOT_SERVICES  *gBS;
+
+STATIC EFI_BOOT_SERVICES                mExt4HostBootServices;
+STATIC EFI_TPL                          mExt4HostTpl = TPL_APPLICATION;
+STATIC EFI_SIMPLE_FILE_SYSTEM_PROTOCOL  *mExt4HostFileSystem;
+
+/**
+   Raises the task priority level.
+
+   @param[in]      NewTpl        The new task priority level.
+
+   @return The previous task priority level.
+**/
+STATIC
+EFI_TPL
+EFIAPI
+Ext4HostRaiseTpl (
+  IN EFI_TPL  NewTpl
+  )
+{
+  EFI_TPL  OldTpl;
+
+  OldTpl       = mExt4HostTpl;
+  mExt4HostTpl = NewTpl;
+  return OldTpl;
+}
+
+/**
+   Restores the task priority level.
+
+   @param[in]      OldTpl        The previous task priority level.
+**/
+STATIC
+VOID
+EFIAPI
+Ext4HostRestoreTpl (
+  IN EFI_TPL  OldTpl
+  )
+{
+  mExt4HostTpl = OldTpl;
+}
+
+/**
+   Creates an event. Notification functions are not supported.
+
+   @param[in]      Type           The type of event to create.
+   @param[in]      NotifyTpl      The task priority level of event notifications.
+   @param[in]      NotifyFunction Must be NULL.
+   @param[in]      NotifyContext  Unused.
+   @param[out]     Event          The newly created event.
+
+   @retval EFI_SUCCESS            The event was created.
+   @retval EFI_UNSUPPORTED        NotifyFunction is not NULL.
+   @retval EFI_OUT_OF_RESOURCES   The event could not be allocated.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+Ext4HostCreateEvent (
+  IN  UINT32            Type,
+  IN  EFI_TPL           NotifyTpl,
+  IN  EFI_EVENT_NOTIFY  NotifyFunction OPTIONAL,
+  IN  VOID              *NotifyContext OPTIONAL,
+  OUT EFI_EVENT         *Event
+  )
+{
+  if (NotifyFunction != NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  *Event = AllocateZeroPool (sizeof (EXT4_HOST_EVENT));
+  return *Event == NULL ? EFI_OUT_OF_RESOURCES : EFI_SUCCESS;
+}
+
+/**
+   Signals an event.
+
+   @param[in]      Event         The event to signal.
+
+   @retval EFI_SUCCESS           The event was signalled.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+Ext4HostSignalEvent (
+  IN EFI_EVENT  Event
+  )
+{
+  ((EXT4_HOST_EVENT *)Event)->Signalled = TRUE;
+  return EFI_SUCCESS;
+}
+
+/**
+   Checks if an event is signalled, and clears it if so.
+
+   @param[in]      Event         The event to check.
+
+   @retval EFI_SUCCESS           The event was signalled.
+   @retval EFI_NOT_READY         The event is not signalled.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+Ext4HostCheckEvent (
+  IN EFI_EVENT  Event
+  )
+{
+  EXT4_HOST_EVENT  *HostEvent;
+
+  HostEvent = Event;
+
+  if (!HostEvent->Signalled) {
+    return EFI_NOT_READY;
+  }
+
+  HostEvent->Signalled = FALSE;
+  return EFI_SUCCESS;
+}
+
+/**
+   Closes an event.
+
+   @param[in]      Event         The event to close.
+
+   @retval EFI_SUCCESS           The event was closed.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+Ext4HostCloseEvent (
+  IN EFI_EVENT  Event
+  )
+{
+  FreePool (Event);
+  return EFI_SUCCESS;
+}
+
+/**
+   Installs protocol interfaces. Only the simple file system protocol is
+   recorded, so that the benchmark can reach the driver's volume.
+
+   @param[in out]  Handle        Pointer to the handle.
+   @param[in]      ...           NULL terminated list of protocol GUID and interface pairs.
+
+   @retval EFI_SUCCESS           The interfaces were installed.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+Ext4HostInstallMultipleProtocolInterfaces (
+  IN OUT EFI_HANDLE  *Handle,
+  ...
+  )
+{
+  VA_LIST   Args;
+  EFI_GUID  *Protocol;
+  VOID      *Interface;
+
+  VA_START (Args, Handle);
+
+  while (TRUE) {
+    Protocol = VA_ARG (Args, EFI_GUID *);
+
+    if (Protocol == NULL) {
+      break;
+    }
+
+    Interface = VA_ARG (Args, VOID *);
+
+    if (CompareGuid (Protocol, &gEfiSimpleFileSystemProtocolGuid)) {
+      mExt4HostFileSystem = Interface;
+    }
+  }
+
+  VA_END (Args);
+
+  return EFI_SUCCESS;
+}
+
+/**
+   Points gBS at the boot services stubs needed by the driver.
+**/
+VOID
+Ext4HostInstallBootServices (
+  VOID
+  )
+{
+  ZeroMem (&mExt4HostBootServices, sizeof (mExt4HostBootServices));
+
+  mExt4HostBootServices.Hdr.Signature                     = EFI_BOOT_SERVICES_SIGNATURE;
+  mExt4HostBootServices.Hdr.Revision                      = EFI_BOOT_SERVICES_REVISION;
+  mExt4HostBootServices.Hdr.HeaderSize                    = sizeof (mExt4HostBootServices);
+  mExt4HostBootServices.RaiseTPL                          = Ext4HostRaiseTpl;
+  mExt4HostBootServices.RestoreTPL                        = Ext4HostRestoreTpl;
+  mExt4HostBootServices.CreateEvent                       = Ext4HostCreateEvent;
+  mExt4HostBootServices.SignalEvent                       = Ext4HostSignalEvent;
+  mExt4HostBootServices.CheckEvent                        = Ext4HostCheckEvent;
+  mExt4HostBootServices.CloseEvent                        = Ext4HostCloseEvent;
+  mExt4HostBootServices.InstallMultipleProtocolInterfaces = Ext4HostInstallMultipleProtocolInterfaces;
+
+  gBS = &mExt4HostBootServices;
+}
+
+/**
+   Returns the EFI_SIMPLE_FILE_SYSTEM_PROTOCOL installed by the driver since the
+   last call, if any.
+
+   @return Pointer to the protocol, or NULL if none was installed.
+**/
+EFI_SIMPLE_FILE_SYSTEM_PROTOCOL *
+Ext4HostGetFileSystem (
+  VOID
+  )
+{
+  EFI_SIMPLE_FILE_SYSTEM_PROTOCOL  *FileSystem;
+
+  FileSystem          = mExt4HostFileSystem;
+  mExt4HostFileSystem = NULL;
+  return FileSystem;
+}
+
+/**
+   Copies data out of the disk image. The image only backs the start of the disk,
+   everything past it reads as zeroes.
+
+   @param[in]      Disk          Pointer to the disk.
+   @param[in]      MediaId       ID of the medium to read from.
+   @param[in]      Offset        Offset of the read, in bytes.
+   @param[in]      BufferSize    Length of the read, in bytes.
+   @param[out]     Buffer        Pointer to the destination buffer.
+
+   @retval EFI_SUCCESS           The data was read.
+   @retval EFI_MEDIA_CHANGED     MediaId is not the ID of the current medium.
+   @retval EFI_INVALID_PARAMETER The read goes past the end of the disk.
+**/
+STATIC
+EFI_STATUS
+Ext4HostReadImage (
+  IN  EXT4_HOST_DISK  *Disk,
+  IN  UINT32          MediaId,
+  IN  UINT64          Offset,
+  IN  UINTN           BufferSize,
+  OUT VOID            *Buffer
+  )
+{
+  UINTN  Backed;
+
+  if (MediaId != Disk->Media.MediaId) {
+    return EFI_MEDIA_CHANGED;
+  }
+
+  if ((Offset > EXT4_HOST_MEDIA_SIZE) || (BufferSize > EXT4_HOST_MEDIA_SIZE - Offset)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Backed = 0;
+
+  if (Offset < Disk->ImageSize) {
+    Backed = (UINTN)MIN (BufferSize, Disk->ImageSize - Offset);
+    CopyMem (Buffer, Disk->Image + Offset, Backed);
+  }
+
+  ZeroMem ((UINT8 *)Buffer + Backed, BufferSize - Backed);
+  return EFI_SUCCESS;
+}
+
+/**
+   EFI_DISK_IO_PROTOCOL.ReadDisk() over the in-memory image.
+
+   @param[in]      This          Pointer to the EFI_DISK_IO_PROTOCOL.
+   @param[in]      MediaId       ID of the medium to read from.
+   @param[in]      Offset        Offset of the read, in bytes.
+   @param[in]      BufferSize    Length of the read, in bytes.
+   @param[out]     Buffer        Pointer to the destination buffer.
+
+   @return Status of the read.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+Ext4HostReadDisk (
+  IN  EFI_DISK_IO_PROTOCOL  *This,
+  IN  UINT32                MediaId,
+  IN  UINT64                Offset,
+  IN  UINTN                 BufferSize,
+  OUT VOID                  *Buffer
+  )
+{
+  EXT4_HOST_DISK  *Disk;
+
+  Disk = EXT4_HOST_DISK_FROM_DISK_IO (This);
+
+  Disk->Stats.DiskReads++;
+  Disk->Stats.BytesRead += BufferSize;
+
+  return Ext4HostReadImage (Disk, MediaId, Offset, BufferSize, Buffer);
+}
+
+/**
+   EFI_DISK_IO2_PROTOCOL.ReadDiskEx() over the in-memory image. Requests complete
+   before returning; the token's event is signalled right away.
+
+   @param[in]      This          Pointer to the EFI_DISK_IO2_PROTOCOL.
+   @param[in]      MediaId       ID of the medium to read from.
+   @param[in]      Offset        Offset of the read, in bytes.
+   @param[in out]  Token         Pointer to the token, or NULL for a blocking read.
+   @param[in]      BufferSize    Length of the read, in bytes.
+   @param[out]     Buffer        Pointer to the destination buffer.
+
+   @return Status of the read.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+Ext4HostReadDiskEx (
+  IN     EFI_DISK_IO2_PROTOCOL  *This,
+  IN     UINT32                 MediaId,
+  IN     UINT64                 Offset,
+  IN OUT EFI_DISK_IO2_TOKEN     *Token,
+  IN     UINTN                  BufferSize,
+  OUT    VOID                   *Buffer
+  )
+{
+  EXT4_HOST_DISK  *Disk;
+  EFI_STATUS      Status;
+
+  Disk = EXT4_HOST_DISK_FROM_DISK_IO2 (This);
+
+  Disk->Stats.AsyncDiskReads++;
+  Disk->Stats.AsyncBytesRead += BufferSize;
+
+  Status = Ext4HostReadImage (Disk, MediaId, Offset, BufferSize, Buffer);
+
+  if ((Token == NULL) || (Token->Event == NULL)) {
+    return Status;
+  }
+
+  Token->TransactionStatus = Status;
+  return gBS->SignalEvent (Token->Event);
+}
+
+/**
+   Sets up an in-memory disk over an ext4 image.
+   The driver doesn't write, so the write entry points are left NULL.
+
+   @param[out]     Disk          Pointer to the disk.
+   @param[in]      Image         Pointer to the image.
+   @param[in]      ImageSize     Size of the image, in bytes.
+**/
+VOID
+Ext4HostInitDisk (
+  OUT EXT4_HOST_DISK  *Disk,
+  IN  UINT8           *Image,
+  IN  UINTN           ImageSize
+  )
+{
+  ZeroMem (Disk, sizeof (*Disk));
+
+  Disk->Image     = Image;
+  Disk->ImageSize = ImageSize;
+
+  Disk->Media.MediaId      = 1;
+  Disk->Media.MediaPresent = TRUE;
+  Disk->Media.ReadOnly     = TRUE;
+  Disk->Media.BlockSize    = EXT4_HOST_SECTOR_SIZE;
+  Disk->Media.IoAlign      = 1;
+  Disk->Media.LastBlock    = EXT4_HOST_MEDIA_SIZE / EXT4_HOST_SECTOR_SIZE - 1;
+
+  Disk->BlockIo.Revision = EFI_BLOCK_IO_PROTOCOL_REVISION;
+  Disk->BlockIo.Media    = &Disk->Media;
+
+  Disk->DiskIo.Revision    = EFI_DISK_IO_PROTOCOL_REVISION;
+  Disk->DiskIo.ReadDisk    = Ext4HostReadDisk;
+  Disk->DiskIo2.Revision   = EFI_DISK_IO2_PROTOCOL_REVISION;
+  Disk->DiskIo2.ReadDiskEx = Ext4HostReadDiskEx;
+}
+
+/**
+   Initialises Unicode collation. The benchmark has no
+   EFI_UNICODE_COLLATION_PROTOCOL, so this is a no-op.
+
+   @param[in]      DriverHandle    Handle to the driver image.
+
+   @retval EFI_SUCCESS   Unicode collation was successfully initialised.
+**/
+EFI_STATUS
+Ext4InitialiseUnicodeCollation (
+  EFI_HANDLE  DriverHandle
+  )
+{
+  return EFI_SUCCESS;
+}
+
+/**
+   Does a case-insensitive string comparison, folding case with BaseLib's
+   CharToUpper() instead of EFI_UNICODE_COLLATION_PROTOCOL.
+
+   @param[in]      Str1   Pointer to a null terminated string.
+   @param[in]      Str2   Pointer to a null terminated string.
+
+   @retval 0   Str1 is equivalent to Str2.
+   @retval >0  Str1 is lexically greater than Str2.
+   @retval <0  Str1 is lexically less than Str2.
+**/
+INTN
+Ext4StrCmpInsensitive (
+  IN CHAR16  *Str1,
+  IN CHAR16  *Str2
+  )
+{
+  while ((*Str1 != L'\0') && (CharToUpper (*Str1) == CharToUpper (*Str2))) {
+    Str1++;
+    Str2++;
+  }
+
+  return CharToUpper (*Str1) - CharToUpper (*Str2);
+}
@@ -0,0 +1,32 @@
+/** @file
+  CRC32C instruction support detection for X64
+
+  Copyright (c) 2021 - 2023 Pedro Falcato All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include "../Ext4Dxe.h"
+
+#include <Register/Intel/Cpuid.h>
+
+/**
+   Checks if the CPU supports the CRC32C instructions used by Ext4Crc32cHw.
+
+   @return TRUE if supported, FALSE otherwise.
+**/
+BOOLEAN
+Ext4Crc32cHwSupported (
+  VOID
+  )
+{
+  UINT32                  MaxLeaf;
+  CPUID_VERSION_INFO_ECX  Ecx;
+
+  AsmCpuid (CPUID_SIGNATURE, &MaxLeaf, NULL, NULL, NULL);
+  if (MaxLeaf < CPUID_VERSION_INFO) {
+    return FALSE;
+  }
+
+  AsmCpuid (CPUID_VERSION_INFO, NULL, NULL, &Ecx.Uint32, NULL);
+  return Ecx.Bits.SSE4_2 == 1;
+}
@@ -171,6 +171,17 @@ Returns:
     return Status;
   }
 
+  //
+  // Return the completion code as the only byte of response data, so that
+  // the caller can tell why the command failed.
+  //
+  if ((IpmiResponse->CompletionCode != COMP_CODE_NORMAL) &&
+      (ResponseData != NULL) && (*ResponseDataSize >= 1))
+  {
+    ResponseData[0]   = IpmiResponse->CompletionCode;
+    *ResponseDataSize = 1;
+  }
+
   if ((IpmiResponse->CompletionCode != COMP_CODE_NORMAL) &&
       (IpmiInstance->BmcStatus == BMC_UPDATE_IN_PROGRESS))
   {
@@ -106,157 +106,245 @@ EfiGetFruSlotInfo (
 }
 
 /**
-  Get Fru Redir Data.
+  Read FRU inventory data of a FRU device from BMC.
 
-  @param This
-  @param FruSlotNumber
-  @param FruDataOffset
-  @param FruDataSize
-  @param FruData
+  The data is read in fragments of the FRU device's ReadFragmentSize bytes.
+  ReadFragmentSize starts from IPMI_RDWR_FRU_MAX_FRAGMENT_SIZE and is halved
+  each time the BMC completes a read with
+  IPMI_FRU_COMP_CODE_CANNOT_RETURN_REQ_LENGTH, so the largest fragment size
+  supported for the device is found on its first read and kept for the later
+  reads. Any other error fails the read without touching the fragment size.
 
-  EFI_STATUS
+  @param FruDeviceInfo  - Pointer to the FRU device information.
+  @param Offset         - Offset in the FRU inventory area.
+  @param Size           - Number of bytes to read.
+  @param Buffer         - Buffer to receive the FRU data.
+
+  @retval EFI_SUCCESS    - The FRU data is read.
+  @retval EFI_NOT_FOUND  - No FRU data is returned by BMC.
+  @retval Others         - IpmiSubmitCommand failed.
 
 **/
 EFI_STATUS
-EFIAPI
-EfiGetFruRedirData (
-  IN EFI_SM_FRU_REDIR_PROTOCOL  *This,
-  IN UINTN                      FruSlotNumber,
-  IN UINTN                      FruDataOffset,
-  IN UINTN                      FruDataSize,
-  IN UINT8                      *FruData
+IpmiReadFruInventory (
+  IN  EFI_FRU_DEVICE_INFO  *FruDeviceInfo,
+  IN  UINTN                Offset,
+  IN  UINTN                Size,
+  OUT UINT8                *Buffer
   )
 {
-  EFI_IPMI_FRU_GLOBAL          *FruPrivate;
+  EFI_STATUS                   Status;
   UINT32                       ResponseDataSize;
-  UINT8                        BackupCount;
-  UINT8                        PointerOffset;
   UINT8                        DataToCopySize;
-  EFI_STATUS                   Status = EFI_SUCCESS;
   IPMI_READ_FRU_DATA_REQUEST   ReadFruDataRequest;
   IPMI_READ_FRU_DATA_RESPONSE  *ReadFruDataResponse;
+  UINT8                        ResponseBuffer[sizeof (IPMI_READ_FRU_DATA_RESPONSE) + IPMI_RDWR_FRU_MAX_FRAGMENT_SIZE];
 
-  FruPrivate    = NULL;
-  PointerOffset = 0;
-
-  FruPrivate = INSTANCE_FROM_EFI_SM_IPMI_FRU_THIS (This);
+  ReadFruDataResponse         = (IPMI_READ_FRU_DATA_RESPONSE *)ResponseBuffer;
+  ReadFruDataRequest.DeviceId = (UINT8)FruDeviceInfo->FruDevice.Bits.FruDeviceId;
 
-  if ((FruSlotNumber + 1) > FruPrivate->NumSlots) {
-    Status = EFI_NO_MAPPING;
-    return Status;
-  }
-
-  if (FruSlotNumber >= sizeof (FruPrivate->FruDeviceInfo) / sizeof (EFI_FRU_DEVICE_INFO)) {
-    Status = EFI_INVALID_PARAMETER;
-    return Status;
-  }
+  //
+  // Collect the data till it is completely retrieved.
+  //
+  while (Size != 0) {
+    ReadFruDataRequest.InventoryOffset = (UINT16)Offset;
+    ReadFruDataRequest.CountToRead     = (UINT8)MIN (Size, FruDeviceInfo->ReadFragmentSize);
 
-  if (FruPrivate->FruDeviceInfo[FruSlotNumber].FruDevice.Bits.LogicalFruDevice) {
     //
-    // Create the FRU Read Command for the logical FRU Device.
+    // The transport returns the completion code as the first byte of the
+    // response data, also when the command fails.
     //
-    ReadFruDataRequest.DeviceId        = FruPrivate->FruDeviceInfo[FruSlotNumber].FruDevice.Bits.FruDeviceId;
-    ReadFruDataRequest.InventoryOffset = (UINT16)FruDataOffset;
-    ReadFruDataRequest.CountToRead     = (UINT8)FruDataSize;
+    ReadFruDataResponse->CompletionCode = IPMI_COMP_CODE_NORMAL;
+    ResponseDataSize                    = sizeof (IPMI_READ_FRU_DATA_RESPONSE) + ReadFruDataRequest.CountToRead;
+    Status                              = IpmiSubmitCommand (
+                                            IPMI_NETFN_STORAGE,
+                                            IPMI_STORAGE_READ_FRU_DATA,
+                                            (UINT8 *)&ReadFruDataRequest,
+                                            sizeof (ReadFruDataRequest),
+                                            (UINT8 *)ReadFruDataResponse,
+                                            &ResponseDataSize
+                                            );
+    if ((ResponseDataSize >= 1) &&
+        (ReadFruDataResponse->CompletionCode == IPMI_FRU_COMP_CODE_CANNOT_RETURN_REQ_LENGTH))
+    {
+      if (FruDeviceInfo->ReadFragmentSize > IPMI_RDWR_FRU_FRAGMENT_SIZE) {
+        //
+        // The BMC can't return the requested number of bytes, retry with a
+        // smaller fragment.
+        //
+        FruDeviceInfo->ReadFragmentSize = FruDeviceInfo->ReadFragmentSize / 2;
+        DEBUG ((
+          DEBUG_WARN,
+          "%a: Reduce FRU device 0x%x read fragment size to 0x%x\n",
+          __func__,
+          ReadFruDataRequest.DeviceId,
+          FruDeviceInfo->ReadFragmentSize
+          ));
+        continue;
+      }
 
-    ReadFruDataResponse = AllocateZeroPool (sizeof (ReadFruDataResponse) + IPMI_RDWR_FRU_FRAGMENT_SIZE);
+      if (!EFI_ERROR (Status)) {
+        Status = EFI_DEVICE_ERROR;
+      }
+    }
 
-    if (ReadFruDataResponse == NULL) {
-      DEBUG ((DEBUG_ERROR, " Null Pointer returned by AllocateZeroPool to Read Fru data\n"));
-      return EFI_OUT_OF_RESOURCES;
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a: IpmiSubmitCommand returned status %r\n", __func__, Status));
+      return Status;
     }
 
     //
-    // Collect the data till it is completely retrieved.
+    // If the read FRU command returns a count of 0, then no FRU data was found, so exit.
     //
-    while (ReadFruDataRequest.CountToRead != 0) {
-      //
-      // Backup the count, since we are going to perform fragmented reads
-      //
-      BackupCount = ReadFruDataRequest.CountToRead;
-      if (ReadFruDataRequest.CountToRead > IPMI_RDWR_FRU_FRAGMENT_SIZE) {
-        ReadFruDataRequest.CountToRead = IPMI_RDWR_FRU_FRAGMENT_SIZE;
-      }
+    if (ReadFruDataResponse->CountReturned == 0x00) {
+      DEBUG ((DEBUG_ERROR, "%a: IpmiSubmitCommand Response data size is 0x0\n", __func__));
+      return EFI_NOT_FOUND;
+    }
 
-      ResponseDataSize = sizeof (ReadFruDataResponse) + ReadFruDataRequest.CountToRead;
+    //
+    // In case of partial retrieval; CountReturned contains the retrieved data size;
+    //
+    DataToCopySize = MIN (ReadFruDataResponse->CountReturned, ReadFruDataRequest.CountToRead);
+    CopyMem (Buffer, &ReadFruDataResponse->Data[0], DataToCopySize);
+    Buffer += DataToCopySize;
+    Offset += DataToCopySize;
+    Size   -= DataToCopySize;
+  }
 
-      Status = IpmiSubmitCommand (
-                 IPMI_NETFN_STORAGE,
-                 IPMI_STORAGE_READ_FRU_DATA,
-                 (UINT8 *)&ReadFruDataRequest,
-                 sizeof (ReadFruDataRequest),
-                 (UINT8 *)ReadFruDataResponse,
-                 &ResponseDataSize
-                 );
+  return EFI_SUCCESS;
+}
 
-      if (Status == EFI_BUFFER_TOO_SMALL) {
-        DEBUG ((DEBUG_WARN, "%a: WARNING:: IpmiSubmitCommand returned EFI_BUFFER_TOO_SMALL \n", __func__));
-      }
+/**
+  Read the whole FRU inventory area of a FRU slot into the cache, unless it
+  is cached already.
 
-      if (EFI_ERROR (Status)) {
-        DEBUG ((DEBUG_ERROR, "%a: IpmiSubmitCommand returned status %r\n", __func__, Status));
-        FreePool (ReadFruDataResponse);
-        return Status;
-      }
+  @param FruPrivate     - Pointer to the FRU driver private data.
+  @param FruSlotNumber  - FRU slot number.
 
-      //
-      // If the read FRU command returns a count of 0, then no FRU data was found, so exit.
-      //
-      if (ReadFruDataResponse->CountReturned == 0x00) {
-        Status = EFI_NOT_FOUND;
-        DEBUG ((DEBUG_ERROR, "%a: IpmiSubmitCommand Response data size is 0x0\n", __func__));
-        FreePool (ReadFruDataResponse);
-        return Status;
-      }
+  @retval EFI_SUCCESS   - The FRU inventory area is cached.
+  @retval Others        - Failed to read the FRU inventory area.
 
-      ReadFruDataRequest.CountToRead = BackupCount;
+**/
+EFI_STATUS
+IpmiCacheFruImage (
+  IN EFI_IPMI_FRU_GLOBAL  *FruPrivate,
+  IN UINTN                FruSlotNumber
+  )
+{
+  EFI_STATUS                                 Status;
+  EFI_FRU_DEVICE_INFO                        *FruDeviceInfo;
+  UINT32                                     ResponseDataSize;
+  IPMI_GET_FRU_INVENTORY_AREA_INFO_REQUEST   GetFruInventoryAreaInfoRequest;
+  IPMI_GET_FRU_INVENTORY_AREA_INFO_RESPONSE  GetFruInventoryAreaInfoResponse;
+  UINT8                                      *FruImage;
+
+  FruDeviceInfo = &FruPrivate->FruDeviceInfo[FruSlotNumber];
+  if (FruDeviceInfo->FruImage != NULL) {
+    return EFI_SUCCESS;
+  }
 
-      //
-      // In case of partial retrieval; Data[0] contains the retrieved data size;
-      //
-      if (ReadFruDataRequest.CountToRead >= ReadFruDataResponse->CountReturned) {
-        DataToCopySize                 = ReadFruDataResponse->CountReturned;
-        ReadFruDataRequest.CountToRead = (UINT8)(ReadFruDataRequest.CountToRead - ReadFruDataResponse->CountReturned);   // Remaining Count
-      } else {
-        DEBUG ((
-          DEBUG_WARN,
-          "%a: WARNING Command.Count (%d) is less than response data size (%d) received\n",
-          __func__,
-          ReadFruDataRequest.CountToRead,
-          ReadFruDataResponse->CountReturned
-          ));
-        DataToCopySize                 = ReadFruDataRequest.CountToRead;
-        ReadFruDataRequest.CountToRead = 0;  // Remaining Count
-      }
+  GetFruInventoryAreaInfoRequest.DeviceId = (UINT8)FruDeviceInfo->FruDevice.Bits.FruDeviceId;
+  ResponseDataSize                        = sizeof (GetFruInventoryAreaInfoResponse);
+  Status                                  = IpmiSubmitCommand (
+                                              IPMI_NETFN_STORAGE,
+                                              IPMI_STORAGE_GET_FRU_INVENTORY_AREAINFO,
+                                              (UINT8 *)&GetFruInventoryAreaInfoRequest,
+                                              sizeof (GetFruInventoryAreaInfoRequest),
+                                              (UINT8 *)&GetFruInventoryAreaInfoResponse,
+                                              &ResponseDataSize
+                                              );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
 
-      ReadFruDataRequest.InventoryOffset = (UINT16)(ReadFruDataRequest.InventoryOffset + DataToCopySize);   // Next Offset to retrieve
+  if (GetFruInventoryAreaInfoResponse.InventoryAreaSize == 0) {
+    return EFI_NOT_FOUND;
+  }
 
-      if (PointerOffset + DataToCopySize > FruDataSize) {
-        DEBUG ((
-          DEBUG_ERROR,
-          "Insufficient storage supplied to %a, need more than % bytes\n",
-          __func__,
-          PointerOffset + DataToCopySize
-          ));
-        Status = EFI_BUFFER_TOO_SMALL;
-        FreePool (ReadFruDataResponse);
-        return Status;
-      }
+  FruImage = AllocatePool (GetFruInventoryAreaInfoResponse.InventoryAreaSize);
+  if (FruImage == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = IpmiReadFruInventory (
+             FruDeviceInfo,
+             0,
+             GetFruInventoryAreaInfoResponse.InventoryAreaSize,
+             FruImage
+             );
+  if (EFI_ERROR (Status)) {
+    FreePool (FruImage);
+    return Status;
+  }
 
-      ASSERT (PointerOffset < FruDataSize);
-      ASSERT (PointerOffset + DataToCopySize <= FruDataSize);
+  FruDeviceInfo->FruImage     = FruImage;
+  FruDeviceInfo->FruImageSize = GetFruInventoryAreaInfoResponse.InventoryAreaSize;
+  return EFI_SUCCESS;
+}
 
-      CopyMem (&FruData[PointerOffset], &ReadFruDataResponse->Data[0], DataToCopySize); // Copy the partial data
-      PointerOffset = (UINT8)(PointerOffset + DataToCopySize);                          // Next offset to the iput pointer.
-    }
+/**
+  Get Fru Redir Data.
 
-    FreePool (ReadFruDataResponse);
-  } else {
-    Status = EFI_UNSUPPORTED;
-    return Status;
+  The whole FRU inventory area is read on the first access and the data is
+  returned from the cache afterwards.
+
+  @param This
+  @param FruSlotNumber
+  @param FruDataOffset
+  @param FruDataSize
+  @param FruData
+
+  EFI_STATUS
+
+**/
+EFI_STATUS
+EFIAPI
+EfiGetFruRedirData (
+  IN EFI_SM_FRU_REDIR_PROTOCOL  *This,
+  IN UINTN                      FruSlotNumber,
+  IN UINTN                      FruDataOffset,
+  IN UINTN                      FruDataSize,
+  IN UINT8                      *FruData
+  )
+{
+  EFI_IPMI_FRU_GLOBAL  *FruPrivate;
+  EFI_FRU_DEVICE_INFO  *FruDeviceInfo;
+  EFI_STATUS           Status;
+
+  FruPrivate = INSTANCE_FROM_EFI_SM_IPMI_FRU_THIS (This);
+
+  if ((FruSlotNumber + 1) > FruPrivate->NumSlots) {
+    return EFI_NO_MAPPING;
+  }
+
+  if (FruSlotNumber >= sizeof (FruPrivate->FruDeviceInfo) / sizeof (EFI_FRU_DEVICE_INFO)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  FruDeviceInfo = &FruPrivate->FruDeviceInfo[FruSlotNumber];
+  if (!FruDeviceInfo->FruDevice.Bits.LogicalFruDevice) {
+    return EFI_UNSUPPORTED;
   }
 
-  return Status;
+  Status = IpmiCacheFruImage (FruPrivate, FruSlotNumber);
+  if (!EFI_ERROR (Status) &&
+      (FruDataOffset <= FruDeviceInfo->FruImageSize) &&
+      (FruDataSize <= FruDeviceInfo->FruImageSize - FruDataOffset))
+  {
+    CopyMem (FruData, &FruDeviceInfo->FruImage[FruDataOffset], FruDataSize);
+    return EFI_SUCCESS;
+  }
+
+  //
+  // Read from BMC directly if the FRU inventory area can't be cached or the
+  // request is out of its range.
+  //
+  return IpmiReadFruInventory (
+           FruDeviceInfo,
+           FruDataOffset,
+           FruDataSize,
+           FruData
+           );
 }
 
 /**
@@ -305,6 +393,15 @@ EfiSetFruRedirData (
   }
 
   if (FruPrivate->FruDeviceInfo[FruSlotNumber].FruDevice.Bits.LogicalFruDevice) {
+    //
+    // Invalidate the cached FRU inventory area.
+    //
+    if (FruPrivate->FruDeviceInfo[FruSlotNumber].FruImage != NULL) {
+      FreePool (FruPrivate->FruDeviceInfo[FruSlotNumber].FruImage);
+      FruPrivate->FruDeviceInfo[FruSlotNumber].FruImage     = NULL;
+      FruPrivate->FruDeviceInfo[FruSlotNumber].FruImageSize = 0;
+    }
+
     WriteFruDataRequest = AllocateZeroPool (sizeof (IPMI_WRITE_FRU_DATA_REQUEST) + IPMI_RDWR_FRU_FRAGMENT_SIZE);
 
     if (WriteFruDataRequest == NULL) {
@@ -409,7 +506,7 @@ InitializeSmRedirFruLayer (
   //
   // Initialize Global memory
   //
-  mIpmiFruGlobal = AllocateRuntimePool (sizeof (EFI_IPMI_FRU_GLOBAL));
+  mIpmiFruGlobal = AllocateRuntimeZeroPool (sizeof (EFI_IPMI_FRU_GLOBAL));
   ASSERT (mIpmiFruGlobal != NULL);
   if (mIpmiFruGlobal == NULL) {
     return EFI_OUT_OF_RESOURCES;
@@ -450,6 +547,7 @@ InitializeSmRedirFruLayer (
       ZeroMem (&mIpmiFruGlobal->FruDeviceInfo[mIpmiFruGlobal->NumSlots].FruDevice, sizeof (IPMI_FRU_DATA_INFO));
       mIpmiFruGlobal->FruDeviceInfo[mIpmiFruGlobal->NumSlots].FruDevice.Bits.LogicalFruDevice = 1;
       mIpmiFruGlobal->FruDeviceInfo[mIpmiFruGlobal->NumSlots].FruDevice.Bits.FruDeviceId      = mIpmiFruGlobal->NumSlots;
+      mIpmiFruGlobal->FruDeviceInfo[mIpmiFruGlobal->NumSlots].ReadFragmentSize                = IPMI_RDWR_FRU_MAX_FRAGMENT_SIZE;
     }
   }
 
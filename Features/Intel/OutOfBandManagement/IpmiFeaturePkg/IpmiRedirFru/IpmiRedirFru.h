@@ -31,6 +31,19 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #define IPMI_RDWR_FRU_FRAGMENT_SIZE  0x10
 
+//
+// FRU data is read in fragments of this size first. The fragment size of a
+// FRU device is halved down to IPMI_RDWR_FRU_FRAGMENT_SIZE when the BMC
+// returns IPMI_FRU_COMP_CODE_CANNOT_RETURN_REQ_LENGTH for it.
+//
+#define IPMI_RDWR_FRU_MAX_FRAGMENT_SIZE  0x80
+
+//
+// Completion code of Read FRU Data command if the BMC cannot return the
+// number of requested data bytes.
+//
+#define IPMI_FRU_COMP_CODE_CANNOT_RETURN_REQ_LENGTH  0xCA
+
 #define CHASSIS_TYPE_LENGTH  1
 #define CHASSIS_TYPE_OFFSET  2
 #define CHASSIS_PART_NUMBER  3
@@ -66,6 +79,9 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 typedef struct {
   BOOLEAN               Valid;
   IPMI_FRU_DATA_INFO    FruDevice;
+  UINT8                 *FruImage;        // The cached FRU inventory area, NULL if not read.
+  UINT16                FruImageSize;
+  UINT8                 ReadFragmentSize; // Largest fragment the BMC returns for this FRU device.
 } EFI_FRU_DEVICE_INFO;
 
 typedef struct {
@@ -0,0 +1,108 @@
+/** @file
+
+  This file defines the manageability request queue library and functions.
+
+  A request queue serializes the requests of a manageability protocol on its
+  transport interface. Requests can be submitted without waiting for the
+  response, the queue drains them in FIFO order from a timer event and signals
+  the event of each request on completion. The synchronous requests are run
+  after all of the pending requests, so the requests complete in the order
+  they are submitted.
+
+  Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#ifndef MANAGEABILITY_REQUEST_QUEUE_LIB_H_
+#define MANAGEABILITY_REQUEST_QUEUE_LIB_H_
+
+typedef struct _MANAGEABILITY_REQUEST_QUEUE MANAGEABILITY_REQUEST_QUEUE;
+
+/**
+  This function runs one request of the manageability protocol.
+
+  @param[in]  Request         The protocol specific request given to
+                              ManageabilityRequestQueueSubmit or
+                              ManageabilityRequestQueueRun.
+
+  @retval     EFI_STATUS      The status of the request.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *MANAGEABILITY_REQUEST_HANDLER)(
+  IN  VOID  *Request
+  );
+
+/**
+  This function creates a request queue.
+
+  @param[in]   Handler                The function runs the requests.
+  @param[out]  Queue                  Pointer to receive the request queue.
+
+  @retval      EFI_SUCCESS            The request queue is created.
+  @retval      EFI_INVALID_PARAMETER  Handler or Queue is NULL.
+  @retval      EFI_OUT_OF_RESOURCES   Out of resource to create the queue.
+  @retval      Otherwise              Failed to create the timer event.
+**/
+EFI_STATUS
+ManageabilityRequestQueueCreate (
+  IN  MANAGEABILITY_REQUEST_HANDLER  Handler,
+  OUT MANAGEABILITY_REQUEST_QUEUE    **Queue
+  );
+
+/**
+  This function destroys a request queue. The pending requests are completed
+  with EFI_ABORTED.
+
+  @param[in]  Queue           The request queue.
+**/
+VOID
+ManageabilityRequestQueueDestroy (
+  IN  MANAGEABILITY_REQUEST_QUEUE  *Queue
+  );
+
+/**
+  This function queues a request without waiting for its completion.
+
+  When the request completes, its status is returned in TransferStatus, the
+  time from the submission to the completion is returned in Latency and Event
+  is signaled. Request, TransferStatus and Latency must stay valid until then.
+
+  @param[in]   Queue                  The request queue.
+  @param[in]   Request                The protocol specific request.
+  @param[in]   Event                  The event signaled on completion.
+  @param[out]  TransferStatus         Pointer to receive the status of request.
+  @param[out]  Latency                Pointer to receive the completion latency
+                                      in microsecond.
+
+  @retval      EFI_SUCCESS            The request is queued.
+  @retval      EFI_INVALID_PARAMETER  One of the given parameter is incorrect.
+  @retval      EFI_OUT_OF_RESOURCES   Out of resource to queue the request.
+**/
+EFI_STATUS
+ManageabilityRequestQueueSubmit (
+  IN  MANAGEABILITY_REQUEST_QUEUE  *Queue,
+  IN  VOID                         *Request,
+  IN  EFI_EVENT                    Event,
+  OUT EFI_STATUS                   *TransferStatus,
+  OUT UINT64                       *Latency
+  );
+
+/**
+  This function runs a request after all of the pending requests in the
+  queue and waits for its completion.
+
+  @param[in]  Queue           The request queue.
+  @param[in]  Request         The protocol specific request.
+
+  @retval     EFI_NOT_READY   The queue is busy on a request and the caller
+                              runs at a TPL above TPL_CALLBACK.
+  @retval     Otherwise       The status of the request.
+**/
+EFI_STATUS
+ManageabilityRequestQueueRun (
+  IN  MANAGEABILITY_REQUEST_QUEUE  *Queue,
+  IN  VOID                         *Request
+  );
+
+#endif
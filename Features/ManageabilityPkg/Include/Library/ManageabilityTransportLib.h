@@ -13,11 +13,29 @@
 #define MANAGEABILITY_TRANSPORT_TOKEN_VERSION_MINOR  0
 #define MANAGEABILITY_TRANSPORT_TOKEN_VERSION        ((MANAGEABILITY_TRANSPORT_TOKEN_VERSION_MAJOR << 8) |\
                                                 MANAGEABILITY_TRANSPORT_TOKEN_VERSION_MINOR)
+///
+/// The transport version of the transport interface that provides
+/// MANAGEABILITY_TRANSPORT_FUNCTION_V1_1.
+///
+#define MANAGEABILITY_TRANSPORT_TOKEN_VERSION_1_1  ((1 << 8) | 1)
+///
+/// The transport version of the transport interface that provides
+/// MANAGEABILITY_TRANSPORT_FUNCTION_V1_2.
+///
+#define MANAGEABILITY_TRANSPORT_TOKEN_VERSION_1_2  ((1 << 8) | 2)
+///
+/// The transport version of the transport interface that provides
+/// MANAGEABILITY_TRANSPORT_FUNCTION_V1_3.
+///
+#define MANAGEABILITY_TRANSPORT_TOKEN_VERSION_1_3  ((1 << 8) | 3)
 
 #define MANAGEABILITY_TRANSPORT_PAYLOAD_SIZE_FROM_CAPABILITY(a)  (1 << ((a & MANAGEABILITY_TRANSPORT_CAPABILITY_MAXIMUM_PAYLOAD_MASK) >>\
            MANAGEABILITY_TRANSPORT_CAPABILITY_MAXIMUM_PAYLOAD_BIT_POSITION))
 
 typedef struct  _MANAGEABILITY_TRANSPORT_FUNCTION_V1_0  MANAGEABILITY_TRANSPORT_FUNCTION_V1_0;
+typedef struct  _MANAGEABILITY_TRANSPORT_FUNCTION_V1_1  MANAGEABILITY_TRANSPORT_FUNCTION_V1_1;
+typedef struct  _MANAGEABILITY_TRANSPORT_FUNCTION_V1_2  MANAGEABILITY_TRANSPORT_FUNCTION_V1_2;
+typedef struct  _MANAGEABILITY_TRANSPORT_FUNCTION_V1_3  MANAGEABILITY_TRANSPORT_FUNCTION_V1_3;
 typedef struct  _MANAGEABILITY_TRANSPORT                MANAGEABILITY_TRANSPORT;
 typedef struct  _MANAGEABILITY_TRANSPORT_TOKEN          MANAGEABILITY_TRANSPORT_TOKEN;
 typedef struct  _MANAGEABILITY_TRANSFER_TOKEN           MANAGEABILITY_TRANSFER_TOKEN;
@@ -68,6 +86,28 @@ typedef UINT32 MANAGEABILITY_TRANSPORT_ADDITIONAL_STATUS;
 #define MANAGEABILITY_TRANSPORT_ADDITIONAL_STATUS_INVALID_COMMAND  0x00000008
 #define MANAGEABILITY_TRANSPORT_ADDITIONAL_STATUS_NOT_AVAILABLE    0xffffffff
 
+///
+/// Transport interface statistics.
+///
+/// Both histograms use power-of-two buckets. Bucket 0 counts the zero
+/// values, bucket n (n > 0) counts the values in [2^(n-1), 2^n), and the last
+/// bucket also counts everything above its range.
+///
+#define MANAGEABILITY_TRANSPORT_LATENCY_BUCKETS  24
+#define MANAGEABILITY_TRANSPORT_RETRY_BUCKETS    16
+
+typedef struct {
+  UINT64    CommandCount;                                                ///< Number of transferred commands.
+  UINT64    ErrorCount;                                                  ///< Number of commands that failed.
+  UINT64    TotalLatencyInMicrosecond;                                   ///< Sum of all command latencies.
+  UINT64    MaxLatencyInMicrosecond;                                     ///< The longest command latency.
+  UINT64    TotalRetries;                                                ///< Sum of all command retries.
+  UINT64    LatencyHistogram[MANAGEABILITY_TRANSPORT_LATENCY_BUCKETS];   ///< Command latency in microsecond.
+  UINT64    RetryHistogram[MANAGEABILITY_TRANSPORT_RETRY_BUCKETS];       ///< Number of times a command had to
+                                                                         ///< back off and wait for the transport
+                                                                         ///< interface.
+} MANAGEABILITY_TRANSPORT_STATISTICS;
+
 ///
 /// Additional transport interface features.
 ///
@@ -97,6 +137,9 @@ typedef UINT32 MANAGEABILITY_TRANSPORT_CAPABILITY;
 ///
 typedef union {
   MANAGEABILITY_TRANSPORT_FUNCTION_V1_0    *Version1_0;
+  MANAGEABILITY_TRANSPORT_FUNCTION_V1_1    *Version1_1;
+  MANAGEABILITY_TRANSPORT_FUNCTION_V1_2    *Version1_2;
+  MANAGEABILITY_TRANSPORT_FUNCTION_V1_3    *Version1_3;
 } MANAGEABILITY_TRANSPORT_FUNCTION;
 
 ///
@@ -116,6 +159,14 @@ typedef struct {
   UINT32    TransmitTimeoutInMillisecond;
 } MANAGEABILITY_TRANSMIT_PACKAGE;
 
+///
+/// One element of the scatter-gather list sent to transport interface.
+///
+typedef struct {
+  UINT8     *Buffer;
+  UINT32    SizeInByte;
+} MANAGEABILITY_TRANSMIT_VECTOR;
+
 typedef struct {
   UINT8     *ReceiveBuffer;
   UINT32    ReceiveSizeInByte;
@@ -353,4 +404,150 @@ struct _MANAGEABILITY_TRANSPORT_FUNCTION_V1_0 {
                                                                         ///< response back.
 };
 
+/**
+  This function returns the statistics collected by the transport interface.
+
+  @param [in]   TransportToken           The transport token acquired through
+                                         AcquireTransportSession function.
+  @param [out]  Statistics               Pointer to receive the statistics.
+  @param [in]   Reset                    TRUE to clear the statistics after
+                                         they are returned.
+
+  @retval      EFI_SUCCESS              The statistics are returned.
+  @retval      EFI_INVALID_PARAMETER    The invalid transport token or
+                                        Statistics is NULL.
+  @retval      EFI_UNSUPPORTED          The transport interface doesn't collect
+                                        statistics.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *MANAGEABILITY_TRANSPORT_GET_STATISTICS)(
+  IN  MANAGEABILITY_TRANSPORT_TOKEN       *TransportToken,
+  OUT MANAGEABILITY_TRANSPORT_STATISTICS  *Statistics,
+  IN  BOOLEAN                             Reset
+  );
+
+///
+/// The second version of Manageability transport interface function.
+/// TransportVersion of the transport interface is
+/// MANAGEABILITY_TRANSPORT_TOKEN_VERSION_1_1 or above.
+///
+struct _MANAGEABILITY_TRANSPORT_FUNCTION_V1_1 {
+  MANAGEABILITY_TRANSPORT_INIT                TransportInit;            ///< Initial the transport.
+  MANAGEABILITY_TRANSPORT_STATUS              TransportStatus;          ///< Get the transport status.
+  MANAGEABILITY_TRANSPORT_RESET               TransportReset;           ///< Reset the transport.
+  MANAGEABILITY_TRANSPORT_TRANSMIT_RECEIVE    TransportTransmitReceive; ///< Transmit the packet over
+                                                                        ///< transport and get the
+                                                                        ///< response back.
+  MANAGEABILITY_TRANSPORT_GET_STATISTICS      TransportGetStatistics;   ///< Get the transport statistics.
+};
+
+/**
+  This function transmits one packet over target transport interface without
+  receiving the response. The packet is the concatenation of the elements in
+  the scatter-gather list, which is sent in order without being copied to an
+  intermediate buffer. The transport-specific header and trailer are given as
+  the elements of the list.
+
+  @param [in]   TransportToken             The transport token acquired through
+                                           AcquireTransportSession function.
+  @param [in]   Vector                     The scatter-gather list of packet.
+  @param [in]   NumberOfVectors            Number of elements in Vector.
+  @param [out]  TransportAdditionalStatus  The additional status of transport
+                                           interface.
+
+  @retval      EFI_SUCCESS              The packet is transmitted.
+  @retval      EFI_INVALID_PARAMETER    The invalid transport token or
+                                        scatter-gather list.
+  @retval      EFI_NOT_READY            The transport interface is not ready.
+  @retval      EFI_TIMEOUT              The transmission is time out.
+  @retval      Otherwise                Other errors.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *MANAGEABILITY_TRANSPORT_TRANSMIT_VECTOR)(
+  IN  MANAGEABILITY_TRANSPORT_TOKEN               *TransportToken,
+  IN  MANAGEABILITY_TRANSMIT_VECTOR               *Vector,
+  IN  UINT16                                      NumberOfVectors,
+  OUT MANAGEABILITY_TRANSPORT_ADDITIONAL_STATUS   *TransportAdditionalStatus
+  );
+
+///
+/// The third version of Manageability transport interface function.
+/// TransportVersion of the transport interface is
+/// MANAGEABILITY_TRANSPORT_TOKEN_VERSION_1_2 or above.
+///
+struct _MANAGEABILITY_TRANSPORT_FUNCTION_V1_2 {
+  MANAGEABILITY_TRANSPORT_INIT                TransportInit;            ///< Initial the transport.
+  MANAGEABILITY_TRANSPORT_STATUS              TransportStatus;          ///< Get the transport status.
+  MANAGEABILITY_TRANSPORT_RESET               TransportReset;           ///< Reset the transport.
+  MANAGEABILITY_TRANSPORT_TRANSMIT_RECEIVE    TransportTransmitReceive; ///< Transmit the packet over
+                                                                        ///< transport and get the
+                                                                        ///< response back.
+  MANAGEABILITY_TRANSPORT_GET_STATISTICS      TransportGetStatistics;   ///< Get the transport statistics.
+  MANAGEABILITY_TRANSPORT_TRANSMIT_VECTOR     TransportTransmitVector;  ///< Transmit the packet given in
+                                                                        ///< scatter-gather list.
+};
+
+/**
+  This function locks the transport interface for the transport session.
+  The transport interface may be shared by the sessions of other manageability
+  protocols. The lock keeps the transfers of other sessions off the transport
+  interface, so that a message made of several transfers, e.g. the packets of
+  a MCTP message and the read of its response, is not interleaved with them.
+
+  The lock is recursive, each successful call must be paired with a call to
+  MANAGEABILITY_TRANSPORT_UNLOCK.
+
+  @param [in]   TransportToken          The transport token acquired through
+                                        AcquireTransportSession function.
+
+  @retval      EFI_SUCCESS              The transport interface is locked.
+  @retval      EFI_INVALID_PARAMETER    The invalid transport token.
+  @retval      EFI_NOT_READY            The transport interface is locked by
+                                        another transport session.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *MANAGEABILITY_TRANSPORT_LOCK)(
+  IN  MANAGEABILITY_TRANSPORT_TOKEN  *TransportToken
+  );
+
+/**
+  This function unlocks the transport interface locked through
+  MANAGEABILITY_TRANSPORT_LOCK.
+
+  @param [in]   TransportToken          The transport token acquired through
+                                        AcquireTransportSession function.
+
+**/
+typedef
+VOID
+(EFIAPI *MANAGEABILITY_TRANSPORT_UNLOCK)(
+  IN  MANAGEABILITY_TRANSPORT_TOKEN  *TransportToken
+  );
+
+///
+/// The fourth version of Manageability transport interface function.
+/// TransportVersion of the transport interface is
+/// MANAGEABILITY_TRANSPORT_TOKEN_VERSION_1_3 or above.
+///
+struct _MANAGEABILITY_TRANSPORT_FUNCTION_V1_3 {
+  MANAGEABILITY_TRANSPORT_INIT                TransportInit;            ///< Initial the transport.
+  MANAGEABILITY_TRANSPORT_STATUS              TransportStatus;          ///< Get the transport status.
+  MANAGEABILITY_TRANSPORT_RESET               TransportReset;           ///< Reset the transport.
+  MANAGEABILITY_TRANSPORT_TRANSMIT_RECEIVE    TransportTransmitReceive; ///< Transmit the packet over
+                                                                        ///< transport and get the
+                                                                        ///< response back.
+  MANAGEABILITY_TRANSPORT_GET_STATISTICS      TransportGetStatistics;   ///< Get the transport statistics.
+  MANAGEABILITY_TRANSPORT_TRANSMIT_VECTOR     TransportTransmitVector;  ///< Transmit the packet given in
+                                                                        ///< scatter-gather list.
+  MANAGEABILITY_TRANSPORT_LOCK                TransportLock;            ///< Lock the transport for the
+                                                                        ///< session.
+  MANAGEABILITY_TRANSPORT_UNLOCK              TransportUnlock;          ///< Unlock the transport.
+};
+
 #endif
@@ -0,0 +1,70 @@
+/** @file
+  Protocol of EDKII IPMI Async Protocol.
+
+  IPMI_PROTOCOL blocks the caller until the response is received. This
+  protocol is produced along with IPMI_PROTOCOL to submit the IPMI commands
+  without waiting for the response.
+
+  Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef EDKII_IPMI_ASYNC_PROTOCOL_H_
+#define EDKII_IPMI_ASYNC_PROTOCOL_H_
+
+typedef struct  _EDKII_IPMI_ASYNC_PROTOCOL EDKII_IPMI_ASYNC_PROTOCOL;
+
+#define EDKII_IPMI_ASYNC_PROTOCOL_GUID \
+  { \
+    0x7D24CF18, 0x124D, 0x4A9D, 0xAC, 0x10, 0xC3, 0x15, 0x77, 0x1A, 0xED, 0x51 \
+  }
+
+///
+/// The token of IPMI command submitted through IpmiSubmitCommandAsync.
+///
+typedef struct {
+  EFI_EVENT     Event;                  ///< The event signaled when the command
+                                        ///< completes. NULL means the command is
+                                        ///< completed before the function returns.
+  EFI_STATUS    TransferStatus;         ///< The status of the command.
+  UINT64        LatencyInMicrosecond;   ///< The time from the submission to the
+                                        ///< completion of the command.
+  UINT8         NetFunction;            ///< Net function of the command.
+  UINT8         Command;                ///< IPMI Command.
+  UINT8         *RequestData;           ///< Command Request Data.
+  UINT32        RequestDataSize;        ///< Size of Command Request Data.
+  UINT8         *ResponseData;          ///< Command Response Data. The completion
+                                        ///< code is the first byte of response data.
+  UINT32        ResponseDataSize;       ///< Size of Command Response Data.
+} EDKII_IPMI_COMMAND_TOKEN;
+
+/**
+  This service submits the IPMI command without waiting for the response.
+  The commands are completed in the order they are submitted, including the
+  commands submitted through IPMI_PROTOCOL.
+
+  @param[in]      This                   EDKII_IPMI_ASYNC_PROTOCOL instance.
+  @param[in, out] Token                  The token of the command. Token and the
+                                         buffers it refers to must stay valid
+                                         until Token->Event is signaled.
+
+  @retval EFI_SUCCESS            The command is submitted. The status of the command
+                                 is returned in Token->TransferStatus.
+  @retval EFI_INVALID_PARAMETER  Token is NULL.
+  @retval EFI_OUT_OF_RESOURCES   The resource allocation is out of resource.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *IPMI_SUBMIT_COMMAND_ASYNC)(
+  IN     EDKII_IPMI_ASYNC_PROTOCOL  *This,
+  IN OUT EDKII_IPMI_COMMAND_TOKEN   *Token
+  );
+
+struct _EDKII_IPMI_ASYNC_PROTOCOL {
+  IPMI_SUBMIT_COMMAND_ASYNC    IpmiSubmitCommandAsync;
+};
+
+extern EFI_GUID  gEdkiiIpmiAsyncProtocolGuid;
+
+#endif // EDKII_IPMI_ASYNC_PROTOCOL_H_
@@ -19,7 +19,7 @@ typedef struct  _EDKII_MCTP_PROTOCOL EDKII_MCTP_PROTOCOL;
   }
 
 #define EDKII_MCTP_PROTOCOL_VERSION_MAJOR  1
-#define EDKII_MCTP_PROTOCOL_VERSION_MINOR  0
+#define EDKII_MCTP_PROTOCOL_VERSION_MINOR  1
 #define EDKII_MCTP_PROTOCOL_VERSION        ((EDKII_MCTP_PROTOCOL_VERSION_MAJOR << 8) |\
                                        EDKII_MCTP_PROTOCOL_VERSION_MINOR)
 
@@ -74,6 +74,54 @@ EFI_STATUS
   OUT    MANAGEABILITY_TRANSPORT_ADDITIONAL_STATUS *AdditionalTransferError
   );
 
+///
+/// The token of MCTP message submitted through MctpSubmitCommandAsync.
+///
+typedef struct {
+  EFI_EVENT                                    Event;                      ///< The event signaled when the message
+                                                                           ///< completes. NULL means the message is
+                                                                           ///< completed before the function returns.
+  EFI_STATUS                                   TransferStatus;             ///< The status of the message.
+  UINT64                                       LatencyInMicrosecond;       ///< The time from the submission to the
+                                                                           ///< completion of the message.
+  UINT8                                        MctpType;                   ///< MCTP message type.
+  UINT8                                        *MctpSourceEndpointId;      ///< Pointer of MCTP source endpoint ID,
+                                                                           ///< NULL means PcdMctpSourceEndpointId.
+  UINT8                                        *MctpDestinationEndpointId; ///< Pointer of MCTP destination endpoint ID,
+                                                                           ///< NULL means PcdMctpDestinationEndpointId.
+  BOOLEAN                                      RequestDataIntegrityCheck;  ///< Message has integrity check byte.
+  UINT8                                        *RequestData;               ///< Message Data.
+  UINT32                                       RequestDataSize;            ///< Size of message Data.
+  UINT32                                       RequestTimeout;             ///< Timeout value in milliseconds.
+  UINT8                                        *ResponseData;              ///< Message Response Data.
+  UINT32                                       ResponseDataSize;           ///< Size of Message Response Data.
+  UINT32                                       ResponseTimeout;            ///< Timeout value in milliseconds.
+  MANAGEABILITY_TRANSPORT_ADDITIONAL_STATUS    AdditionalTransferError;    ///< Additional transfer error.
+} EDKII_MCTP_COMMAND_TOKEN;
+
+/**
+  This service submits the message via EDKII MCTP protocol without waiting
+  for the response. The messages submitted through the same EDKII MCTP
+  protocol are completed in the order they are submitted, including the
+  messages submitted through MctpSubmitCommand.
+
+  @param[in]      This                       EDKII_MCTP_PROTOCOL instance.
+  @param[in, out] Token                      The token of the message. Token and the
+                                             buffers it refers to must stay valid
+                                             until Token->Event is signaled.
+
+  @retval EFI_SUCCESS            The message is submitted. The status of the message
+                                 is returned in Token->TransferStatus.
+  @retval EFI_INVALID_PARAMETER  Token is NULL or the data in Token is incorrect.
+  @retval EFI_OUT_OF_RESOURCES   The resource allocation is out of resource.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *MCTP_SUBMIT_COMMAND_ASYNC)(
+  IN     EDKII_MCTP_PROTOCOL       *This,
+  IN OUT EDKII_MCTP_COMMAND_TOKEN  *Token
+  );
+
 //
 // EDKII_MCTP_PROTOCOL Version 1.0
 //
@@ -81,6 +129,14 @@ typedef struct {
   MCTP_SUBMIT_COMMAND    MctpSubmitCommand;
 } EDKII_MCTP_PROTOCOL_V1_0;
 
+//
+// EDKII_MCTP_PROTOCOL Version 1.1
+//
+typedef struct {
+  MCTP_SUBMIT_COMMAND          MctpSubmitCommand;
+  MCTP_SUBMIT_COMMAND_ASYNC    MctpSubmitCommandAsync;
+} EDKII_MCTP_PROTOCOL_V1_1;
+
 ///
 /// Definitions of EDKII_MCTP_PROTOCOL.
 /// This is a union that can accommodate the new functionalities defined
@@ -94,6 +150,7 @@ typedef struct {
 ///
 typedef union {
   EDKII_MCTP_PROTOCOL_V1_0    *Version1_0;
+  EDKII_MCTP_PROTOCOL_V1_1    *Version1_1;
 } EDKII_MCTP_PROTOCOL_FUNCTION;
 
 struct _EDKII_MCTP_PROTOCOL {
@@ -19,7 +19,7 @@ typedef struct  _EDKII_PLDM_PROTOCOL EDKII_PLDM_PROTOCOL;
   }
 
 #define EDKII_PLDM_PROTOCOL_VERSION_MAJOR  1
-#define EDKII_PLDM_PROTOCOL_VERSION_MINOR  0
+#define EDKII_PLDM_PROTOCOL_VERSION_MINOR  1
 #define EDKII_PLDM_PROTOCOL_VERSION        ((EDKII_PLDM_PROTOCOL_VERSION_MAJOR << 8) |\
                                        EDKII_PLDM_PROTOCOL_VERSION_MINOR)
 
@@ -59,6 +59,49 @@ EFI_STATUS
   IN OUT UINT32               *ResponseDataSize
   );
 
+///
+/// The token of PLDM command submitted through PldmSubmitCommandAsync.
+///
+typedef struct {
+  EFI_EVENT     Event;                       ///< The event signaled when the command
+                                             ///< completes. NULL means the command is
+                                             ///< completed before the function returns.
+  EFI_STATUS    TransferStatus;              ///< The status of the command.
+  UINT64        LatencyInMicrosecond;        ///< The time from the submission to the
+                                             ///< completion of the command.
+  UINT8         PldmType;                    ///< PLDM message type.
+  UINT8         Command;                     ///< PLDM Command of PLDM message type.
+  UINT8         PldmTerminusSourceId;        ///< PLDM source teminus ID.
+  UINT8         PldmTerminusDestinationId;   ///< PLDM destination teminus ID.
+  UINT8         *RequestData;                ///< Command Request Data.
+  UINT32        RequestDataSize;             ///< Size of Command Request Data.
+  UINT8         *ResponseData;               ///< Command Response Data.
+  UINT32        ResponseDataSize;            ///< Size of Command Response Data.
+} EDKII_PLDM_COMMAND_TOKEN;
+
+/**
+  This service submits the command via EDKII PLDM protocol without waiting
+  for the response. The commands submitted through the same EDKII PLDM
+  protocol are completed in the order they are submitted, including the
+  commands submitted through PldmSubmitCommand.
+
+  @param[in]      This                       EDKII_PLDM_PROTOCOL instance.
+  @param[in, out] Token                      The token of the command. Token and the
+                                             buffers it refers to must stay valid
+                                             until Token->Event is signaled.
+
+  @retval EFI_SUCCESS            The command is submitted. The status of the command
+                                 is returned in Token->TransferStatus.
+  @retval EFI_INVALID_PARAMETER  Token is NULL or the data in Token is incorrect.
+  @retval EFI_OUT_OF_RESOURCES   The resource allcation is out of resource.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *PLDM_SUBMIT_COMMAND_ASYNC)(
+  IN     EDKII_PLDM_PROTOCOL       *This,
+  IN OUT EDKII_PLDM_COMMAND_TOKEN  *Token
+  );
+
 //
 // EDKII_PLDM_PROTOCOL Version 1.0
 //
@@ -66,6 +109,14 @@ typedef struct {
   PLDM_SUBMIT_COMMAND    PldmSubmitCommand;
 } EDKII_PLDM_PROTOCOL_V1_0;
 
+//
+// EDKII_PLDM_PROTOCOL Version 1.1
+//
+typedef struct {
+  PLDM_SUBMIT_COMMAND          PldmSubmitCommand;
+  PLDM_SUBMIT_COMMAND_ASYNC    PldmSubmitCommandAsync;
+} EDKII_PLDM_PROTOCOL_V1_1;
+
 ///
 /// Definitions of EDKII_PLDM_PROTOCOL.
 /// This is a union that can accommodate the new functionalities defined
@@ -79,6 +130,7 @@ typedef struct {
 ///
 typedef union {
   EDKII_PLDM_PROTOCOL_V1_0    *Version1_0;
+  EDKII_PLDM_PROTOCOL_V1_1    *Version1_1;
 } EDKII_PLDM_PROTOCOL_FUNCTION;
 
 struct _EDKII_PLDM_PROTOCOL {
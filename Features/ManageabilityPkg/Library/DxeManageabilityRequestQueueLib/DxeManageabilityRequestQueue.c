@@ -0,0 +1,413 @@
+/** @file
+
+  DXE instance of Manageability Request Queue Library
+
+  Copyright (C) 2023 Advanced Micro Devices, Inc. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/DebugLib.h>
+#include <Library/ManageabilityRequestQueueLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiLib.h>
+
+#define MANAGEABILITY_REQUEST_QUEUE_SIGNATURE  SIGNATURE_32 ('M', 'R', 'Q', 'U')
+#define MANAGEABILITY_REQUEST_ENTRY_SIGNATURE  SIGNATURE_32 ('M', 'R', 'Q', 'E')
+
+///
+/// The delay between a request is queued and the timer event drains the queue.
+///
+#define MANAGEABILITY_REQUEST_QUEUE_TIMER_PERIOD  EFI_TIMER_PERIOD_MILLISECONDS (1)
+
+///
+/// The number of timer ticks a request is retried while the transport
+/// interface underneath is busy, before it is completed with EFI_NOT_READY.
+///
+#define MANAGEABILITY_REQUEST_QUEUE_RETRY_LIMIT  1000
+
+///
+/// Pending request in the queue.
+///
+typedef struct {
+  UINT32        Signature;
+  LIST_ENTRY    Link;
+  VOID          *Request;
+  EFI_EVENT     Event;
+  EFI_STATUS    *TransferStatus;
+  UINT64        *Latency;
+  UINT64        BeginTick;
+  UINT32        Retry;
+} MANAGEABILITY_REQUEST_ENTRY;
+
+#define MANAGEABILITY_REQUEST_ENTRY_FROM_LINK(a)  CR (a, MANAGEABILITY_REQUEST_ENTRY, Link, MANAGEABILITY_REQUEST_ENTRY_SIGNATURE)
+
+struct _MANAGEABILITY_REQUEST_QUEUE {
+  UINT32                           Signature;
+  EFI_LOCK                         Lock;    ///< Protects PendingList and Busy.
+  LIST_ENTRY                       PendingList;
+  BOOLEAN                          Busy;    ///< A request is running on the transport.
+  EFI_EVENT                        Timer;
+  MANAGEABILITY_REQUEST_HANDLER    Handler;
+};
+
+/**
+  This function returns the time elapsed since the given performance counter
+  value.
+
+  @param[in]  BeginTick       The performance counter value to start with.
+
+  @retval     UINT64          Elapsed time in microsecond.
+**/
+UINT64
+RequestQueueElapsedTime (
+  IN  UINT64  BeginTick
+  )
+{
+  UINT64  EndTick;
+  UINT64  StartValue;
+  UINT64  EndValue;
+  UINT64  Ticks;
+
+  EndTick = GetPerformanceCounter ();
+  GetPerformanceCounterProperties (&StartValue, &EndValue);
+  if (StartValue < EndValue) {
+    Ticks = (EndTick >= BeginTick) ? EndTick - BeginTick : (EndValue - BeginTick) + (EndTick - StartValue);
+  } else {
+    Ticks = (BeginTick >= EndTick) ? BeginTick - EndTick : (BeginTick - EndValue) + (StartValue - EndTick);
+  }
+
+  return DivU64x32 (GetTimeInNanoSecond (Ticks), 1000);
+}
+
+/**
+  This function marks the queue busy so the requests are run by the caller.
+
+  @param[in]  Queue           The request queue.
+
+  @retval     TRUE            The caller owns the queue.
+  @retval     FALSE           The queue is owned by the interrupted code.
+**/
+BOOLEAN
+RequestQueueEnter (
+  IN  MANAGEABILITY_REQUEST_QUEUE  *Queue
+  )
+{
+  BOOLEAN  Busy;
+
+  EfiAcquireLock (&Queue->Lock);
+  Busy        = Queue->Busy;
+  Queue->Busy = TRUE;
+  EfiReleaseLock (&Queue->Lock);
+
+  return !Busy;
+}
+
+/**
+  This function releases the queue owned by RequestQueueEnter. The timer is
+  armed again if requests are queued by the code which interrupts the owner.
+
+  @param[in]  Queue           The request queue.
+**/
+VOID
+RequestQueueLeave (
+  IN  MANAGEABILITY_REQUEST_QUEUE  *Queue
+  )
+{
+  BOOLEAN  Pending;
+
+  EfiAcquireLock (&Queue->Lock);
+  Queue->Busy = FALSE;
+  Pending     = !IsListEmpty (&Queue->PendingList);
+  EfiReleaseLock (&Queue->Lock);
+
+  if (Pending) {
+    gBS->SetTimer (Queue->Timer, TimerRelative, MANAGEABILITY_REQUEST_QUEUE_TIMER_PERIOD);
+  }
+}
+
+/**
+  This function removes the first pending request from the queue.
+
+  @param[in]  Queue           The request queue.
+
+  @retval     !NULL           The first pending request.
+  @retval     NULL            No pending request.
+**/
+MANAGEABILITY_REQUEST_ENTRY *
+RequestQueueRemoveFirst (
+  IN  MANAGEABILITY_REQUEST_QUEUE  *Queue
+  )
+{
+  MANAGEABILITY_REQUEST_ENTRY  *Entry;
+
+  Entry = NULL;
+  EfiAcquireLock (&Queue->Lock);
+  if (!IsListEmpty (&Queue->PendingList)) {
+    Entry = MANAGEABILITY_REQUEST_ENTRY_FROM_LINK (GetFirstNode (&Queue->PendingList));
+    RemoveEntryList (&Entry->Link);
+  }
+
+  EfiReleaseLock (&Queue->Lock);
+  return Entry;
+}
+
+/**
+  This function returns the status of a pending request to its submitter.
+
+  @param[in]  Entry           The pending request.
+  @param[in]  Status          The status of the request.
+**/
+VOID
+RequestQueueComplete (
+  IN  MANAGEABILITY_REQUEST_ENTRY  *Entry,
+  IN  EFI_STATUS                   Status
+  )
+{
+  *Entry->TransferStatus = Status;
+  *Entry->Latency        = RequestQueueElapsedTime (Entry->BeginTick);
+  gBS->SignalEvent (Entry->Event);
+  FreePool (Entry);
+}
+
+/**
+  This function runs all of the pending requests in FIFO order. The caller
+  must own the queue.
+
+  A request that fails with EFI_NOT_READY found the transport interface
+  underneath busy, e.g. the MCTP queue PLDM runs on or the KCS interface
+  owned by another driver. The request is put back to the head of the queue
+  and retried on the next timer tick, up to
+  MANAGEABILITY_REQUEST_QUEUE_RETRY_LIMIT times.
+
+  @param[in]  Queue           The request queue.
+
+  @retval     TRUE            All of the pending requests are completed.
+  @retval     FALSE           The transport interface is busy, the requests
+                              are left in the queue.
+**/
+BOOLEAN
+RequestQueueDrain (
+  IN  MANAGEABILITY_REQUEST_QUEUE  *Queue
+  )
+{
+  MANAGEABILITY_REQUEST_ENTRY  *Entry;
+  EFI_STATUS                   Status;
+
+  while ((Entry = RequestQueueRemoveFirst (Queue)) != NULL) {
+    Status = Queue->Handler (Entry->Request);
+    if ((Status == EFI_NOT_READY) && (Entry->Retry < MANAGEABILITY_REQUEST_QUEUE_RETRY_LIMIT)) {
+      Entry->Retry++;
+      EfiAcquireLock (&Queue->Lock);
+      InsertHeadList (&Queue->PendingList, &Entry->Link);
+      EfiReleaseLock (&Queue->Lock);
+      return FALSE;
+    }
+
+    RequestQueueComplete (Entry, Status);
+  }
+
+  return TRUE;
+}
+
+/**
+  Timer event notification function that drains the request queue.
+
+  @param[in]  Event           The timer event.
+  @param[in]  Context         The request queue.
+**/
+VOID
+EFIAPI
+RequestQueueTimerNotify (
+  IN  EFI_EVENT  Event,
+  IN  VOID       *Context
+  )
+{
+  MANAGEABILITY_REQUEST_QUEUE  *Queue;
+
+  Queue = (MANAGEABILITY_REQUEST_QUEUE *)Context;
+  if (!RequestQueueEnter (Queue)) {
+    return;
+  }
+
+  RequestQueueDrain (Queue);
+  RequestQueueLeave (Queue);
+}
+
+/**
+  This function creates a request queue.
+
+  @param[in]   Handler                The function runs the requests.
+  @param[out]  Queue                  Pointer to receive the request queue.
+
+  @retval      EFI_SUCCESS            The request queue is created.
+  @retval      EFI_INVALID_PARAMETER  Handler or Queue is NULL.
+  @retval      EFI_OUT_OF_RESOURCES   Out of resource to create the queue.
+  @retval      Otherwise              Failed to create the timer event.
+**/
+EFI_STATUS
+ManageabilityRequestQueueCreate (
+  IN  MANAGEABILITY_REQUEST_HANDLER  Handler,
+  OUT MANAGEABILITY_REQUEST_QUEUE    **Queue
+  )
+{
+  EFI_STATUS                   Status;
+  MANAGEABILITY_REQUEST_QUEUE  *NewQueue;
+
+  if ((Handler == NULL) || (Queue == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  NewQueue = AllocateZeroPool (sizeof (MANAGEABILITY_REQUEST_QUEUE));
+  if (NewQueue == NULL) {
+    DEBUG ((DEBUG_ERROR, "%a: Fail to allocate memory for MANAGEABILITY_REQUEST_QUEUE\n", __func__));
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  NewQueue->Signature = MANAGEABILITY_REQUEST_QUEUE_SIGNATURE;
+  NewQueue->Handler   = Handler;
+  EfiInitializeLock (&NewQueue->Lock, TPL_NOTIFY);
+  InitializeListHead (&NewQueue->PendingList);
+  Status = gBS->CreateEvent (
+                  EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                  TPL_CALLBACK,
+                  RequestQueueTimerNotify,
+                  NewQueue,
+                  &NewQueue->Timer
+                  );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: Failed to create the request queue timer - %r\n", __func__, Status));
+    FreePool (NewQueue);
+    return Status;
+  }
+
+  *Queue = NewQueue;
+  return EFI_SUCCESS;
+}
+
+/**
+  This function destroys a request queue. The pending requests are completed
+  with EFI_ABORTED.
+
+  @param[in]  Queue           The request queue.
+**/
+VOID
+ManageabilityRequestQueueDestroy (
+  IN  MANAGEABILITY_REQUEST_QUEUE  *Queue
+  )
+{
+  MANAGEABILITY_REQUEST_ENTRY  *Entry;
+
+  if (Queue == NULL) {
+    return;
+  }
+
+  gBS->CloseEvent (Queue->Timer);
+  while ((Entry = RequestQueueRemoveFirst (Queue)) != NULL) {
+    RequestQueueComplete (Entry, EFI_ABORTED);
+  }
+
+  FreePool (Queue);
+}
+
+/**
+  This function queues a request without waiting for its completion.
+
+  When the request completes, its status is returned in TransferStatus, the
+  time from the submission to the completion is returned in Latency and Event
+  is signaled. Request, TransferStatus and Latency must stay valid until then.
+
+  @param[in]   Queue                  The request queue.
+  @param[in]   Request                The protocol specific request.
+  @param[in]   Event                  The event signaled on completion.
+  @param[out]  TransferStatus         Pointer to receive the status of request.
+  @param[out]  Latency                Pointer to receive the completion latency
+                                      in microsecond.
+
+  @retval      EFI_SUCCESS            The request is queued.
+  @retval      EFI_INVALID_PARAMETER  One of the given parameter is incorrect.
+  @retval      EFI_OUT_OF_RESOURCES   Out of resource to queue the request.
+**/
+EFI_STATUS
+ManageabilityRequestQueueSubmit (
+  IN  MANAGEABILITY_REQUEST_QUEUE  *Queue,
+  IN  VOID                         *Request,
+  IN  EFI_EVENT                    Event,
+  OUT EFI_STATUS                   *TransferStatus,
+  OUT UINT64                       *Latency
+  )
+{
+  MANAGEABILITY_REQUEST_ENTRY  *Entry;
+
+  if ((Queue == NULL) || (Request == NULL) || (Event == NULL) ||
+      (TransferStatus == NULL) || (Latency == NULL))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Entry = AllocatePool (sizeof (MANAGEABILITY_REQUEST_ENTRY));
+  if (Entry == NULL) {
+    DEBUG ((DEBUG_ERROR, "%a: Fail to allocate memory for MANAGEABILITY_REQUEST_ENTRY\n", __func__));
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Entry->Signature      = MANAGEABILITY_REQUEST_ENTRY_SIGNATURE;
+  Entry->Request        = Request;
+  Entry->Event          = Event;
+  Entry->TransferStatus = TransferStatus;
+  Entry->Latency        = Latency;
+  Entry->BeginTick      = GetPerformanceCounter ();
+  Entry->Retry          = 0;
+  *TransferStatus       = EFI_NOT_READY;
+
+  EfiAcquireLock (&Queue->Lock);
+  InsertTailList (&Queue->PendingList, &Entry->Link);
+  EfiReleaseLock (&Queue->Lock);
+
+  gBS->SetTimer (Queue->Timer, TimerRelative, MANAGEABILITY_REQUEST_QUEUE_TIMER_PERIOD);
+  return EFI_SUCCESS;
+}
+
+/**
+  This function runs a request after all of the pending requests in the
+  queue and waits for its completion.
+
+  @param[in]  Queue           The request queue.
+  @param[in]  Request         The protocol specific request.
+
+  @retval     EFI_NOT_READY   The queue is busy on a request and the caller
+                              runs at a TPL above TPL_CALLBACK, or the
+                              transport interface underneath is busy on the
+                              pending requests.
+  @retval     Otherwise       The status of the request.
+**/
+EFI_STATUS
+ManageabilityRequestQueueRun (
+  IN  MANAGEABILITY_REQUEST_QUEUE  *Queue,
+  IN  VOID                         *Request
+  )
+{
+  EFI_STATUS  Status;
+
+  if (!RequestQueueEnter (Queue)) {
+    DEBUG ((DEBUG_ERROR, "%a: The transport interface is busy on the interrupted request.\n", __func__));
+    return EFI_NOT_READY;
+  }
+
+  //
+  // The request is not run ahead of the pending requests which are waiting
+  // for the transport interface underneath. They are retried by the timer.
+  //
+  if (RequestQueueDrain (Queue)) {
+    Status = Queue->Handler (Request);
+  } else {
+    Status = EFI_NOT_READY;
+  }
+
+  RequestQueueLeave (Queue);
+  return Status;
+}
@@ -9,6 +9,7 @@
 #include <Uefi.h>
 #include <IndustryStandard/IpmiKcs.h>
 #include <IndustryStandard/Mctp.h>
+#include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
 #include <Library/IoLib.h>
 #include <Library/DebugLib.h>
@@ -22,35 +23,78 @@
 extern MANAGEABILITY_TRANSPORT_KCS_HARDWARE_INFO  mKcsHardwareInfo;
 extern MANAGEABILITY_TRANSPORT_KCS                *mSingleSessionToken;
 
+MANAGEABILITY_TRANSPORT_STATISTICS  mKcsStatistics;
+UINT32                              mKcsCommandRetries;
+
 /**
-  This function waits for parameter Flag to set.
-  Checks status flag in every 1ms internal till 5 seconds elapses.
+  This function waits for parameter Flag to reach the given state.
+
+  A BMC usually responds to a KCS transfer within a few microseconds, so
+  the status register is first read back to back PcdKcsStatusTightPollCount
+  times. After that the interval between reads starts at 1us and doubles up
+  to PcdKcsStatusMaxPollInterval until 5 seconds elapse.
 
   @param[in]  Flag        KCS Flag to test.
-  @retval     EFI_SUCCESS The KCS flag under test is set.
-  @retval     EFI_TIMEOUT The KCS flag didn't set in 5 second windows.
+  @param[in]  Set         TRUE to wait for the flag to set, FALSE to wait for
+                          the flag to get cleared.
+
+  @retval     EFI_SUCCESS The KCS flag under test reaches the given state.
+  @retval     EFI_TIMEOUT The KCS flag didn't reach the given state in 5
+                          second windows.
 **/
 EFI_STATUS
-WaitStatusSet (
-  IN  UINT8  Flag
+WaitStatus (
+  IN  UINT8    Flag,
+  IN  BOOLEAN  Set
   )
 {
-  UINT64  Timeout = 0;
+  UINT32  Poll;
+  UINT32  Interval;
+  UINT64  Timeout;
+
+  for (Poll = 0; Poll < FixedPcdGet32 (PcdKcsStatusTightPollCount); Poll++) {
+    if (((KcsRegisterRead8 (KCS_REG_STATUS) & Flag) != 0) == Set) {
+      return EFI_SUCCESS;
+    }
+
+    CpuPause ();
+  }
 
-  while (!(KcsRegisterRead8 (KCS_REG_STATUS) & Flag)) {
-    MicroSecondDelay (IPMI_KCS_TIMEOUT_1MS);
-    Timeout = Timeout + IPMI_KCS_TIMEOUT_1MS;
+  Interval = 1;
+  Timeout  = 0;
+  while (((KcsRegisterRead8 (KCS_REG_STATUS) & Flag) != 0) != Set) {
     if (Timeout >= IPMI_KCS_TIMEOUT_5_SEC) {
       return EFI_TIMEOUT;
     }
+
+    MicroSecondDelay (Interval);
+    Timeout = Timeout + Interval;
+    mKcsCommandRetries++;
+    if (Interval < FixedPcdGet32 (PcdKcsStatusMaxPollInterval)) {
+      Interval = MIN (Interval * 2, FixedPcdGet32 (PcdKcsStatusMaxPollInterval));
+    }
   }
 
   return EFI_SUCCESS;
 }
 
+/**
+  This function waits for parameter Flag to set.
+
+  @param[in]  Flag        KCS Flag to test.
+  @retval     EFI_SUCCESS The KCS flag under test is set.
+  @retval     EFI_TIMEOUT The KCS flag didn't set in 5 second windows.
+**/
+EFI_STATUS
+WaitStatusSet (
+  IN  UINT8  Flag
+  )
+{
+  return WaitStatus (Flag, TRUE);
+}
+
 /**
   This function waits for parameter Flag to get cleared.
-  Checks status flag in every 1ms internal till 5 seconds elapses.
 
   @param[in]  Flag        KCS Flag to test.
 
@@ -62,17 +106,84 @@ WaitStatusClear (
   IN  UINT8  Flag
   )
 {
-  UINT64  Timeout = 0;
+  return WaitStatus (Flag, FALSE);
+}
 
-  while (KcsRegisterRead8 (KCS_REG_STATUS) & Flag) {
-    MicroSecondDelay (IPMI_KCS_TIMEOUT_1MS);
-    Timeout = Timeout + IPMI_KCS_TIMEOUT_1MS;
-    if (Timeout >= IPMI_KCS_TIMEOUT_5_SEC) {
-      return EFI_TIMEOUT;
-    }
+/**
+  This function returns the histogram bucket of the given value.
+
+  @param[in]  Value       The value to be counted.
+  @param[in]  Buckets     Number of buckets in the histogram.
+
+  @retval     UINTN       Index of the bucket.
+**/
+UINTN
+KcsHistogramBucket (
+  IN  UINT64  Value,
+  IN  UINTN   Buckets
+  )
+{
+  if (Value == 0) {
+    return 0;
   }
 
-  return EFI_SUCCESS;
+  return MIN ((UINTN)HighBitSet64 (Value) + 1, Buckets - 1);
+}
+
+/**
+  This function starts to account a KCS command in the transport statistics.
+
+  @retval     UINT64      The performance counter value when the command
+                          starts.
+**/
+UINT64
+KcsStatisticsBegin (
+  VOID
+  )
+{
+  mKcsCommandRetries = 0;
+  return GetPerformanceCounter ();
+}
+
+/**
+  This function records the latency and the retries of a KCS command in the
+  transport statistics.
+
+  @param[in]  BeginTick   The value returned by KcsStatisticsBegin.
+  @param[in]  Status      The status of the command.
+**/
+VOID
+KcsStatisticsEnd (
+  IN  UINT64      BeginTick,
+  IN  EFI_STATUS  Status
+  )
+{
+  UINT64  EndTick;
+  UINT64  StartValue;
+  UINT64  EndValue;
+  UINT64  Ticks;
+  UINT64  Latency;
+
+  EndTick = GetPerformanceCounter ();
+  GetPerformanceCounterProperties (&StartValue, &EndValue);
+  if (StartValue < EndValue) {
+    Ticks = (EndTick >= BeginTick) ? EndTick - BeginTick : (EndValue - BeginTick) + (EndTick - StartValue);
+  } else {
+    Ticks = (BeginTick >= EndTick) ? BeginTick - EndTick : (BeginTick - EndValue) + (StartValue - EndTick);
+  }
+
+  Latency = DivU64x32 (GetTimeInNanoSecond (Ticks), 1000);
+
+  mKcsStatistics.CommandCount++;
+  if (EFI_ERROR (Status)) {
+    mKcsStatistics.ErrorCount++;
+  }
+
+  mKcsStatistics.TotalLatencyInMicrosecond += Latency;
+  mKcsStatistics.MaxLatencyInMicrosecond    = MAX (mKcsStatistics.MaxLatencyInMicrosecond, Latency);
+  mKcsStatistics.TotalRetries              += mKcsCommandRetries;
+  mKcsStatistics.LatencyHistogram[KcsHistogramBucket (Latency, MANAGEABILITY_TRANSPORT_LATENCY_BUCKETS)]++;
+  mKcsStatistics.RetryHistogram[KcsHistogramBucket (mKcsCommandRetries, MANAGEABILITY_TRANSPORT_RETRY_BUCKETS)]++;
 }
 
 /**
@@ -98,119 +209,88 @@ ClearOBF (
 }
 
 /**
-  This function writes/sends data to the KCS port.
+  This function returns the next byte of the scatter-gather list.
+
+  @param[in]      Vector      The scatter-gather list.
+  @param[in, out] Index       The index of current element in Vector.
+  @param[in, out] Offset      The offset of next byte in current element.
+
+  @retval         UINT8       The next byte.
+**/
+UINT8
+KcsVectorNextByte (
+  IN      MANAGEABILITY_TRANSMIT_VECTOR  *Vector,
+  IN OUT  UINTN                          *Index,
+  IN OUT  UINT32                         *Offset
+  )
+{
+  while (*Offset >= Vector[*Index].SizeInByte) {
+    (*Index)++;
+    *Offset = 0;
+  }
+
+  return Vector[*Index].Buffer[(*Offset)++];
+}
+
+/**
+  This function writes/sends the scatter-gather list to the KCS port.
+  The elements are sent back to back as one KCS write transfer, so the
+  transport header, payload and trailer don't have to be copied into a
+  contiguous buffer.
   Algorithm is based on flow chart provided in IPMI spec 2.0
   Figure 9-6, KCS Interface BMC to SMS Write Transfer Flow Chart
 
-  @param[in]      TransmitHeader        KCS packet header.
-  @param[in]      TransmitHeaderSize    KCS packet header size in byte.
-  @param[in]      TransmitTrailer       KCS packet trailer.
-  @param[in]      TransmitTrailerSize   KCS packet trailer size in byte.
-  @param[in]      RequestData           Command Request Data, could be NULL.
-                                        RequestDataSize must be zero, if RequestData
-                                        is NULL.
-  @param[in]      RequestDataSize       Size of Command Request Data.
+  @param[in]      Vector                The scatter-gather list.
+  @param[in]      NumberOfVectors       Number of elements in Vector.
 
-  @retval     EFI_SUCCESS           The command byte stream was successfully
-                                    submit to the device and a response was
-                                    successfully received.
-  @retval     EFI_NOT_FOUND         The command was not successfully sent to the
-                                    device or a response was not successfully
-                                    received from the device.
+  @retval     EFI_SUCCESS           The data was successfully sent to the
+                                    device.
+  @retval     EFI_INVALID_PARAMETER The scatter-gather list is empty or has an
+                                    element with NULL buffer.
   @retval     EFI_NOT_READY         Ipmi Device is not ready for Ipmi command
                                     access.
-  @retval     EFI_DEVICE_ERROR      Ipmi Device hardware error.
   @retval     EFI_TIMEOUT           The command time out.
-  @retval     EFI_UNSUPPORTED       The command was not successfully sent to
-                                    the device.
-  @retval     EFI_OUT_OF_RESOURCES  The resource allocation is out of resource or
-                                    data size error.
 **/
 EFI_STATUS
-KcsTransportWrite (
-  IN  MANAGEABILITY_TRANSPORT_HEADER   TransmitHeader,
-  IN  UINT16                           TransmitHeaderSize,
-  IN  MANAGEABILITY_TRANSPORT_TRAILER  TransmitTrailer OPTIONAL,
-  IN  UINT16                           TransmitTrailerSize,
-  IN  UINT8                            *RequestData OPTIONAL,
-  IN  UINT32                           RequestDataSize
+KcsTransportWriteVector (
+  IN  MANAGEABILITY_TRANSMIT_VECTOR  *Vector,
+  IN  UINT16                         NumberOfVectors
   )
 {
   EFI_STATUS  Status;
   UINT32      Length;
-  UINT8       *Buffer;
-  UINT8       *BufferPtr;
+  UINTN       Index;
+  UINT32      Offset;
 
-  // Validation on RequestData and RequestDataSize.
-  if (((RequestData == NULL) && (RequestDataSize != 0)) ||
-      ((RequestData != NULL) && (RequestDataSize == 0))
-      )
-  {
-    DEBUG ((DEBUG_ERROR, "%a: Mismatched values of RequestData or RequestDataSize.\n", __func__));
-    return EFI_INVALID_PARAMETER;
-  }
-
-  // Validation on TransmitHeader and TransmitHeaderSize.
-  if (((TransmitHeader == NULL) && (TransmitHeaderSize != 0)) ||
-      ((TransmitHeader != NULL) && (TransmitHeaderSize == 0))
-      )
-  {
-    DEBUG ((DEBUG_ERROR, "%a: Mismatched values of TransmitHeader or TransmitHeaderSize.\n", __func__));
+  if (Vector == NULL) {
     return EFI_INVALID_PARAMETER;
   }
 
-  // Validation on TransmitHeader and TransmitHeaderSize.
-  if (((TransmitTrailer == NULL) && (TransmitTrailerSize != 0)) ||
-      ((TransmitTrailer != NULL) && (TransmitTrailerSize == 0))
-      )
-  {
-    DEBUG ((DEBUG_ERROR, "%a: Mismatched values of TransmitTrailer or TransmitTrailerSize.\n", __func__));
-    return EFI_INVALID_PARAMETER;
-  }
-
-  Length = TransmitHeaderSize;
-  if (RequestData != NULL) {
-    Length = Length + RequestDataSize;
-  }
-
-  if ((TransmitTrailer != NULL) && (TransmitTrailerSize != 0)) {
-    Length += TransmitTrailerSize;
-  }
-
-  Buffer = AllocateZeroPool (Length);
-  if (Buffer == NULL) {
-    return EFI_OUT_OF_RESOURCES;
-  }
+  Length = 0;
+  for (Index = 0; Index < NumberOfVectors; Index++) {
+    if ((Vector[Index].Buffer == NULL) && (Vector[Index].SizeInByte != 0)) {
+      DEBUG ((DEBUG_ERROR, "%a: Mismatched values of Buffer or SizeInByte.\n", __func__));
+      return EFI_INVALID_PARAMETER;
+    }
 
-  //
-  // Buffer[0..(TransmitHeaderSize - 1)] = TransmitHeader
-  // Buffer [TransmitHeader..(TransmitHeader + RequestDataSize - 1)] = RequestData
-  // Buffer [(TransmitHeader + RequestDataSize)..(TransmitHeader + RequestDataSize + TransmitTrailerSize - 1)] = TransmitTrailer
-  //
-  BufferPtr = Buffer;
-  CopyMem ((VOID *)BufferPtr, (VOID *)TransmitHeader, TransmitHeaderSize);
-  BufferPtr += TransmitHeaderSize;
-  if (RequestData != NULL) {
-    CopyMem (BufferPtr, RequestData, RequestDataSize);
+    Length += Vector[Index].SizeInByte;
   }
 
-  BufferPtr += RequestDataSize;
-  if (TransmitTrailer != NULL) {
-    CopyMem (BufferPtr, (VOID *)TransmitTrailer, TransmitTrailerSize);
+  if (Length == 0) {
+    return EFI_INVALID_PARAMETER;
   }
 
-  BufferPtr = Buffer;
+  Index  = 0;
+  Offset = 0;
 
   // Step 1. wait for IBF to get clear
   Status = WaitStatusClear (IPMI_KCS_IBF);
   if (EFI_ERROR (Status)) {
-    FreePool (Buffer);
     return Status;
   }
 
   // Step 2. clear OBF
   if (EFI_ERROR (ClearOBF ())) {
-    FreePool (Buffer);
     return EFI_NOT_READY;
   }
 
@@ -220,44 +300,37 @@ KcsTransportWrite (
   // Step 4. wait for IBF to get clear
   Status = WaitStatusClear (IPMI_KCS_IBF);
   if (EFI_ERROR (Status)) {
-    FreePool (Buffer);
     return Status;
   }
 
   // Step 5. check state it should be WRITE_STATE, else exit with error
   if (IPMI_KCS_GET_STATE (KcsRegisterRead8 (KCS_REG_STATUS)) != IpmiKcsWriteState) {
-    FreePool (Buffer);
     return EFI_NOT_READY;
   }
 
   // Step 6, Clear OBF
   if (EFI_ERROR (ClearOBF ())) {
-    FreePool (Buffer);
     return EFI_NOT_READY;
   }
 
   while (Length > 1) {
     // Step 7, phase wr_data, write one byte of Data
-    KcsRegisterWrite8 (KCS_REG_DATA_OUT, *BufferPtr);
+    KcsRegisterWrite8 (KCS_REG_DATA_OUT, KcsVectorNextByte (Vector, &Index, &Offset));
     Length--;
-    BufferPtr++;
 
     // Step 8. wait for IBF clear
     Status = WaitStatusClear (IPMI_KCS_IBF);
     if (EFI_ERROR (Status)) {
-      FreePool (Buffer);
       return Status;
     }
 
     // Step 9. check state it should be WRITE_STATE, else exit with error
     if (IPMI_KCS_GET_STATE (KcsRegisterRead8 (KCS_REG_STATUS)) != IpmiKcsWriteState) {
-      FreePool (Buffer);
       return EFI_NOT_READY;
     }
 
     // Step 10
     if (EFI_ERROR (ClearOBF ())) {
-      FreePool (Buffer);
       return EFI_NOT_READY;
     }
 
@@ -273,28 +346,101 @@ KcsTransportWrite (
   // Step 13. wait for IBF to get clear
   Status = WaitStatusClear (IPMI_KCS_IBF);
   if (EFI_ERROR (Status)) {
-    FreePool (Buffer);
     return Status;
   }
 
   // Step 14. check state it should be WRITE_STATE, else exit with error
   if (IPMI_KCS_GET_STATE (KcsRegisterRead8 (KCS_REG_STATUS)) != IpmiKcsWriteState) {
-    FreePool (Buffer);
     return EFI_NOT_READY;
   }
 
   // Step 15
   if (EFI_ERROR (ClearOBF ())) {
-    FreePool (Buffer);
     return EFI_NOT_READY;
   }
 
   // Step 16, write the last byte
-  KcsRegisterWrite8 (KCS_REG_DATA_OUT, *BufferPtr);
-  FreePool (Buffer);
+  KcsRegisterWrite8 (KCS_REG_DATA_OUT, KcsVectorNextByte (Vector, &Index, &Offset));
   return EFI_SUCCESS;
 }
 
+/**
+  This function writes/sends data to the KCS port.
+  Algorithm is based on flow chart provided in IPMI spec 2.0
+  Figure 9-6, KCS Interface BMC to SMS Write Transfer Flow Chart
+
+  @param[in]      TransmitHeader        KCS packet header.
+  @param[in]      TransmitHeaderSize    KCS packet header size in byte.
+  @param[in]      TransmitTrailer       KCS packet trailer.
+  @param[in]      TransmitTrailerSize   KCS packet trailer size in byte.
+  @param[in]      RequestData           Command Request Data, could be NULL.
+                                        RequestDataSize must be zero, if RequestData
+                                        is NULL.
+  @param[in]      RequestDataSize       Size of Command Request Data.
+
+  @retval     EFI_SUCCESS           The command byte stream was successfully
+                                    submit to the device and a response was
+                                    successfully received.
+  @retval     EFI_NOT_FOUND         The command was not successfully sent to the
+                                    device or a response was not successfully
+                                    received from the device.
+  @retval     EFI_NOT_READY         Ipmi Device is not ready for Ipmi command
+                                    access.
+  @retval     EFI_DEVICE_ERROR      Ipmi Device hardware error.
+  @retval     EFI_TIMEOUT           The command time out.
+  @retval     EFI_UNSUPPORTED       The command was not successfully sent to
+                                    the device.
+  @retval     EFI_OUT_OF_RESOURCES  The resource allocation is out of resource or
+                                    data size error.
+**/
+EFI_STATUS
+KcsTransportWrite (
+  IN  MANAGEABILITY_TRANSPORT_HEADER   TransmitHeader,
+  IN  UINT16                           TransmitHeaderSize,
+  IN  MANAGEABILITY_TRANSPORT_TRAILER  TransmitTrailer OPTIONAL,
+  IN  UINT16                           TransmitTrailerSize,
+  IN  UINT8                            *RequestData OPTIONAL,
+  IN  UINT32                           RequestDataSize
+  )
+{
+  MANAGEABILITY_TRANSMIT_VECTOR  Vector[3];
+
+  // Validation on RequestData and RequestDataSize.
+  if (((RequestData == NULL) && (RequestDataSize != 0)) ||
+      ((RequestData != NULL) && (RequestDataSize == 0))
+      )
+  {
+    DEBUG ((DEBUG_ERROR, "%a: Mismatched values of RequestData or RequestDataSize.\n", __func__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  // Validation on TransmitHeader and TransmitHeaderSize.
+  if (((TransmitHeader == NULL) && (TransmitHeaderSize != 0)) ||
+      ((TransmitHeader != NULL) && (TransmitHeaderSize == 0))
+      )
+  {
+    DEBUG ((DEBUG_ERROR, "%a: Mismatched values of TransmitHeader or TransmitHeaderSize.\n", __func__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  // Validation on TransmitHeader and TransmitHeaderSize.
+  if (((TransmitTrailer == NULL) && (TransmitTrailerSize != 0)) ||
+      ((TransmitTrailer != NULL) && (TransmitTrailerSize == 0))
+      )
+  {
+    DEBUG ((DEBUG_ERROR, "%a: Mismatched values of TransmitTrailer or TransmitTrailerSize.\n", __func__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Vector[0].Buffer     = (UINT8 *)TransmitHeader;
+  Vector[0].SizeInByte = TransmitHeaderSize;
+  Vector[1].Buffer     = RequestData;
+  Vector[1].SizeInByte = RequestDataSize;
+  Vector[2].Buffer     = (UINT8 *)TransmitTrailer;
+  Vector[2].SizeInByte = TransmitTrailerSize;
+  return KcsTransportWriteVector (Vector, ARRAY_SIZE (Vector));
+}
+
 /**
   This function sends/receives data from KCS port.
   Algorithm is based on flow chart provided in IPMI spec 2.0
@@ -10,8 +10,10 @@
 #define MANAGEABILITY_TRANSPORT_KCS_LIB_H_
 
 #include <Library/ManageabilityTransportLib.h>
+#include <Library/UefiLib.h>
 
-#define MANAGEABILITY_TRANSPORT_KCS_SIGNATURE  SIGNATURE_32 ('M', 'T', 'K', 'C')
+#define MANAGEABILITY_TRANSPORT_KCS_SIGNATURE       SIGNATURE_32 ('M', 'T', 'K', 'C')
+#define MANAGEABILITY_TRANSPORT_KCS_LOCK_SIGNATURE  SIGNATURE_32 ('M', 'T', 'K', 'L')
 
 #define KCS_BASE_ADDRESS  mKcsHardwareInfo.IoBaseAddress
 #define KCS_REG_DATA_IN   mKcsHardwareInfo.IoDataInAddress
@@ -29,6 +31,21 @@ typedef struct {
 
 #define MANAGEABILITY_TRANSPORT_KCS_FROM_LINK(a)  CR (a, MANAGEABILITY_TRANSPORT_KCS, Token, MANAGEABILITY_TRANSPORT_KCS_SIGNATURE)
 
+///
+/// The lock of a KCS interface. Each manageability protocol driver links its
+/// own instance of this library, the lock is installed with
+/// gManageabilityTransportKcsLockProtocolGuid to be shared by the drivers
+/// accessing the same KCS interface.
+///
+typedef struct {
+  UINT32                                 Signature;
+  EFI_LOCK                               Lock;          ///< Protects Owner and LockCount.
+  BOOLEAN                                MemoryMap;     ///< The KCS interface the lock is for.
+  MANAGEABILITY_TRANSPORT_HARDWARE_IO    IoBaseAddress;
+  MANAGEABILITY_TRANSPORT_TOKEN          *Owner;        ///< The transport session owns the interface.
+  UINTN                                  LockCount;     ///< The recursion count of Owner.
+} MANAGEABILITY_TRANSPORT_KCS_LOCK;
+
 #define IPMI_KCS_GET_STATE(s)  (s >> 6)
 #define IPMI_KCS_SET_STATE(s)  (s << 6)
 
@@ -83,6 +100,51 @@ KcsTransportSendCommand (
   OUT  MANAGEABILITY_TRANSPORT_ADDITIONAL_STATUS  *AdditionalStatus
   );
 
+/**
+  This function writes/sends the scatter-gather list to the KCS port.
+  The elements are sent back to back as one KCS write transfer.
+
+  @param[in]      Vector                The scatter-gather list.
+  @param[in]      NumberOfVectors       Number of elements in Vector.
+
+  @retval     EFI_SUCCESS           The data was successfully sent to the
+                                    device.
+  @retval     EFI_INVALID_PARAMETER The scatter-gather list is empty or has an
+                                    element with NULL buffer.
+  @retval     EFI_NOT_READY         Ipmi Device is not ready for Ipmi command
+                                    access.
+  @retval     EFI_TIMEOUT           The command time out.
+**/
+EFI_STATUS
+KcsTransportWriteVector (
+  IN  MANAGEABILITY_TRANSMIT_VECTOR  *Vector,
+  IN  UINT16                         NumberOfVectors
+  );
+
+/**
+  This function starts to account a KCS command in the transport statistics.
+
+  @retval     UINT64      The performance counter value when the command
+                          starts.
+**/
+UINT64
+KcsStatisticsBegin (
+  VOID
+  );
+
+/**
+  This function records the latency and the retries of a KCS command in the
+  transport statistics.
+
+  @param[in]  BeginTick   The value returned by KcsStatisticsBegin.
+  @param[in]  Status      The status of the command.
+**/
+VOID
+KcsStatisticsEnd (
+  IN  UINT64      BeginTick,
+  IN  EFI_STATUS  Status
+  );
+
 /**
   This function reads 8-bit value from register address.
 
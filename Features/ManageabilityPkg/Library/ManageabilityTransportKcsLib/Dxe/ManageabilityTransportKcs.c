@@ -13,6 +13,7 @@
 #include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
 #include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
 #include <Library/ManageabilityTransportLib.h>
 #include <Library/ManageabilityTransportIpmiLib.h>
 #include <Library/ManageabilityTransportHelperLib.h>
@@ -29,6 +30,163 @@ EFI_GUID  *SupportedManageabilityProtocol[] = {
 UINT8  NumberOfSupportedProtocol = (sizeof (SupportedManageabilityProtocol)/sizeof (EFI_GUID *));
 
 MANAGEABILITY_TRANSPORT_KCS_HARDWARE_INFO  mKcsHardwareInfo;
+MANAGEABILITY_TRANSPORT_KCS_LOCK           *mKcsLock = NULL;
+
+extern MANAGEABILITY_TRANSPORT_STATISTICS  mKcsStatistics;
+
+/**
+  This function finds the lock of the KCS interface in mKcsHardwareInfo,
+  which is installed by another driver linked with this library. The lock
+  is created and installed if it is not found.
+
+  @retval      EFI_SUCCESS              mKcsLock is set to the lock.
+  @retval      EFI_OUT_OF_RESOURCES     Out of resource to create the lock.
+  @retval      Otherwise                Failed to install the lock.
+
+**/
+EFI_STATUS
+KcsTransportAttachLock (
+  VOID
+  )
+{
+  EFI_STATUS                        Status;
+  EFI_HANDLE                        *HandleBuffer;
+  UINTN                             NumberOfHandles;
+  UINTN                             Index;
+  EFI_HANDLE                        Handle;
+  MANAGEABILITY_TRANSPORT_KCS_LOCK  *KcsLock;
+
+  Status = gBS->LocateHandleBuffer (
+                  ByProtocol,
+                  &gManageabilityTransportKcsLockProtocolGuid,
+                  NULL,
+                  &NumberOfHandles,
+                  &HandleBuffer
+                  );
+  if (!EFI_ERROR (Status)) {
+    for (Index = 0; Index < NumberOfHandles; Index++) {
+      Status = gBS->HandleProtocol (
+                      HandleBuffer[Index],
+                      &gManageabilityTransportKcsLockProtocolGuid,
+                      (VOID **)&KcsLock
+                      );
+      if (EFI_ERROR (Status) || (KcsLock->Signature != MANAGEABILITY_TRANSPORT_KCS_LOCK_SIGNATURE)) {
+        continue;
+      }
+
+      if ((KcsLock->MemoryMap == mKcsHardwareInfo.MemoryMap) &&
+          (KcsLock->IoBaseAddress.IoAddress32 == mKcsHardwareInfo.IoBaseAddress.IoAddress32))
+      {
+        FreePool (HandleBuffer);
+        mKcsLock = KcsLock;
+        return EFI_SUCCESS;
+      }
+    }
+
+    FreePool (HandleBuffer);
+  }
+
+  KcsLock = AllocateZeroPool (sizeof (MANAGEABILITY_TRANSPORT_KCS_LOCK));
+  if (KcsLock == NULL) {
+    DEBUG ((DEBUG_ERROR, "%a: Fail to allocate memory for MANAGEABILITY_TRANSPORT_KCS_LOCK\n", __func__));
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  KcsLock->Signature     = MANAGEABILITY_TRANSPORT_KCS_LOCK_SIGNATURE;
+  KcsLock->MemoryMap     = mKcsHardwareInfo.MemoryMap;
+  KcsLock->IoBaseAddress = mKcsHardwareInfo.IoBaseAddress;
+  EfiInitializeLock (&KcsLock->Lock, TPL_NOTIFY);
+
+  Handle = NULL;
+  Status = gBS->InstallProtocolInterface (
+                  &Handle,
+                  &gManageabilityTransportKcsLockProtocolGuid,
+                  EFI_NATIVE_INTERFACE,
+                  KcsLock
+                  );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: Failed to install the KCS lock - %r\n", __func__, Status));
+    FreePool (KcsLock);
+    return Status;
+  }
+
+  mKcsLock = KcsLock;
+  return EFI_SUCCESS;
+}
+
+/**
+  This function locks the KCS interface for the transport session.
+  See the definition of MANAGEABILITY_TRANSPORT_LOCK.
+
+  @param [in]   TransportToken          The transport token acquired through
+                                        AcquireTransportSession function.
+
+  @retval      EFI_SUCCESS              The KCS interface is locked.
+  @retval      EFI_INVALID_PARAMETER    The invalid transport token.
+  @retval      EFI_NOT_READY            The KCS interface is locked by the
+                                        transport session of another driver.
+
+**/
+EFI_STATUS
+EFIAPI
+KcsTransportLock (
+  IN  MANAGEABILITY_TRANSPORT_TOKEN  *TransportToken
+  )
+{
+  EFI_STATUS  Status;
+
+  if (TransportToken == NULL) {
+    DEBUG ((DEBUG_ERROR, "%a: Invalid transport token.\n", __func__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (mKcsLock == NULL) {
+    //
+    // The transport interface is not initialized.
+    //
+    return EFI_SUCCESS;
+  }
+
+  Status = EFI_SUCCESS;
+  EfiAcquireLock (&mKcsLock->Lock);
+  if ((mKcsLock->Owner != NULL) && (mKcsLock->Owner != TransportToken)) {
+    Status = EFI_NOT_READY;
+  } else {
+    mKcsLock->Owner = TransportToken;
+    mKcsLock->LockCount++;
+  }
+
+  EfiReleaseLock (&mKcsLock->Lock);
+  return Status;
+}
+
+/**
+  This function unlocks the KCS interface locked through KcsTransportLock.
+
+  @param [in]   TransportToken          The transport token acquired through
+                                        AcquireTransportSession function.
+
+**/
+VOID
+EFIAPI
+KcsTransportUnlock (
+  IN  MANAGEABILITY_TRANSPORT_TOKEN  *TransportToken
+  )
+{
+  if ((TransportToken == NULL) || (mKcsLock == NULL)) {
+    return;
+  }
+
+  EfiAcquireLock (&mKcsLock->Lock);
+  if ((mKcsLock->Owner == TransportToken) && (mKcsLock->LockCount != 0)) {
+    mKcsLock->LockCount--;
+    if (mKcsLock->LockCount == 0) {
+      mKcsLock->Owner = NULL;
+    }
+  }
+
+  EfiReleaseLock (&mKcsLock->Lock);
+}
 
 /**
   This function initializes the transport interface.
@@ -45,6 +203,8 @@ MANAGEABILITY_TRANSPORT_KCS_HARDWARE_INFO  mKcsHardwareInfo;
   @retval                               is not ready.
   @retval      EFI_DEVICE_ERROR         The transport interface has problems.
   @retval      EFI_ALREADY_STARTED      Teh protocol interface has already initialized.
+  @retval      EFI_OUT_OF_RESOURCES     Out of resource to create the lock of
+                                        KCS interface.
   @retval      Otherwise                Other errors.
 
 **/
@@ -99,7 +259,12 @@ KcsTransportInit (
     DEBUG ((DEBUG_MANAGEABILITY_INFO, "Status I/O port  : 0x%04x\n", mKcsHardwareInfo.IoStatusAddress.IoAddress16));
   }
 
-  return EFI_SUCCESS;
+  //
+  // The KCS interface may be accessed by the drivers of other manageability
+  // protocols, e.g. IPMI and MCTP over KCS, each from its own timer event.
+  // The transfers are serialized through the lock shared with them.
+  //
+  return KcsTransportAttachLock ();
 }
 
 /**
@@ -221,12 +386,22 @@ KcsTransportTransmitReceive (
 {
   EFI_STATUS                                 Status;
   MANAGEABILITY_TRANSPORT_ADDITIONAL_STATUS  AdditionalStatus;
+  UINT64                                     BeginTick;
 
   if ((TransportToken == NULL) || (TransferToken == NULL)) {
     DEBUG ((DEBUG_ERROR, "%a: Invalid transport token or transfer token.\n", __func__));
     return;
   }
 
+  Status = KcsTransportLock (TransportToken);
+  if (EFI_ERROR (Status)) {
+    TransferToken->TransferStatus            = Status;
+    TransferToken->TransportAdditionalStatus = MANAGEABILITY_TRANSPORT_ADDITIONAL_STATUS_NOT_AVAILABLE;
+    return;
+  }
+
+  BeginTick = KcsStatisticsBegin ();
+
   Status = KcsTransportSendCommand (
              TransferToken->TransmitHeader,
              TransferToken->TransmitHeaderSize,
@@ -238,10 +413,98 @@ KcsTransportTransmitReceive (
              &TransferToken->ReceivePackage.ReceiveSizeInByte,
              &AdditionalStatus
              );
+  KcsStatisticsEnd (BeginTick, Status);
 
   TransferToken->TransferStatus = Status;
   KcsTransportStatus (TransportToken, &TransferToken->TransportAdditionalStatus);
   TransferToken->TransportAdditionalStatus |= AdditionalStatus;
+  KcsTransportUnlock (TransportToken);
+}
+
+/**
+  This function transmits one packet given in the scatter-gather list over
+  KCS without receiving the response.
+
+  @param [in]   TransportToken             The transport token acquired through
+                                           AcquireTransportSession function.
+  @param [in]   Vector                     The scatter-gather list of packet.
+  @param [in]   NumberOfVectors            Number of elements in Vector.
+  @param [out]  TransportAdditionalStatus  The additional status of transport
+                                           interface.
+
+  @retval      EFI_SUCCESS              The packet is transmitted.
+  @retval      EFI_INVALID_PARAMETER    The invalid transport token or
+                                        scatter-gather list.
+  @retval      EFI_NOT_READY            The KCS interface is locked by the
+                                        transport session of another driver.
+  @retval      Otherwise                Other errors.
+
+**/
+EFI_STATUS
+EFIAPI
+KcsTransportTransmitVector (
+  IN  MANAGEABILITY_TRANSPORT_TOKEN              *TransportToken,
+  IN  MANAGEABILITY_TRANSMIT_VECTOR              *Vector,
+  IN  UINT16                                     NumberOfVectors,
+  OUT MANAGEABILITY_TRANSPORT_ADDITIONAL_STATUS  *TransportAdditionalStatus
+  )
+{
+  EFI_STATUS  Status;
+  UINT64      BeginTick;
+
+  if ((TransportToken == NULL) || (Vector == NULL) || (TransportAdditionalStatus == NULL)) {
+    DEBUG ((DEBUG_ERROR, "%a: Invalid transport token or scatter-gather list.\n", __func__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status = KcsTransportLock (TransportToken);
+  if (EFI_ERROR (Status)) {
+    *TransportAdditionalStatus = MANAGEABILITY_TRANSPORT_ADDITIONAL_STATUS_NOT_AVAILABLE;
+    return Status;
+  }
+
+  BeginTick = KcsStatisticsBegin ();
+  Status    = KcsTransportWriteVector (Vector, NumberOfVectors);
+  KcsStatisticsEnd (BeginTick, Status);
+
+  KcsTransportStatus (TransportToken, TransportAdditionalStatus);
+  KcsTransportUnlock (TransportToken);
+  return Status;
+}
+
+/**
+  This function returns the statistics collected by the transport interface.
+
+  @param [in]   TransportToken           The transport token acquired through
+                                         AcquireTransportSession function.
+  @param [out]  Statistics               Pointer to receive the statistics.
+  @param [in]   Reset                    TRUE to clear the statistics after
+                                         they are returned.
+
+  @retval      EFI_SUCCESS              The statistics are returned.
+  @retval      EFI_INVALID_PARAMETER    The invalid transport token or
+                                        Statistics is NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+KcsTransportGetStatistics (
+  IN  MANAGEABILITY_TRANSPORT_TOKEN       *TransportToken,
+  OUT MANAGEABILITY_TRANSPORT_STATISTICS  *Statistics,
+  IN  BOOLEAN                             Reset
+  )
+{
+  if ((TransportToken == NULL) || (Statistics == NULL)) {
+    DEBUG ((DEBUG_ERROR, "%a: Invalid transport token or statistics buffer.\n", __func__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  CopyMem (Statistics, &mKcsStatistics, sizeof (MANAGEABILITY_TRANSPORT_STATISTICS));
+  if (Reset) {
+    ZeroMem (&mKcsStatistics, sizeof (MANAGEABILITY_TRANSPORT_STATISTICS));
+  }
+
+  return EFI_SUCCESS;
 }
 
 /**
@@ -307,12 +570,12 @@ AcquireTransportSession (
 
   KcsTransportToken->Signature                                            = MANAGEABILITY_TRANSPORT_KCS_SIGNATURE;
   KcsTransportToken->Token.ManageabilityProtocolSpecification             = ManageabilityProtocolSpec;
-  KcsTransportToken->Token.Transport->TransportVersion                    = MANAGEABILITY_TRANSPORT_TOKEN_VERSION;
+  KcsTransportToken->Token.Transport->TransportVersion                    = MANAGEABILITY_TRANSPORT_TOKEN_VERSION_1_3;
   KcsTransportToken->Token.Transport->ManageabilityTransportSpecification = &gManageabilityTransportKcsGuid;
   KcsTransportToken->Token.Transport->TransportName                       = L"KCS";
-  KcsTransportToken->Token.Transport->Function.Version1_0                 = AllocateZeroPool (sizeof (MANAGEABILITY_TRANSPORT_FUNCTION_V1_0));
-  if (KcsTransportToken->Token.Transport->Function.Version1_0 == NULL) {
-    DEBUG ((DEBUG_ERROR, "%a: Fail to allocate memory for MANAGEABILITY_TRANSPORT_FUNCTION_V1_0\n", __func__));
+  KcsTransportToken->Token.Transport->Function.Version1_3                 = AllocateZeroPool (sizeof (MANAGEABILITY_TRANSPORT_FUNCTION_V1_3));
+  if (KcsTransportToken->Token.Transport->Function.Version1_3 == NULL) {
+    DEBUG ((DEBUG_ERROR, "%a: Fail to allocate memory for MANAGEABILITY_TRANSPORT_FUNCTION_V1_3\n", __func__));
     FreePool (KcsTransportToken);
     FreePool (KcsTransportToken->Token.Transport);
     return EFI_OUT_OF_RESOURCES;
@@ -322,6 +585,10 @@ AcquireTransportSession (
   KcsTransportToken->Token.Transport->Function.Version1_0->TransportReset           = KcsTransportReset;
   KcsTransportToken->Token.Transport->Function.Version1_0->TransportStatus          = KcsTransportStatus;
   KcsTransportToken->Token.Transport->Function.Version1_0->TransportTransmitReceive = KcsTransportTransmitReceive;
+  KcsTransportToken->Token.Transport->Function.Version1_1->TransportGetStatistics   = KcsTransportGetStatistics;
+  KcsTransportToken->Token.Transport->Function.Version1_2->TransportTransmitVector  = KcsTransportTransmitVector;
+  KcsTransportToken->Token.Transport->Function.Version1_3->TransportLock            = KcsTransportLock;
+  KcsTransportToken->Token.Transport->Function.Version1_3->TransportUnlock          = KcsTransportUnlock;
 
   mSingleSessionToken = KcsTransportToken;
   *TransportToken     = &KcsTransportToken->Token;
@@ -398,6 +665,16 @@ ReleaseTransportSession (
   }
 
   if (KcsTransportToken != NULL) {
+    //
+    // Don't leave the KCS interface locked by the released session.
+    //
+    if ((mKcsLock != NULL) && (mKcsLock->Owner == TransportToken)) {
+      EfiAcquireLock (&mKcsLock->Lock);
+      mKcsLock->Owner     = NULL;
+      mKcsLock->LockCount = 0;
+      EfiReleaseLock (&mKcsLock->Lock);
+    }
+
     FreePool (KcsTransportToken->Token.Transport->Function.Version1_0);
     FreePool (KcsTransportToken->Token.Transport);
     FreePool (KcsTransportToken);
@@ -184,6 +184,7 @@ MctpTransportTransmitReceive (
       // Dxe MCTP Protocol is not installed.
       //
       DEBUG ((DEBUG_ERROR, "%a: EDKII MCTP protocol is not found - %r\n", __func__, Status));
+      TransferToken->TransferStatus = Status;
       return;
     }
   }
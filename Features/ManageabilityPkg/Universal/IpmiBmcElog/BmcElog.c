@@ -14,15 +14,236 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/UefiRuntimeServicesTableLib.h>
 #include <Library/IpmiCommandLib.h>
+#include <Protocol/IpmiAsyncProtocol.h>
 
 #include <Library/ManageabilityTransportHelperLib.h>
 
+///
+/// The BMC event log request submitted through EDKII_IPMI_ASYNC_PROTOCOL.
+///
+typedef struct {
+  EDKII_IPMI_COMMAND_TOKEN                Token;
+  IPMI_GET_BMC_GLOBAL_ENABLES_RESPONSE    GetBmcGlobalEnables;
+  IPMI_SET_BMC_GLOBAL_ENABLES_REQUEST     SetBmcGlobalEnables;
+  UINT8                                   CompletionCode;
+  IPMI_GET_SEL_INFO_RESPONSE              SelInfo;
+} BMC_ELOG_REQUEST;
+
+EDKII_IPMI_ASYNC_PROTOCOL  *mIpmiAsync = NULL;
+
 EFI_STATUS
 EFIAPI
 CheckIfSelIsFull (
   VOID
   );
 
+/**
+  This function submits an IPMI command of the BMC event log request without
+  waiting for the response. NotifyFunction is called with the request when
+  the command completes.
+
+  @param[in]  ElogRequest       The BMC event log request.
+  @param[in]  NetFunction       Net function of the command.
+  @param[in]  Command           IPMI Command.
+  @param[in]  RequestData       Command Request Data.
+  @param[in]  RequestDataSize   Size of Command Request Data.
+  @param[in]  ResponseData      Command Response Data.
+  @param[in]  ResponseDataSize  Size of Command Response Data.
+  @param[in]  NotifyFunction    The function called on completion.
+
+  @retval     EFI_SUCCESS       The command is submitted.
+  @retval     Otherwise         The command could not be submitted.
+**/
+EFI_STATUS
+SubmitBmcElogCommand (
+  IN  BMC_ELOG_REQUEST  *ElogRequest,
+  IN  UINT8             NetFunction,
+  IN  UINT8             Command,
+  IN  VOID              *RequestData,
+  IN  UINT32            RequestDataSize,
+  IN  VOID              *ResponseData,
+  IN  UINT32            ResponseDataSize,
+  IN  EFI_EVENT_NOTIFY  NotifyFunction
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = gBS->CreateEvent (
+                  EVT_NOTIFY_SIGNAL,
+                  TPL_CALLBACK,
+                  NotifyFunction,
+                  ElogRequest,
+                  &ElogRequest->Token.Event
+                  );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  ElogRequest->Token.NetFunction      = NetFunction;
+  ElogRequest->Token.Command          = Command;
+  ElogRequest->Token.RequestData      = RequestData;
+  ElogRequest->Token.RequestDataSize  = RequestDataSize;
+  ElogRequest->Token.ResponseData     = ResponseData;
+  ElogRequest->Token.ResponseDataSize = ResponseDataSize;
+  Status                              = mIpmiAsync->IpmiSubmitCommandAsync (mIpmiAsync, &ElogRequest->Token);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: Failed to submit IPMI command 0x%x - %r\n", __func__, Command, Status));
+    gBS->CloseEvent (ElogRequest->Token.Event);
+  }
+
+  return Status;
+}
+
+/**
+  Notification function of the Set BMC Global Enables command that activates
+  BMC event log.
+
+  @param[in]  Event           The event of the command.
+  @param[in]  Context         The BMC event log request.
+**/
+VOID
+EFIAPI
+SetBmcGlobalEnablesNotify (
+  IN  EFI_EVENT  Event,
+  IN  VOID       *Context
+  )
+{
+  BMC_ELOG_REQUEST  *ElogRequest;
+
+  ElogRequest = (BMC_ELOG_REQUEST *)Context;
+  if (EFI_ERROR (ElogRequest->Token.TransferStatus)) {
+    DEBUG ((DEBUG_ERROR, "%a: Failed to activate BMC event log - %r\n", __func__, ElogRequest->Token.TransferStatus));
+  }
+
+  gBS->CloseEvent (Event);
+  FreePool (ElogRequest);
+}
+
+/**
+  Notification function of the Get BMC Global Enables command. The system
+  event logging is enabled in the BMC global enables returned by BMC.
+
+  @param[in]  Event           The event of the command.
+  @param[in]  Context         The BMC event log request.
+**/
+VOID
+EFIAPI
+GetBmcGlobalEnablesNotify (
+  IN  EFI_EVENT  Event,
+  IN  VOID       *Context
+  )
+{
+  BMC_ELOG_REQUEST  *ElogRequest;
+
+  ElogRequest = (BMC_ELOG_REQUEST *)Context;
+  gBS->CloseEvent (Event);
+  if (!EFI_ERROR (ElogRequest->Token.TransferStatus)) {
+    CopyMem (&ElogRequest->SetBmcGlobalEnables, (UINT8 *)&ElogRequest->GetBmcGlobalEnables + 1, sizeof (UINT8));
+    ElogRequest->SetBmcGlobalEnables.SetEnables.Bits.SystemEventLogging = 1;
+    if (!EFI_ERROR (
+           SubmitBmcElogCommand (
+             ElogRequest,
+             IPMI_NETFN_APP,
+             IPMI_APP_SET_BMC_GLOBAL_ENABLES,
+             &ElogRequest->SetBmcGlobalEnables,
+             sizeof (ElogRequest->SetBmcGlobalEnables),
+             &ElogRequest->CompletionCode,
+             sizeof (ElogRequest->CompletionCode),
+             SetBmcGlobalEnablesNotify
+             )
+           ))
+    {
+      return;
+    }
+  }
+
+  FreePool (ElogRequest);
+}
+
+/**
+  Notification function of the Get SEL Info command that checks whether
+  the BMC SEL is full.
+
+  @param[in]  Event           The event of the command.
+  @param[in]  Context         The BMC event log request.
+**/
+VOID
+EFIAPI
+GetSelInfoNotify (
+  IN  EFI_EVENT  Event,
+  IN  VOID       *Context
+  )
+{
+  BMC_ELOG_REQUEST  *ElogRequest;
+
+  ElogRequest = (BMC_ELOG_REQUEST *)Context;
+  if (!EFI_ERROR (ElogRequest->Token.TransferStatus)) {
+    DEBUG ((DEBUG_MANAGEABILITY_INFO, "SelIsFull - 0x%x\n", ElogRequest->SelInfo.OperationSupport & 0x80));
+  }
+
+  gBS->CloseEvent (Event);
+  FreePool (ElogRequest);
+}
+
+/**
+  This function queues the IPMI commands that activate BMC event log and
+  check whether the BMC SEL is full, the driver doesn't wait for BMC.
+
+  @retval  EFI_SUCCESS            The commands are submitted.
+  @retval  EFI_OUT_OF_RESOURCES   Out of resource to submit the commands.
+  @retval  Otherwise              The commands could not be submitted.
+
+**/
+EFI_STATUS
+SubmitBmcElogRequests (
+  VOID
+  )
+{
+  EFI_STATUS        Status;
+  BMC_ELOG_REQUEST  *ElogRequest;
+
+  ElogRequest = AllocateZeroPool (sizeof (BMC_ELOG_REQUEST));
+  if (ElogRequest == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = SubmitBmcElogCommand (
+             ElogRequest,
+             IPMI_NETFN_APP,
+             IPMI_APP_GET_BMC_GLOBAL_ENABLES,
+             NULL,
+             0,
+             &ElogRequest->GetBmcGlobalEnables,
+             sizeof (ElogRequest->GetBmcGlobalEnables),
+             GetBmcGlobalEnablesNotify
+             );
+  if (EFI_ERROR (Status)) {
+    FreePool (ElogRequest);
+    return Status;
+  }
+
+  ElogRequest = AllocateZeroPool (sizeof (BMC_ELOG_REQUEST));
+  if (ElogRequest == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = SubmitBmcElogCommand (
+             ElogRequest,
+             IPMI_NETFN_STORAGE,
+             IPMI_STORAGE_GET_SEL_INFO,
+             NULL,
+             0,
+             &ElogRequest->SelInfo,
+             sizeof (ElogRequest->SelInfo),
+             GetSelInfoNotify
+             );
+  if (EFI_ERROR (Status)) {
+    FreePool (ElogRequest);
+  }
+
+  return Status;
+}
+
 /**
   This function erases event logs and waits until complete.
 
@@ -135,6 +356,7 @@ SetElogRedirInstall (
   //
   // Activate the Event Log (This should depend upon Setup).
   //
+  EnableElog = TRUE;
   EfiActivateBmcElog (&EnableElog, &ElogStatus);
   return EFI_SUCCESS;
 }
@@ -155,6 +377,17 @@ InitializeBmcElogLayer (
   IN EFI_SYSTEM_TABLE  *SystemTable
   )
 {
+  EFI_STATUS  Status;
+
+  //
+  // Don't wait for BMC when the IPMI commands can be queued.
+  //
+  Status = gBS->LocateProtocol (&gEdkiiIpmiAsyncProtocolGuid, NULL, (VOID **)&mIpmiAsync);
+  if (!EFI_ERROR (Status)) {
+    SubmitBmcElogRequests ();
+    return EFI_SUCCESS;
+  }
+
   SetElogRedirInstall ();
 
   CheckIfSelIsFull ();
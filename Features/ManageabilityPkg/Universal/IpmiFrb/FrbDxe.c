@@ -15,9 +15,22 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/PcdLib.h>
 #include <Library/IpmiCommandLib.h>
 #include <IndustryStandard/Ipmi.h>
+#include <Protocol/IpmiAsyncProtocol.h>
 
 #include <Library/ManageabilityTransportHelperLib.h>
 
+///
+/// The watchdog timer request submitted through EDKII_IPMI_ASYNC_PROTOCOL.
+///
+typedef struct {
+  EDKII_IPMI_COMMAND_TOKEN            Token;
+  IPMI_GET_WATCHDOG_TIMER_RESPONSE    GetWatchdogTimer;
+  IPMI_SET_WATCHDOG_TIMER_REQUEST     SetWatchdogTimer;
+  UINT8                               CompletionCode;
+} FRB_WATCHDOG_REQUEST;
+
+EDKII_IPMI_ASYNC_PROTOCOL  *mIpmiAsync = NULL;
+
 /**
   This routine disables the specified FRB timer.
 
@@ -82,6 +95,46 @@ DisableFRB2Handler (
   EfiDisableFrb ();
 }
 
+/**
+  This function reports the kind of watchdog timeout occurred and builds
+  the request that clears the timer expiration flags.
+
+  @param[in]   GetWatchdogTimer  The watchdog timer info returned by BMC.
+  @param[out]  SetWatchdogTimer  The request to clear the expiration flags.
+
+**/
+VOID
+BuildClearExpirationFlagsRequest (
+  IN  IPMI_GET_WATCHDOG_TIMER_RESPONSE  *GetWatchdogTimer,
+  OUT IPMI_SET_WATCHDOG_TIMER_REQUEST   *SetWatchdogTimer
+  )
+{
+  //
+  // If FRB2 Failure occurred, report it to the error manager and log a SEL.
+  //
+  if ((GetWatchdogTimer->TimerUseExpirationFlagsClear & BIT1) != 0) {
+    //
+    // Report the FRB2 time-out error
+    //
+  } else if ((GetWatchdogTimer->TimerUseExpirationFlagsClear & BIT3) != 0) {
+    //
+    // Report the OS Watchdog timer failure
+    //
+  }
+
+  //
+  // Need to clear Timer expiration flags after checking.
+  //
+  ZeroMem (SetWatchdogTimer, sizeof (*SetWatchdogTimer));
+  SetWatchdogTimer->TimerUse                      = GetWatchdogTimer->TimerUse;
+  SetWatchdogTimer->TimerActions                  = GetWatchdogTimer->TimerActions;
+  SetWatchdogTimer->PretimeoutInterval            = GetWatchdogTimer->PretimeoutInterval;
+  SetWatchdogTimer->TimerUseExpirationFlagsClear  = GetWatchdogTimer->TimerUseExpirationFlagsClear;
+  SetWatchdogTimer->InitialCountdownValue         = GetWatchdogTimer->InitialCountdownValue;
+  SetWatchdogTimer->TimerUse.Bits.TimerRunning    = 1;
+  SetWatchdogTimer->TimerUseExpirationFlagsClear |= BIT1 | BIT2 | BIT3;
+}
+
 /**
   This function checks the Watchdog timer expiration flags and
   report the kind of watchdog timeout occurred to the Error
@@ -110,31 +163,7 @@ CheckForAndReportErrors (
     return Status;
   }
 
-  //
-  // If FRB2 Failure occurred, report it to the error manager and log a SEL.
-  //
-  if ((GetWatchdogTimer.TimerUseExpirationFlagsClear & BIT1) != 0) {
-    //
-    // Report the FRB2 time-out error
-    //
-  } else if ((GetWatchdogTimer.TimerUseExpirationFlagsClear & BIT3) != 0) {
-    //
-    // Report the OS Watchdog timer failure
-    //
-  }
-
-  //
-  // Need to clear Timer expiration flags after checking.
-  //
-  ZeroMem (&SetWatchdogTimer, sizeof (SetWatchdogTimer));
-  SetWatchdogTimer.TimerUse                      = GetWatchdogTimer.TimerUse;
-  SetWatchdogTimer.TimerActions                  = GetWatchdogTimer.TimerActions;
-  SetWatchdogTimer.PretimeoutInterval            = GetWatchdogTimer.PretimeoutInterval;
-  SetWatchdogTimer.TimerUseExpirationFlagsClear  = GetWatchdogTimer.TimerUseExpirationFlagsClear;
-  SetWatchdogTimer.InitialCountdownValue         = GetWatchdogTimer.InitialCountdownValue;
-  SetWatchdogTimer.TimerUse.Bits.TimerRunning    = 1;
-  SetWatchdogTimer.TimerUseExpirationFlagsClear |= BIT1 | BIT2 | BIT3;
-
+  BuildClearExpirationFlagsRequest (&GetWatchdogTimer, &SetWatchdogTimer);
   Status = IpmiSetWatchdogTimer (&SetWatchdogTimer, &CompletionCode);
 
   return Status;
@@ -177,6 +206,147 @@ ReportFrb2Status (
   return EFI_SUCCESS;
 }
 
+/**
+  This function submits a watchdog timer command without waiting for the
+  response. NotifyFunction is called with the request when the command
+  completes.
+
+  @param[in]  FrbRequest      The watchdog timer request.
+  @param[in]  Command         IPMI_APP_GET_WATCHDOG_TIMER or
+                              IPMI_APP_SET_WATCHDOG_TIMER.
+  @param[in]  NotifyFunction  The function called on completion.
+
+  @retval     EFI_SUCCESS     The command is submitted.
+  @retval     Otherwise       The command could not be submitted.
+**/
+EFI_STATUS
+SubmitWatchdogTimerCommand (
+  IN  FRB_WATCHDOG_REQUEST  *FrbRequest,
+  IN  UINT8                 Command,
+  IN  EFI_EVENT_NOTIFY      NotifyFunction
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = gBS->CreateEvent (
+                  EVT_NOTIFY_SIGNAL,
+                  TPL_CALLBACK,
+                  NotifyFunction,
+                  FrbRequest,
+                  &FrbRequest->Token.Event
+                  );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  FrbRequest->Token.NetFunction = IPMI_NETFN_APP;
+  FrbRequest->Token.Command     = Command;
+  if (Command == IPMI_APP_SET_WATCHDOG_TIMER) {
+    FrbRequest->Token.RequestData      = (UINT8 *)&FrbRequest->SetWatchdogTimer;
+    FrbRequest->Token.RequestDataSize  = sizeof (FrbRequest->SetWatchdogTimer);
+    FrbRequest->Token.ResponseData     = &FrbRequest->CompletionCode;
+    FrbRequest->Token.ResponseDataSize = sizeof (FrbRequest->CompletionCode);
+  } else {
+    FrbRequest->Token.RequestData      = NULL;
+    FrbRequest->Token.RequestDataSize  = 0;
+    FrbRequest->Token.ResponseData     = (UINT8 *)&FrbRequest->GetWatchdogTimer;
+    FrbRequest->Token.ResponseDataSize = sizeof (FrbRequest->GetWatchdogTimer);
+  }
+
+  Status = mIpmiAsync->IpmiSubmitCommandAsync (mIpmiAsync, &FrbRequest->Token);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: Failed to submit IPMI command 0x%x - %r\n", __func__, Command, Status));
+    gBS->CloseEvent (FrbRequest->Token.Event);
+  }
+
+  return Status;
+}
+
+/**
+  Notification function of the Get Watchdog Timer command that reports the
+  status of FRB2. This is the last command of the request.
+
+  @param[in]  Event           The event of the command.
+  @param[in]  Context         The watchdog timer request.
+**/
+VOID
+EFIAPI
+ReportFrb2StatusNotify (
+  IN  EFI_EVENT  Event,
+  IN  VOID       *Context
+  )
+{
+  FRB_WATCHDOG_REQUEST  *FrbRequest;
+
+  FrbRequest = (FRB_WATCHDOG_REQUEST *)Context;
+  if (EFI_ERROR (FrbRequest->Token.TransferStatus)) {
+    DEBUG ((DEBUG_ERROR, "Failed to get Watchdog Timer info from BMC.\n"));
+  } else if (FrbRequest->GetWatchdogTimer.TimerUse.Bits.TimerRunning == 1) {
+    DEBUG ((DEBUG_MANAGEABILITY_INFO, "FRB2 Timer is running.\n"));
+  } else {
+    DEBUG ((DEBUG_MANAGEABILITY_INFO, "FRB2 Timer is not running.\n"));
+  }
+
+  gBS->CloseEvent (Event);
+  FreePool (FrbRequest);
+}
+
+/**
+  Notification function of the Set Watchdog Timer command that clears the
+  timer expiration flags. The status of FRB2 is retrieved next.
+
+  @param[in]  Event           The event of the command.
+  @param[in]  Context         The watchdog timer request.
+**/
+VOID
+EFIAPI
+ClearExpirationFlagsNotify (
+  IN  EFI_EVENT  Event,
+  IN  VOID       *Context
+  )
+{
+  FRB_WATCHDOG_REQUEST  *FrbRequest;
+
+  FrbRequest = (FRB_WATCHDOG_REQUEST *)Context;
+  gBS->CloseEvent (Event);
+  if (EFI_ERROR (SubmitWatchdogTimerCommand (FrbRequest, IPMI_APP_GET_WATCHDOG_TIMER, ReportFrb2StatusNotify))) {
+    FreePool (FrbRequest);
+  }
+}
+
+/**
+  Notification function of the Get Watchdog Timer command that checks the
+  timer expiration flags. The flags are cleared next, then the status of
+  FRB2 is retrieved, in the same order as CheckForAndReportErrors and
+  ReportFrb2Status.
+
+  @param[in]  Event           The event of the command.
+  @param[in]  Context         The watchdog timer request.
+**/
+VOID
+EFIAPI
+CheckForAndReportErrorsNotify (
+  IN  EFI_EVENT  Event,
+  IN  VOID       *Context
+  )
+{
+  FRB_WATCHDOG_REQUEST  *FrbRequest;
+  EFI_STATUS            Status;
+
+  FrbRequest = (FRB_WATCHDOG_REQUEST *)Context;
+  gBS->CloseEvent (Event);
+  if (!EFI_ERROR (FrbRequest->Token.TransferStatus)) {
+    BuildClearExpirationFlagsRequest (&FrbRequest->GetWatchdogTimer, &FrbRequest->SetWatchdogTimer);
+    Status = SubmitWatchdogTimerCommand (FrbRequest, IPMI_APP_SET_WATCHDOG_TIMER, ClearExpirationFlagsNotify);
+  } else {
+    Status = SubmitWatchdogTimerCommand (FrbRequest, IPMI_APP_GET_WATCHDOG_TIMER, ReportFrb2StatusNotify);
+  }
+
+  if (EFI_ERROR (Status)) {
+    FreePool (FrbRequest);
+  }
+}
+
 /**
   The entry point of the Ipmi Fault Resilient Booting DXE driver.
 
@@ -194,11 +364,31 @@ FrbDxeEntryPoint (
   IN EFI_SYSTEM_TABLE  *SystemTable
   )
 {
-  EFI_EVENT   ReadyToBootEvent;
-  EFI_STATUS  Status;
+  EFI_EVENT             ReadyToBootEvent;
+  EFI_STATUS            Status;
+  FRB_WATCHDOG_REQUEST  *FrbRequest;
 
-  CheckForAndReportErrors ();
-  ReportFrb2Status ();
+  //
+  // Don't wait for BMC when the IPMI commands can be queued. FRB2 is still
+  // disabled synchronously at ReadyToBoot, which runs after the commands
+  // queued here.
+  //
+  FrbRequest = NULL;
+  Status     = gBS->LocateProtocol (&gEdkiiIpmiAsyncProtocolGuid, NULL, (VOID **)&mIpmiAsync);
+  if (!EFI_ERROR (Status)) {
+    FrbRequest = AllocateZeroPool (sizeof (FRB_WATCHDOG_REQUEST));
+  }
+
+  if ((FrbRequest == NULL) ||
+      EFI_ERROR (SubmitWatchdogTimerCommand (FrbRequest, IPMI_APP_GET_WATCHDOG_TIMER, CheckForAndReportErrorsNotify)))
+  {
+    if (FrbRequest != NULL) {
+      FreePool (FrbRequest);
+    }
+
+    CheckForAndReportErrors ();
+    ReportFrb2Status ();
+  }
 
   //
   // Register the event to Disable FRB2 before Boot.
@@ -12,8 +12,10 @@
 #include <Library/ManageabilityTransportLib.h>
 #include <Library/ManageabilityTransportIpmiLib.h>
 #include <Library/ManageabilityTransportHelperLib.h>
+#include <Library/ManageabilityRequestQueueLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 #include <Protocol/IpmiProtocol.h>
+#include <Protocol/IpmiAsyncProtocol.h>
 
 #include "IpmiProtocolCommon.h"
 
@@ -21,6 +23,34 @@ MANAGEABILITY_TRANSPORT_TOKEN                 *mTransportToken = NULL;
 CHAR16                                        *mTransportName;
 UINT32                                        TransportMaximumPayload;
 MANAGEABILITY_TRANSPORT_HARDWARE_INFORMATION  mHardwareInformation;
+MANAGEABILITY_REQUEST_QUEUE                   *mRequestQueue = NULL;
+
+/**
+  This function runs the IPMI command queued in the request queue.
+
+  @param[in]  Request         Pointer to EDKII_IPMI_COMMAND_TOKEN.
+
+  @retval     EFI_STATUS      The status of the command.
+**/
+EFI_STATUS
+EFIAPI
+DxeIpmiRunCommand (
+  IN  VOID  *Request
+  )
+{
+  EDKII_IPMI_COMMAND_TOKEN  *Token;
+
+  Token = (EDKII_IPMI_COMMAND_TOKEN *)Request;
+  return CommonIpmiSubmitCommand (
+           mTransportToken,
+           Token->NetFunction,
+           Token->Command,
+           Token->RequestData,
+           Token->RequestDataSize,
+           Token->ResponseData,
+           &Token->ResponseDataSize
+           );
+}
 
 /**
   This service enables submitting commands via Ipmi.
@@ -53,24 +83,70 @@ DxeIpmiSubmitCommand (
   IN OUT UINT32         *ResponseDataSize
   )
 {
-  EFI_STATUS  Status;
+  EFI_STATUS                Status;
+  EDKII_IPMI_COMMAND_TOKEN  Token;
 
-  Status = CommonIpmiSubmitCommand (
-             mTransportToken,
-             NetFunction,
-             Command,
-             RequestData,
-             RequestDataSize,
-             ResponseData,
-             ResponseDataSize
-             );
+  Token.NetFunction      = NetFunction;
+  Token.Command          = Command;
+  Token.RequestData      = RequestData;
+  Token.RequestDataSize  = RequestDataSize;
+  Token.ResponseData     = ResponseData;
+  Token.ResponseDataSize = *ResponseDataSize;
+
+  //
+  // Run the command after the commands queued through
+  // EDKII_IPMI_ASYNC_PROTOCOL.
+  //
+  Status            = ManageabilityRequestQueueRun (mRequestQueue, &Token);
+  *ResponseDataSize = Token.ResponseDataSize;
   return Status;
 }
 
+/**
+  This service submits the IPMI command without waiting for the response.
+
+  @param[in]      This                   EDKII_IPMI_ASYNC_PROTOCOL instance.
+  @param[in, out] Token                  The token of the command.
+
+  @retval EFI_SUCCESS            The command is submitted. The status of the command
+                                 is returned in Token->TransferStatus.
+  @retval EFI_INVALID_PARAMETER  Token is NULL.
+  @retval EFI_OUT_OF_RESOURCES   The resource allocation is out of resource.
+**/
+EFI_STATUS
+EFIAPI
+DxeIpmiSubmitCommandAsync (
+  IN     EDKII_IPMI_ASYNC_PROTOCOL  *This,
+  IN OUT EDKII_IPMI_COMMAND_TOKEN   *Token
+  )
+{
+  if (Token == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (Token->Event == NULL) {
+    Token->LatencyInMicrosecond = 0;
+    Token->TransferStatus       = ManageabilityRequestQueueRun (mRequestQueue, Token);
+    return EFI_SUCCESS;
+  }
+
+  return ManageabilityRequestQueueSubmit (
+           mRequestQueue,
+           Token,
+           Token->Event,
+           &Token->TransferStatus,
+           &Token->LatencyInMicrosecond
+           );
+}
+
 static IPMI_PROTOCOL  mIpmiProtocol = {
   DxeIpmiSubmitCommand
 };
 
+static EDKII_IPMI_ASYNC_PROTOCOL  mIpmiAsyncProtocol = {
+  DxeIpmiSubmitCommandAsync
+};
+
 /**
   The entry point of the Ipmi DXE driver.
 
@@ -143,12 +219,20 @@ DxeIpmiEntry (
     return Status;
   }
 
+  Status = ManageabilityRequestQueueCreate (DxeIpmiRunCommand, &mRequestQueue);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: Failed to create request queue for IPMI protocol - %r\n", __func__, Status));
+    return Status;
+  }
+
   Handle = NULL;
-  Status = gBS->InstallProtocolInterface (
+  Status = gBS->InstallMultipleProtocolInterfaces (
                   &Handle,
                   &gIpmiProtocolGuid,
-                  EFI_NATIVE_INTERFACE,
-                  (VOID **)&mIpmiProtocol
+                  (VOID **)&mIpmiProtocol,
+                  &gEdkiiIpmiAsyncProtocolGuid,
+                  (VOID **)&mIpmiAsyncProtocol,
+                  NULL
                   );
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "%a: Failed to install IPMI protocol - %r\n", __func__, Status));
@@ -176,6 +260,8 @@ IpmiUnloadImage (
 {
   EFI_STATUS  Status;
 
+  ManageabilityRequestQueueDestroy (mRequestQueue);
+
   Status = EFI_SUCCESS;
   if (mTransportToken != NULL) {
     Status = ReleaseTransportSession (mTransportToken);
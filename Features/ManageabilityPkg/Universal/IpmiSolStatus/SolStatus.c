@@ -15,9 +15,23 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/UefiRuntimeServicesTableLib.h>
 #include <Library/IpmiCommandLib.h>
 #include <IndustryStandard/Ipmi.h>
+#include <Protocol/IpmiAsyncProtocol.h>
 
 #define SOL_CMD_RETRY_COUNT  10
 
+///
+/// The SOL status request of a channel submitted through
+/// EDKII_IPMI_ASYNC_PROTOCOL.
+///
+typedef struct {
+  EDKII_IPMI_COMMAND_TOKEN                          Token;
+  UINT8                                             RetryCount;
+  IPMI_GET_SOL_CONFIGURATION_PARAMETERS_REQUEST     Request;
+  IPMI_GET_SOL_CONFIGURATION_PARAMETERS_RESPONSE    Response;
+} SOL_STATUS_REQUEST;
+
+EDKII_IPMI_ASYNC_PROTOCOL  *mIpmiAsync = NULL;
+
 /*++
 
 Routine Description:
@@ -125,6 +139,116 @@ SetSolParams (
   return Status;
 }
 
+/**
+  This function submits the SOL status request of a channel to BMC without
+  waiting for the response.
+
+  @param[in]  SolRequest      The SOL status request.
+
+  @retval     EFI_SUCCESS     The request is submitted.
+  @retval     Otherwise       The request could not be submitted.
+**/
+EFI_STATUS
+SubmitSolStatusRequest (
+  IN  SOL_STATUS_REQUEST  *SolRequest
+  )
+{
+  ZeroMem (&SolRequest->Response, sizeof (SolRequest->Response));
+  SolRequest->Token.NetFunction      = IPMI_NETFN_TRANSPORT;
+  SolRequest->Token.Command          = IPMI_TRANSPORT_GET_SOL_CONFIG_PARAM;
+  SolRequest->Token.RequestData      = (UINT8 *)&SolRequest->Request;
+  SolRequest->Token.RequestDataSize  = sizeof (SolRequest->Request);
+  SolRequest->Token.ResponseData     = (UINT8 *)&SolRequest->Response;
+  SolRequest->Token.ResponseDataSize = sizeof (SolRequest->Response);
+  return mIpmiAsync->IpmiSubmitCommandAsync (mIpmiAsync, &SolRequest->Token);
+}
+
+/**
+  Notification function of the SOL status request. The request is submitted
+  again on failure, up to SOL_CMD_RETRY_COUNT times.
+
+  @param[in]  Event           The event of the request.
+  @param[in]  Context         The SOL status request.
+**/
+VOID
+EFIAPI
+SolStatusRequestNotify (
+  IN  EFI_EVENT  Event,
+  IN  VOID       *Context
+  )
+{
+  SOL_STATUS_REQUEST  *SolRequest;
+  EFI_STATUS          Status;
+  UINT8               Channel;
+
+  SolRequest = (SOL_STATUS_REQUEST *)Context;
+  Status     = SolRequest->Token.TransferStatus;
+  Channel    = SolRequest->Request.ChannelNumber.Bits.ChannelNumber;
+  if (EFI_ERROR (Status) && (++SolRequest->RetryCount < SOL_CMD_RETRY_COUNT)) {
+    if (!EFI_ERROR (SubmitSolStatusRequest (SolRequest))) {
+      return;
+    }
+  }
+
+  if (Status == EFI_SUCCESS) {
+    DEBUG ((DEBUG_ERROR, "SOL enabling status for channel %x is %x\n", Channel, SolRequest->Response.ParameterData[0]));
+  } else {
+    DEBUG ((DEBUG_ERROR, "Failed to get channel %x SOL status from BMC!, status is %x\n", Channel, Status));
+  }
+
+  gBS->CloseEvent (Event);
+  FreePool (SolRequest);
+}
+
+/**
+  This function queues the SOL status requests of all channels, the status
+  is reported when BMC responds.
+
+  @retval     EFI_SUCCESS     The requests are submitted.
+  @retval     Otherwise       Failed to submit the request of a channel.
+**/
+EFI_STATUS
+SubmitSolStatusRequests (
+  VOID
+  )
+{
+  EFI_STATUS          Status;
+  UINT8               Channel;
+  SOL_STATUS_REQUEST  *SolRequest;
+
+  for (Channel = 1; Channel <= PcdGet8 (PcdMaxSolChannels); Channel++) {
+    SolRequest = AllocateZeroPool (sizeof (SOL_STATUS_REQUEST));
+    if (SolRequest == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    SolRequest->Request.ChannelNumber.Bits.ChannelNumber = Channel;
+    SolRequest->Request.ParameterSelector                = IPMI_SOL_CONFIGURATION_PARAMETER_SOL_ENABLE;
+
+    Status = gBS->CreateEvent (
+                    EVT_NOTIFY_SIGNAL,
+                    TPL_CALLBACK,
+                    SolStatusRequestNotify,
+                    SolRequest,
+                    &SolRequest->Token.Event
+                    );
+    if (EFI_ERROR (Status)) {
+      FreePool (SolRequest);
+      return Status;
+    }
+
+    Status = SubmitSolStatusRequest (SolRequest);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "Failed to submit channel %x SOL status request, status is %x\n", Channel, Status));
+      gBS->CloseEvent (SolRequest->Token.Event);
+      FreePool (SolRequest);
+      return Status;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
 /*++
 
   Routine Description:
@@ -151,6 +275,14 @@ SolStatusEntryPoint (
   UINT8       Channel;
   BOOLEAN     SolEnabled = FALSE;
 
+  //
+  // Don't wait for BMC when the IPMI commands can be queued.
+  //
+  Status = gBS->LocateProtocol (&gEdkiiIpmiAsyncProtocolGuid, NULL, (VOID **)&mIpmiAsync);
+  if (!EFI_ERROR (Status)) {
+    return SubmitSolStatusRequests ();
+  }
+
   for (Channel = 1; Channel <= PcdGet8 (PcdMaxSolChannels); Channel++) {
     Status = GetSolStatus (Channel, IPMI_SOL_CONFIGURATION_PARAMETER_SOL_ENABLE, &SolEnabled);
     if (Status == EFI_SUCCESS) {
@@ -25,6 +25,7 @@ MANAGEABILITY_TRANSPORT_HARDWARE_INFORMATION  mHardwareInformation;
 UINT8                                         mMctpPacketSequence;
 BOOLEAN                                       mStartOfMessage;
 BOOLEAN                                       mEndOfMessage;
+MCTP_PACKET_BUFFER                            mMctpPacketBufferPool[MCTP_PACKET_BUFFER_POOL_SIZE];
 
 /**
   This functions setup the MCTP transport hardware information according
@@ -84,8 +85,59 @@ SetupMctpTransportHardwareInformation (
 }
 
 /**
-  This functions setup the final header/body/trailer packets for
-  the acquired transport interface.
+  This function acquires a packet buffer from the packet buffer pool. The
+  packet buffer is allocated from memory pool if all of the packet buffers
+  in the pool are in use.
+
+  @retval  MCTP_PACKET_BUFFER  Pointer to the packet buffer.
+  @retval  NULL                Not enough resource for the packet buffer.
+**/
+MCTP_PACKET_BUFFER *
+AcquireMctpPacketBuffer (
+  VOID
+  )
+{
+  UINTN               Index;
+  MCTP_PACKET_BUFFER  *PacketBuffer;
+
+  for (Index = 0; Index < MCTP_PACKET_BUFFER_POOL_SIZE; Index++) {
+    if (!mMctpPacketBufferPool[Index].InUse) {
+      mMctpPacketBufferPool[Index].InUse = TRUE;
+      return &mMctpPacketBufferPool[Index];
+    }
+  }
+
+  PacketBuffer = (MCTP_PACKET_BUFFER *)AllocateZeroPool (sizeof (MCTP_PACKET_BUFFER));
+  if (PacketBuffer != NULL) {
+    PacketBuffer->InUse = TRUE;
+  }
+
+  return PacketBuffer;
+}
+
+/**
+  This function releases the packet buffer acquired through
+  AcquireMctpPacketBuffer.
+
+  @param[in]  PacketBuffer   The packet buffer.
+**/
+VOID
+ReleaseMctpPacketBuffer (
+  IN  MCTP_PACKET_BUFFER  *PacketBuffer
+  )
+{
+  if ((PacketBuffer >= &mMctpPacketBufferPool[0]) &&
+      (PacketBuffer < &mMctpPacketBufferPool[MCTP_PACKET_BUFFER_POOL_SIZE]))
+  {
+    PacketBuffer->InUse = FALSE;
+  } else {
+    FreePool (PacketBuffer);
+  }
+}
+
+/**
+  This functions setup the transport header, trailer and the MCTP headers of
+  one packet in the given packet buffer for the acquired transport interface.
 
   @param[in]         TransportToken             The transport interface.
   @param[in]         MctpType                   MCTP message type.
@@ -93,51 +145,39 @@ SetupMctpTransportHardwareInformation (
   @param[in]         MctpDestinationEndpointId  MCTP source endpoint ID.
   @param[in]         RequestDataIntegrityCheck  Indicates whether MCTP message has
                                                 integrity check byte.
-  @param[out]        PacketHeader               The pointer to receive header of request.
-  @param[out]        PacketHeaderSize           Packet header size.
-  @param[in, out]    PacketBody                 The request body.
-                                                When IN, it is the caller's request body.
-                                                When OUT and NULL, the request body is not
-                                                changed.
-                                                Whee out and non-NULL, the request body is
-                                                changed to comfort the transport interface.
-  @param[in, out]    PacketBodySize             The request body size.
-                                                When IN and non-zero, it is the new data
-                                                length of request body.
-                                                When IN and zero, the request body is unchanged.
-  @param[out]        PacketTrailer              The pointer to receive trailer of request.
-  @param[out]        PacketTrailerSize          Packet trailer size.
-
-  @retval EFI_SUCCESS            Request packet is returned.
-  @retval EFI_OUT_OF_RESOURCE    Not enough resource to create the request
-                                 transport packets.
+  @param[in]         Payload                    The payload of this packet.
+  @param[in]         PayloadSize                The payload size.
+  @param[in]         CopyPayload                TRUE to copy the payload after the
+                                                MCTP headers in PacketBuffer->Packet,
+                                                FALSE if the payload is transmitted
+                                                from Payload directly.
+  @param[out]        PacketBuffer               The packet buffer to setup.
+
+  @retval EFI_SUCCESS            The packet is set up in PacketBuffer.
+  @retval EFI_INVALID_PARAMETER  PacketBuffer is NULL or the payload doesn't fit
+                                 in one packet.
   @retval EFI_UNSUPPORTED        Request packet is not returned because
                                  the unsupported transport interface.
 **/
 EFI_STATUS
 SetupMctpRequestTransportPacket (
-  IN   MANAGEABILITY_TRANSPORT_TOKEN    *TransportToken,
-  IN   UINT8                            MctpType,
-  IN   UINT8                            MctpSourceEndpointId,
-  IN   UINT8                            MctpDestinationEndpointId,
-  IN   BOOLEAN                          RequestDataIntegrityCheck,
-  OUT  MANAGEABILITY_TRANSPORT_HEADER   *PacketHeader,
-  OUT  UINT16                           *PacketHeaderSize,
-  IN   OUT UINT8                        **PacketBody,
-  IN   OUT UINT32                       *PacketBodySize,
-  OUT  MANAGEABILITY_TRANSPORT_TRAILER  *PacketTrailer,
-  OUT  UINT16                           *PacketTrailerSize
+  IN   MANAGEABILITY_TRANSPORT_TOKEN  *TransportToken,
+  IN   UINT8                          MctpType,
+  IN   UINT8                          MctpSourceEndpointId,
+  IN   UINT8                          MctpDestinationEndpointId,
+  IN   BOOLEAN                        RequestDataIntegrityCheck,
+  IN   UINT8                          *Payload,
+  IN   UINT32                         PayloadSize,
+  IN   BOOLEAN                        CopyPayload,
+  OUT  MCTP_PACKET_BUFFER             *PacketBuffer
   )
 {
-  MANAGEABILITY_MCTP_KCS_HEADER   *MctpKcsHeader;
-  MCTP_TRANSPORT_HEADER           *MctpTransportHeader;
-  MCTP_MESSAGE_HEADER             *MctpMessageHeader;
-  MANAGEABILITY_MCTP_KCS_TRAILER  *MctpKcsTrailer;
-  UINT8                           *ThisPackage;
-
-  if ((PacketHeader == NULL) || (PacketHeaderSize == NULL) ||
-      (PacketBody == NULL) || (PacketBodySize == NULL) ||
-      (PacketTrailer == NULL) || (PacketTrailerSize == NULL)
+  MCTP_TRANSPORT_HEADER  *MctpTransportHeader;
+  MCTP_MESSAGE_HEADER    *MctpMessageHeader;
+
+  if ((PacketBuffer == NULL) ||
+      ((Payload == NULL) && (PayloadSize != 0)) ||
+      (PayloadSize > MCTP_KCS_PACKET_MAXIMUM_SIZE - MCTP_PACKET_HEADER_SIZE)
       )
   {
     DEBUG ((DEBUG_ERROR, "%a: One or more than one of the input parameter is invalid.\n", __func__));
@@ -145,34 +185,13 @@ SetupMctpRequestTransportPacket (
   }
 
   if (CompareGuid (&gManageabilityTransportKcsGuid, TransportToken->Transport->ManageabilityTransportSpecification)) {
-    MctpKcsHeader = (MANAGEABILITY_MCTP_KCS_HEADER *)AllocateZeroPool (sizeof (MANAGEABILITY_MCTP_KCS_HEADER));
-    if (MctpKcsHeader == NULL) {
-      DEBUG ((DEBUG_ERROR, "%a: Not enough resource for MANAGEABILITY_MCTP_KCS_HEADER.\n", __func__));
-      return EFI_OUT_OF_RESOURCES;
-    }
-
-    MctpKcsTrailer = (MANAGEABILITY_MCTP_KCS_TRAILER *)AllocateZeroPool (sizeof (MANAGEABILITY_MCTP_KCS_TRAILER));
-    if (MctpKcsTrailer == NULL) {
-      DEBUG ((DEBUG_ERROR, "%a: Not enough resource for PEC.\n", __func__));
-      FreePool (MctpKcsHeader);
-      return EFI_OUT_OF_RESOURCES;
-    }
-
     // Generate MCTP KCS transport header
-    MctpKcsHeader->DefiningBody = DEFINING_BODY_DMTF_PRE_OS_WORKING_GROUP;
-    MctpKcsHeader->NetFunc      = MCTP_KCS_NETFN_LUN;
-    MctpKcsHeader->ByteCount    = (UINT8)(MIN (mTransportMaximumPayload, *PacketBodySize + (UINT8)sizeof (MCTP_MESSAGE_HEADER) + (UINT8)sizeof (MCTP_TRANSPORT_HEADER)));
-
-    ThisPackage = (UINT8 *)AllocateZeroPool (MctpKcsHeader->ByteCount);
-    if (ThisPackage == NULL) {
-      DEBUG ((DEBUG_ERROR, "%a: Not enough resource for package.\n", __func__));
-      FreePool (MctpKcsHeader);
-      FreePool (MctpKcsTrailer);
-      return EFI_OUT_OF_RESOURCES;
-    }
+    PacketBuffer->KcsHeader.DefiningBody = DEFINING_BODY_DMTF_PRE_OS_WORKING_GROUP;
+    PacketBuffer->KcsHeader.NetFunc      = MCTP_KCS_NETFN_LUN;
+    PacketBuffer->KcsHeader.ByteCount    = (UINT8)(PayloadSize + MCTP_PACKET_HEADER_SIZE);
 
     // Setup MCTP transport header
-    MctpTransportHeader                             = (MCTP_TRANSPORT_HEADER *)ThisPackage;
+    MctpTransportHeader                             = (MCTP_TRANSPORT_HEADER *)PacketBuffer->Packet;
     MctpTransportHeader->Bits.Reserved              = 0;
     MctpTransportHeader->Bits.HeaderVersion         = MCTP_KCS_HEADER_VERSION;
     MctpTransportHeader->Bits.DestinationEndpointId = MctpDestinationEndpointId;
@@ -189,25 +208,75 @@ SetupMctpRequestTransportPacket (
     MctpMessageHeader->Bits.IntegrityCheck = RequestDataIntegrityCheck ? 1 : 0;
 
     // Copy payload
-    CopyMem ((VOID *)(MctpMessageHeader + 1), (VOID *)*PacketBody, *PacketBodySize);
+    if (CopyPayload && (PayloadSize != 0)) {
+      CopyMem ((VOID *)(MctpMessageHeader + 1), (VOID *)Payload, PayloadSize);
+    }
 
     //
-    // Generate PEC follow SMBUS 2.0 specification.
-    MctpKcsTrailer->Pec = HelperManageabilityGenerateCrc8 (MCTP_KCS_PACKET_ERROR_CODE_POLY, 0, ThisPackage, MctpKcsHeader->ByteCount);
-
-    *PacketBody        = (UINT8 *)ThisPackage;
-    *PacketBodySize    = MctpKcsHeader->ByteCount;
-    *PacketTrailer     = (MANAGEABILITY_TRANSPORT_TRAILER)MctpKcsTrailer;
-    *PacketHeader      = (MANAGEABILITY_TRANSPORT_HEADER)MctpKcsHeader;
-    *PacketHeaderSize  = sizeof (MANAGEABILITY_MCTP_KCS_HEADER);
-    *PacketTrailerSize = sizeof (MANAGEABILITY_MCTP_KCS_TRAILER);
+    // Generate PEC follow SMBUS 2.0 specification. The PEC of the MCTP
+    // headers is the initial value of the PEC of payload, so the payload
+    // doesn't have to follow the headers in memory.
+    //
+    PacketBuffer->KcsTrailer.Pec = HelperManageabilityGenerateCrc8 (
+                                     MCTP_KCS_PACKET_ERROR_CODE_POLY,
+                                     0,
+                                     PacketBuffer->Packet,
+                                     MCTP_PACKET_HEADER_SIZE
+                                     );
+    PacketBuffer->KcsTrailer.Pec = HelperManageabilityGenerateCrc8 (
+                                     MCTP_KCS_PACKET_ERROR_CODE_POLY,
+                                     PacketBuffer->KcsTrailer.Pec,
+                                     Payload,
+                                     PayloadSize
+                                     );
     return EFI_SUCCESS;
   } else {
     DEBUG ((DEBUG_ERROR, "%a: No implementation of building up packet.", __func__));
     ASSERT (FALSE);
   }
 
-  return EFI_SUCCESS;
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  This function locks the transport interface, so that the packets of a MCTP
+  message and the read of its response are not interleaved with the transfers
+  of other manageability protocols on the same transport interface.
+
+  @param[in]  TransportToken    Transport token.
+
+  @retval     EFI_SUCCESS       The transport interface is locked or it
+                                doesn't support the lock.
+  @retval     EFI_NOT_READY     The transport interface is locked by another
+                                manageability protocol.
+**/
+EFI_STATUS
+MctpLockTransport (
+  IN  MANAGEABILITY_TRANSPORT_TOKEN  *TransportToken
+  )
+{
+  if (TransportToken->Transport->TransportVersion < MANAGEABILITY_TRANSPORT_TOKEN_VERSION_1_3) {
+    return EFI_SUCCESS;
+  }
+
+  return TransportToken->Transport->Function.Version1_3->TransportLock (TransportToken);
+}
+
+/**
+  This function unlocks the transport interface locked by MctpLockTransport.
+
+  @param[in]  TransportToken    Transport token.
+**/
+VOID
+MctpUnlockTransport (
+  IN  MANAGEABILITY_TRANSPORT_TOKEN  *TransportToken
+  )
+{
+  if (TransportToken->Transport->TransportVersion < MANAGEABILITY_TRANSPORT_TOKEN_VERSION_1_3) {
+    return;
+  }
+
+  TransportToken->Transport->Function.Version1_3->TransportUnlock (TransportToken);
 }
 
 /**
@@ -233,7 +302,8 @@ SetupMctpRequestTransportPacket (
                                  response was successfully received.
   @retval EFI_NOT_FOUND          The message was not successfully sent to transport interface or a response
                                  was not successfully received from transport interface.
-  @retval EFI_NOT_READY          MCTP transport interface is not ready for MCTP message.
+  @retval EFI_NOT_READY          MCTP transport interface is not ready for MCTP message, or
+                                 it is locked by another manageability protocol.
   @retval EFI_DEVICE_ERROR       MCTP transport interface Device hardware error.
   @retval EFI_TIMEOUT            The message time out.
   @retval EFI_UNSUPPORTED        The message was not successfully sent to the transport interface.
@@ -258,15 +328,14 @@ CommonMctpSubmitMessage (
 {
   EFI_STATUS                                 Status;
   UINT16                                     IndexOfPackage;
+  UINT16                                     NumberOfPackages;
+  UINT32                                     PackagePayloadSize;
   UINT8                                      *ThisRequestData;
   UINT32                                     ThisRequestDataSize;
-  UINT16                                     MctpTransportHeaderSize;
-  UINT16                                     MctpTransportTrailerSize;
+  BOOLEAN                                    TransmitVector;
+  MANAGEABILITY_TRANSMIT_VECTOR              Vector[4];
   MANAGEABILITY_TRANSFER_TOKEN               TransferToken;
-  MANAGEABILITY_TRANSPORT_HEADER             MctpTransportHeader;
-  MANAGEABILITY_TRANSPORT_TRAILER            MctpTransportTrailer;
-  MANAGEABILITY_TRANSMISSION_MULTI_PACKAGES  *MultiPackages;
-  MANAGEABILITY_TRANSMISSION_PACKAGE_ATTR    *ThisPackage;
+  MCTP_PACKET_BUFFER                         *PacketBuffer;
   UINT8                                      *ResponseBuffer;
   MCTP_TRANSPORT_HEADER                      *MctpTransportResponseHeader;
   MCTP_MESSAGE_HEADER                        *MctpMessageResponseHeader;
@@ -285,51 +354,45 @@ CommonMctpSubmitMessage (
     return Status;
   }
 
-  MultiPackages = NULL;
-  Status        = HelperManageabilitySplitPayload (
-                    sizeof (MCTP_TRANSPORT_HEADER) + sizeof (MCTP_MESSAGE_HEADER),
-                    0,
-                    RequestData,
-                    RequestDataSize,
-                    mTransportMaximumPayload,
-                    &MultiPackages
-                    );
-  if (EFI_ERROR (Status) || (MultiPackages == NULL)) {
-    DEBUG ((DEBUG_ERROR, "%a: Fails to split payload into multiple packages - (%r)\n", __func__, mTransportName, Status));
-    return Status;
+  if (mTransportMaximumPayload <= MCTP_PACKET_HEADER_SIZE) {
+    DEBUG ((DEBUG_ERROR, "%a: Maximum payload 0x%x of %s is too small for MCTP packet.\n", __func__, mTransportMaximumPayload, mTransportName));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Split the payload into packets. Each packet is transmitted from the
+  // request data in place when the transport interface can transmit a
+  // scatter-gather list, otherwise the payload is copied to the packet buffer.
+  //
+  PackagePayloadSize = MIN (mTransportMaximumPayload, MCTP_KCS_PACKET_MAXIMUM_SIZE) - MCTP_PACKET_HEADER_SIZE;
+  NumberOfPackages   = (UINT16)((RequestDataSize + (PackagePayloadSize - 1)) / PackagePayloadSize);
+  TransmitVector     = (BOOLEAN)(TransportToken->Transport->TransportVersion >= MANAGEABILITY_TRANSPORT_TOKEN_VERSION_1_2);
+  DEBUG ((DEBUG_MANAGEABILITY_INFO, "Manageability Transmission packages: %d\n", NumberOfPackages));
+
+  PacketBuffer = AcquireMctpPacketBuffer ();
+  if (PacketBuffer == NULL) {
+    DEBUG ((DEBUG_ERROR, "%a: Not enough resource for MCTP packet buffer.\n", __func__));
+    return EFI_OUT_OF_RESOURCES;
   }
 
-  // Print transmission packages info.
-  DEBUG ((DEBUG_MANAGEABILITY_INFO, "Manageability Transmission packages:\n"));
-  ThisPackage = (MANAGEABILITY_TRANSMISSION_PACKAGE_ATTR *)(MultiPackages + 1);
-  for (IndexOfPackage = 0; IndexOfPackage < MultiPackages->NumberOfPackages; IndexOfPackage++) {
-    DEBUG ((DEBUG_MANAGEABILITY_INFO, "#%d: \n", IndexOfPackage));
-    DEBUG ((DEBUG_MANAGEABILITY_INFO, "    Packet pointer: 0x%08x\n", ThisPackage->PayloadPointer));
-    DEBUG ((DEBUG_MANAGEABILITY_INFO, "    Packet size   : 0x%08x\n", ThisPackage->PayloadSize));
+  //
+  // Hold the transport interface until the response of this message is read.
+  //
+  Status = MctpLockTransport (TransportToken);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_MANAGEABILITY_INFO, "%a: Transport %s is busy on other manageability protocol.\n", __func__, mTransportName));
+    ReleaseMctpPacketBuffer (PacketBuffer);
+    return Status;
   }
 
-  ThisPackage         = (MANAGEABILITY_TRANSMISSION_PACKAGE_ATTR *)(MultiPackages + 1);
+  ThisRequestData     = RequestData;
   mMctpPacketSequence = 0;
-  for (IndexOfPackage = 0; IndexOfPackage < MultiPackages->NumberOfPackages; IndexOfPackage++) {
-    MctpTransportHeader  = NULL;
-    MctpTransportTrailer = NULL;
-    ThisRequestData      = ThisPackage->PayloadPointer;
-    ThisRequestDataSize  = ThisPackage->PayloadSize;
+  for (IndexOfPackage = 0; IndexOfPackage < NumberOfPackages; IndexOfPackage++) {
+    ThisRequestDataSize = MIN (PackagePayloadSize, RequestDataSize - (UINT32)(ThisRequestData - RequestData));
 
     // Setup Start of Message bit and End of Message bit.
-    if (MultiPackages->NumberOfPackages == 1) {
-      mStartOfMessage = TRUE;
-      mEndOfMessage   = TRUE;
-    } else if (IndexOfPackage == 0) {
-      mStartOfMessage = TRUE;
-      mEndOfMessage   = FALSE;
-    } else if (IndexOfPackage == MultiPackages->NumberOfPackages - 1) {
-      mStartOfMessage = FALSE;
-      mEndOfMessage   = TRUE;
-    } else {
-      mStartOfMessage = FALSE;
-      mEndOfMessage   = FALSE;
-    }
+    mStartOfMessage = (BOOLEAN)(IndexOfPackage == 0);
+    mEndOfMessage   = (BOOLEAN)(IndexOfPackage == NumberOfPackages - 1);
 
     Status = SetupMctpRequestTransportPacket (
                TransportToken,
@@ -337,109 +400,108 @@ CommonMctpSubmitMessage (
                MctpSourceEndpointId,
                MctpDestinationEndpointId,
                RequestDataIntegrityCheck,
-               &MctpTransportHeader,
-               &MctpTransportHeaderSize,
-               &ThisRequestData,
-               &ThisRequestDataSize,
-               &MctpTransportTrailer,
-               &MctpTransportTrailerSize
+               ThisRequestData,
+               ThisRequestDataSize,
+               !TransmitVector,
+               PacketBuffer
                );
     if (EFI_ERROR (Status)) {
       DEBUG ((DEBUG_ERROR, "%a: Fail to build packets - (%r)\n", __func__, Status));
+      MctpUnlockTransport (TransportToken);
+      ReleaseMctpPacketBuffer (PacketBuffer);
       return Status;
     }
 
-    ZeroMem (&TransferToken, sizeof (MANAGEABILITY_TRANSFER_TOKEN));
-    TransferToken.TransmitHeader      = MctpTransportHeader;
-    TransferToken.TransmitHeaderSize  = MctpTransportHeaderSize;
-    TransferToken.TransmitTrailer     = MctpTransportTrailer;
-    TransferToken.TransmitTrailerSize = MctpTransportTrailerSize;
-
-    // Transmit packet.
-    if ((ThisRequestData == NULL) || (ThisRequestDataSize == 0)) {
-      // Transmit parameter were not changed by SetupMctpRequestTransportPacket().
-      TransferToken.TransmitPackage.TransmitPayload    = ThisPackage->PayloadPointer;
-      TransferToken.TransmitPackage.TransmitSizeInByte = ThisPackage->PayloadSize;
-    } else {
-      TransferToken.TransmitPackage.TransmitPayload    = ThisRequestData;
-      TransferToken.TransmitPackage.TransmitSizeInByte = ThisRequestDataSize;
-    }
-
-    TransferToken.TransmitPackage.TransmitTimeoutInMillisecond = MANAGEABILITY_TRANSPORT_NO_TIMEOUT;
-
-    // Receive packet.
-    TransferToken.ReceivePackage.ReceiveBuffer                = NULL;
-    TransferToken.ReceivePackage.ReceiveSizeInByte            = 0;
-    TransferToken.ReceivePackage.TransmitTimeoutInMillisecond = MANAGEABILITY_TRANSPORT_NO_TIMEOUT;
-
     // Print out MCTP packet.
     DEBUG ((
       DEBUG_MANAGEABILITY_INFO,
-      "%a: Send MCTP message type: 0x%x, from source endpoint ID: 0x%x to destination ID 0x%x: Request size: 0x%x, Response size: 0x%x\n",
+      "%a: Send MCTP message type: 0x%x, from source endpoint ID: 0x%x to destination ID 0x%x: Packet #%d size: 0x%x\n",
       __func__,
       MctpType,
       MctpSourceEndpointId,
       MctpDestinationEndpointId,
-      TransferToken.TransmitPackage.TransmitSizeInByte,
-      TransferToken.ReceivePackage.ReceiveSizeInByte
+      IndexOfPackage,
+      PacketBuffer->KcsHeader.ByteCount
       ));
 
-    if ((MctpTransportHeader != NULL) && (MctpTransportHeaderSize != 0)) {
-      HelperManageabilityDebugPrint (
-        (VOID *)TransferToken.TransmitHeader,
-        (UINT32)TransferToken.TransmitHeaderSize,
-        "MCTP transport header.\n"
-        );
-    }
-
     HelperManageabilityDebugPrint (
-      (VOID *)TransferToken.TransmitPackage.TransmitPayload,
-      TransferToken.TransmitPackage.TransmitSizeInByte,
-      "MCTP full request payload.\n"
+      (VOID *)&PacketBuffer->KcsHeader,
+      (UINT32)sizeof (PacketBuffer->KcsHeader),
+      "MCTP transport header.\n"
+      );
+    HelperManageabilityDebugPrint (
+      (VOID *)PacketBuffer->Packet,
+      MCTP_PACKET_HEADER_SIZE,
+      "MCTP packet header.\n"
+      );
+    HelperManageabilityDebugPrint (
+      (VOID *)ThisRequestData,
+      ThisRequestDataSize,
+      "MCTP packet payload.\n"
+      );
+    HelperManageabilityDebugPrint (
+      (VOID *)&PacketBuffer->KcsTrailer,
+      (UINT32)sizeof (PacketBuffer->KcsTrailer),
+      "MCTP transport trailer.\n"
       );
 
-    if ((MctpTransportTrailer != NULL) && (MctpTransportTrailerSize != 0)) {
-      HelperManageabilityDebugPrint (
-        (VOID *)TransferToken.TransmitTrailer,
-        (UINT32)TransferToken.TransmitTrailerSize,
-        "MCTP transport trailer.\n"
-        );
-    }
-
-    TransportToken->Transport->Function.Version1_0->TransportTransmitReceive (
-                                                      TransportToken,
-                                                      &TransferToken
-                                                      );
-    if (MctpTransportHeader != NULL) {
-      FreePool ((VOID *)MctpTransportHeader);
-    }
-
-    if (MctpTransportTrailer != NULL) {
-      FreePool ((VOID *)MctpTransportTrailer);
-    }
-
-    if (ThisRequestData != NULL) {
-      FreePool ((VOID *)ThisRequestData);
-      ThisRequestData = NULL;
+    if (TransmitVector) {
+      Vector[0].Buffer     = (UINT8 *)&PacketBuffer->KcsHeader;
+      Vector[0].SizeInByte = sizeof (PacketBuffer->KcsHeader);
+      Vector[1].Buffer     = PacketBuffer->Packet;
+      Vector[1].SizeInByte = MCTP_PACKET_HEADER_SIZE;
+      Vector[2].Buffer     = ThisRequestData;
+      Vector[2].SizeInByte = ThisRequestDataSize;
+      Vector[3].Buffer     = (UINT8 *)&PacketBuffer->KcsTrailer;
+      Vector[3].SizeInByte = sizeof (PacketBuffer->KcsTrailer);
+      Status               = TransportToken->Transport->Function.Version1_2->TransportTransmitVector (
+                                                                              TransportToken,
+                                                                              Vector,
+                                                                              ARRAY_SIZE (Vector),
+                                                                              AdditionalTransferError
+                                                                              );
+    } else {
+      ZeroMem (&TransferToken, sizeof (MANAGEABILITY_TRANSFER_TOKEN));
+      TransferToken.TransmitHeader                               = (MANAGEABILITY_TRANSPORT_HEADER)&PacketBuffer->KcsHeader;
+      TransferToken.TransmitHeaderSize                           = sizeof (PacketBuffer->KcsHeader);
+      TransferToken.TransmitTrailer                              = (MANAGEABILITY_TRANSPORT_TRAILER)&PacketBuffer->KcsTrailer;
+      TransferToken.TransmitTrailerSize                          = sizeof (PacketBuffer->KcsTrailer);
+      TransferToken.TransmitPackage.TransmitPayload              = PacketBuffer->Packet;
+      TransferToken.TransmitPackage.TransmitSizeInByte           = PacketBuffer->KcsHeader.ByteCount;
+      TransferToken.TransmitPackage.TransmitTimeoutInMillisecond = MANAGEABILITY_TRANSPORT_NO_TIMEOUT;
+
+      // Receive packet.
+      TransferToken.ReceivePackage.ReceiveBuffer                = NULL;
+      TransferToken.ReceivePackage.ReceiveSizeInByte            = 0;
+      TransferToken.ReceivePackage.TransmitTimeoutInMillisecond = MANAGEABILITY_TRANSPORT_NO_TIMEOUT;
+
+      TransportToken->Transport->Function.Version1_0->TransportTransmitReceive (
+                                                        TransportToken,
+                                                        &TransferToken
+                                                        );
+      Status                   = TransferToken.TransferStatus;
+      *AdditionalTransferError = TransferToken.TransportAdditionalStatus;
     }
 
     //
     // Return transfer status.
     //
-    Status                   = TransferToken.TransferStatus;
-    *AdditionalTransferError = TransferToken.TransportAdditionalStatus;
     if (EFI_ERROR (Status)) {
       DEBUG ((DEBUG_ERROR, "%a: Failed to send MCTP command over %s\n", __func__, mTransportName));
-      FreePool (MultiPackages);
+      MctpUnlockTransport (TransportToken);
+      ReleaseMctpPacketBuffer (PacketBuffer);
       return Status;
     }
 
     mMctpPacketSequence++;
-    ThisPackage++;
+    ThisRequestData += ThisRequestDataSize;
   }
 
+  ReleaseMctpPacketBuffer (PacketBuffer);
+
   ResponseBuffer = (UINT8 *)AllocatePool (*ResponseDataSize + sizeof (MCTP_TRANSPORT_HEADER) + sizeof (MCTP_MESSAGE_HEADER));
   // Receive packet.
+  ZeroMem (&TransferToken, sizeof (MANAGEABILITY_TRANSFER_TOKEN));
   TransferToken.TransmitPackage.TransmitPayload             = NULL;
   TransferToken.TransmitPackage.TransmitSizeInByte          = 0;
   TransferToken.ReceivePackage.ReceiveBuffer                = ResponseBuffer;
@@ -460,6 +522,7 @@ CommonMctpSubmitMessage (
                                                     TransportToken,
                                                     &TransferToken
                                                     );
+  MctpUnlockTransport (TransportToken);
 
   *AdditionalTransferError = TransferToken.TransportAdditionalStatus;
   Status                   = TransferToken.TransferStatus;
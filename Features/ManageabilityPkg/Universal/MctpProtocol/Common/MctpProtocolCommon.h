@@ -9,7 +9,9 @@
 #define MANAGEABILITY_MCTP_COMMON_H_
 
 #include <IndustryStandard/IpmiKcs.h>
+#include <IndustryStandard/Mctp.h>
 #include <Library/ManageabilityTransportLib.h>
+#include <Library/ManageabilityTransportMctpLib.h>
 
 #define MCTP_KCS_BASE_ADDRESS  PcdGet32(PcdMctpKcsBaseAddress)
 
@@ -25,6 +27,28 @@
 #define MCTP_KCS_REG_COMMAND_MEMMAP   MCTP_KCS_BASE_ADDRESS + (IPMI_KCS_COMMAND_REGISTER_OFFSET * 4)
 #define MCTP_KCS_REG_STATUS_MEMMAP    MCTP_KCS_BASE_ADDRESS + (IPMI_KCS_STATUS_REGISTER_OFFSET * 4)
 
+// MCTP transport header and message header precede the payload of each packet.
+#define MCTP_PACKET_HEADER_SIZE  (sizeof (MCTP_TRANSPORT_HEADER) + sizeof (MCTP_MESSAGE_HEADER))
+
+// The packet size is limited by ByteCount of MANAGEABILITY_MCTP_KCS_HEADER.
+#define MCTP_KCS_PACKET_MAXIMUM_SIZE  0xff
+
+// Number of packet buffers reserved for MCTP messages.
+#define MCTP_PACKET_BUFFER_POOL_SIZE  2
+
+///
+/// The buffer of one MCTP packet. A message is sent packet by packet using
+/// one packet buffer, so no memory is allocated per packet. Packet holds the
+/// MCTP headers, and also the payload if the transport interface can't
+/// transmit a scatter-gather list.
+///
+typedef struct {
+  BOOLEAN                           InUse;
+  MANAGEABILITY_MCTP_KCS_HEADER     KcsHeader;
+  UINT8                             Packet[MCTP_KCS_PACKET_MAXIMUM_SIZE];
+  MANAGEABILITY_MCTP_KCS_TRAILER    KcsTrailer;
+} MCTP_PACKET_BUFFER;
+
 /**
   This functions setup the PLDM transport hardware information according
   to the specification of transport token acquired from transport library.
@@ -45,8 +69,8 @@ SetupMctpTransportHardwareInformation (
   );
 
 /**
-  This functions setup the final header/body/trailer packets for
-  the acquired transport interface.
+  This functions setup the transport header, trailer and the MCTP headers of
+  one packet in the given packet buffer for the acquired transport interface.
 
   @param[in]         TransportToken             The transport interface.
   @param[in]         MctpType                   MCTP message type.
@@ -54,40 +78,31 @@ SetupMctpTransportHardwareInformation (
   @param[in]         MctpDestinationEndpointId  MCTP source endpoint ID.
   @param[in]         RequestDataIntegrityCheck  Indicates whether MCTP message has
                                                 integrity check byte.
-  @param[out]        PacketHeader               The pointer to receive header of request.
-  @param[out]        PacketHeaderSize           Packet header size.
-  @param[in, out]    PacketBody                 The request body.
-                                                When IN, it is the caller's request body.
-                                                When OUT and NULL, the request body is not
-                                                changed.
-                                                Whee out and non-NULL, the request body is
-                                                changed to comfort the transport interface.
-  @param[in, out]    PacketBodySize             The request body size.
-                                                When IN and non-zero, it is the new data
-                                                length of request body.
-                                                When IN and zero, the request body is unchanged.
-  @param[out]        PacketTrailer              The pointer to receive trailer of request.
-  @param[out]        PacketTrailerSize          Packet trailer size.
-
-  @retval EFI_SUCCESS            Request packet is returned.
-  @retval EFI_OUT_OF_RESOURCE    Not enough resource to create the request
-                                 transport packets.
+  @param[in]         Payload                    The payload of this packet.
+  @param[in]         PayloadSize                The payload size.
+  @param[in]         CopyPayload                TRUE to copy the payload after the
+                                                MCTP headers in PacketBuffer->Packet,
+                                                FALSE if the payload is transmitted
+                                                from Payload directly.
+  @param[out]        PacketBuffer               The packet buffer to setup.
+
+  @retval EFI_SUCCESS            The packet is set up in PacketBuffer.
+  @retval EFI_INVALID_PARAMETER  PacketBuffer is NULL or the payload doesn't fit
+                                 in one packet.
   @retval EFI_UNSUPPORTED        Request packet is not returned because
                                  the unsupported transport interface.
 **/
 EFI_STATUS
 SetupMctpRequestTransportPacket (
-  IN   MANAGEABILITY_TRANSPORT_TOKEN    *TransportToken,
-  IN   UINT8                            MctpType,
-  IN   UINT8                            MctpSourceEndpointId,
-  IN   UINT8                            MctpDestinationEndpointId,
-  IN   BOOLEAN                          RequestDataIntegrityCheck,
-  OUT  MANAGEABILITY_TRANSPORT_HEADER   *PacketHeader,
-  OUT  UINT16                           *PacketHeaderSize,
-  IN OUT UINT8                          **PacketBody,
-  IN OUT UINT32                         *PacketBodySize,
-  OUT  MANAGEABILITY_TRANSPORT_TRAILER  *PacketTrailer,
-  OUT  UINT16                           *PacketTrailerSize
+  IN   MANAGEABILITY_TRANSPORT_TOKEN  *TransportToken,
+  IN   UINT8                          MctpType,
+  IN   UINT8                          MctpSourceEndpointId,
+  IN   UINT8                          MctpDestinationEndpointId,
+  IN   BOOLEAN                        RequestDataIntegrityCheck,
+  IN   UINT8                          *Payload,
+  IN   UINT32                         PayloadSize,
+  IN   BOOLEAN                        CopyPayload,
+  OUT  MCTP_PACKET_BUFFER             *PacketBuffer
   );
 
 /**
@@ -11,6 +11,7 @@
 #include <Library/MemoryAllocationLib.h>
 #include <Library/ManageabilityTransportLib.h>
 #include <Library/ManageabilityTransportHelperLib.h>
+#include <Library/ManageabilityRequestQueueLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 #include <Protocol/MctpProtocol.h>
 
@@ -23,6 +24,118 @@ extern MANAGEABILITY_TRANSPORT_HARDWARE_INFORMATION  mHardwareInformation;
 MANAGEABILITY_TRANSPORT_TOKEN  *mTransportToken = NULL;
 CHAR16                         *mTransportName;
 UINT32                         mTransportMaximumPayload;
+MANAGEABILITY_REQUEST_QUEUE    *mRequestQueue = NULL;
+
+/**
+  This function checks the MCTP message and returns the endpoint IDs of it.
+
+  @param[in]   Token                  The token of the message.
+  @param[out]  SourceEid              Pointer to receive the source endpoint ID.
+  @param[out]  DestinationEid         Pointer to receive the destination endpoint ID.
+
+  @retval      EFI_SUCCESS            The message is correct.
+  @retval      EFI_INVALID_PARAMETER  The message is incorrect.
+**/
+EFI_STATUS
+MctpCheckMessage (
+  IN  EDKII_MCTP_COMMAND_TOKEN  *Token,
+  OUT UINT8                     *SourceEid OPTIONAL,
+  OUT UINT8                     *DestinationEid OPTIONAL
+  )
+{
+  UINT8  ThisSourceEid;
+  UINT8  ThisDestinationEid;
+
+  if ((Token->RequestData == NULL) && (Token->ResponseData == NULL)) {
+    DEBUG ((DEBUG_ERROR, "%a: Both RequestData and ResponseData are NULL\n", __func__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (Token->MctpSourceEndpointId == NULL) {
+    ThisSourceEid = PcdGet8 (PcdMctpSourceEndpointId);
+    DEBUG ((DEBUG_MANAGEABILITY, "%a: Use PcdMctpSourceEndpointId for MCTP source EID: %x\n", __func__, ThisSourceEid));
+  } else {
+    ThisSourceEid = *Token->MctpSourceEndpointId;
+    DEBUG ((DEBUG_MANAGEABILITY, "%a: MCTP source EID: %x\n", __func__, ThisSourceEid));
+  }
+
+  if (Token->MctpDestinationEndpointId == NULL) {
+    ThisDestinationEid = PcdGet8 (PcdMctpDestinationEndpointId);
+    DEBUG ((DEBUG_MANAGEABILITY, "%a: Use PcdMctpDestinationEndpointId for MCTP destination EID: %x\n", __func__, ThisDestinationEid));
+  } else {
+    ThisDestinationEid = *Token->MctpDestinationEndpointId;
+    DEBUG ((DEBUG_MANAGEABILITY, "%a: MCTP destination EID: %x\n", __func__, ThisDestinationEid));
+  }
+
+  //
+  // Check source EID and destination EID
+  //
+  if ((ThisSourceEid >= MCTP_RESERVED_ENDPOINT_START_ID) &&
+      (ThisSourceEid <= MCTP_RESERVED_ENDPOINT_END_ID)
+      )
+  {
+    DEBUG ((DEBUG_ERROR, "%a: The value of MCTP source EID (%x) is reserved.\n", __func__, ThisSourceEid));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((ThisDestinationEid >= MCTP_RESERVED_ENDPOINT_START_ID) &&
+      (ThisDestinationEid <= MCTP_RESERVED_ENDPOINT_END_ID)
+      )
+  {
+    DEBUG ((DEBUG_ERROR, "%a: The value of MCTP destination EID (%x) is reserved.\n", __func__, ThisDestinationEid));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (SourceEid != NULL) {
+    *SourceEid = ThisSourceEid;
+  }
+
+  if (DestinationEid != NULL) {
+    *DestinationEid = ThisDestinationEid;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  This function runs the MCTP message queued in the request queue.
+
+  @param[in]  Request         Pointer to EDKII_MCTP_COMMAND_TOKEN.
+
+  @retval     EFI_STATUS      The status of the message.
+**/
+EFI_STATUS
+EFIAPI
+MctpRunMessage (
+  IN  VOID  *Request
+  )
+{
+  EFI_STATUS                Status;
+  EDKII_MCTP_COMMAND_TOKEN  *Token;
+  UINT8                     SourceEid;
+  UINT8                     DestinationEid;
+
+  Token  = (EDKII_MCTP_COMMAND_TOKEN *)Request;
+  Status = MctpCheckMessage (Token, &SourceEid, &DestinationEid);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  return CommonMctpSubmitMessage (
+           mTransportToken,
+           Token->MctpType,
+           SourceEid,
+           DestinationEid,
+           Token->RequestDataIntegrityCheck,
+           Token->RequestData,
+           Token->RequestDataSize,
+           Token->RequestTimeout,
+           Token->ResponseData,
+           &Token->ResponseDataSize,
+           Token->ResponseTimeout,
+           &Token->AdditionalTransferError
+           );
+}
 
 /**
   This service enables submitting message via EDKII MCTP protocol.
@@ -75,69 +188,84 @@ MctpSubmitMessage (
   OUT    MANAGEABILITY_TRANSPORT_ADDITIONAL_STATUS  *AdditionalTransferError
   )
 {
-  EFI_STATUS  Status;
-  UINT8       SourceEid;
-  UINT8       DestinationEid;
-
-  if ((RequestData == NULL) && (ResponseData == NULL)) {
-    DEBUG ((DEBUG_ERROR, "%a: Both RequestData and ResponseData are NULL\n", __func__));
-    return EFI_INVALID_PARAMETER;
-  }
-
-  if (MctpSourceEndpointId == NULL) {
-    SourceEid = PcdGet8 (PcdMctpSourceEndpointId);
-    DEBUG ((DEBUG_MANAGEABILITY, "%a: Use PcdMctpSourceEndpointId for MCTP source EID: %x\n", __func__, SourceEid));
-  } else {
-    SourceEid = *MctpSourceEndpointId;
-    DEBUG ((DEBUG_MANAGEABILITY, "%a: MCTP source EID: %x\n", __func__, SourceEid));
-  }
-
-  if (MctpDestinationEndpointId == NULL) {
-    DestinationEid = PcdGet8 (PcdMctpDestinationEndpointId);
-    DEBUG ((DEBUG_MANAGEABILITY, "%a: Use PcdMctpDestinationEndpointId for MCTP destination EID: %x\n", __func__, DestinationEid));
-  } else {
-    DestinationEid = *MctpDestinationEndpointId;
-    DEBUG ((DEBUG_MANAGEABILITY, "%a: MCTP destination EID: %x\n", __func__, DestinationEid));
+  EFI_STATUS                Status;
+  EDKII_MCTP_COMMAND_TOKEN  Token;
+
+  Token.MctpType                  = MctpType;
+  Token.MctpSourceEndpointId      = MctpSourceEndpointId;
+  Token.MctpDestinationEndpointId = MctpDestinationEndpointId;
+  Token.RequestDataIntegrityCheck = RequestDataIntegrityCheck;
+  Token.RequestData               = RequestData;
+  Token.RequestDataSize           = RequestDataSize;
+  Token.RequestTimeout            = RequestTimeout;
+  Token.ResponseData              = ResponseData;
+  Token.ResponseDataSize          = *ResponseDataSize;
+  Token.ResponseTimeout           = ResponseTimeout;
+  Token.AdditionalTransferError   = MANAGEABILITY_TRANSPORT_ADDITIONAL_STATUS_NO_ERRORS;
+
+  Status = MctpCheckMessage (&Token, NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    return Status;
   }
 
   //
-  // Check source EID and destination EID
+  // Run the message after the messages queued through
+  // MctpSubmitCommandAsync.
   //
-  if ((SourceEid >= MCTP_RESERVED_ENDPOINT_START_ID) &&
-      (SourceEid <= MCTP_RESERVED_ENDPOINT_END_ID)
-      )
-  {
-    DEBUG ((DEBUG_ERROR, "%a: The value of MCTP source EID (%x) is reserved.\n", __func__, MctpSourceEndpointId));
+  Status                   = ManageabilityRequestQueueRun (mRequestQueue, &Token);
+  *ResponseDataSize        = Token.ResponseDataSize;
+  *AdditionalTransferError = Token.AdditionalTransferError;
+  return Status;
+}
+
+/**
+  This service submits the message via EDKII MCTP protocol without waiting
+  for the response.
+
+  @param[in]      This                       EDKII_MCTP_PROTOCOL instance.
+  @param[in, out] Token                      The token of the message.
+
+  @retval EFI_SUCCESS            The message is submitted. The status of the message
+                                 is returned in Token->TransferStatus.
+  @retval EFI_INVALID_PARAMETER  Token is NULL or the data in Token is incorrect.
+  @retval EFI_OUT_OF_RESOURCES   The resource allocation is out of resource.
+**/
+EFI_STATUS
+EFIAPI
+MctpSubmitMessageAsync (
+  IN     EDKII_MCTP_PROTOCOL       *This,
+  IN OUT EDKII_MCTP_COMMAND_TOKEN  *Token
+  )
+{
+  EFI_STATUS  Status;
+
+  if (Token == NULL) {
     return EFI_INVALID_PARAMETER;
   }
 
-  if ((DestinationEid >= MCTP_RESERVED_ENDPOINT_START_ID) &&
-      (DestinationEid <= MCTP_RESERVED_ENDPOINT_END_ID)
-      )
-  {
-    DEBUG ((DEBUG_ERROR, "%a: The value of MCTP destination EID (%x) is reserved.\n", __func__, MctpDestinationEndpointId));
-    return EFI_INVALID_PARAMETER;
+  Status = MctpCheckMessage (Token, NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    return Status;
   }
 
-  Status = CommonMctpSubmitMessage (
-             mTransportToken,
-             MctpType,
-             SourceEid,
-             DestinationEid,
-             RequestDataIntegrityCheck,
-             RequestData,
-             RequestDataSize,
-             RequestTimeout,
-             ResponseData,
-             ResponseDataSize,
-             ResponseTimeout,
-             AdditionalTransferError
-             );
-  return Status;
+  if (Token->Event == NULL) {
+    Token->LatencyInMicrosecond = 0;
+    Token->TransferStatus       = ManageabilityRequestQueueRun (mRequestQueue, Token);
+    return EFI_SUCCESS;
+  }
+
+  return ManageabilityRequestQueueSubmit (
+           mRequestQueue,
+           Token,
+           Token->Event,
+           &Token->TransferStatus,
+           &Token->LatencyInMicrosecond
+           );
 }
 
-EDKII_MCTP_PROTOCOL_V1_0  mMctpProtocolV10 = {
-  MctpSubmitMessage
+EDKII_MCTP_PROTOCOL_V1_1  mMctpProtocolV11 = {
+  MctpSubmitMessage,
+  MctpSubmitMessageAsync
 };
 
 EDKII_MCTP_PROTOCOL  mMctpProtocol;
@@ -215,8 +343,14 @@ DxeMctpEntry (
     return Status;
   }
 
+  Status = ManageabilityRequestQueueCreate (MctpRunMessage, &mRequestQueue);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: Failed to create request queue for MCTP protocol - %r\n", __func__, Status));
+    return Status;
+  }
+
   mMctpProtocol.ProtocolVersion      = EDKII_MCTP_PROTOCOL_VERSION;
-  mMctpProtocol.Functions.Version1_0 = &mMctpProtocolV10;
+  mMctpProtocol.Functions.Version1_1 = &mMctpProtocolV11;
   Handle                             = NULL;
   Status                             = gBS->InstallProtocolInterface (
                                               &Handle,
@@ -250,6 +384,8 @@ MctpUnloadImage (
 {
   EFI_STATUS  Status;
 
+  ManageabilityRequestQueueDestroy (mRequestQueue);
+
   Status = EFI_SUCCESS;
   if (mTransportToken != NULL) {
     Status = ReleaseTransportSession (mTransportToken);
@@ -268,6 +268,16 @@ CommonPldmSubmitCommand (
                                                     TransportToken,
                                                     &TransferToken
                                                     );
+  //
+  // Return the transfer error as is, EFI_NOT_READY tells the caller the
+  // transport interface is busy and the command can be retried.
+  //
+  Status = TransferToken.TransferStatus;
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: Failed to send PLDM command over %s - (%r)\n", __func__, mTransportName, Status));
+    goto ErrorExit;
+  }
+
   //
   // Check the response size.
   //
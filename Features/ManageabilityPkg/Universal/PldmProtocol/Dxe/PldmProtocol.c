@@ -12,6 +12,7 @@
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/ManageabilityTransportLib.h>
 #include <Library/ManageabilityTransportHelperLib.h>
+#include <Library/ManageabilityRequestQueueLib.h>
 #include <IndustryStandard/Pldm.h>
 #include <Protocol/PldmProtocol.h>
 
@@ -21,6 +22,103 @@ MANAGEABILITY_TRANSPORT_TOKEN  *mTransportToken = NULL;
 CHAR16                         *mTransportName;
 UINT8                          mPldmRequestInstanceId;
 UINT32                         TransportMaximumPayload;
+MANAGEABILITY_REQUEST_QUEUE    *mRequestQueue = NULL;
+
+/**
+  This function runs the PLDM command queued in the request queue.
+
+  @param[in]  Request         Pointer to EDKII_PLDM_COMMAND_TOKEN.
+
+  @retval     EFI_STATUS      The status of the command.
+**/
+EFI_STATUS
+EFIAPI
+PldmRunCommand (
+  IN  VOID  *Request
+  )
+{
+  EDKII_PLDM_COMMAND_TOKEN  *Token;
+
+  Token = (EDKII_PLDM_COMMAND_TOKEN *)Request;
+  DEBUG ((
+    DEBUG_MANAGEABILITY,
+    "%a: Source terminus ID: 0x%x, Destination terminus ID: 0x%x.\n",
+    __func__,
+    Token->PldmTerminusSourceId,
+    Token->PldmTerminusDestinationId
+    ));
+  return CommonPldmSubmitCommand (
+           mTransportToken,
+           Token->PldmType,
+           Token->Command,
+           Token->PldmTerminusSourceId,
+           Token->PldmTerminusDestinationId,
+           Token->RequestData,
+           Token->RequestDataSize,
+           Token->ResponseData,
+           &Token->ResponseDataSize
+           );
+}
+
+/**
+  This function checks the data of PLDM command.
+
+  @param[in]  Token                  The token of the command.
+
+  @retval     EFI_SUCCESS            The data of command is correct.
+  @retval     EFI_INVALID_PARAMETER  The data of command is incorrect.
+**/
+EFI_STATUS
+PldmCheckCommand (
+  IN  EDKII_PLDM_COMMAND_TOKEN  *Token
+  )
+{
+  if ((Token->RequestData == NULL) && (Token->RequestDataSize != 0)) {
+    DEBUG ((
+      DEBUG_ERROR,
+      "%a: RequestDataSize != 0, however RequestData is NULL for PLDM type: 0x%x, Command: 0x%x.\n",
+      __func__,
+      Token->PldmType,
+      Token->Command
+      ));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((Token->RequestData != NULL) && (Token->RequestDataSize == 0)) {
+    DEBUG ((
+      DEBUG_ERROR,
+      "%a: RequestDataSize == 0, however RequestData is not NULL for PLDM type: 0x%x, Command: 0x%x.\n",
+      __func__,
+      Token->PldmType,
+      Token->Command
+      ));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((Token->ResponseData == NULL) && (Token->ResponseDataSize != 0)) {
+    DEBUG ((
+      DEBUG_ERROR,
+      "%a: *ResponseDataSize != 0, however ResponseData is NULL for PLDM type: 0x%x, Command: 0x%x.\n",
+      __func__,
+      Token->PldmType,
+      Token->Command
+      ));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((Token->ResponseData != NULL) && (Token->ResponseDataSize == 0)) {
+    DEBUG ((
+      DEBUG_ERROR,
+      "%a: *ResponseDataSize == 0, however ResponseData is not NULL for PLDM type: 0x%x, Command: 0x%x.\n",
+      __func__,
+      Token->PldmType,
+      Token->Command
+      ));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  return EFI_SUCCESS;
+}
 
 /**
   This service enables submitting commands via EDKII PLDM protocol.
@@ -58,72 +156,83 @@ PldmSubmitCommand (
   IN OUT UINT32               *ResponseDataSize
   )
 {
-  EFI_STATUS  Status;
+  EFI_STATUS                Status;
+  EDKII_PLDM_COMMAND_TOKEN  Token;
+
+  Token.PldmType                  = PldmType;
+  Token.Command                   = Command;
+  Token.PldmTerminusSourceId      = PldmTerminusSourceId;
+  Token.PldmTerminusDestinationId = PldmTerminusDestinationId;
+  Token.RequestData               = RequestData;
+  Token.RequestDataSize           = RequestDataSize;
+  Token.ResponseData              = ResponseData;
+  Token.ResponseDataSize          = *ResponseDataSize;
 
   //
   // Check the given input parameters.
   //
-  if ((RequestData == NULL) && (RequestDataSize != 0)) {
-    DEBUG ((
-      DEBUG_ERROR,
-      "%a: RequestDataSize != 0, however RequestData is NULL for PLDM type: 0x%x, Command: 0x%x.\n",
-      __func__,
-      PldmType,
-      Command
-      ));
-    return EFI_INVALID_PARAMETER;
+  Status = PldmCheckCommand (&Token);
+  if (EFI_ERROR (Status)) {
+    return Status;
   }
 
-  if ((RequestData != NULL) && (RequestDataSize == 0)) {
-    DEBUG ((
-      DEBUG_ERROR,
-      "%a: RequestDataSize == 0, however RequestData is not NULL for PLDM type: 0x%x, Command: 0x%x.\n",
-      __func__,
-      PldmType,
-      Command
-      ));
+  //
+  // Run the command after the commands queued through
+  // PldmSubmitCommandAsync.
+  //
+  Status            = ManageabilityRequestQueueRun (mRequestQueue, &Token);
+  *ResponseDataSize = Token.ResponseDataSize;
+  return Status;
+}
+
+/**
+  This service submits the command via EDKII PLDM protocol without waiting
+  for the response.
+
+  @param[in]      This                       EDKII_PLDM_PROTOCOL instance.
+  @param[in, out] Token                      The token of the command.
+
+  @retval EFI_SUCCESS            The command is submitted. The status of the command
+                                 is returned in Token->TransferStatus.
+  @retval EFI_INVALID_PARAMETER  Token is NULL or the data in Token is incorrect.
+  @retval EFI_OUT_OF_RESOURCES   The resource allcation is out of resource.
+**/
+EFI_STATUS
+EFIAPI
+PldmSubmitCommandAsync (
+  IN     EDKII_PLDM_PROTOCOL       *This,
+  IN OUT EDKII_PLDM_COMMAND_TOKEN  *Token
+  )
+{
+  EFI_STATUS  Status;
+
+  if (Token == NULL) {
     return EFI_INVALID_PARAMETER;
   }
 
-  if ((ResponseData == NULL) && (*ResponseDataSize != 0)) {
-    DEBUG ((
-      DEBUG_ERROR,
-      "%a: *ResponseDataSize != 0, however ResponseData is NULL for PLDM type: 0x%x, Command: 0x%x.\n",
-      __func__,
-      PldmType,
-      Command
-      ));
-    return EFI_INVALID_PARAMETER;
+  Status = PldmCheckCommand (Token);
+  if (EFI_ERROR (Status)) {
+    return Status;
   }
 
-  if ((ResponseData != NULL) && (*ResponseDataSize == 0)) {
-    DEBUG ((
-      DEBUG_ERROR,
-      "%a: *ResponseDataSize == 0, however ResponseData is not NULL for PLDM type: 0x%x, Command: 0x%x.\n",
-      __func__,
-      PldmType,
-      Command
-      ));
-    return EFI_INVALID_PARAMETER;
+  if (Token->Event == NULL) {
+    Token->LatencyInMicrosecond = 0;
+    Token->TransferStatus       = ManageabilityRequestQueueRun (mRequestQueue, Token);
+    return EFI_SUCCESS;
   }
 
-  DEBUG ((DEBUG_MANAGEABILITY, "%a: Source terminus ID: 0x%x, Destination terminus ID: 0x%x.\n"));
-  Status = CommonPldmSubmitCommand (
-             mTransportToken,
-             PldmType,
-             Command,
-             PldmTerminusSourceId,
-             PldmTerminusDestinationId,
-             RequestData,
-             RequestDataSize,
-             ResponseData,
-             ResponseDataSize
-             );
-  return Status;
+  return ManageabilityRequestQueueSubmit (
+           mRequestQueue,
+           Token,
+           Token->Event,
+           &Token->TransferStatus,
+           &Token->LatencyInMicrosecond
+           );
 }
 
-EDKII_PLDM_PROTOCOL_V1_0  mPldmProtocolV10 = {
-  PldmSubmitCommand
+EDKII_PLDM_PROTOCOL_V1_1  mPldmProtocolV11 = {
+  PldmSubmitCommand,
+  PldmSubmitCommandAsync
 };
 
 EDKII_PLDM_PROTOCOL  mPldmProtocol;
@@ -187,9 +296,15 @@ DxePldmProtocolEntry (
     return Status;
   }
 
+  Status = ManageabilityRequestQueueCreate (PldmRunCommand, &mRequestQueue);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: Failed to create request queue for PLDM protocol - %r\n", __func__, Status));
+    return Status;
+  }
+
   mPldmRequestInstanceId             = 0;
   mPldmProtocol.ProtocolVersion      = EDKII_PLDM_PROTOCOL_VERSION;
-  mPldmProtocol.Functions.Version1_0 = &mPldmProtocolV10;
+  mPldmProtocol.Functions.Version1_1 = &mPldmProtocolV11;
   Handle                             = NULL;
   Status                             = gBS->InstallProtocolInterface (
                                               &Handle,
@@ -221,6 +336,8 @@ PldmProtocolUnloadImage (
 {
   EFI_STATUS  Status;
 
+  ManageabilityRequestQueueDestroy (mRequestQueue);
+
   Status = EFI_SUCCESS;
   if (mTransportToken != NULL) {
     Status = ReleaseTransportSession (mTransportToken);
@@ -153,6 +153,52 @@ GetSmbiosTableLength (
   return ((UINTN)TableEntry - (UINTN)TableAddress);
 }
 
+/**
+  This function builds the metadata of SMBIOS structure table.
+
+  @param [in]   SmbiosEntry       SMBIOS 3.0 entry point structure.
+  @param [in]   TableLength       SMBIOS structure table length.
+  @param [in]   Crc32             SMBIOS structure table integrity checksum.
+  @param [out]  MetaData          Pointer to receive the metadata.
+
+**/
+VOID
+BuildSmbiosStructureTableMetaData (
+  IN  SMBIOS_TABLE_3_0_ENTRY_POINT          *SmbiosEntry,
+  IN  UINT16                                TableLength,
+  IN  UINT32                                Crc32,
+  OUT PLDM_SMBIOS_STRUCTURE_TABLE_METADATA  *MetaData
+  )
+{
+  UINT8   *TableEntry;
+  UINT8   *TableAddressEnd;
+  UINTN   TableEntryLength;
+  UINT16  NumberOfStructures;
+  UINT16  MaximumStructureSize;
+
+  TableEntry           = (UINT8 *)(UINTN)SmbiosEntry->TableAddress;
+  TableAddressEnd      = TableEntry + TableLength;
+  NumberOfStructures   = 0;
+  MaximumStructureSize = 0;
+  while (TableEntry < TableAddressEnd) {
+    TableEntryLength = GetSmbiosStructureSize ((EFI_SMBIOS_TABLE_HEADER *)TableEntry, NULL);
+    if (TableEntryLength == 0) {
+      break;
+    }
+
+    NumberOfStructures++;
+    MaximumStructureSize = MAX (MaximumStructureSize, (UINT16)TableEntryLength);
+    TableEntry          += TableEntryLength;
+  }
+
+  MetaData->SmbiosMajorVersion                    = SmbiosEntry->MajorVersion;
+  MetaData->SmbiosMinorVersion                    = SmbiosEntry->MinorVersion;
+  MetaData->MaximumStructureSize                  = MaximumStructureSize;
+  MetaData->SmbiosStructureTableLength            = TableLength;
+  MetaData->NumberOfSmbiosStructures              = NumberOfStructures;
+  MetaData->SmbiosStructureTableIntegrityChecksum = Crc32;
+}
+
 /**
   This function gets SMBIOS table metadata.
 
@@ -298,6 +344,8 @@ SetSmbiosStructureTable (
   UINT16                                   TableLength;
   EFI_SMBIOS_TABLE_HEADER                  *Record;
   PLDM_SET_SMBIOS_STRUCTURE_TABLE_REQUEST  *PldmSetSmbiosStructureTable;
+  PLDM_SMBIOS_STRUCTURE_TABLE_METADATA     MetaData;
+  PLDM_SMBIOS_STRUCTURE_TABLE_METADATA     BmcMetaData;
 
   DEBUG ((DEBUG_MANAGEABILITY_INFO, "%a: Set SMBIOS structure table.\n", __func__));
 
@@ -391,6 +439,25 @@ SetSmbiosStructureTable (
   DataPointer += PaddingSize;
   CopyMem ((VOID *)DataPointer, (VOID *)&Crc32, 4);
 
+  BuildSmbiosStructureTableMetaData (SmbiosEntry, TableLength, Crc32, &MetaData);
+  if (FeaturePcdGet (PcdPldmSmbiosTransferSkipUnchangedTable)) {
+    //
+    // The SMBIOS structure table rarely changes across boots. Skip the
+    // transfer if the table on BMC has the same length and checksum.
+    // PLDM SMBIOS transfer has no command to set a single structure, so
+    // the whole table is transferred if it is changed.
+    //
+    Status = GetSmbiosStructureTableMetaData (This, &BmcMetaData);
+    if (!EFI_ERROR (Status) &&
+        (BmcMetaData.SmbiosStructureTableLength == MetaData.SmbiosStructureTableLength) &&
+        (BmcMetaData.SmbiosStructureTableIntegrityChecksum == MetaData.SmbiosStructureTableIntegrityChecksum))
+    {
+      DEBUG ((DEBUG_MANAGEABILITY_INFO, "%a: SMBIOS structure table on BMC is unchanged, skip the transfer.\n", __func__));
+      FreePool (RequestBuffer);
+      return EFI_SUCCESS;
+    }
+  }
+
   PldmSetSmbiosStructureTable                     = (PLDM_SET_SMBIOS_STRUCTURE_TABLE_REQUEST *)RequestBuffer;
   PldmSetSmbiosStructureTable->DataTransferHandle = SetSmbiosStructureTableHandle;
   PldmSetSmbiosStructureTable->TransferFlag       = PLDM_TRANSFER_FLAG_START_AND_END;
@@ -410,6 +477,11 @@ SetSmbiosStructureTable (
 
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "%a: Set SMBIOS structure table.\n", __func__));
+  } else if (FeaturePcdGet (PcdPldmSmbiosTransferSkipUnchangedTable)) {
+    //
+    // Update the metadata on BMC for the comparison on next boot.
+    //
+    SetSmbiosStructureTableMetaData (This, &MetaData);
   }
 
   if ((ResponseSize != 0) && (ResponseSize <= sizeof (SetSmbiosStructureTableHandle))) {
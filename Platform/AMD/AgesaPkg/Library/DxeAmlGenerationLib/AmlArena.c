@@ -0,0 +1,384 @@
+/** @file
+
+  Copyright (C) 2023-2025 Advanced Micro Devices, Inc. All rights reserved.<BR>
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+  Arena allocator for AML objects.
+
+  Tables built on a list created by AmlInitializeTableList get all of their
+  AML_OBJECT_INSTANCE nodes and Data buffers from an arena owned by that list.
+  Allocations just bump a pointer inside a large chunk, freeing individual
+  objects is (almost always) a no-op, and AmlReleaseTableList frees every chunk
+  in one shot.  Lists that were not created by AmlInitializeTableList keep
+  using pool allocations.
+
+**/
+
+#include "LocalAmlLib.h"
+
+// All table lists handed out by AmlInitializeTableList
+STATIC LIST_ENTRY  mAmlTableLists = INITIALIZE_LIST_HEAD_VARIABLE (mAmlTableLists);
+
+/**
+  Adds a new chunk to the arena
+
+  @param [in,out] Arena       - Arena to grow
+  @param [in]     MinimumSize - Minimum usable size of the new chunk
+
+  @return         Pointer to the new chunk, or NULL if out of resources
+**/
+STATIC
+AML_ARENA_CHUNK *
+InternalAmlArenaNewChunk (
+  IN OUT  AML_ARENA   *Arena,
+  IN      UINTN       MinimumSize
+)
+{
+  AML_ARENA_CHUNK     *Chunk;
+  UINTN               Size;
+
+  Size = MAX (MinimumSize, AML_ARENA_CHUNK_SIZE);
+  Chunk = AllocatePool (sizeof (AML_ARENA_CHUNK) + Size);
+  if (Chunk == NULL) {
+    DEBUG ((DEBUG_ERROR, "%a: ERROR: Allocate arena chunk of 0x%X bytes\n", __FUNCTION__, Size));
+    return NULL;
+  }
+
+  Chunk->Size = Size;
+  Chunk->Used = 0;
+  Chunk->Last = NULL;
+
+  if (MinimumSize > AML_ARENA_CHUNK_SIZE / 4) {
+    // Oversized request: keep bumping in the current chunk
+    InsertTailList (&Arena->Chunks, &Chunk->Link);
+  } else {
+    InsertHeadList (&Arena->Chunks, &Chunk->Link);
+  }
+
+  return Chunk;
+}
+
+/**
+  Allocates a buffer from the arena
+
+  @param [in,out] Arena       - Arena to allocate from
+  @param [in]     Size        - Size of the buffer
+
+  @return         Pointer to the buffer, or NULL if out of resources
+**/
+VOID *
+EFIAPI
+InternalAmlArenaAllocate (
+  IN OUT  AML_ARENA   *Arena,
+  IN      UINTN       Size
+)
+{
+  AML_ARENA_CHUNK     *Chunk;
+  UINTN               AlignedSize;
+
+  AlignedSize = ALIGN_VALUE (MAX (Size, 1), sizeof (UINT64));
+
+  Chunk = NULL;
+  if (!IsListEmpty (&Arena->Chunks)) {
+    Chunk = AML_ARENA_CHUNK_FROM_LINK (GetFirstNode (&Arena->Chunks));
+    if (Chunk->Size - Chunk->Used < AlignedSize) {
+      Chunk = NULL;
+    }
+  }
+
+  if (Chunk == NULL) {
+    Chunk = InternalAmlArenaNewChunk (Arena, AlignedSize);
+    if (Chunk == NULL) {
+      return NULL;
+    }
+  }
+
+  Chunk->Last = AML_ARENA_CHUNK_DATA (Chunk) + Chunk->Used;
+  Chunk->Used += AlignedSize;
+  return Chunk->Last;
+}
+
+/**
+  Frees a buffer allocated from the arena
+
+  Only the most recent allocation of a chunk is actually given back, anything
+  else is reclaimed when the whole arena is freed.
+
+  @param [in,out] Arena       - Arena the buffer was allocated from
+  @param [in]     Buffer      - Buffer to free
+**/
+VOID
+EFIAPI
+InternalAmlArenaFree (
+  IN OUT  AML_ARENA   *Arena,
+  IN      VOID        *Buffer
+)
+{
+  AML_ARENA_CHUNK     *Chunk;
+
+  if (Buffer == NULL || IsListEmpty (&Arena->Chunks)) {
+    return;
+  }
+
+  Chunk = AML_ARENA_CHUNK_FROM_LINK (GetFirstNode (&Arena->Chunks));
+  if (Chunk->Last == Buffer) {
+    Chunk->Used = Chunk->Last - AML_ARENA_CHUNK_DATA (Chunk);
+    Chunk->Last = NULL;
+  }
+}
+
+/**
+  Resizes a buffer allocated from the arena, growing it in place when it is
+  the most recent allocation
+
+  @param [in,out] Arena       - Arena the buffer was allocated from
+  @param [in]     OldSize     - Current size of Buffer
+  @param [in]     NewSize     - Requested size
+  @param [in]     Buffer      - Buffer to resize, may be NULL
+
+  @return         Pointer to the resized buffer, or NULL if out of resources
+**/
+VOID *
+EFIAPI
+InternalAmlArenaReallocate (
+  IN OUT  AML_ARENA   *Arena,
+  IN      UINTN       OldSize,
+  IN      UINTN       NewSize,
+  IN      VOID        *Buffer
+)
+{
+  AML_ARENA_CHUNK     *Chunk;
+  UINTN               Offset;
+  UINTN               AlignedSize;
+  VOID                *NewBuffer;
+
+  if (Buffer != NULL && !IsListEmpty (&Arena->Chunks)) {
+    Chunk = AML_ARENA_CHUNK_FROM_LINK (GetFirstNode (&Arena->Chunks));
+    if (Chunk->Last == Buffer) {
+      Offset = Chunk->Last - AML_ARENA_CHUNK_DATA (Chunk);
+      AlignedSize = ALIGN_VALUE (MAX (NewSize, 1), sizeof (UINT64));
+      if (Chunk->Size - Offset >= AlignedSize) {
+        Chunk->Used = Offset + AlignedSize;
+        return Buffer;
+      }
+    }
+  }
+
+  NewBuffer = InternalAmlArenaAllocate (Arena, NewSize);
+  if (NewBuffer != NULL && Buffer != NULL) {
+    CopyMem (NewBuffer, Buffer, MIN (OldSize, NewSize));
+  }
+  return NewBuffer;
+}
+
+/**
+  Finds the arena owned by a table list
+
+  @param [in]     ListHead    - Head of AML Object linked list
+
+  @return         Pointer to the arena, or NULL if ListHead was not created
+                  by AmlInitializeTableList
+**/
+AML_ARENA *
+EFIAPI
+InternalAmlGetArena (
+  IN      LIST_ENTRY  *ListHead
+)
+{
+  LIST_ENTRY          *Node;
+  AML_TABLE_LIST      *TableList;
+
+  if (ListHead == NULL) {
+    return NULL;
+  }
+
+  for (Node = GetFirstNode (&mAmlTableLists);
+       !IsNull (&mAmlTableLists, Node);
+       Node = GetNextNode (&mAmlTableLists, Node)) {
+    TableList = AML_TABLE_LIST_FROM_LINK (Node);
+    if (&TableList->ListHead == ListHead) {
+      return &TableList->Arena;
+    }
+  }
+  return NULL;
+}
+
+/**
+  Allocates a table list along with its arena
+
+  @return         Pointer to the table list, or NULL if out of resources
+**/
+AML_TABLE_LIST *
+EFIAPI
+InternalAmlNewTableList (
+  VOID
+)
+{
+  AML_TABLE_LIST      *TableList;
+
+  TableList = AllocatePool (sizeof (AML_TABLE_LIST));
+  if (TableList == NULL) {
+    return NULL;
+  }
+
+  TableList->Signature = AML_TABLE_LIST_SIGNATURE;
+  InitializeListHead (&TableList->ListHead);
+  InitializeListHead (&TableList->Arena.Chunks);
+  InsertTailList (&mAmlTableLists, &TableList->Link);
+
+  return TableList;
+}
+
+/**
+  Finds the table list that owns ListHead
+
+  @param [in]     ListHead    - Head of AML Object linked list
+
+  @return         Pointer to the table list, or NULL if ListHead was not
+                  created by AmlInitializeTableList
+**/
+AML_TABLE_LIST *
+EFIAPI
+InternalAmlGetTableList (
+  IN      LIST_ENTRY  *ListHead
+)
+{
+  AML_ARENA           *Arena;
+
+  Arena = InternalAmlGetArena (ListHead);
+  if (Arena == NULL) {
+    return NULL;
+  }
+  return BASE_CR (Arena, AML_TABLE_LIST, Arena);
+}
+
+/**
+  Frees a table list, its arena and with it every Object and Data buffer that
+  was allocated for the table
+
+  @param [in]     TableList   - Table list to free
+**/
+VOID
+EFIAPI
+InternalAmlFreeTableList (
+  IN      AML_TABLE_LIST  *TableList
+)
+{
+  LIST_ENTRY          *Node;
+  AML_ARENA_CHUNK     *Chunk;
+
+  ASSERT (TableList->Signature == AML_TABLE_LIST_SIGNATURE);
+
+  RemoveEntryList (&TableList->Link);
+
+  Node = GetFirstNode (&TableList->Arena.Chunks);
+  while (!IsNull (&TableList->Arena.Chunks, Node)) {
+    Chunk = AML_ARENA_CHUNK_FROM_LINK (Node);
+    Node = GetNextNode (&TableList->Arena.Chunks, Node);
+    FreePool (Chunk);
+  }
+
+  FreePool (TableList);
+}
+
+/**
+  Allocates a buffer for an Object's Data, from the Object's arena when it has
+  one, else from pool
+
+  @param [in]     Object      - Object the buffer is for
+  @param [in]     Size        - Size of the buffer
+
+  @return         Pointer to the buffer, or NULL if out of resources
+**/
+VOID *
+EFIAPI
+InternalAmlAllocateData (
+  IN      AML_OBJECT_INSTANCE *Object,
+  IN      UINTN               Size
+)
+{
+  AML_ARENA           *Arena;
+
+  Arena = AML_OBJECT_NODE_FROM_OBJECT (Object)->Arena;
+  if (Arena == NULL) {
+    return AllocatePool (Size);
+  }
+  return InternalAmlArenaAllocate (Arena, Size);
+}
+
+/**
+  Allocates a zeroed buffer for an Object's Data, from the Object's arena when
+  it has one, else from pool
+
+  @param [in]     Object      - Object the buffer is for
+  @param [in]     Size        - Size of the buffer
+
+  @return         Pointer to the buffer, or NULL if out of resources
+**/
+VOID *
+EFIAPI
+InternalAmlAllocateZeroData (
+  IN      AML_OBJECT_INSTANCE *Object,
+  IN      UINTN               Size
+)
+{
+  VOID                *Buffer;
+
+  Buffer = InternalAmlAllocateData (Object, Size);
+  if (Buffer != NULL) {
+    ZeroMem (Buffer, Size);
+  }
+  return Buffer;
+}
+
+/**
+  Resizes an Object's Data buffer, like ReallocatePool
+
+  @param [in]     Object      - Object the buffer belongs to
+  @param [in]     OldSize     - Current size of Buffer
+  @param [in]     NewSize     - Requested size
+  @param [in]     Buffer      - Buffer to resize, may be NULL
+
+  @return         Pointer to the resized buffer, or NULL if out of resources
+**/
+VOID *
+EFIAPI
+InternalAmlReallocateData (
+  IN      AML_OBJECT_INSTANCE *Object,
+  IN      UINTN               OldSize,
+  IN      UINTN               NewSize,
+  IN      VOID                *Buffer
+)
+{
+  AML_ARENA           *Arena;
+
+  Arena = AML_OBJECT_NODE_FROM_OBJECT (Object)->Arena;
+  if (Arena == NULL) {
+    return ReallocatePool (OldSize, NewSize, Buffer);
+  }
+  return InternalAmlArenaReallocate (Arena, OldSize, NewSize, Buffer);
+}
+
+/**
+  Frees an Object's Data buffer
+
+  @param [in]     Object      - Object the buffer belongs to
+  @param [in]     Buffer      - Buffer to free
+**/
+VOID
+EFIAPI
+InternalAmlFreeData (
+  IN      AML_OBJECT_INSTANCE *Object,
+  IN      VOID                *Buffer
+)
+{
+  AML_ARENA           *Arena;
+
+  Arena = AML_OBJECT_NODE_FROM_OBJECT (Object)->Arena;
+  if (Arena == NULL) {
+    FreePool (Buffer);
+  } else {
+    InternalAmlArenaFree (Arena, Buffer);
+  }
+}
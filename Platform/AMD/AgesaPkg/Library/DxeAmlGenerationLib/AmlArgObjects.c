@@ -13,6 +13,10 @@
   Valid Argument numbers are 0, 1, 2, 3, 4, 5 and 6.
   AML supports max 7 argument, i.e., Arg1, Arg2 ... Arg6.
 
+  The buffer is allocated from Object's arena, or from pool when Object has
+  no arena.
+
+  @param[in]    Object          - Object the buffer is for
   @param[in]    ArgN            - Argument Number
   @param[out]   ReturnData      - Allocated DataBuffer with encoded integer
   @param[out]   ReturnDataSize  - Size of ReturnData
@@ -24,50 +28,52 @@
 EFI_STATUS
 EFIAPI
 InternalAmlArgBuffer (
-  IN  OUT UINT8   ArgN,
-      OUT VOID    **ReturnData,
-      OUT UINTN   *ReturnDataSize
+  IN      AML_OBJECT_INSTANCE *Object,
+  IN  OUT UINT8               ArgN,
+      OUT VOID                **ReturnData,
+      OUT UINTN               *ReturnDataSize
 )
 {
   UINT8   *Data;
   UINTN   DataSize;
+  UINT8   OpCode;
 
-  Data = AllocateZeroPool (sizeof (UINT8));
-  if (Data == NULL) {
-    DEBUG ((
-      DEBUG_ERROR,
-      "%a: ERROR: Failed to create Data Buffer.\n",
-      __FUNCTION__
-      ));
-    return EFI_OUT_OF_RESOURCES;
-  }
-  DataSize = 1;
   switch (ArgN) {
     case 0:
-      Data[0] = AML_ARG0;
+      OpCode = AML_ARG0;
       break;
     case 1:
-      Data[0] = AML_ARG1;
+      OpCode = AML_ARG1;
       break;
     case 2:
-      Data[0] = AML_ARG2;
+      OpCode = AML_ARG2;
       break;
     case 3:
-      Data[0] = AML_ARG3;
+      OpCode = AML_ARG3;
       break;
     case 4:
-      Data[0] = AML_ARG4;
+      OpCode = AML_ARG4;
       break;
     case 5:
-      Data[0] = AML_ARG5;
+      OpCode = AML_ARG5;
       break;
     case 6:
-      Data[0] = AML_ARG6;
+      OpCode = AML_ARG6;
       break;
     default:
-      FreePool (Data);
       return EFI_INVALID_PARAMETER;
   }
+  DataSize = 1;
+  Data = InternalAmlAllocateData (Object, DataSize);
+  if (Data == NULL) {
+    DEBUG ((
+      DEBUG_ERROR,
+      "%a: ERROR: Failed to create Data Buffer.\n",
+      __FUNCTION__
+      ));
+    return EFI_OUT_OF_RESOURCES;
+  }
+  Data[0] = OpCode;
   *ReturnData = (VOID *)Data;
   *ReturnDataSize = DataSize;
 
@@ -122,6 +128,7 @@ AmlOpArgN (
   }
 
   Status = InternalAmlArgBuffer (
+            Object,
             ArgN,
             (VOID **)&(Object->Data),
             &(Object->DataSize)
@@ -90,6 +90,10 @@ AmlGetCompletedTable (
   Allocates a LIST_ENTRY linked list item and initializes it.  Use
   AmlReleaseTableList to free resulting table and LIST_ENTRY.
 
+  The list owns an arena that all Objects of the table, and their Data, are
+  allocated from.  The table returned by AmlGetCompletedTable lives in that
+  arena and is valid until AmlReleaseTableList.
+
   @param[in,out]  ListHead  - Head of linked list of Objects
 
   @retval         EFI_SUCCESS
@@ -102,18 +106,21 @@ AmlInitializeTableList (
   IN OUT  LIST_ENTRY  **ListHead
   )
 {
+  AML_TABLE_LIST  *TableList;
+
   if (ListHead == NULL) {
     DEBUG ((DEBUG_ERROR, "%a: ERROR: ListHead = NULL\n", __FUNCTION__));
     return EFI_INVALID_PARAMETER;
   }
 
-  *ListHead = AllocatePool (sizeof (LIST_ENTRY));
-  if (*ListHead == NULL) {
+  TableList = InternalAmlNewTableList ();
+  if (TableList == NULL) {
     DEBUG ((DEBUG_ERROR, "%a: ERROR: Unable to allocate Table List Head\n", __FUNCTION__));
+    *ListHead = NULL;
     return EFI_OUT_OF_RESOURCES;
   }
 
-  InitializeListHead (*ListHead);
+  *ListHead = &TableList->ListHead;
 
   return EFI_SUCCESS;
 }
@@ -122,7 +129,8 @@ AmlInitializeTableList (
   Release table List
 
   Releases all elements.  Use to free built table and LIST_ENTRY allocated by
-  AmlInitializeTableList.
+  AmlInitializeTableList.  The table's arena is freed in one shot, without
+  walking the Objects.
 
   @param[in,out]  ListHead  - Head of linked list of Objects
 
@@ -135,14 +143,20 @@ AmlReleaseTableList (
   IN OUT  LIST_ENTRY  **ListHead
   )
 {
+  AML_TABLE_LIST  *TableList;
 
   if (*ListHead == NULL) {
     DEBUG ((DEBUG_ERROR, "%a: ERROR: NULL ListHead passed in\n", __FUNCTION__));
     return EFI_INVALID_PARAMETER;
   }
 
-  AmlFreeObjectList (*ListHead);
-  FreePool (*ListHead);
+  TableList = InternalAmlGetTableList (*ListHead);
+  if (TableList != NULL) {
+    InternalAmlFreeTableList (TableList);
+  } else {
+    AmlFreeObjectList (*ListHead);
+    FreePool (*ListHead);
+  }
   *ListHead = NULL;
 
   return EFI_SUCCESS;
@@ -9,7 +9,7 @@
 #include "LocalAmlLib.h"
 
 /*
-  Creates an allocated buffer with sized data and no Op Code
+  Creates a buffer for Object with sized data and no Op Code
 
   ByteData := 0x00 - 0xFF
   WordData := ByteData[0:7] ByteData[8:15] // 0x0000-0xFFFF
@@ -18,12 +18,13 @@
 
   Forces max integer size UINT64
 
-  Caller is responsible for freeing returned buffer.
+  The buffer is allocated from Object's arena, or from pool when Object has
+  no arena, and is released along with Object.
 
+  @param[in]    Object          - Object the buffer is for
   @param[in]    Integer         - Integer value to encode
   @param[in]    IntegerSize     - Size of integer in bytes
   @param[out]   ReturnData      - Allocated DataBuffer with encoded integer
-  @param[out]   ReturnDataSize  - Size of ReturnData
 
   @return       EFI_SUCCESS     - Successful completion
   @return       EFI_OUT_OF_RESOURCES - Failed to allocate ReturnDataBuffer
@@ -31,6 +32,7 @@
 EFI_STATUS
 EFIAPI
 InternalAmlSizedDataBuffer (
+  IN      AML_OBJECT_INSTANCE *Object,
   IN      UINT64      Integer,
   IN      UINTN       IntegerSize,
   OUT     VOID        **ReturnData
@@ -49,26 +51,26 @@ InternalAmlSizedDataBuffer (
     DEBUG ((DEBUG_ERROR, "%a: ERROR: Integer is larger than requestd size.\n", __FUNCTION__));
     return EFI_INVALID_PARAMETER;
   }
-  // Max Data Size is 64 bit. Plus one Opcode byte
-  Data = AllocateZeroPool (sizeof (UINT64));
+  Data = InternalAmlAllocateData (Object, IntegerSize);
   if (Data == NULL) {
     DEBUG ((DEBUG_ERROR, "%a: ERROR: Integer Space Alloc Failed\n", __FUNCTION__));
     return EFI_OUT_OF_RESOURCES;
   }
 
-  // Already established we only have supported sizes above
+  // Already established we only have supported sizes above. Arena buffers
+  // are not naturally aligned, so store unaligned
   switch (IntegerSize) {
     case sizeof (UINT8):
-      *(UINT8 *)Data = (UINT8)Integer;
+      *Data = (UINT8)Integer;
       break;
     case sizeof (UINT16):
-      *(UINT16 *)Data = (UINT16)Integer;
+      WriteUnaligned16 ((UINT16 *)Data, (UINT16)Integer);
       break;
     case sizeof (UINT32):
-      *(UINT32 *)Data = (UINT32)Integer;
+      WriteUnaligned32 ((UINT32 *)Data, (UINT32)Integer);
       break;
     case sizeof (UINT64):
-      *(UINT64 *)Data = (UINT64)Integer;
+      WriteUnaligned64 ((UINT64 *)Data, Integer);
       break;
   }
 
@@ -81,6 +83,10 @@ InternalAmlSizedDataBuffer (
 
   Forces max integer size UINT64
 
+  The buffer is allocated from Object's arena, or from pool when Object has
+  no arena, and is released along with Object.
+
+  @param[in]    Object          - Object the buffer is for
   @param[in]    Integer         - Integer value to encode
   @param[out]   ReturnData      - Allocated DataBuffer with encoded integer
   @param[out]   ReturnDataSize  - Size of ReturnData
@@ -91,6 +97,7 @@ InternalAmlSizedDataBuffer (
 EFI_STATUS
 EFIAPI
 InternalAmlDataIntegerBuffer (
+  IN      AML_OBJECT_INSTANCE *Object,
   IN      UINT64      Integer,
   OUT     VOID        **ReturnData,
   OUT     UINTN       *ReturnDataSize
@@ -98,59 +105,51 @@ InternalAmlDataIntegerBuffer (
 {
   UINT8               *IntegerData;
   UINTN               IntegerDataSize;
-  UINT8               *Data = NULL;
-  UINTN               DataSize;
-
-
-  // Max Data Size is 64 bit. Plus one Opcode byte
-  IntegerData = AllocateZeroPool (sizeof (UINT64) + 1);
-  if (IntegerData == NULL) {
-    DEBUG ((DEBUG_ERROR, "%a: ERROR: Integer Space Alloc Failed\n", __FUNCTION__));
-    return EFI_OUT_OF_RESOURCES;
-  }
+  UINT8               OpCode;
 
   if (Integer == 0) {
     // ZeroOp
     IntegerDataSize = 1;
-    IntegerData[0] = AML_ZERO_OP;
+    OpCode = AML_ZERO_OP;
   } else if (Integer == 1) {
     // OneOp
     IntegerDataSize = 1;
-    IntegerData[0] = AML_ONE_OP;
+    OpCode = AML_ONE_OP;
   } else if (Integer == (UINT64) ~0x0){
     // OnesOp
     IntegerDataSize = 1;
-    IntegerData[0] = AML_ONES_OP;
+    OpCode = AML_ONES_OP;
+  } else if (Integer >= 0x100000000) {
+    // QWordConst
+    IntegerDataSize = sizeof (UINT64) + 1;
+    OpCode = AML_QWORD_PREFIX;
+  } else if (Integer >= 0x10000) {
+    // DWordConst
+    IntegerDataSize = sizeof (UINT32) + 1;
+    OpCode = AML_DWORD_PREFIX;
+  } else if (Integer >= 0x100) {
+    // WordConst
+    IntegerDataSize = sizeof (UINT16) + 1;
+    OpCode = AML_WORD_PREFIX;
   } else {
-    if (Integer >= 0x100000000) {
-      // QWordConst
-      IntegerDataSize = sizeof (UINT64) + 1;
-      IntegerData[0] = AML_QWORD_PREFIX;
-    } else if (Integer >= 0x10000) {
-      // DWordConst
-      IntegerDataSize = sizeof (UINT32) + 1;
-      IntegerData[0] = AML_DWORD_PREFIX;
-    } else if (Integer >= 0x100) {
-      // WordConst
-      IntegerDataSize = sizeof (UINT16) + 1;
-      IntegerData[0] = AML_WORD_PREFIX;
-    } else {
-      // ByteConst
-      IntegerDataSize = sizeof (UINT8) + 1;
-      IntegerData[0] = AML_BYTE_PREFIX;
-    }
-    DataSize = IntegerDataSize - 1;
-    InternalAmlSizedDataBuffer (Integer, DataSize, (VOID **)&Data);
-    if (Data == NULL) {
-      DEBUG ((DEBUG_ERROR, "%a: ERROR: Integer Data Space Alloc Failed\n", __FUNCTION__));
-      FreePool (IntegerData);
-      return EFI_OUT_OF_RESOURCES;
-    }
-    CopyMem (&IntegerData[1], Data, DataSize);
-    FreePool (Data);
+    // ByteConst
+    IntegerDataSize = sizeof (UINT8) + 1;
+    OpCode = AML_BYTE_PREFIX;
+  }
+
+  // Size is known up front, so allocate exactly what is emitted
+  IntegerData = InternalAmlAllocateData (Object, IntegerDataSize);
+  if (IntegerData == NULL) {
+    DEBUG ((DEBUG_ERROR, "%a: ERROR: Integer Space Alloc Failed\n", __FUNCTION__));
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  IntegerData[0] = OpCode;
+  if (IntegerDataSize > 1) {
+    // AML integers are little endian, so the low bytes of Integer are the data
+    CopyMem (&IntegerData[1], &Integer, IntegerDataSize - 1);
   }
 
-  // Reallocate the pool so size is exact
   *ReturnData = (VOID *)IntegerData;
   *ReturnDataSize = IntegerDataSize;
 
@@ -215,7 +214,8 @@ AmlOPDataInteger (
     goto Done;
   }
 
-  Status = InternalAmlDataIntegerBuffer (Integer,
+  Status = InternalAmlDataIntegerBuffer (Object,
+                                         Integer,
                                          (VOID **)&(Object->Data),
                                          &(Object->DataSize));
   if (EFI_ERROR (Status)) {
@@ -276,7 +276,8 @@ InternalAmlOPSizedData (
   }
 
   Object->DataSize = IntegerSize;
-  Status = InternalAmlSizedDataBuffer (Integer,
+  Status = InternalAmlSizedDataBuffer (Object,
+                                              Integer,
                                               Object->DataSize,
                                               (VOID **)&(Object->Data)
                                               );
@@ -439,7 +440,7 @@ AmlOPDataString (
 
   // AML_STRING_PREFIX + String + NULL Terminator
   DataSize += 2;
-  Data = AllocatePool (DataSize);
+  Data = InternalAmlAllocateData (Object, DataSize);
   if (Data == NULL) {
     Status = EFI_OUT_OF_RESOURCES;
     DEBUG ((DEBUG_ERROR, "%a: ERROR: String Space Allocation %a\n",
@@ -500,7 +501,7 @@ AmlOPDataBufferFromArray (
     goto Done;
   }
 
-  Object->Data = AllocatePool (BufferSize);
+  Object->Data = InternalAmlAllocateData (Object, BufferSize);
   Object->DataSize = BufferSize;
   if (Object->Data == NULL) {
     Status = EFI_OUT_OF_RESOURCES;
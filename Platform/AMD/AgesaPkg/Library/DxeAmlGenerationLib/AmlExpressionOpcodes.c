@@ -137,6 +137,7 @@ AmlBuffer (
       goto Done;
     }
     Status = InternalAmlDataIntegerBuffer (
+                Object,
                 InternalBufferSize,
                 (VOID **)&Object->Data,
                 &Object->DataSize
@@ -148,10 +149,11 @@ AmlBuffer (
 
     if (ChildObject->DataSize !=0 && ChildObject->Data != NULL) {
       // Make room for ChildObject->Data
-      Object->Data = ReallocatePool (Object->DataSize,
-                                     Object->DataSize +
-                                       ChildObject->DataSize,
-                                     Object->Data);
+      Object->Data = InternalAmlReallocateData (Object,
+                                                Object->DataSize,
+                                                Object->DataSize +
+                                                  ChildObject->DataSize,
+                                                Object->Data);
       if (Object->Data == NULL) {
         DEBUG ((DEBUG_ERROR, "%a: ERROR: to reallocate BufferSize\n", __FUNCTION__));
         Status = EFI_OUT_OF_RESOURCES;
@@ -198,7 +200,7 @@ AmlBuffer (
 
     //  BufferOp is one byte
     Object->DataSize = ChildObject->DataSize + 1;
-    Object->Data = AllocatePool (Object->DataSize);
+    Object->Data = InternalAmlAllocateData (Object, Object->DataSize);
     if (Object->Data == NULL) {
       DEBUG ((DEBUG_ERROR, "%a: ERROR: Buffer allocate failed\n", __FUNCTION__));
       Status = EFI_OUT_OF_RESOURCES;
@@ -309,7 +311,7 @@ AmlLEqual (
 
     //  LequalOp is one byte
     Object->DataSize = ChildObject->DataSize + 1;
-    Object->Data = AllocatePool (Object->DataSize);
+    Object->Data = InternalAmlAllocateData (Object, Object->DataSize);
     if (Object->Data == NULL) {
       DEBUG ((DEBUG_ERROR, "%a: ERROR: Buffer allocate failed\n", __FUNCTION__));
       Status = EFI_OUT_OF_RESOURCES;
@@ -433,7 +435,7 @@ InternalAmlNumElements (
 
     if (*NumElements <= MAX_UINT8) {
       Object->DataSize = 1;
-      Object->Data = AllocateZeroPool(Object->DataSize);
+      Object->Data = InternalAmlAllocateZeroData (Object, Object->DataSize);
       if (Object->Data == NULL) {
         DEBUG ((DEBUG_ERROR, "%a: ERROR: NumElements allocate failed\n", __FUNCTION__));
         Status = EFI_OUT_OF_RESOURCES;
@@ -442,6 +444,7 @@ InternalAmlNumElements (
       Object->Data[0] = (UINT8)*NumElements;
     } else {
       Status = InternalAmlDataIntegerBuffer (
+                 Object,
                  *NumElements,
                  (VOID **)&Object->Data,
                  &Object->DataSize
@@ -454,7 +457,8 @@ InternalAmlNumElements (
 
     if (ChildObject->DataSize !=0 && ChildObject->Data != NULL) {
       // Make room for ChildObject->Data
-      Object->Data = ReallocatePool (
+      Object->Data = InternalAmlReallocateData (
+                       Object,
                        Object->DataSize,
                        Object->DataSize +
                        ChildObject->DataSize,
@@ -613,7 +617,7 @@ AmlPackage (
 
     //  PackageOp and VarPackageOp are both one byte
     Object->DataSize = ChildObject->DataSize + 1;
-    Object->Data = AllocatePool (Object->DataSize);
+    Object->Data = InternalAmlAllocateData (Object, Object->DataSize);
     if (Object->Data == NULL) {
       DEBUG ((DEBUG_ERROR, "%a: ERROR: Package allocate failed\n", __FUNCTION__));
       Status = EFI_OUT_OF_RESOURCES;
@@ -722,7 +726,7 @@ AmlStore (
         goto Done;
       }
 
-      Object->Data = AllocateZeroPool (ChildObject->DataSize + 1);
+      Object->Data = InternalAmlAllocateZeroData (Object, ChildObject->DataSize + 1);
       if (Object->Data == NULL) {
         Status = EFI_OUT_OF_RESOURCES;
         DEBUG ((DEBUG_ERROR, "%a: ERROR: allocate Object->Data for Store()\n", __FUNCTION__));
@@ -844,7 +848,7 @@ InternalAmlShift (
         goto Done;
       }
 
-      Object->Data = AllocateZeroPool (ChildObject->DataSize + 1);
+      Object->Data = InternalAmlAllocateZeroData (Object, ChildObject->DataSize + 1);
       if (Object->Data == NULL) {
         Status = EFI_OUT_OF_RESOURCES;
         DEBUG ((DEBUG_ERROR, "%a: ERROR: allocate Object->Data for Store()\n", __FUNCTION__));
@@ -1031,7 +1035,7 @@ InternalAmlFindSetBit (
         goto Done;
       }
 
-      Object->Data = AllocateZeroPool (ChildObject->DataSize + 1);
+      Object->Data = InternalAmlAllocateZeroData (Object, ChildObject->DataSize + 1);
       if (Object->Data == NULL) {
         Status = EFI_OUT_OF_RESOURCES;
         DEBUG ((DEBUG_ERROR, "%a: ERROR: allocate Object->Data for Store()\n", __FUNCTION__));
@@ -1207,7 +1211,7 @@ AmlDecrement (
         goto Done;
       }
 
-      Object->Data = AllocateZeroPool (ChildObject->DataSize + 1);
+      Object->Data = InternalAmlAllocateZeroData (Object, ChildObject->DataSize + 1);
       if (Object->Data == NULL) {
         Status = EFI_OUT_OF_RESOURCES;
         DEBUG ((DEBUG_ERROR, "%a: ERROR: allocate Object->Data for Store()\n", __FUNCTION__));
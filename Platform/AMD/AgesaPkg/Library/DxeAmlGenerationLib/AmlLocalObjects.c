@@ -13,6 +13,10 @@
   Valid Argument numbers are 0, 1, 2, 3, 4, 5 and 6.
   AML supports max 7 Local variables, i.e., Local1, Local2 ... Local6.
 
+  The buffer is allocated from Object's arena, or from pool when Object has
+  no arena.
+
+  @param[in]    Object          - Object the buffer is for
   @param[in]    LocalN          - Local variable Number
   @param[out]   ReturnData      - Allocated DataBuffer with encoded integer
   @param[out]   ReturnDataSize  - Size of ReturnData
@@ -24,55 +28,58 @@
 EFI_STATUS
 EFIAPI
 InternalAmlLocalBuffer (
-  IN  OUT UINT8  LocalN,
-  OUT VOID       **ReturnData,
-  OUT UINTN      *ReturnDataSize
+  IN      AML_OBJECT_INSTANCE  *Object,
+  IN  OUT UINT8                LocalN,
+  OUT VOID                     **ReturnData,
+  OUT UINTN                    *ReturnDataSize
   )
 {
   UINT8  *Data;
   UINTN  DataSize;
+  UINT8  OpCode;
 
-  Data = AllocateZeroPool (sizeof (UINT8));
-  if (Data == NULL) {
-    DEBUG ((
-      DEBUG_ERROR,
-      "%a: ERROR: Failed to create Data Buffer.\n",
-      __FUNCTION__
-      ));
-    return EFI_OUT_OF_RESOURCES;
-  }
-
-  DataSize = 1;
   switch (LocalN) {
     case 0:
-      Data[0] = AML_LOCAL0;
+      OpCode = AML_LOCAL0;
       break;
     case 1:
-      Data[0] = AML_LOCAL1;
+      OpCode = AML_LOCAL1;
       break;
     case 2:
-      Data[0] = AML_LOCAL2;
+      OpCode = AML_LOCAL2;
       break;
     case 3:
-      Data[0] = AML_LOCAL3;
+      OpCode = AML_LOCAL3;
       break;
     case 4:
-      Data[0] = AML_LOCAL4;
+      OpCode = AML_LOCAL4;
       break;
     case 5:
-      Data[0] = AML_LOCAL5;
+      OpCode = AML_LOCAL5;
       break;
     case 6:
-      Data[0] = AML_LOCAL6;
+      OpCode = AML_LOCAL6;
       break;
     case 7:
-      Data[0] = AML_LOCAL7;
+      OpCode = AML_LOCAL7;
       break;
     default:
-      FreePool (Data);
       return EFI_INVALID_PARAMETER;
   }
 
+  DataSize = 1;
+  Data     = InternalAmlAllocateData (Object, DataSize);
+  if (Data == NULL) {
+    DEBUG ((
+      DEBUG_ERROR,
+      "%a: ERROR: Failed to create Data Buffer.\n",
+      __FUNCTION__
+      ));
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Data[0] = OpCode;
+
   *ReturnData     = (VOID *)Data;
   *ReturnDataSize = DataSize;
 
@@ -128,6 +135,7 @@ AmlOPLocalN (
   }
 
   Status = InternalAmlLocalBuffer (
+             Object,
              LocalN,
              (VOID **)&(Object->Data),
              &(Object->DataSize)
@@ -176,8 +176,16 @@ InternalAmlNameSeg (
     }
   }
 
-  NameSeg = AllocateZeroPool(4);
+  // Append the object first so NameSeg comes from its arena
+  Status = InternalAppendNewAmlObjectNoData(&Object, ListHead);
+  if (EFI_ERROR(Status)) {
+    InternalFreeAmlObject (&Object, ListHead);
+    return Status;
+  }
+
+  NameSeg = InternalAmlAllocateData (Object, 4);
   if (NameSeg == NULL) {
+    InternalFreeAmlObject (&Object, ListHead);
     return EFI_OUT_OF_RESOURCES;
   }
   CopyMem(NameSeg, Name, NameLen);
@@ -186,18 +194,10 @@ InternalAmlNameSeg (
     SetMem (&NameSeg[NameLen], 4 - NameLen, '_');
   }
 
-  Status = InternalAppendNewAmlObjectNoData(&Object, ListHead);
-  if (Object != NULL) {
-    if (!EFI_ERROR(Status)) {
-      Object->Data = NameSeg;
-      Object->DataSize = 4;
-      Object->Completed = TRUE;
-    } else {
-      InternalFreeAmlObject (&Object, ListHead);
-      FreePool(NameSeg);
-    }
-  }
-  return Status;
+  Object->Data = NameSeg;
+  Object->DataSize = 4;
+  Object->Completed = TRUE;
+  return EFI_SUCCESS;
 }
 
 /**
@@ -423,9 +423,10 @@ AmlOPNameString (
   // Create AML Record with NameString contents from above
   // Copy in RootChar or ParentPrefixChar(s)
   if (NameStringPrefixSize != 0) {
-    Object->Data = ReallocatePool (Object->DataSize,
-                                   NameStringPrefixSize,
-                                   Object->Data);
+    Object->Data = InternalAmlReallocateData (Object,
+                                              Object->DataSize,
+                                              NameStringPrefixSize,
+                                              Object->Data);
     CopyMem (&Object->Data[Object->DataSize],
              NameStringPrefix,
              NameStringPrefixSize);
@@ -443,19 +444,22 @@ AmlOPNameString (
     goto Done;
   } else if (NameSegCount == 1) {
     // Single NameSeg
-    Object->Data = ReallocatePool (Object->DataSize,
-                                   Object->DataSize + NameStringSize,
-                                   Object->Data);
+    Object->Data = InternalAmlReallocateData (Object,
+                                              Object->DataSize,
+                                              Object->DataSize + NameStringSize,
+                                              Object->Data);
   } else if (NameSegCount == 2) {
-    Object->Data = ReallocatePool (Object->DataSize,
-                                   Object->DataSize + NameStringSize + 1,
-                                   Object->Data);
+    Object->Data = InternalAmlReallocateData (Object,
+                                              Object->DataSize,
+                                              Object->DataSize + NameStringSize + 1,
+                                              Object->Data);
     Object->Data[Object->DataSize] = AML_DUAL_NAME_PREFIX;
     Object->DataSize += 1;
   } else {
-    Object->Data = ReallocatePool (Object->DataSize,
-                                   Object->DataSize + NameStringSize + 2,
-                                   Object->Data);
+    Object->Data = InternalAmlReallocateData (Object,
+                                              Object->DataSize,
+                                              Object->DataSize + NameStringSize + 2,
+                                              Object->Data);
     Object->Data[Object->DataSize] = AML_MULTI_NAME_PREFIX;
     Object->Data[Object->DataSize + 1] = NameSegCount & 0xFF;
     Object->DataSize += 2;
@@ -110,7 +110,7 @@ AmlDevice (
 
     // Device Op is two bytes
     Object->DataSize = ChildObject->DataSize + 2;
-    Object->Data = AllocatePool (Object->DataSize);
+    Object->Data = InternalAmlAllocateData (Object, Object->DataSize);
     if (Object->Data == NULL) {
       Status = EFI_OUT_OF_RESOURCES;
       DEBUG ((DEBUG_ERROR, "%a: ERROR: allocate Object->Data for %a\n", __FUNCTION__, String));
@@ -172,7 +172,7 @@ InternalAmlAccessField (
     goto Done;
   }
 
-  Object->Data = AllocateZeroPool (3);
+  Object->Data = InternalAmlAllocateZeroData (Object, 3);
   // AML_ACCESSFIELD_OP + AccessType + AccessAttrib
   if (Object->Data == NULL) {
     Status = EFI_OUT_OF_RESOURCES;
@@ -229,7 +229,7 @@ InternalAmlExtendedAccessField (
     goto Done;
   }
 
-  Object->Data = AllocateZeroPool (4);
+  Object->Data = InternalAmlAllocateZeroData (Object, 4);
   // AML_EXTACCESSFIELD_OP + AccessType + AccessAttrib + AccessLength
   if (Object->Data == NULL) {
     Status = EFI_OUT_OF_RESOURCES;
@@ -430,7 +430,7 @@ AmlOPExternal (
     goto Done;
   }
 
-  Object->Data = AllocateZeroPool (ChildObject->DataSize + 3);
+  Object->Data = InternalAmlAllocateZeroData (Object, ChildObject->DataSize + 3);
   // AML_EXTERNAL_OP + Name + ObjectType + ArgumentCount
   if (Object->Data == NULL) {
     Status = EFI_OUT_OF_RESOURCES;
@@ -598,25 +598,26 @@ AmlOPOffset (
     DEBUG ((DEBUG_ERROR, "%a: ERROR: appending new AML object\n", __FUNCTION__));
     goto Done;
   }
-  Status = InternalAmlBitPkgLength((UINT32) BitCount, &PkgLength, &DataLength);
+  Status = InternalAmlBitPkgLength(Object, (UINT32) BitCount, &PkgLength, &DataLength);
   if (EFI_ERROR(Status)) {
     DEBUG ((DEBUG_ERROR, "%a: ERROR: internal AML PkgLength\n", __FUNCTION__));
     goto Done;
   }
 
   Object->DataSize = DataLength + 1; //add one for Reserved Field Indicator
-  Object->Data = AllocateZeroPool(Object->DataSize);
+  Object->Data = InternalAmlAllocateZeroData (Object, Object->DataSize);
 
   if (Object->Data == NULL) {
     Status = EFI_OUT_OF_RESOURCES;
     DEBUG ((DEBUG_ERROR, "%a: ERROR: allocate Object->Data for Offset\n", __FUNCTION__));
+    InternalAmlFreeData (Object, PkgLength);
     goto Done;
   }
 
   Object->Data[0] = 0;
   CopyMem(&Object->Data[1], PkgLength, DataLength); //read internal offset data
   Object->Completed = TRUE;
-  FreePool(PkgLength);
+  InternalAmlFreeData (Object, PkgLength);
 
   Done:
   if (EFI_ERROR (Status)) {
@@ -672,7 +673,7 @@ AmlOPFieldUnit (
         DEBUG ((DEBUG_ERROR, "%a: ERROR: Unable to append AML object.\n", __FUNCTION__));
         goto Done;
       }
-      Object->Data = AllocateZeroPool(1);
+      Object->Data = InternalAmlAllocateZeroData (Object, 1);
       Object->DataSize = 1;
       Object->Completed = TRUE;
     }
@@ -705,7 +706,7 @@ AmlOPFieldUnit (
     goto Done;
   }
 
-  Status = InternalAmlBitPkgLength(BitLength, &Object->Data, &Object->DataSize);
+  Status = InternalAmlBitPkgLength(Object, BitLength, &Object->Data, &Object->DataSize);
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "%a: ERROR: Appending BitLength for %a object\n", __FUNCTION__, Name));
     goto Done;
@@ -788,7 +789,7 @@ AmlField (
       goto Done;
     }
     Object->DataSize = sizeof(UINT64);
-    Object->Data = AllocateZeroPool (Object->DataSize);
+    Object->Data = InternalAmlAllocateZeroData (Object, Object->DataSize);
     Object->Completed = TRUE;
     if (EFI_ERROR (Status) || Object->Data == NULL) {
       DEBUG ((DEBUG_ERROR, "%a: ERROR: Start Field internal offset %a object\n", __FUNCTION__, Name));
@@ -818,7 +819,7 @@ AmlField (
 
     // Field Flags is one byte
     Object->DataSize = 1;
-    Object->Data = AllocatePool (Object->DataSize);
+    Object->Data = InternalAmlAllocateData (Object, Object->DataSize);
     if (Object->Data == NULL) {
       Status = EFI_OUT_OF_RESOURCES;
       DEBUG ((DEBUG_ERROR, "%a: ERROR: allocate Object->Data for %a\n", __FUNCTION__, Name));
@@ -881,7 +882,7 @@ AmlField (
 
     // Field Op is two bytes
     Object->DataSize = ChildObject->DataSize + 2;
-    Object->Data = AllocatePool (Object->DataSize);
+    Object->Data = InternalAmlAllocateData (Object, Object->DataSize);
     if (Object->Data == NULL) {
       Status = EFI_OUT_OF_RESOURCES;
       DEBUG ((DEBUG_ERROR, "%a: ERROR: allocate Object->Data for %a\n", __FUNCTION__, Name));
@@ -978,7 +979,7 @@ AmlBankField (
     // Insert internal offset counter
     Status = InternalAppendNewAmlObjectNoData (&Object, ListHead);
     Object->DataSize = sizeof(UINT64);
-    Object->Data = AllocateZeroPool (Object->DataSize);
+    Object->Data = InternalAmlAllocateZeroData (Object, Object->DataSize);
     Object->Completed = TRUE;
     if (EFI_ERROR (Status) || Object->Data == NULL) {
       DEBUG ((DEBUG_ERROR, "%a: ERROR: Start BankField internal offset %a object\n", __FUNCTION__, BankName));
@@ -1022,7 +1023,7 @@ AmlBankField (
 
     // Field Flags is one byte
     Object->DataSize = 1;
-    Object->Data = AllocatePool (Object->DataSize);
+    Object->Data = InternalAmlAllocateData (Object, Object->DataSize);
     if (Object->Data == NULL) {
       Status = EFI_OUT_OF_RESOURCES;
       DEBUG ((DEBUG_ERROR, "%a: ERROR: allocate Object->Data for %a\n", __FUNCTION__, BankName));
@@ -1085,7 +1086,7 @@ AmlBankField (
 
     // Field Op is two bytes
     Object->DataSize = ChildObject->DataSize + 2;
-    Object->Data = AllocatePool (Object->DataSize);
+    Object->Data = InternalAmlAllocateData (Object, Object->DataSize);
     if (Object->Data == NULL) {
       Status = EFI_OUT_OF_RESOURCES;
       DEBUG ((DEBUG_ERROR, "%a: ERROR: allocate Object->Data for %a\n", __FUNCTION__, BankName));
@@ -1180,7 +1181,7 @@ AmlIndexField (
     // Insert internal offset counter
     Status = InternalAppendNewAmlObjectNoData (&Object, ListHead);
     Object->DataSize = sizeof(UINT64);
-    Object->Data = AllocateZeroPool (Object->DataSize);
+    Object->Data = InternalAmlAllocateZeroData (Object, Object->DataSize);
     Object->Completed = TRUE;
     if (EFI_ERROR (Status) || Object->Data == NULL) {
       DEBUG ((DEBUG_ERROR, "%a: ERROR: Start IndexField internal offset %a object\n", __FUNCTION__, IndexName));
@@ -1217,7 +1218,7 @@ AmlIndexField (
 
     // Field Flags is one byte
     Object->DataSize = 1;
-    Object->Data = AllocatePool (Object->DataSize);
+    Object->Data = InternalAmlAllocateData (Object, Object->DataSize);
     if (Object->Data == NULL) {
       Status = EFI_OUT_OF_RESOURCES;
       DEBUG ((DEBUG_ERROR, "%a: ERROR: allocate Object->Data for %a\n", __FUNCTION__, IndexName));
@@ -1280,7 +1281,7 @@ AmlIndexField (
 
     // Field Op is two bytes
     Object->DataSize = ChildObject->DataSize + 2;
-    Object->Data = AllocatePool (Object->DataSize);
+    Object->Data = InternalAmlAllocateData (Object, Object->DataSize);
     if (Object->Data == NULL) {
       Status = EFI_OUT_OF_RESOURCES;
       DEBUG ((DEBUG_ERROR, "%a: ERROR: allocate Object->Data for %a\n", __FUNCTION__, IndexName));
@@ -1420,7 +1421,7 @@ AmlOPOperationRegion(
 
   // OpRegion Opcode is two bytes
   Object->DataSize = ChildObject->DataSize + 2;
-  Object->Data = AllocatePool (Object->DataSize);
+  Object->Data = InternalAmlAllocateData (Object, Object->DataSize);
   if (Object->Data == NULL) {
     Status = EFI_OUT_OF_RESOURCES;
     DEBUG ((DEBUG_ERROR, "%a: ERROR: allocate Object->Data for %a\n", __FUNCTION__, RegionName));
@@ -1545,7 +1546,7 @@ AmlOPCreateField (
 
   // CreateFieldOp is two bytes
   Object->DataSize = ChildObject->DataSize + 2;
-  Object->Data = AllocatePool (Object->DataSize);
+  Object->Data = InternalAmlAllocateData (Object, Object->DataSize);
   if (Object->Data == NULL) {
     Status = EFI_OUT_OF_RESOURCES;
     DEBUG ((DEBUG_ERROR, "%a: ERROR: allocate Object->Data for %a\n", __FUNCTION__, FieldName));
@@ -1672,7 +1673,7 @@ InternalAmlCreateFixedField (
 
   // CreateWordFieldOp is one byte
   Object->DataSize = ChildObject->DataSize + 1;
-  Object->Data = AllocatePool (Object->DataSize);
+  Object->Data = InternalAmlAllocateData (Object, Object->DataSize);
   if (Object->Data == NULL) {
     Status = EFI_OUT_OF_RESOURCES;
     DEBUG ((DEBUG_ERROR, "%a: ERROR: allocate Object->Data for %a\n", __FUNCTION__, FixedFieldName));
@@ -1977,7 +1978,7 @@ AmlMethod (
     }
     // Method Flags is one byte
     Object->DataSize = ChildObject->DataSize + 1;
-    Object->Data = AllocatePool (Object->DataSize);
+    Object->Data = InternalAmlAllocateData (Object, Object->DataSize);
     if (Object->Data == NULL) {
       Status = EFI_OUT_OF_RESOURCES;
       DEBUG ((DEBUG_ERROR, "%a: ERROR: allocate Object->Data for %a\n", __FUNCTION__, Name));
@@ -2029,7 +2030,7 @@ AmlMethod (
 
     // Method Op is one byte
     Object->DataSize = ChildObject->DataSize + 1;
-    Object->Data = AllocatePool (Object->DataSize);
+    Object->Data = InternalAmlAllocateData (Object, Object->DataSize);
     if (Object->Data == NULL) {
       Status = EFI_OUT_OF_RESOURCES;
       DEBUG ((DEBUG_ERROR, "%a: ERROR: allocate Object->Data for %a\n", __FUNCTION__, Name));
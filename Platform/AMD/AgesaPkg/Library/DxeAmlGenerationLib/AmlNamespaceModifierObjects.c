@@ -105,7 +105,7 @@ AmlScope (
 
     // Scope Op is one byte
     Object->DataSize = ChildObject->DataSize + 1;
-    Object->Data = AllocatePool (Object->DataSize);
+    Object->Data = InternalAmlAllocateData (Object, Object->DataSize);
     if (Object->Data == NULL) {
       Status = EFI_OUT_OF_RESOURCES;
       DEBUG ((DEBUG_ERROR, "%a: ERROR: allocate Object->Data for %a\n", __FUNCTION__, String));
@@ -211,7 +211,7 @@ AmlName (
       goto Done;
     }
 
-    Object->Data = AllocatePool (ChildObject->DataSize + 1);
+    Object->Data = InternalAmlAllocateData (Object, ChildObject->DataSize + 1);
     // Name Op is one byte
     Object->DataSize = ChildObject->DataSize + 1;
     if (Object->Data == NULL) {
@@ -319,7 +319,7 @@ AmlOPAlias (
     goto Done;
   }
 
-  Object->Data = AllocateZeroPool (ChildObject->DataSize + 1);
+  Object->Data = InternalAmlAllocateZeroData (Object, ChildObject->DataSize + 1);
   // Alias Op is one byte
   Object->DataSize = ChildObject->DataSize + 1;
   if (Object->Data == NULL) {
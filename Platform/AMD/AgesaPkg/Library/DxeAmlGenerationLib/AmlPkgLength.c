@@ -27,6 +27,10 @@
   PkgLengthEncoding. Similar to AmlPkgLength but the PkgLength does not
   include the length of its own encoding.
 
+  The buffer is allocated from Object's arena, or from pool when Object has
+  no arena.
+
+  @param[in]   Object    - Object the encoding buffer is allocated for
   @param[in]   DataSize  - The size of data to be encoded as a pkglength
   @param[out]  PkgLengthEncoding  - Return buffer containing the AML encoding
   @param[out]  ReturnDataLength  - Size of the return buffer
@@ -37,6 +41,7 @@
 EFI_STATUS
 EFIAPI
 InternalAmlBitPkgLength (
+  IN   AML_OBJECT_INSTANCE *Object,
   IN   UINT32        DataSize,
   OUT  UINT8         **PkgLengthEncoding,
   OUT  UINTN         *ReturnDataLength
@@ -80,7 +85,7 @@ InternalAmlBitPkgLength (
 
     // Allocate new data buffer
     //DataSize = DataLength + DataSize;
-    *PkgLengthEncoding = AllocatePool (DataLength);
+    *PkgLengthEncoding = InternalAmlAllocateData (Object, DataLength);
     if (*PkgLengthEncoding == NULL) {
       Status = EFI_OUT_OF_RESOURCES;
       DEBUG ((DEBUG_ERROR, "%a: ERROR: allocation failed Object=PkgLength\n", __FUNCTION__));
@@ -96,6 +101,7 @@ InternalAmlBitPkgLength (
       CopyMem(&PkgLengthEncoding[0][1], &PkgLengthRemainder, DataLength - 1);
     }
     *ReturnDataLength = DataLength;
+    Status = EFI_SUCCESS;
 
   Done:
   return Status;
@@ -139,8 +145,8 @@ AmlPkgLength (
 {
   EFI_STATUS          Status;
   AML_OBJECT_INSTANCE *Object;
-  AML_OBJECT_INSTANCE *ChildObject;
   UINTN               ChildCount;
+  UINTN               ChildDataSize;
   UINTN               DataLength;
   UINT8               PkgLeadByte;
   UINTN               PkgLengthRemainder;
@@ -151,7 +157,6 @@ AmlPkgLength (
 
   Status = EFI_DEVICE_ERROR;
   Object = NULL;
-  ChildObject = NULL;
 
   switch (Phase) {
   case AmlStart:
@@ -171,16 +176,17 @@ AmlPkgLength (
     // Get rid of original Identifier data
     InternalFreeAmlObjectData (Object);
 
-    // Collect child data and delete children
-    Status = InternalAmlCollapseAndReleaseChildren (
-                    &ChildObject,
-                    &ChildCount,
+    // Size child data first, so the PkgLength encoding and the child data
+    // can be emitted into a single buffer
+    Status = InternalAmlSizeChildren (
                     &Object->Link,
-                    ListHead
+                    ListHead,
+                    &ChildDataSize,
+                    &ChildCount
                     );
     if (EFI_ERROR (Status) ||
-        ChildObject->Data == NULL ||
-        ChildObject->DataSize == 0) {
+        ChildDataSize == 0) {
+      Status = EFI_DEVICE_ERROR;
       DEBUG ((DEBUG_ERROR, "%a: ERROR: %a has no child data.\n", __FUNCTION__, "Length"));
       goto Done;
     }
@@ -188,21 +194,21 @@ AmlPkgLength (
     DataLength = 0;
     // Calculate Length of PkgLength Data and fill out least
     // significant nibble
-    if ((ChildObject->DataSize + 1) <= MAX_ONE_BYTE_PKG_LENGTH) {
+    if ((ChildDataSize + 1) <= MAX_ONE_BYTE_PKG_LENGTH) {
       DataLength = 1;
       PkgLeadByte = ONE_BYTE_PKG_LENGTH_ENCODING;
-      PkgLeadByte |= ((ChildObject->DataSize + DataLength) & ONE_BYTE_NIBBLE_MASK);
+      PkgLeadByte |= ((ChildDataSize + DataLength) & ONE_BYTE_NIBBLE_MASK);
 
     } else {
-      if ((ChildObject->DataSize + 2) <= MAX_TWO_BYTE_PKG_LENGTH) {
+      if ((ChildDataSize + 2) <= MAX_TWO_BYTE_PKG_LENGTH) {
         DataLength = 2;
         PkgLeadByte = TWO_BYTE_PKG_LENGTH_ENCODING;
 
-      } else if ((ChildObject->DataSize + 3) <= MAX_THREE_BYTE_PKG_LENGTH) {
+      } else if ((ChildDataSize + 3) <= MAX_THREE_BYTE_PKG_LENGTH) {
         DataLength = 3;
         PkgLeadByte = THREE_BYTE_PKG_LENGTH_ENCODING;
 
-      } else if ((ChildObject->DataSize + 4) <= MAX_FOUR_BYTE_PKG_LENGTH) {
+      } else if ((ChildDataSize + 4) <= MAX_FOUR_BYTE_PKG_LENGTH) {
         DataLength = 4;
         PkgLeadByte = FOUR_BYTE_PKG_LENGTH_ENCODING;
 
@@ -212,12 +218,12 @@ AmlPkgLength (
               __FUNCTION__, MAX_FOUR_BYTE_PKG_LENGTH - 4));
         goto Done;
       }
-      PkgLeadByte |= ((ChildObject->DataSize + DataLength) & PKG_LENGTH_NIBBLE_MASK);
+      PkgLeadByte |= ((ChildDataSize + DataLength) & PKG_LENGTH_NIBBLE_MASK);
     }
 
     // Allocate new data buffer
-    Object->DataSize = DataLength + ChildObject->DataSize;
-    Object->Data = AllocatePool (Object->DataSize);
+    Object->DataSize = DataLength + ChildDataSize;
+    Object->Data = InternalAmlAllocateData (Object, Object->DataSize);
     if (Object->Data == NULL) {
       Status = EFI_OUT_OF_RESOURCES;
       DEBUG ((DEBUG_ERROR, "%a: ERROR: allocation failed Object=PkgLength\n", __FUNCTION__));
@@ -228,16 +234,22 @@ AmlPkgLength (
     Object->Data[0] = PkgLeadByte;
 
     // Populate remainder of PkgLength bytes
-    PkgLengthRemainder = (ChildObject->DataSize + DataLength) >> 4;
+    PkgLengthRemainder = (ChildDataSize + DataLength) >> 4;
     if (PkgLengthRemainder != 0) {
       CopyMem(&Object->Data[1], &PkgLengthRemainder, DataLength - 1);
     }
 
-    CopyMem (&Object->Data[DataLength],
-             ChildObject->Data,
-             ChildObject->DataSize);
+    // Emit child data right after the encoding and delete children
+    Status = InternalAmlEmitAndReleaseChildren (
+                    &Object->Link,
+                    ListHead,
+                    &Object->Data[DataLength]
+                    );
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a: ERROR: %a child data collection.\n", __FUNCTION__, "Length"));
+      goto Done;
+    }
 
-    InternalFreeAmlObject (&ChildObject, ListHead);
     Object->Completed = TRUE;
     Status = EFI_SUCCESS;
     break;
@@ -250,7 +262,6 @@ AmlPkgLength (
   Done:
   if (EFI_ERROR (Status)) {
     InternalFreeAmlObject (&Object, ListHead);
-    InternalFreeAmlObject (&ChildObject, ListHead);
   }
   return Status;
 }
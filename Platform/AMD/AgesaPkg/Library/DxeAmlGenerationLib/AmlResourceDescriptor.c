@@ -87,7 +87,7 @@ AmlResourceTemplate (
       }
 
       Object->DataSize = ChildObject->DataSize + sizeof (EFI_ACPI_END_TAG_DESCRIPTOR);
-      Object->Data     = AllocateZeroPool (Object->DataSize);
+      Object->Data     = InternalAmlAllocateZeroData (Object, Object->DataSize);
       if (Object->Data == NULL) {
         DEBUG ((DEBUG_ERROR, "%a: ERROR: EndTag Alloc Failed\n", __FUNCTION__));
         Status = EFI_OUT_OF_RESOURCES;
@@ -364,7 +364,7 @@ InternalAmlOPDWordAddressSpace (
   }
 
   Object->DataSize = sizeof (EFI_ACPI_DWORD_ADDRESS_SPACE_DESCRIPTOR);
-  Object->Data     = AllocateZeroPool (Object->DataSize);
+  Object->Data     = InternalAmlAllocateZeroData (Object, Object->DataSize);
   if (Object->Data == NULL) {
     DEBUG ((DEBUG_ERROR, "%a: ERROR: %a Alloc Failed\n", __FUNCTION__, "DWORD_ADDRESS"));
     Status = EFI_OUT_OF_RESOURCES;
@@ -461,7 +461,7 @@ AmlOPDma (
   }
 
   Object->DataSize = sizeof (EFI_ACPI_DMA_DESCRIPTOR);
-  Object->Data     = AllocateZeroPool (Object->DataSize);
+  Object->Data     = InternalAmlAllocateZeroData (Object, Object->DataSize);
   if (Object->Data == NULL) {
     DEBUG ((DEBUG_ERROR, "%a: ERROR: %a Alloc Failed\n", __FUNCTION__, "DMA_RESOURCE"));
     Status = EFI_OUT_OF_RESOURCES;
@@ -840,7 +840,7 @@ InternalAmlOPQWordAddressSpace (
   }
 
   Object->DataSize = sizeof (EFI_ACPI_QWORD_ADDRESS_SPACE_DESCRIPTOR);
-  Object->Data     = AllocateZeroPool (Object->DataSize);
+  Object->Data     = InternalAmlAllocateZeroData (Object, Object->DataSize);
   if (Object->Data == NULL) {
     DEBUG ((DEBUG_ERROR, "%a: ERROR: %a Alloc Failed\n", __FUNCTION__, "QWORD_ADDRESS"));
     Status = EFI_OUT_OF_RESOURCES;
@@ -977,7 +977,7 @@ AmlOPIRQ (
   }
 
   Object->DataSize = sizeof (EFI_ACPI_IRQ_DESCRIPTOR);
-  Object->Data     = AllocateZeroPool (Object->DataSize);
+  Object->Data     = InternalAmlAllocateZeroData (Object, Object->DataSize);
   if (Object->Data == NULL) {
     DEBUG ((DEBUG_ERROR, "%a: ERROR: Alloc for %a failed\n", __FUNCTION__, "IRQ_RESOURCE"));
     Status = EFI_OUT_OF_RESOURCES;
@@ -1148,7 +1148,7 @@ AmlOPIO (
   }
 
   Object->DataSize = sizeof (EFI_ACPI_IO_PORT_DESCRIPTOR);
-  Object->Data     = AllocateZeroPool (Object->DataSize);
+  Object->Data     = InternalAmlAllocateZeroData (Object, Object->DataSize);
   if (Object->Data == NULL) {
     DEBUG ((DEBUG_ERROR, "%a: ERROR: %a Alloc Failed\n", __FUNCTION__, "IO_RESOURCE"));
     Status = EFI_OUT_OF_RESOURCES;
@@ -1251,7 +1251,7 @@ AmlOPRegister (
   }
 
   Object->DataSize = sizeof (EFI_ACPI_GENERIC_REGISTER_DESCRIPTOR);
-  Object->Data     = AllocateZeroPool (Object->DataSize);
+  Object->Data     = InternalAmlAllocateZeroData (Object, Object->DataSize);
   if (Object->Data == NULL) {
     DEBUG ((DEBUG_ERROR, "%a: ERROR: %a Alloc Failed\n", __FUNCTION__, "IO_RESOURCE"));
     Status = EFI_OUT_OF_RESOURCES;
@@ -1438,7 +1438,7 @@ AmlOPMemory32Fixed (
   }
 
   Object->DataSize = sizeof (EFI_ACPI_32_BIT_FIXED_MEMORY_RANGE_DESCRIPTOR);
-  Object->Data     = AllocateZeroPool (Object->DataSize);
+  Object->Data     = InternalAmlAllocateZeroData (Object, Object->DataSize);
   if (Object->Data == NULL) {
     DEBUG ((DEBUG_ERROR, "%a: ERROR: %a Alloc Failed\n", __FUNCTION__, "MEMORY_32_FIXED_RESOURCE"));
     Status = EFI_OUT_OF_RESOURCES;
@@ -1724,7 +1724,7 @@ InternalAmlOPWordAddressSpace (
   }
 
   Object->DataSize = sizeof (EFI_ACPI_WORD_ADDRESS_SPACE_DESCRIPTOR);
-  Object->Data     = AllocateZeroPool (Object->DataSize);
+  Object->Data     = InternalAmlAllocateZeroData (Object, Object->DataSize);
   if (Object->Data == NULL) {
     DEBUG ((DEBUG_ERROR, "%a: ERROR: %a Alloc Failed\n", __FUNCTION__, "DWORD_ADDRESS"));
     Status = EFI_OUT_OF_RESOURCES;
@@ -121,7 +121,7 @@ AmlElse (
       }
 
       // Allocate buffer for Return object
-      Object->Data     = AllocatePool (ChildObject->DataSize + 1);
+      Object->Data     = InternalAmlAllocateData (Object, ChildObject->DataSize + 1);
       Object->DataSize = ChildObject->DataSize + 1;
       if (Object->Data == NULL) {
         Status = EFI_OUT_OF_RESOURCES;
@@ -269,7 +269,7 @@ AmlIf (
       }
 
       // Allocate buffer for Return object
-      Object->Data     = AllocatePool (ChildObject->DataSize + 1);
+      Object->Data     = InternalAmlAllocateData (Object, ChildObject->DataSize + 1);
       Object->DataSize = ChildObject->DataSize + 1;
       if (Object->Data == NULL) {
         Status = EFI_OUT_OF_RESOURCES;
@@ -370,7 +370,7 @@ AmlOPNotify (
   }
 
   // Allocate buffer for Return object
-  Object->Data     = AllocatePool (ChildObject->DataSize + 1);
+  Object->Data     = InternalAmlAllocateData (Object, ChildObject->DataSize + 1);
   Object->DataSize = ChildObject->DataSize + 1;
   if (Object->Data == NULL) {
     Status = EFI_OUT_OF_RESOURCES;
@@ -466,7 +466,7 @@ AmlReturn (
       if ((ChildObject->Data == NULL) || (ChildObject->DataSize == 0)) {
         // Return without arguments is treated like Return(0)
         // Zeroed byte = ZeroOp
-        ChildObject->Data = AllocateZeroPool (sizeof (UINT8));
+        ChildObject->Data = InternalAmlAllocateZeroData (ChildObject, sizeof (UINT8));
         if (ChildObject->Data == NULL) {
           Status = EFI_OUT_OF_RESOURCES;
           DEBUG ((DEBUG_ERROR, "%a: ERROR: allocate Zero Child for Return\n", __FUNCTION__));
@@ -477,7 +477,7 @@ AmlReturn (
       }
 
       // Allocate buffer for Return object
-      Object->Data     = AllocatePool (ChildObject->DataSize + 1);
+      Object->Data     = InternalAmlAllocateData (Object, ChildObject->DataSize + 1);
       Object->DataSize = ChildObject->DataSize + 1;
       if (Object->Data == NULL) {
         Status = EFI_OUT_OF_RESOURCES;
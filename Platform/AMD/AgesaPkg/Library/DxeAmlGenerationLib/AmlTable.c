@@ -69,8 +69,8 @@ AmlDefinitionBlock (
 {
   EFI_STATUS          Status;
   AML_OBJECT_INSTANCE *Object;
-  AML_OBJECT_INSTANCE *ChildObject;
   UINTN               ChildCount;
+  UINTN               ChildDataSize;
 
   if (Phase >= AmlInvalid ||
       ListHead == NULL ||
@@ -87,7 +87,6 @@ AmlDefinitionBlock (
 
   Status = EFI_DEVICE_ERROR;
   Object = NULL;
-  ChildObject = NULL;
 
   switch (Phase)
   {
@@ -107,22 +106,23 @@ AmlDefinitionBlock (
     // Get rid of original Identifier data
     InternalFreeAmlObjectData (Object);
 
-    // Collect child data and delete children
-    Status = InternalAmlCollapseAndReleaseChildren (
-                    &ChildObject,
-                    &ChildCount,
+    // Size child data first, so the table header and the child data can be
+    // emitted into a single buffer
+    Status = InternalAmlSizeChildren (
                     &Object->Link,
-                    ListHead
+                    ListHead,
+                    &ChildDataSize,
+                    &ChildCount
                     );
     if (EFI_ERROR (Status) ||
-        ChildObject->Data == NULL ||
-        ChildObject->DataSize == 0) {
+        ChildDataSize == 0) {
+      Status = EFI_DEVICE_ERROR;
       DEBUG ((DEBUG_ERROR, "%a: ERROR: %a has no child data.\n", __FUNCTION__, TableNameString));
       goto Done;
     }
 
-    Object->DataSize = ChildObject->DataSize + sizeof(EFI_ACPI_DESCRIPTION_HEADER);
-    Object->Data = AllocateZeroPool (Object->DataSize);
+    Object->DataSize = ChildDataSize + sizeof(EFI_ACPI_DESCRIPTION_HEADER);
+    Object->Data = InternalAmlAllocateZeroData (Object, Object->DataSize);
     if (Object->Data == NULL) {
       Status = EFI_OUT_OF_RESOURCES;
       DEBUG ((DEBUG_ERROR, "%a: ERROR: allocate Object->Data for %a\n", __FUNCTION__, TableNameString));
@@ -168,13 +168,18 @@ AmlDefinitionBlock (
             (UINT8*)&CreatorRevision,
             sizeof(UINT32));
 
-    // Copy rest of data into Object
-    CopyMem (&Object->Data[sizeof(EFI_ACPI_DESCRIPTION_HEADER)],
-             ChildObject->Data,
-             ChildObject->DataSize);
+    // Emit rest of data into Object and delete children
+    Status = InternalAmlEmitAndReleaseChildren (
+                    &Object->Link,
+                    ListHead,
+                    &Object->Data[sizeof(EFI_ACPI_DESCRIPTION_HEADER)]
+                    );
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a: ERROR: %a child data collection.\n", __FUNCTION__, TableNameString));
+      goto Done;
+    }
 
     // Checksum Set on Table Install
-    InternalFreeAmlObject (&ChildObject, ListHead);
     Object->Completed = TRUE;
     Status = EFI_SUCCESS;
     break;
@@ -187,7 +192,6 @@ AmlDefinitionBlock (
   Done:
   if (EFI_ERROR (Status)) {
     InternalFreeAmlObject (&Object, ListHead);
-    InternalFreeAmlObject (&ChildObject, ListHead);
   }
   return Status;
 }
@@ -42,6 +42,7 @@
 
   Not a public function so no doxygen comment identifiers.
 
+  @param[in]    Object          - Object the buffer is for
   @param[in]    Integer         - Integer value to encode
   @param[out]   ReturnData      - Allocated DataBuffer with encoded integer
   @param[out]   ReturnDataSize  - Size of ReturnData
@@ -52,6 +53,7 @@
 EFI_STATUS
 EFIAPI
 InternalAmlDataIntegerBuffer (
+  IN      AML_OBJECT_INSTANCE *Object,
   IN      UINT64      Integer,
   OUT     VOID       **ReturnData,
   OUT     UINTN       *ReturnDataSize
@@ -62,6 +64,7 @@ InternalAmlDataIntegerBuffer (
   PkgLengthEncoding. Similar to AmlPkgLength but the PkgLength does not
   include the length of its own encoding.
 
+  @param[in]   Object    - Object the encoding buffer is allocated for
   @param[in]   DataSize  - The size of data to be encoded as a pkglength
   @param[out]  PkgLengthEncoding  - Return buffer containing the AML encoding
   @param[out]  ReturnDataLength  - Size of the return buffer
@@ -72,6 +75,7 @@ InternalAmlDataIntegerBuffer (
 EFI_STATUS
 EFIAPI
 InternalAmlBitPkgLength (
+  IN   AML_OBJECT_INSTANCE *Object,
   IN   UINT32        DataSize,
   OUT  UINT8         **PkgLengthEncoding,
   OUT  UINTN         *ReturnDataLength
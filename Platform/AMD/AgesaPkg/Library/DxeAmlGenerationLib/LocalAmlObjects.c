@@ -30,7 +30,7 @@ InternalFreeAmlObjectData (
   }
 
   if (Object->Data != NULL) {
-    FreePool (Object->Data);
+    InternalAmlFreeData (Object, Object->Data);
     Object->Data = NULL;
     Object->DataSize = 0;
     Object->Completed = FALSE;
@@ -67,10 +67,14 @@ InternalFreeAmlObject (
   Object = *FreeObject;
   if (Object != NULL) {
     InternalFreeAmlObjectData (Object);
-    if (IsNodeInList (ListHead, &Object->Link)) {
+    // Objects that are not on a list are self-linked, which avoids walking
+    // the whole (possibly very long) list to find out
+    if (!IsListEmpty (&Object->Link)) {
       RemoveEntryList (&Object->Link);
     }
-    FreePool (Object);
+    if (AML_OBJECT_NODE_FROM_OBJECT (Object)->Arena == NULL) {
+      FreePool (AML_OBJECT_NODE_FROM_OBJECT (Object));
+    }
   }
   *FreeObject = NULL;
   return EFI_SUCCESS;
@@ -80,9 +84,11 @@ InternalFreeAmlObject (
   Creates a new AML_OBJECT_INSTANCE.  Object->Data will be NULL and
   Object->DataSize will be 0
 
-  Allocates AML_OBJECT_INSTANCE which must be freed by caller
+  Allocates AML_OBJECT_INSTANCE which must be freed by caller.  The Object is
+  allocated from the arena of ListHead when it has one.
 
   @param [out]    ReturnObject  - Pointer to an Object
+  @param [in]     ListHead      - Head of AML Object linked list the Object is for
 
   @return         EFI_SUCCESS   - Object created and appended to linked list
   @return         <all others>  - Object creation failed, Object = NULL
@@ -90,9 +96,12 @@ InternalFreeAmlObject (
 EFI_STATUS
 EFIAPI
 InternalNewAmlObjectNoData (
-     OUT  AML_OBJECT_INSTANCE **ReturnObject
+     OUT  AML_OBJECT_INSTANCE **ReturnObject,
+  IN      LIST_ENTRY          *ListHead
 )
 {
+  AML_ARENA           *Arena;
+  AML_OBJECT_NODE     *Node;
   AML_OBJECT_INSTANCE *Object;
 
   if (ReturnObject == NULL) {
@@ -100,15 +109,26 @@ InternalNewAmlObjectNoData (
   }
   *ReturnObject = NULL;
 
-  // Allocate AML Object
-  Object = AllocateZeroPool (sizeof (AML_OBJECT_INSTANCE));
-  if (Object == NULL) {
+  // Allocate AML Object, from the table's arena if it has one
+  Arena = InternalAmlGetArena (ListHead);
+  if (Arena == NULL) {
+    Node = AllocateZeroPool (sizeof (AML_OBJECT_NODE));
+  } else {
+    Node = InternalAmlArenaAllocate (Arena, sizeof (AML_OBJECT_NODE));
+    if (Node != NULL) {
+      ZeroMem (Node, sizeof (AML_OBJECT_NODE));
+    }
+  }
+  if (Node == NULL) {
     DEBUG ((DEBUG_ERROR, "%a: ERROR: Allocate Object Failed\n", __FUNCTION__));
     return EFI_OUT_OF_RESOURCES;
   }
+  Node->Arena = Arena;
+  Object = &Node->Object;
   Object->DataSize = 0;
   Object->Data = NULL;
   Object->Signature = AML_OBJECT_INSTANCE_SIGNATURE;
+  InitializeListHead (&Object->Link);
 
   *ReturnObject = Object;
   return EFI_SUCCESS;
@@ -140,7 +160,7 @@ InternalAppendNewAmlObjectNoData (
     return EFI_INVALID_PARAMETER;
   }
 
-  Status = InternalNewAmlObjectNoData(&Object);
+  Status = InternalNewAmlObjectNoData(&Object, ListHead);
   if (!EFI_ERROR (Status)) {
     InsertTailList (ListHead, &Object->Link);
     *ReturnObject = Object;
@@ -185,7 +205,7 @@ InternalAppendNewAmlObject (
   }
   // Allocate Identifier Data + NULL termination
   Object->DataSize = AsciiStrLen (Identifier) + 1;
-  Object->Data = AllocatePool (Object->DataSize);
+  Object->Data = InternalAmlAllocateData (Object, Object->DataSize);
   if (Object->Data == NULL) {
     DEBUG ((DEBUG_ERROR, "%a: ERROR: Allocate Data Identifier=%a\n", __FUNCTION__, Identifier));
     InternalFreeAmlObject (&Object, ListHead);
@@ -257,10 +277,101 @@ InternalAmlLocateObjectByIdentifier (
   return EFI_NOT_FOUND;
 }
 
+/**
+  Computes the total data size of all children of the Link.  This is the first
+  pass of collapsing children: it lets the caller allocate the final buffer,
+  including any header that depends on the size (e.g. a PkgLength), only once.
+
+  @param [in]     Link          - Linked List Object entry whose children are sized
+  @param [in]     ListHead      - Head of Object Linked List
+  @param [out]    DataSize      - Sum of the DataSize of all child Objects
+  @param [out]    ChildCount    - Count of Child Objects
+
+  @return         EFI_SUCCESS   - Children sized
+  @return         <all others>  - Sizing failed
+**/
+EFI_STATUS
+EFIAPI
+InternalAmlSizeChildren (
+  IN      LIST_ENTRY          *Link,
+  IN      LIST_ENTRY          *ListHead,
+     OUT  UINTN               *DataSize,
+     OUT  UINTN               *ChildCount
+)
+{
+  LIST_ENTRY          *Node;
+  AML_OBJECT_INSTANCE *ChildObject;
+
+  if (Link == NULL ||
+      ListHead == NULL ||
+      DataSize == NULL ||
+      ChildCount == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  *DataSize = 0;
+  *ChildCount = 0;
+
+  Node = GetNextNode (ListHead, Link);
+  while (Node != ListHead) {
+    ChildObject = AML_OBJECT_INSTANCE_FROM_LINK (Node);
+    *DataSize += ChildObject->DataSize;
+    *ChildCount = *ChildCount + 1;
+    Node = GetNextNode (ListHead, Node);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Copies the data of all children of the Link, in order, into Buffer and frees
+  the children.  This is the second pass of collapsing children; Buffer must be
+  at least as large as the size returned by InternalAmlSizeChildren.
+
+  @param [in]     Link          - Linked List Object entry whose children are emitted
+  @param [in,out] ListHead      - Head of Object Linked List
+  @param [out]    Buffer        - Buffer receiving the child data
+
+  @return         EFI_SUCCESS   - Children emitted and freed
+  @return         <all others>  - Emission failed
+**/
+EFI_STATUS
+EFIAPI
+InternalAmlEmitAndReleaseChildren (
+  IN      LIST_ENTRY          *Link,
+  IN OUT  LIST_ENTRY          *ListHead,
+     OUT  UINT8               *Buffer
+)
+{
+  LIST_ENTRY          *Node;
+  AML_OBJECT_INSTANCE *ChildObject;
+
+  if (Link == NULL || ListHead == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Node = GetNextNode (ListHead, Link);
+  while (Node != ListHead) {
+    ChildObject = AML_OBJECT_INSTANCE_FROM_LINK (Node);
+    if (ChildObject->DataSize != 0) {
+      CopyMem (Buffer, ChildObject->Data, ChildObject->DataSize);
+      Buffer += ChildObject->DataSize;
+    }
+    // Get Next ChildObject Node, then free ChildObject from list
+    Node = GetNextNode (ListHead, Node);
+    InternalFreeAmlObject (&ChildObject, ListHead);
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Finds all children of the Link and appends them into a single ObjectData
   buffer of ObjectDataSize
 
+  The children are sized first so that the buffer is allocated exactly once,
+  and a single child simply hands its buffer over.
+
   Allocates AML_OBJECT_INSTANCE and Data which must be freed by caller
 
   @param [out]    ReturnObject  - Pointer to an Object pointer
@@ -281,9 +392,9 @@ InternalAmlCollapseAndReleaseChildren (
 )
 {
   EFI_STATUS          Status;
-  LIST_ENTRY          *Node;
   AML_OBJECT_INSTANCE *Object;
   AML_OBJECT_INSTANCE *ChildObject;
+  UINTN               DataSize;
 
   Status = EFI_SUCCESS;
   if (ReturnObject == NULL ||
@@ -294,36 +405,40 @@ InternalAmlCollapseAndReleaseChildren (
   }
   *ChildCount = 0;
 
-  Status = InternalNewAmlObjectNoData(&Object);
+  Status = InternalNewAmlObjectNoData(&Object, ListHead);
   if (EFI_ERROR(Status)) {
     DEBUG ((DEBUG_ERROR, "%a: ERROR: allocating Object Data\n", __FUNCTION__));
     goto Done;
   }
 
-  // Get first Child Node
-  Node = GetNextNode(ListHead, Link);
-  while (Node != ListHead) {
-    ChildObject = AML_OBJECT_INSTANCE_FROM_LINK (Node);
-    // Expand data buffer to fit existing data + new data
-    Object->Data = ReallocatePool (Object->DataSize,
-                                   Object->DataSize + ChildObject->DataSize,
-                                   Object->Data);
-    if (Object->Data == NULL) {
-      Status = EFI_OUT_OF_RESOURCES;
-      DEBUG ((DEBUG_ERROR, "%a: ERROR: reallocating Object Data\n", __FUNCTION__));
-      goto Done;
-    }
-    // Copy new data at end of buffer
-    CopyMem (&Object->Data[Object->DataSize],
-             ChildObject->Data,
-             ChildObject->DataSize);
-    Object->DataSize += ChildObject->DataSize;
-    // Get Next ChildObject Node, then free ChildObject from list
-    Node = GetNextNode (ListHead, Node);
+  Status = InternalAmlSizeChildren (Link, ListHead, &DataSize, ChildCount);
+  if (EFI_ERROR (Status) || DataSize == 0) {
+    // Nothing to collect, leave the Object without Data
+    InternalAmlEmitAndReleaseChildren (Link, ListHead, NULL);
+    goto Done;
+  }
+
+  if (*ChildCount == 1) {
+    // Take over the only child's buffer instead of copying it
+    ChildObject = AML_OBJECT_INSTANCE_FROM_LINK (GetNextNode (ListHead, Link));
+    Object->Data = ChildObject->Data;
+    Object->DataSize = ChildObject->DataSize;
+    ChildObject->Data = NULL;
+    ChildObject->DataSize = 0;
     InternalFreeAmlObject (&ChildObject, ListHead);
-    *ChildCount = *ChildCount + 1;
+    goto Done;
   }
 
+  Object->Data = InternalAmlAllocateData (Object, DataSize);
+  if (Object->Data == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    DEBUG ((DEBUG_ERROR, "%a: ERROR: allocating Object Data\n", __FUNCTION__));
+    goto Done;
+  }
+  Object->DataSize = DataSize;
+
+  Status = InternalAmlEmitAndReleaseChildren (Link, ListHead, Object->Data);
+
   Done:
   if (EFI_ERROR (Status)) {
     InternalFreeAmlObject (&Object, ListHead);
@@ -11,6 +11,213 @@
 
 //#include "LocalAmlLib.h"
 
+// Size of the chunks an AML_ARENA grows by
+#define AML_ARENA_CHUNK_SIZE        SIZE_64KB
+
+typedef struct {
+  LIST_ENTRY    Link;
+  UINTN         Size;           // Usable bytes following the header
+  UINTN         Used;           // Bytes handed out so far
+  UINT8         *Last;          // Most recent allocation, may be given back
+} AML_ARENA_CHUNK;
+
+#define AML_ARENA_CHUNK_FROM_LINK(_link) \
+  BASE_CR (_link, AML_ARENA_CHUNK, Link)
+#define AML_ARENA_CHUNK_DATA(_chunk)  ((UINT8 *)((_chunk) + 1))
+
+typedef struct {
+  LIST_ENTRY    Chunks;         // Chunk being filled is first
+} AML_ARENA;
+
+// Objects are allocated with a hidden header recording the arena they, and
+// their Data, come from.  Arena is NULL for pool allocated Objects.
+typedef struct {
+  AML_ARENA             *Arena;
+  AML_OBJECT_INSTANCE   Object;
+} AML_OBJECT_NODE;
+
+#define AML_OBJECT_NODE_FROM_OBJECT(_object) \
+  BASE_CR (_object, AML_OBJECT_NODE, Object)
+
+#define AML_TABLE_LIST_SIGNATURE    SIGNATURE_32 ('a', 'm', 'l', 't')
+
+// Table list allocated by AmlInitializeTableList, ListHead is handed out
+typedef struct {
+  UINT32        Signature;
+  LIST_ENTRY    ListHead;
+  AML_ARENA     Arena;
+  LIST_ENTRY    Link;
+} AML_TABLE_LIST;
+
+#define AML_TABLE_LIST_FROM_LINK(_link) \
+  CR (_link, AML_TABLE_LIST, Link, AML_TABLE_LIST_SIGNATURE)
+
+/**
+  Allocates a buffer from the arena
+
+  @param [in,out] Arena       - Arena to allocate from
+  @param [in]     Size        - Size of the buffer
+
+  @return         Pointer to the buffer, or NULL if out of resources
+**/
+VOID *
+EFIAPI
+InternalAmlArenaAllocate (
+  IN OUT  AML_ARENA   *Arena,
+  IN      UINTN       Size
+);
+
+/**
+  Frees a buffer allocated from the arena
+
+  Only the most recent allocation of a chunk is actually given back, anything
+  else is reclaimed when the whole arena is freed.
+
+  @param [in,out] Arena       - Arena the buffer was allocated from
+  @param [in]     Buffer      - Buffer to free
+**/
+VOID
+EFIAPI
+InternalAmlArenaFree (
+  IN OUT  AML_ARENA   *Arena,
+  IN      VOID        *Buffer
+);
+
+/**
+  Resizes a buffer allocated from the arena, growing it in place when it is
+  the most recent allocation
+
+  @param [in,out] Arena       - Arena the buffer was allocated from
+  @param [in]     OldSize     - Current size of Buffer
+  @param [in]     NewSize     - Requested size
+  @param [in]     Buffer      - Buffer to resize, may be NULL
+
+  @return         Pointer to the resized buffer, or NULL if out of resources
+**/
+VOID *
+EFIAPI
+InternalAmlArenaReallocate (
+  IN OUT  AML_ARENA   *Arena,
+  IN      UINTN       OldSize,
+  IN      UINTN       NewSize,
+  IN      VOID        *Buffer
+);
+
+/**
+  Finds the arena owned by a table list
+
+  @param [in]     ListHead    - Head of AML Object linked list
+
+  @return         Pointer to the arena, or NULL if ListHead was not created
+                  by AmlInitializeTableList
+**/
+AML_ARENA *
+EFIAPI
+InternalAmlGetArena (
+  IN      LIST_ENTRY  *ListHead
+);
+
+/**
+  Allocates a table list along with its arena
+
+  @return         Pointer to the table list, or NULL if out of resources
+**/
+AML_TABLE_LIST *
+EFIAPI
+InternalAmlNewTableList (
+  VOID
+);
+
+/**
+  Finds the table list that owns ListHead
+
+  @param [in]     ListHead    - Head of AML Object linked list
+
+  @return         Pointer to the table list, or NULL if ListHead was not
+                  created by AmlInitializeTableList
+**/
+AML_TABLE_LIST *
+EFIAPI
+InternalAmlGetTableList (
+  IN      LIST_ENTRY  *ListHead
+);
+
+/**
+  Frees a table list, its arena and with it every Object and Data buffer that
+  was allocated for the table
+
+  @param [in]     TableList   - Table list to free
+**/
+VOID
+EFIAPI
+InternalAmlFreeTableList (
+  IN      AML_TABLE_LIST  *TableList
+);
+
+/**
+  Allocates a buffer for an Object's Data, from the Object's arena when it has
+  one, else from pool
+
+  @param [in]     Object      - Object the buffer is for
+  @param [in]     Size        - Size of the buffer
+
+  @return         Pointer to the buffer, or NULL if out of resources
+**/
+VOID *
+EFIAPI
+InternalAmlAllocateData (
+  IN      AML_OBJECT_INSTANCE *Object,
+  IN      UINTN               Size
+);
+
+/**
+  Allocates a zeroed buffer for an Object's Data, from the Object's arena when
+  it has one, else from pool
+
+  @param [in]     Object      - Object the buffer is for
+  @param [in]     Size        - Size of the buffer
+
+  @return         Pointer to the buffer, or NULL if out of resources
+**/
+VOID *
+EFIAPI
+InternalAmlAllocateZeroData (
+  IN      AML_OBJECT_INSTANCE *Object,
+  IN      UINTN               Size
+);
+
+/**
+  Resizes an Object's Data buffer, like ReallocatePool
+
+  @param [in]     Object      - Object the buffer belongs to
+  @param [in]     OldSize     - Current size of Buffer
+  @param [in]     NewSize     - Requested size
+  @param [in]     Buffer      - Buffer to resize, may be NULL
+
+  @return         Pointer to the resized buffer, or NULL if out of resources
+**/
+VOID *
+EFIAPI
+InternalAmlReallocateData (
+  IN      AML_OBJECT_INSTANCE *Object,
+  IN      UINTN               OldSize,
+  IN      UINTN               NewSize,
+  IN      VOID                *Buffer
+);
+
+/**
+  Frees an Object's Data buffer
+
+  @param [in]     Object      - Object the buffer belongs to
+  @param [in]     Buffer      - Buffer to free
+**/
+VOID
+EFIAPI
+InternalAmlFreeData (
+  IN      AML_OBJECT_INSTANCE *Object,
+  IN      VOID                *Buffer
+);
+
 /**
   Free Object->Data
 
@@ -52,9 +259,11 @@ InternalFreeAmlObject (
   Creates a new AML_OBJECT_INSTANCE.  Object->Data will be NULL and
   Object->DataSize will be 0
 
-  Allocates AML_OBJECT_INSTANCE which must be freed by caller
+  Allocates AML_OBJECT_INSTANCE which must be freed by caller.  The Object is
+  allocated from the arena of ListHead when it has one.
 
   @param [out]    ReturnObject  - Pointer to an Object
+  @param [in]     ListHead      - Head of AML Object linked list the Object is for
 
   @return         EFI_SUCCESS   - Object created and appended to linked list
   @return         <all others>  - Object creation failed, Object = NULL
@@ -62,7 +271,8 @@ InternalFreeAmlObject (
 EFI_STATUS
 EFIAPI
 InternalNewAmlObjectNoData (
-     OUT  AML_OBJECT_INSTANCE **ReturnObject
+     OUT  AML_OBJECT_INSTANCE **ReturnObject,
+  IN      LIST_ENTRY          *ListHead
 );
 
 /**
@@ -124,6 +334,48 @@ InternalAmlLocateObjectByIdentifier (
   IN      LIST_ENTRY          *ListHead
 );
 
+/**
+  Computes the total data size of all children of the Link.  This is the first
+  pass of collapsing children: it lets the caller allocate the final buffer,
+  including any header that depends on the size (e.g. a PkgLength), only once.
+
+  @param [in]     Link          - Linked List Object entry whose children are sized
+  @param [in]     ListHead      - Head of Object Linked List
+  @param [out]    DataSize      - Sum of the DataSize of all child Objects
+  @param [out]    ChildCount    - Count of Child Objects
+
+  @return         EFI_SUCCESS   - Children sized
+  @return         <all others>  - Sizing failed
+**/
+EFI_STATUS
+EFIAPI
+InternalAmlSizeChildren (
+  IN      LIST_ENTRY          *Link,
+  IN      LIST_ENTRY          *ListHead,
+     OUT  UINTN               *DataSize,
+     OUT  UINTN               *ChildCount
+);
+
+/**
+  Copies the data of all children of the Link, in order, into Buffer and frees
+  the children.  This is the second pass of collapsing children; Buffer must be
+  at least as large as the size returned by InternalAmlSizeChildren.
+
+  @param [in]     Link          - Linked List Object entry whose children are emitted
+  @param [in,out] ListHead      - Head of Object Linked List
+  @param [out]    Buffer        - Buffer receiving the child data
+
+  @return         EFI_SUCCESS   - Children emitted and freed
+  @return         <all others>  - Emission failed
+**/
+EFI_STATUS
+EFIAPI
+InternalAmlEmitAndReleaseChildren (
+  IN      LIST_ENTRY          *Link,
+  IN OUT  LIST_ENTRY          *ListHead,
+     OUT  UINT8               *Buffer
+);
+
 /**
   Finds all children of the Link and appends them into a single ObjectData
   buffer of ObjectDataSize
@@ -8,7 +8,6 @@
 #include "AcpiCommon.h"
 
 #include <Library/AmlLib/AmlLib.h>
-#include <Library/SortLib.h>
 #include <Protocol/MpService.h>
 #include <Register/Intel/Cpuid.h> // for CPUID_EXTENDED_TOPOLOGY
 
@@ -146,59 +145,97 @@ AmdGetProcessorLocation2ByApicId (
 }
 
 /**
-  Callback compare function.
-  Compares CCD number of provided arguments.
+  Sort the processors by socket, then by the CCD order in mCcdOrder.
 
-  @param[in] LocalX2ApicLeft   Pointer to Left Buffer.
-  @param[in] LocalX2ApicRight  Pointer to Right Buffer.
-  @return    0                 If both are same
-             -1                If left value is less than righ value.
-             1                 If left value is greater than righ value.
+  A counting sort over (socket, CCD rank) buckets is used, so the sort is
+  stable and each socket keeps its own number of processors.  CCDs missing
+  in mCcdOrder are placed after the others of the same socket.
 
+  @retval EFI_SUCCESS           The processors are sorted.
+  @retval EFI_OUT_OF_RESOURCES  Failed to allocate the sort buffers.
 **/
-INTN
-EFIAPI
-SortByCcd (
-  IN  CONST VOID  *LocalX2ApicLeft,
-  IN  CONST VOID  *LocalX2ApicRight
+EFI_STATUS
+SortApicIdtoUidMapByCcd (
+  VOID
   )
 {
-  EFI_PROCESSOR_INFORMATION  *Left;
-  EFI_PROCESSOR_INFORMATION  *Right;
-  UINT32                     Index;
-  UINT32                     LeftCcdIndex;
-  UINT32                     RightCcdIndex;
+  EFI_PROCESSOR_INFORMATION  *SortedMap;
+  UINT32                     *CcdRank;
+  UINTN                      *BucketStart;
+  UINT32                     MaxPackage;
+  UINT32                     MaxCcd;
+  UINTN                      NumberOfRanks;
+  UINTN                      NumberOfBuckets;
+  UINTN                      Bucket;
+  UINTN                      Index;
+
+  MaxPackage = 0;
+  MaxCcd     = 0;
+  for (Index = 0; Index < ARRAY_SIZE (mCcdOrder); Index++) {
+    MaxCcd = MAX (MaxCcd, mCcdOrder[Index]);
+  }
+
+  for (Index = 0; Index < mNumberOfCpus; Index++) {
+    MaxPackage = MAX (MaxPackage, mApicIdtoUidMap[Index].ExtendedInformation.Location2.Package);
+    MaxCcd     = MAX (MaxCcd, mApicIdtoUidMap[Index].ExtendedInformation.Location2.Die);
+  }
 
-  Left  = (EFI_PROCESSOR_INFORMATION *)LocalX2ApicLeft;
-  Right = (EFI_PROCESSOR_INFORMATION *)LocalX2ApicRight;
+  NumberOfRanks   = ARRAY_SIZE (mCcdOrder) + 1;
+  NumberOfBuckets = (MaxPackage + 1) * NumberOfRanks;
+  CcdRank         = AllocatePool ((MaxCcd + 1) * sizeof (UINT32));
+  BucketStart     = AllocateZeroPool ((NumberOfBuckets + 1) * sizeof (UINTN));
+  SortedMap       = AllocatePool (mNumberOfCpus * sizeof (EFI_PROCESSOR_INFORMATION));
+  if ((CcdRank == NULL) || (BucketStart == NULL) || (SortedMap == NULL)) {
+    if (CcdRank != NULL) {
+      FreePool (CcdRank);
+    }
 
-  // Get the CCD Index number
-  LeftCcdIndex = MAX_UINT32;
-  for (Index = 0; Index < ARRAY_SIZE (mCcdOrder); Index++) {
-    if (Left->ExtendedInformation.Location2.Die == mCcdOrder[Index]) {
-      LeftCcdIndex = Index;
-      break;
+    if (BucketStart != NULL) {
+      FreePool (BucketStart);
     }
-  }
 
-  RightCcdIndex = MAX_UINT32;
-  for (Index = 0; Index < ARRAY_SIZE (mCcdOrder); Index++) {
-    if (Right->ExtendedInformation.Location2.Die == mCcdOrder[Index]) {
-      RightCcdIndex = Index;
-      break;
+    if (SortedMap != NULL) {
+      FreePool (SortedMap);
     }
+
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  // Get the CCD Index number of each CCD
+  for (Index = 0; Index <= MaxCcd; Index++) {
+    CcdRank[Index] = ARRAY_SIZE (mCcdOrder);
+  }
+
+  for (Index = ARRAY_SIZE (mCcdOrder); Index > 0; Index--) {
+    CcdRank[mCcdOrder[Index - 1]] = (UINT32)(Index - 1);
+  }
+
+  // Count the processors of each bucket
+  for (Index = 0; Index < mNumberOfCpus; Index++) {
+    Bucket = mApicIdtoUidMap[Index].ExtendedInformation.Location2.Package * NumberOfRanks +
+             CcdRank[mApicIdtoUidMap[Index].ExtendedInformation.Location2.Die];
+    BucketStart[Bucket + 1]++;
   }
 
-  // Now compare for quick sort
-  if (LeftCcdIndex < RightCcdIndex) {
-    return -1;
+  // Get the first index of each bucket
+  for (Bucket = 1; Bucket <= NumberOfBuckets; Bucket++) {
+    BucketStart[Bucket] += BucketStart[Bucket - 1];
   }
 
-  if (LeftCcdIndex > RightCcdIndex) {
-    return 1;
+  // Move the processors to their buckets in the MP services order
+  for (Index = 0; Index < mNumberOfCpus; Index++) {
+    Bucket = mApicIdtoUidMap[Index].ExtendedInformation.Location2.Package * NumberOfRanks +
+             CcdRank[mApicIdtoUidMap[Index].ExtendedInformation.Location2.Die];
+    CopyMem (&SortedMap[BucketStart[Bucket]], &mApicIdtoUidMap[Index], sizeof (EFI_PROCESSOR_INFORMATION));
+    BucketStart[Bucket]++;
   }
 
-  return 0;
+  FreePool (mApicIdtoUidMap);
+  mApicIdtoUidMap = SortedMap;
+
+  FreePool (CcdRank);
+  FreePool (BucketStart);
+  return EFI_SUCCESS;
 }
 
 EFI_STATUS
@@ -247,13 +284,12 @@ GenerateApicIdtoUidMap (
       );
   }
 
-  if (FixedPcdGet32 (PcdMaxCpuSocketCount) > 1) {
-    /// Sort by CCD location
-    PerformQuickSort (mApicIdtoUidMap, mNumberOfCpus/2, sizeof (EFI_PROCESSOR_INFORMATION), SortByCcd);
-    PerformQuickSort (mApicIdtoUidMap+(mNumberOfCpus/2), mNumberOfCpus/2, sizeof (EFI_PROCESSOR_INFORMATION), SortByCcd);
-  } else {
-    /// Sort by CCD location
-    PerformQuickSort (mApicIdtoUidMap, mNumberOfCpus, sizeof (EFI_PROCESSOR_INFORMATION), SortByCcd);
+  /// Sort by socket and CCD location
+  Status = SortApicIdtoUidMapByCcd ();
+  if (EFI_ERROR (Status)) {
+    FreePool (mApicIdtoUidMap);
+    mApicIdtoUidMap = NULL;
+    return Status;
   }
 
   // Now allocate the Uid
@@ -24,6 +24,8 @@
 #define BLOCK_SIZE              (FixedPcdGet32 (PcdAgesaFlashNvStorageBlockSize))
 // Set to 1 to turn on FVB writes and erases.  Shouldn't be needed anymore.
 #define SPI_FVB_VERIFY          1
+// Matching bytes that end a run of bytes programmed by one SPI write.
+#define SPI_FVB_WRITE_SKIP_BYTES  16
 
 EFI_SPI_NOR_FLASH_PROTOCOL *mSpiNorFlashProtocol;
 
@@ -36,6 +38,12 @@ STATIC CONST UINT64 mNvStorageSize = FixedPcdGet32 (PcdFlashNvStorageVariableSiz
                                      FixedPcdGet32 (PcdFlashNvStorageFtwWorkingSize) +
                                      FixedPcdGet32 (PcdFlashNvStorageFtwSpareSize);
 
+//
+// In-memory copy of the NV storage region.  It is read from the flash on the
+// first access, serves all the reads and is kept in sync on writes and erases.
+//
+STATIC UINT8   *mNvStorageMirror;
+STATIC BOOLEAN mNvStorageMirrorValid;
 
 /*
  * Calculates the SPI offset of the current image using the
@@ -176,6 +184,208 @@ VerifyErase (
 }
 #endif // SPI_FVB_VERIFY
 
+/**
+  Returns the mirror of a range in the NV storage region.
+
+  The mirror is read from the flash the first time it is needed, and again
+  after a failed write or erase left it out of sync.
+
+  @param[in]  MirrorOffset  Offset of the range from the start of the NV storage.
+  @param[in]  Length        Length of the range in bytes.
+
+  @return Pointer to the mirror of the range, or NULL if the range is not
+          mirrored.
+**/
+STATIC
+UINT8 *
+GetNvStorageMirror (
+  IN  UINT64    MirrorOffset,
+  IN  UINTN     Length
+  )
+{
+  EFI_STATUS Status;
+
+  if (MirrorOffset > mNvStorageSize || Length > mNvStorageSize - MirrorOffset) {
+    return NULL;
+  }
+
+  if (!mNvStorageMirrorValid) {
+    if (mNvStorageMirror == NULL) {
+      mNvStorageMirror = AllocatePool ((UINTN)mNvStorageSize);
+      if (mNvStorageMirror == NULL) {
+        return NULL;
+      }
+    }
+    Status = mSpiNorFlashProtocol->ReadData (
+        mSpiNorFlashProtocol,
+        (UINT32)mNvStorageLbaOffset * BLOCK_SIZE + mSpiFlashOffset,
+        (UINT32)mNvStorageSize,
+        mNvStorageMirror
+        );
+    if (EFI_ERROR (Status)) {
+      DEBUG((DEBUG_ERROR, "%a: Failed to read NV storage - %r\n", __FUNCTION__, Status));
+      return NULL;
+    }
+    mNvStorageMirrorValid = TRUE;
+  }
+
+  return mNvStorageMirror + MirrorOffset;
+}
+
+/**
+  Checks if a buffer holds erased flash data.
+
+  @param[in]  Buffer    Buffer to check.
+  @param[in]  Length    Length of the buffer in bytes.
+
+  @retval TRUE          All the bytes in the buffer are 0xFF.
+  @retval FALSE         The buffer has a byte that isn't 0xFF.
+**/
+STATIC
+BOOLEAN
+IsErasedBuffer (
+  IN  UINT8     *Buffer,
+  IN  UINTN     Length
+  )
+{
+  UINTN Index;
+
+  for (Index = 0; Index < Length; Index++) {
+    if (Buffer[Index] != 0xFF) {
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+/**
+  Writes the bytes that differ from the NV storage mirror.
+
+  Runs of bytes that already hold the data are skipped, and the mirror is
+  updated with the written bytes.
+
+  @param[in]  SpiOffset   SPI offset of the data.
+  @param[in]  Mirror      Mirror of the data in the flash.
+  @param[in]  NumBytes    Number of bytes to write.
+  @param[in]  Buffer      Data to write.
+
+  @retval EFI_SUCCESS     The data was written.
+  @retval others          The write failed.
+**/
+STATIC
+EFI_STATUS
+WriteMirroredData (
+  IN  UINT32    SpiOffset,
+  IN  UINT8     *Mirror,
+  IN  UINTN     NumBytes,
+  IN  UINT8     *Buffer
+  )
+{
+  EFI_STATUS Status;
+  UINTN Index;
+  UINTN End;
+  UINTN RunLength;
+  UINTN MatchCount;
+
+  Status = EFI_SUCCESS;
+  for (Index = 0; Index < NumBytes;) {
+    if (Mirror[Index] == Buffer[Index]) {
+      Index++;
+      continue;
+    }
+
+    // Extend the run till SPI_FVB_WRITE_SKIP_BYTES bytes in a row match
+    RunLength = 1;
+    MatchCount = 0;
+    for (End = Index + 1; End < NumBytes && MatchCount < SPI_FVB_WRITE_SKIP_BYTES; End++) {
+      if (Mirror[End] == Buffer[End]) {
+        MatchCount++;
+      } else {
+        MatchCount = 0;
+        RunLength = End - Index + 1;
+      }
+    }
+
+    Status = mSpiNorFlashProtocol->WriteData (
+        mSpiNorFlashProtocol,
+        SpiOffset + (UINT32)Index,
+        (UINT32)RunLength,
+        &Buffer[Index]
+        );
+#if SPI_FVB_VERIFY
+    if (!EFI_ERROR (Status)) {
+      Status = VerifyWrite (SpiOffset + (UINT32)Index, (UINT32)RunLength, &Buffer[Index]);
+    }
+#endif // SPI_FVB_VERIFY
+    if (EFI_ERROR (Status)) {
+      mNvStorageMirrorValid = FALSE;
+      break;
+    }
+
+    CopyMem (&Mirror[Index], &Buffer[Index], RunLength);
+    Index += RunLength;
+  }
+
+  return Status;
+}
+
+/**
+  Erases the blocks that aren't erased in the NV storage mirror.
+
+  @param[in]  SpiOffset   SPI offset of the first block.
+  @param[in]  Mirror      Mirror of the first block.
+  @param[in]  Length      Length of the blocks in bytes.
+
+  @retval EFI_SUCCESS     The blocks were erased.
+  @retval others          The erase failed.
+**/
+STATIC
+EFI_STATUS
+EraseMirroredBlocks (
+  IN  UINT32    SpiOffset,
+  IN  UINT8     *Mirror,
+  IN  UINTN     Length
+  )
+{
+  EFI_STATUS Status;
+  UINTN Index;
+  UINTN RunLength;
+
+  Status = EFI_SUCCESS;
+  for (Index = 0; Index < Length;) {
+    if (IsErasedBuffer (&Mirror[Index], BLOCK_SIZE)) {
+      Index += BLOCK_SIZE;
+      continue;
+    }
+
+    // Erase the blocks that aren't erased with one request
+    for (RunLength = BLOCK_SIZE;
+         Index + RunLength < Length && !IsErasedBuffer (&Mirror[Index + RunLength], BLOCK_SIZE);
+         RunLength += BLOCK_SIZE) {
+    }
+
+    Status = mSpiNorFlashProtocol->Erase (
+        mSpiNorFlashProtocol,
+        SpiOffset + (UINT32)Index,
+        (UINT32)RunLength / SIZE_4KB
+        );
+#if SPI_FVB_VERIFY
+    if (!EFI_ERROR (Status)) {
+      Status = VerifyErase (SpiOffset + (UINT32)Index, (UINT32)RunLength);
+    }
+#endif // SPI_FVB_VERIFY
+    if (EFI_ERROR (Status)) {
+      mNvStorageMirrorValid = FALSE;
+      break;
+    }
+
+    SetMem (&Mirror[Index], RunLength, 0xFF);
+    Index += RunLength;
+  }
+
+  return Status;
+}
+
 /**
   The GetAttributes() function retrieves the attributes and
   current settings of the block.
@@ -374,6 +584,7 @@ SpiFvbRead (
 {
   EFI_STATUS Status;
   UINT32 SpiOffset;
+  UINT8 *Mirror;
 
   if (Offset >= BLOCK_SIZE) {
     return EFI_INVALID_PARAMETER;
@@ -386,6 +597,12 @@ SpiFvbRead (
   DEBUG((DEBUG_VERBOSE, "%a(AfterBlockBoundary Lba=%lX, Offset=%lX, *NumBytes=%lX, Buffer=%lX)\n",
         __FUNCTION__, Lba, Offset, *NumBytes, Buffer));
 
+  Mirror = GetNvStorageMirror (MultU64x32 (Lba, BLOCK_SIZE) + Offset, *NumBytes);
+  if (Mirror != NULL) {
+    CopyMem (Buffer, Mirror, *NumBytes);
+    return EFI_SUCCESS;
+  }
+
   SpiOffset = ((UINT32)mNvStorageLbaOffset + (UINT32)(Lba))
     * BLOCK_SIZE + (UINT32)Offset;
   SpiOffset += mSpiFlashOffset;
@@ -472,6 +689,7 @@ SpiFvbWrite (
 {
   EFI_STATUS Status;
   UINT32 SpiOffset;
+  UINT8 *Mirror;
 
   if (Offset >= BLOCK_SIZE) {
     return EFI_INVALID_PARAMETER;
@@ -488,6 +706,11 @@ SpiFvbWrite (
     * BLOCK_SIZE + (UINT32)Offset;
   SpiOffset += mSpiFlashOffset;
 
+  Mirror = GetNvStorageMirror (MultU64x32 (Lba, BLOCK_SIZE) + Offset, *NumBytes);
+  if (Mirror != NULL) {
+    return WriteMirroredData (SpiOffset, Mirror, *NumBytes, Buffer);
+  }
+
   Status = mSpiNorFlashProtocol->WriteData (
       mSpiNorFlashProtocol,
       SpiOffset,
@@ -563,6 +786,7 @@ SpiFvbErase (
   UINTN Length;
   EFI_STATUS Status;
   UINT32 SpiOffset;
+  UINT8 *Mirror;
 
   Status = EFI_SUCCESS;
   VA_START (Args, This);
@@ -578,6 +802,15 @@ SpiFvbErase (
     SpiOffset = ((UINT32)Start + (UINT32)mNvStorageLbaOffset) * BLOCK_SIZE;
     SpiOffset += mSpiFlashOffset;
 
+    Mirror = GetNvStorageMirror (MultU64x32 (Start, BLOCK_SIZE), Length);
+    if (Mirror != NULL) {
+      Status = EraseMirroredBlocks (SpiOffset, Mirror, Length);
+      if (EFI_ERROR(Status)) {
+        break;
+      }
+      continue;
+    }
+
     Status = mSpiNorFlashProtocol->Erase (
         mSpiNorFlashProtocol,
         SpiOffset,
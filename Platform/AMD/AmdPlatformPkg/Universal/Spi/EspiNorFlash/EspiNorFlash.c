@@ -479,6 +479,12 @@ LfReadData (
   Instance             = ESPI_NOR_FLASH_FROM_THIS (This);
   MaximumTransferBytes = Instance->SpiIo->MaximumTransferBytes;
 
+  // Check not WIP. Reads don't start a write, so check once for all chunks.
+  Status = WaitNotWip (Instance);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
   CurrentBuffer = Buffer;
   Length        = 0;
   for (ByteCounter = 0; ByteCounter < LengthInBytes;) {
@@ -490,17 +496,7 @@ LfReadData (
       Length = MaximumTransferBytes;
     }
 
-    // Check not WIP
-    Status = WaitNotWip (Instance);
-    if (EFI_ERROR (Status)) {
-      break;
-    }
-
     //  Read Data
-    if (EFI_ERROR (Status)) {
-      break;
-    }
-
     TransactionBufferLength = FillWriteBuffer (
                                 Instance,
                                 SPI_FLASH_READ,
@@ -524,12 +520,57 @@ LfReadData (
                                 CurrentBuffer
                                 );
     ASSERT_EFI_ERROR (Status);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
     ByteCounter += Length;
   }
 
   return Status;
 }
 
+/**
+  Get the time elapsed since a performance counter value in nanoseconds.
+
+  @param[in]  StartTicks  Performance counter value at the start.
+
+  @retval     Elapsed time in nanoseconds.
+**/
+STATIC
+UINT64
+GetElapsedNanoSeconds (
+  IN  UINT64  StartTicks
+  )
+{
+  UINT64  EndTicks;
+  UINT64  CounterStart;
+  UINT64  CounterEnd;
+  UINT64  Ticks;
+
+  EndTicks = GetPerformanceCounter ();
+  GetPerformanceCounterProperties (&CounterStart, &CounterEnd);
+  if (CounterStart < CounterEnd) {
+    // Count up counter
+    if (EndTicks >= StartTicks) {
+      Ticks = EndTicks - StartTicks;
+    } else {
+      // The counter rolled over from CounterEnd to CounterStart
+      Ticks = (CounterEnd - StartTicks) + (EndTicks - CounterStart) + 1;
+    }
+  } else {
+    // Count down counter
+    if (StartTicks >= EndTicks) {
+      Ticks = StartTicks - EndTicks;
+    } else {
+      // The counter rolled over from CounterEnd to CounterStart
+      Ticks = (StartTicks - CounterEnd) + (CounterStart - EndTicks) + 1;
+    }
+  }
+
+  return GetTimeInNanoSecond (Ticks);
+}
+
 /**
   Read data from the SPI flash.
 
@@ -565,6 +606,8 @@ ReadData (
   UINT32                   Length;
   UINT32                   TransactionBufferLength;
   UINT32                   MaximumTransferBytes;
+  UINT64                   StartTicks;
+  UINT64                   NanoSeconds;
 
   Status = EFI_DEVICE_ERROR;
   if ((Buffer == NULL) ||
@@ -574,11 +617,20 @@ ReadData (
     return EFI_INVALID_PARAMETER;
   }
 
+  StartTicks           = GetPerformanceCounter ();
   Instance             = ESPI_NOR_FLASH_FROM_THIS (This);
   MaximumTransferBytes = Instance->SpiIo->MaximumTransferBytes;
   if (Instance->EspiSafsMode) {
     // ESPI SAFS
     MaximumTransferBytes = Instance->EspiMaxReadReqSize;
+  } else {
+    // MAFS
+    // Check not WIP. Reads don't start a write, so check once for all chunks.
+    Status = WaitNotWip (Instance);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_INFO, "Espi read data ERROR after WaitNotWip: Status = %r\n", Status));
+      return Status;
+    }
   }
 
   CurrentBuffer = Buffer;
@@ -599,13 +651,6 @@ ReadData (
       }
     } else {
       // MAFS
-      // Check not WIP
-      Status = WaitNotWip (Instance);
-      if (EFI_ERROR (Status)) {
-        DEBUG ((DEBUG_INFO, "Espi read data ERROR after WaitNotWip: Status = %r\n", Status));
-        break;
-      }
-
       TransactionBufferLength = FillWriteBuffer (
                                   Instance,
                                   SPI_FLASH_FAST_READ,
@@ -634,6 +679,20 @@ ReadData (
     ByteCounter += Length;
   }
 
+  if (!EFI_ERROR (Status)) {
+    NanoSeconds                = GetElapsedNanoSeconds (StartTicks);
+    Instance->ReadByteCount   += LengthInBytes;
+    Instance->ReadNanoSeconds += NanoSeconds;
+    DEBUG ((
+      DEBUG_VERBOSE,
+      "%a: 0x%X bytes in %ld ns, total %ld KB/s\n",
+      __FUNCTION__,
+      LengthInBytes,
+      NanoSeconds,
+      (Instance->ReadNanoSeconds == 0) ? 0 : DivU64x64Remainder (MultU64x32 (Instance->ReadByteCount, 1000000), Instance->ReadNanoSeconds, NULL)
+      ));
+  }
+
   return Status;
 }
 
@@ -28,6 +28,8 @@ typedef struct {
   UINT32                        EspiMaxReadReqSize;
   UINT32                        EspiMaxPayloadSize;
   UINT32                        EspiEraseBlockMap;
+  UINT64                        ReadByteCount;
+  UINT64                        ReadNanoSeconds;
 } ESPI_NOR_FLASH_INSTANCE;
 
 #define ESPI_NOR_FLASH_FROM_THIS(a) \
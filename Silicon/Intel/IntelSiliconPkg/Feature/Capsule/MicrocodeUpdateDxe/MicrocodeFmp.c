@@ -738,6 +738,7 @@ InitializeProcessorInfo (
   UINTN                                NumberOfEnabledProcessors;
   UINTN                                Index;
   UINTN                                BspIndex;
+  EFI_PROCESSOR_INFORMATION            ProcessorInfoBuffer;
 
   Status = gBS->LocateProtocol (&gEfiMpServiceProtocolGuid, NULL, (VOID **)&MpService);
   ASSERT_EFI_ERROR(Status);
@@ -762,22 +763,16 @@ InitializeProcessorInfo (
   for (Index = 0; Index < NumberOfProcessors; Index++) {
     MicrocodeFmpPrivate->ProcessorInfo[Index].CpuIndex = Index;
     MicrocodeFmpPrivate->ProcessorInfo[Index].MicrocodeIndex = (UINTN)-1;
-    if (Index == BspIndex) {
-      CollectProcessorInfo (&MicrocodeFmpPrivate->ProcessorInfo[Index]);
-    } else {
-      Status = MpService->StartupThisAP (
-                            MpService,
-                            CollectProcessorInfo,
-                            Index,
-                            NULL,
-                            0,
-                            &MicrocodeFmpPrivate->ProcessorInfo[Index],
-                            NULL
-                            );
-      ASSERT_EFI_ERROR(Status);
+    Status = MpService->GetProcessorInfo (MpService, Index, &ProcessorInfoBuffer);
+    ASSERT_EFI_ERROR(Status);
+    if (!EFI_ERROR(Status)) {
+      MicrocodeFmpPrivate->ProcessorInfo[Index].Enabled = (BOOLEAN)((ProcessorInfoBuffer.StatusFlag & PROCESSOR_ENABLED_BIT) != 0);
+      CopyMem (&MicrocodeFmpPrivate->ProcessorInfo[Index].Location, &ProcessorInfoBuffer.Location, sizeof(EFI_CPU_PHYSICAL_LOCATION));
     }
   }
 
+  CollectAllProcessorInfo (MicrocodeFmpPrivate);
+
   return EFI_SUCCESS;
 }
 
@@ -166,6 +166,150 @@ LoadMicrocodeOnThis (
   }
 }
 
+/**
+  Load Microcode on the Application Processors selected in the load buffer.
+  The function prototype for invoking a function on all Application Processors.
+
+  @param[in,out] Buffer  The pointer to MICROCODE_LOAD_ALL_BUFFER.
+**/
+VOID
+EFIAPI
+MicrocodeLoadAllAp (
+  IN OUT VOID  *Buffer
+  )
+{
+  EFI_STATUS                           Status;
+  MICROCODE_LOAD_ALL_BUFFER            *MicrocodeLoadAllBuffer;
+  UINTN                                CpuIndex;
+
+  MicrocodeLoadAllBuffer = Buffer;
+  Status = MicrocodeLoadAllBuffer->MpService->WhoAmI (MicrocodeLoadAllBuffer->MpService, &CpuIndex);
+  if (EFI_ERROR(Status) || (CpuIndex >= MicrocodeLoadAllBuffer->ProcessorCount)) {
+    return;
+  }
+  if (MicrocodeLoadAllBuffer->LoadBuffer[CpuIndex].Address != 0) {
+    MicrocodeLoadAp (&MicrocodeLoadAllBuffer->LoadBuffer[CpuIndex]);
+  }
+}
+
+/**
+  Load new Microcode on all processors with the signature and platform ID of
+  the target processor.
+
+  The Microcode update is shared by the threads of a core, so the Microcode is
+  loaded on one thread of each core. The cores are loaded concurrently, and the
+  Microcode revision of all processors is collected again afterwards.
+
+  @param[in]  MicrocodeFmpPrivate        The Microcode driver private data
+  @param[in]  TargetProcessorInfo        The information of the processor which matches the Microcode.
+  @param[in]  Address                    The address of new Microcode.
+
+  @return  The lowest Microcode signature loaded on the matched processors.
+
+**/
+UINT32
+LoadMicrocodeOnAll (
+  IN  MICROCODE_FMP_PRIVATE_DATA  *MicrocodeFmpPrivate,
+  IN  PROCESSOR_INFO              *TargetProcessorInfo,
+  IN  UINT64                      Address
+  )
+{
+  EFI_STATUS                           Status;
+  EFI_MP_SERVICES_PROTOCOL             *MpService;
+  MICROCODE_LOAD_ALL_BUFFER            MicrocodeLoadAllBuffer;
+  MICROCODE_LOAD_BUFFER                *LoadBuffer;
+  PROCESSOR_INFO                       *ProcessorInfo;
+  UINTN                                Index;
+  UINTN                                SiblingIndex;
+  UINTN                                LoadCount;
+  UINT32                               ProcessorSignature;
+  UINT8                                PlatformId;
+  UINT32                               Revision;
+
+  LoadBuffer = AllocateZeroPool (sizeof(MICROCODE_LOAD_BUFFER) * MicrocodeFmpPrivate->ProcessorCount);
+  if (LoadBuffer == NULL) {
+    return LoadMicrocodeOnThis (MicrocodeFmpPrivate, TargetProcessorInfo->CpuIndex, Address);
+  }
+
+  //
+  // Select the first enabled thread of each matched core.
+  //
+  ProcessorInfo      = MicrocodeFmpPrivate->ProcessorInfo;
+  ProcessorSignature = TargetProcessorInfo->ProcessorSignature;
+  PlatformId         = TargetProcessorInfo->PlatformId;
+  LoadCount          = 0;
+  for (Index = 0; Index < MicrocodeFmpPrivate->ProcessorCount; Index++) {
+    if (!ProcessorInfo[Index].Enabled ||
+        (ProcessorInfo[Index].ProcessorSignature != ProcessorSignature) ||
+        (ProcessorInfo[Index].PlatformId != PlatformId)) {
+      continue;
+    }
+    for (SiblingIndex = 0; SiblingIndex < Index; SiblingIndex++) {
+      if ((LoadBuffer[SiblingIndex].Address != 0) &&
+          (ProcessorInfo[SiblingIndex].Location.Package == ProcessorInfo[Index].Location.Package) &&
+          (ProcessorInfo[SiblingIndex].Location.Core == ProcessorInfo[Index].Location.Core)) {
+        break;
+      }
+    }
+    if (SiblingIndex == Index) {
+      LoadBuffer[Index].Address = Address;
+      LoadCount++;
+    }
+  }
+  DEBUG((DEBUG_INFO, "LoadMicrocodeOnAll - 0x%x cores\n", LoadCount));
+
+  if (LoadBuffer[MicrocodeFmpPrivate->BspIndex].Address != 0) {
+    MicrocodeLoadAp (&LoadBuffer[MicrocodeFmpPrivate->BspIndex]);
+  }
+  if (MicrocodeFmpPrivate->ProcessorCount > 1) {
+    MpService = MicrocodeFmpPrivate->MpService;
+    MicrocodeLoadAllBuffer.MpService      = MpService;
+    MicrocodeLoadAllBuffer.ProcessorCount = MicrocodeFmpPrivate->ProcessorCount;
+    MicrocodeLoadAllBuffer.LoadBuffer     = LoadBuffer;
+    Status = MpService->StartupAllAPs (
+                          MpService,
+                          MicrocodeLoadAllAp,
+                          FALSE,
+                          NULL,
+                          0,
+                          &MicrocodeLoadAllBuffer,
+                          NULL
+                          );
+    if (EFI_ERROR(Status)) {
+      DEBUG((DEBUG_ERROR, "LoadMicrocodeOnAll - StartupAllAPs - %r\n", Status));
+      for (Index = 0; Index < MicrocodeFmpPrivate->ProcessorCount; Index++) {
+        if ((Index != MicrocodeFmpPrivate->BspIndex) && (LoadBuffer[Index].Address != 0)) {
+          LoadBuffer[Index].Revision = LoadMicrocodeOnThis (MicrocodeFmpPrivate, Index, Address);
+        }
+      }
+    }
+  }
+
+  FreePool (LoadBuffer);
+
+  //
+  // Aggregate the Microcode revision of all matched processors, including the
+  // threads sharing the Microcode update of a loaded core.
+  //
+  CollectAllProcessorInfo (MicrocodeFmpPrivate);
+  Revision = TargetProcessorInfo->MicrocodeRevision;
+  for (Index = 0; Index < MicrocodeFmpPrivate->ProcessorCount; Index++) {
+    if (!ProcessorInfo[Index].Enabled ||
+        (ProcessorInfo[Index].ProcessorSignature != ProcessorSignature) ||
+        (ProcessorInfo[Index].PlatformId != PlatformId)) {
+      continue;
+    }
+    if (ProcessorInfo[Index].MicrocodeRevision != TargetProcessorInfo->MicrocodeRevision) {
+      DEBUG((DEBUG_ERROR, "LoadMicrocodeOnAll - ProcessorInfo[0x%x] revision 0x%08x\n", Index, ProcessorInfo[Index].MicrocodeRevision));
+    }
+    if (ProcessorInfo[Index].MicrocodeRevision < Revision) {
+      Revision = ProcessorInfo[Index].MicrocodeRevision;
+    }
+  }
+
+  return Revision;
+}
+
 /**
   Collect processor information.
   The function prototype for invoking a function on an Application Processor.
@@ -186,6 +330,86 @@ CollectProcessorInfo (
   ProcessorInfo->MicrocodeRevision = GetCurrentMicrocodeSignature();
 }
 
+/**
+  Collect processor information on the calling Application Processor.
+  The function prototype for invoking a function on all Application Processors.
+
+  @param[in,out] Buffer  The pointer to private data buffer.
+**/
+VOID
+EFIAPI
+CollectProcessorInfoAllAp (
+  IN OUT VOID  *Buffer
+  )
+{
+  EFI_STATUS                  Status;
+  MICROCODE_FMP_PRIVATE_DATA  *MicrocodeFmpPrivate;
+  UINTN                       CpuIndex;
+
+  MicrocodeFmpPrivate = Buffer;
+  Status = MicrocodeFmpPrivate->MpService->WhoAmI (MicrocodeFmpPrivate->MpService, &CpuIndex);
+  if (EFI_ERROR(Status) || (CpuIndex >= MicrocodeFmpPrivate->ProcessorCount)) {
+    return;
+  }
+  CollectProcessorInfo (&MicrocodeFmpPrivate->ProcessorInfo[CpuIndex]);
+}
+
+/**
+  Collect processor information of all processors.
+
+  If PcdMicrocodeUpdateParallelLoad is TRUE, the information is collected on
+  all Application Processors concurrently.
+
+  @param[in]  MicrocodeFmpPrivate        The Microcode driver private data
+**/
+VOID
+CollectAllProcessorInfo (
+  IN  MICROCODE_FMP_PRIVATE_DATA  *MicrocodeFmpPrivate
+  )
+{
+  EFI_STATUS                           Status;
+  EFI_MP_SERVICES_PROTOCOL             *MpService;
+  UINTN                                Index;
+
+  MpService = MicrocodeFmpPrivate->MpService;
+  CollectProcessorInfo (&MicrocodeFmpPrivate->ProcessorInfo[MicrocodeFmpPrivate->BspIndex]);
+  if (MicrocodeFmpPrivate->ProcessorCount <= 1) {
+    return;
+  }
+
+  if (FeaturePcdGet (PcdMicrocodeUpdateParallelLoad)) {
+    Status = MpService->StartupAllAPs (
+                          MpService,
+                          CollectProcessorInfoAllAp,
+                          FALSE,
+                          NULL,
+                          0,
+                          MicrocodeFmpPrivate,
+                          NULL
+                          );
+    if (!EFI_ERROR(Status)) {
+      return;
+    }
+    DEBUG((DEBUG_ERROR, "CollectAllProcessorInfo - StartupAllAPs - %r\n", Status));
+  }
+
+  for (Index = 0; Index < MicrocodeFmpPrivate->ProcessorCount; Index++) {
+    if (Index == MicrocodeFmpPrivate->BspIndex) {
+      continue;
+    }
+    Status = MpService->StartupThisAP (
+                          MpService,
+                          CollectProcessorInfo,
+                          Index,
+                          NULL,
+                          0,
+                          &MicrocodeFmpPrivate->ProcessorInfo[Index],
+                          NULL
+                          );
+    ASSERT_EFI_ERROR(Status);
+  }
+}
+
 /**
   Get current Microcode information.
 
@@ -578,7 +802,11 @@ VerifyMicrocode (
   // try load MCU
   //
   if (TryLoad) {
-    CurrentRevision = LoadMicrocodeOnThis(MicrocodeFmpPrivate, ProcessorInfo->CpuIndex, (UINTN)MicrocodeEntryPoint + sizeof(CPU_MICROCODE_HEADER));
+    if (FeaturePcdGet (PcdMicrocodeUpdateParallelLoad)) {
+      CurrentRevision = LoadMicrocodeOnAll(MicrocodeFmpPrivate, ProcessorInfo, (UINTN)MicrocodeEntryPoint + sizeof(CPU_MICROCODE_HEADER));
+    } else {
+      CurrentRevision = LoadMicrocodeOnThis(MicrocodeFmpPrivate, ProcessorInfo->CpuIndex, (UINTN)MicrocodeEntryPoint + sizeof(CPU_MICROCODE_HEADER));
+    }
     if (MicrocodeEntryPoint->UpdateRevision != CurrentRevision) {
       DEBUG((DEBUG_ERROR, "VerifyMicrocode - fail on LoadMicrocode\n"));
       *LastAttemptStatus = LAST_ATTEMPT_STATUS_ERROR_AUTH_ERROR;
@@ -61,11 +61,13 @@ typedef struct {
 } FIT_MICROCODE_INFO;
 
 typedef struct {
-  UINTN                  CpuIndex;
-  UINT32                 ProcessorSignature;
-  UINT8                  PlatformId;
-  UINT32                 MicrocodeRevision;
-  UINTN                  MicrocodeIndex;
+  UINTN                      CpuIndex;
+  UINT32                     ProcessorSignature;
+  UINT8                      PlatformId;
+  UINT32                     MicrocodeRevision;
+  UINTN                      MicrocodeIndex;
+  BOOLEAN                    Enabled;
+  EFI_CPU_PHYSICAL_LOCATION  Location;
 } PROCESSOR_INFO;
 
 typedef struct {
@@ -73,6 +75,12 @@ typedef struct {
   UINT32                 Revision;
 } MICROCODE_LOAD_BUFFER;
 
+typedef struct {
+  EFI_MP_SERVICES_PROTOCOL  *MpService;
+  UINTN                     ProcessorCount;
+  MICROCODE_LOAD_BUFFER     *LoadBuffer;
+} MICROCODE_LOAD_ALL_BUFFER;
+
 struct _MICROCODE_FMP_PRIVATE_DATA {
   UINT32                               Signature;
   EFI_FIRMWARE_MANAGEMENT_PROTOCOL     Fmp;
@@ -142,6 +150,19 @@ CollectProcessorInfo (
   IN OUT VOID  *Buffer
   );
 
+/**
+  Collect processor information of all processors.
+
+  If PcdMicrocodeUpdateParallelLoad is TRUE, the information is collected on
+  all Application Processors concurrently.
+
+  @param[in]  MicrocodeFmpPrivate        The Microcode driver private data
+**/
+VOID
+CollectAllProcessorInfo (
+  IN  MICROCODE_FMP_PRIVATE_DATA  *MicrocodeFmpPrivate
+  );
+
 /**
   Get current Microcode information.
 
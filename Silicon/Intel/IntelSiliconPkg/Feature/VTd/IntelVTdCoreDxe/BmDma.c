@@ -30,12 +30,176 @@ typedef struct {
   UINTN                                     NumberOfPages;
   EFI_PHYSICAL_ADDRESS                      HostAddress;
   EFI_PHYSICAL_ADDRESS                      DeviceAddress;
+  UINTN                                     BounceBufferClass;
   LIST_ENTRY                                HandleList;
 } MAP_INFO;
 #define MAP_INFO_FROM_LINK(a) CR (a, MAP_INFO, Link, MAP_INFO_SIGNATURE)
 
+//
+// The remap buffers of 1 page (class 0) to 256 pages (class 8) are rounded up
+// to a power of 2 pages and recycled on unmap, instead of being returned to the
+// page allocator. The recycled buffers are below 4GB so that any remap can use them.
+//
+#define BOUNCE_BUFFER_CLASS_NUMBER  9
+#define BOUNCE_BUFFER_CLASS_DEPTH   8
+#define BOUNCE_BUFFER_NO_CLASS      ((UINTN)-1)
+
+typedef struct {
+  UINTN                                     FreeCount;
+  EFI_PHYSICAL_ADDRESS                      FreeBuffer[BOUNCE_BUFFER_CLASS_DEPTH];
+} BOUNCE_BUFFER_CLASS;
+
 LIST_ENTRY                        gMaps = INITIALIZE_LIST_HEAD_VARIABLE(gMaps);
 
+BOUNCE_BUFFER_CLASS               mBounceBufferClass[BOUNCE_BUFFER_CLASS_NUMBER];
+UINT64                            mRemapCount = 0;
+UINT64                            mBounceBufferHitCount = 0;
+
+/**
+  Return the bounce buffer class of the number of pages.
+
+  @param[in]  Pages             The number of pages.
+
+  @return The bounce buffer class.
+  @retval BOUNCE_BUFFER_NO_CLASS  The buffer is too large to be recycled.
+**/
+UINTN
+GetBounceBufferClass (
+  IN UINTN  Pages
+  )
+{
+  UINTN  Class;
+
+  if ((Pages == 0) || (Pages > ((UINTN)1 << (BOUNCE_BUFFER_CLASS_NUMBER - 1)))) {
+    return BOUNCE_BUFFER_NO_CLASS;
+  }
+
+  Class = (UINTN)HighBitSet64 (Pages);
+  if ((Pages & (Pages - 1)) != 0) {
+    Class++;
+  }
+  return Class;
+}
+
+/**
+  Allocate a buffer to remap a DMA transfer to.
+
+  @param[in]  Pages             The number of pages of the transfer.
+  @param[in]  MaxAddress        The highest address the buffer may end at.
+  @param[out] Class             The bounce buffer class of the buffer.
+  @param[out] Buffer            The address of the buffer.
+
+  @retval EFI_SUCCESS           The buffer is allocated.
+  @retval Others                The buffer cannot be allocated.
+**/
+EFI_STATUS
+AllocateBounceBuffer (
+  IN  UINTN                 Pages,
+  IN  EFI_PHYSICAL_ADDRESS  MaxAddress,
+  OUT UINTN                 *Class,
+  OUT EFI_PHYSICAL_ADDRESS  *Buffer
+  )
+{
+  EFI_STATUS           Status;
+  BOUNCE_BUFFER_CLASS  *BufferClass;
+  EFI_TPL              OriginalTpl;
+
+  *Class = GetBounceBufferClass (Pages);
+
+  OriginalTpl = gBS->RaiseTPL (VTD_TPL_LEVEL);
+  mRemapCount++;
+  if (*Class != BOUNCE_BUFFER_NO_CLASS) {
+    BufferClass = &mBounceBufferClass[*Class];
+    if (BufferClass->FreeCount != 0) {
+      BufferClass->FreeCount--;
+      *Buffer = BufferClass->FreeBuffer[BufferClass->FreeCount];
+      mBounceBufferHitCount++;
+      gBS->RestoreTPL (OriginalTpl);
+      return EFI_SUCCESS;
+    }
+  }
+  gBS->RestoreTPL (OriginalTpl);
+
+  if (*Class != BOUNCE_BUFFER_NO_CLASS) {
+    Pages      = (UINTN)1 << *Class;
+    MaxAddress = MIN (MaxAddress, SIZE_4GB - 1);
+  }
+
+  *Buffer = MaxAddress;
+  Status = gBS->AllocatePages (
+                  AllocateMaxAddress,
+                  EfiBootServicesData,
+                  Pages,
+                  Buffer
+                  );
+  return Status;
+}
+
+/**
+  Free a buffer allocated by AllocateBounceBuffer().
+
+  Any deferred DMA access revocation is flushed first: the previous device may
+  still hold a stale IOTLB entry for the buffer, and it must not be able to reach
+  the buffer once it is recycled for another transfer or returned to the system.
+
+  @param[in]  Pages             The number of pages of the transfer.
+  @param[in]  Class             The bounce buffer class of the buffer.
+  @param[in]  Buffer            The address of the buffer.
+**/
+VOID
+FreeBounceBuffer (
+  IN UINTN                 Pages,
+  IN UINTN                 Class,
+  IN EFI_PHYSICAL_ADDRESS  Buffer
+  )
+{
+  BOUNCE_BUFFER_CLASS  *BufferClass;
+  EFI_TPL              OriginalTpl;
+
+  if (PcdGet32 (PcdVTdDeferredInvalidationThreshold) != 0) {
+    FlushDeferredInvalidation ();
+  }
+
+  if (Class != BOUNCE_BUFFER_NO_CLASS) {
+    OriginalTpl = gBS->RaiseTPL (VTD_TPL_LEVEL);
+    BufferClass = &mBounceBufferClass[Class];
+    if (BufferClass->FreeCount < BOUNCE_BUFFER_CLASS_DEPTH) {
+      BufferClass->FreeBuffer[BufferClass->FreeCount] = Buffer;
+      BufferClass->FreeCount++;
+      gBS->RestoreTPL (OriginalTpl);
+      return;
+    }
+    gBS->RestoreTPL (OriginalTpl);
+    Pages = (UINTN)1 << Class;
+  }
+
+  gBS->FreePages (Buffer, Pages);
+}
+
+/**
+  Dump the statistics of the remap buffers.
+**/
+VOID
+DumpBounceBufferStatistics (
+  VOID
+  )
+{
+  UINTN  Class;
+
+  DEBUG ((
+    DEBUG_INFO,
+    "IoMmu remap: %ld, bounce buffer hit: %ld (%d%%)\n",
+    mRemapCount,
+    mBounceBufferHitCount,
+    (mRemapCount == 0) ? 0 : (UINTN)DivU64x64Remainder (MultU64x32 (mBounceBufferHitCount, 100), mRemapCount, NULL)
+    ));
+  for (Class = 0; Class < BOUNCE_BUFFER_CLASS_NUMBER; Class++) {
+    if (mBounceBufferClass[Class].FreeCount != 0) {
+      DEBUG ((DEBUG_INFO, "  %dKB bounce buffer free: %d\n", EFI_PAGES_TO_SIZE ((UINTN)1 << Class) / SIZE_1KB, mBounceBufferClass[Class].FreeCount));
+    }
+  }
+}
+
 /**
   This function fills DeviceHandle/IoMmuAccess to the MAP_HANDLE_INFO,
   based upon the DeviceAddress.
@@ -243,18 +407,19 @@ IoMmuMap (
   MapInfo->NumberOfPages     = EFI_SIZE_TO_PAGES (MapInfo->NumberOfBytes);
   MapInfo->HostAddress       = PhysicalAddress;
   MapInfo->DeviceAddress     = DmaMemoryTop;
+  MapInfo->BounceBufferClass = BOUNCE_BUFFER_NO_CLASS;
   InitializeListHead(&MapInfo->HandleList);
 
   //
   // Allocate a buffer below 4GB to map the transfer to.
   //
   if (NeedRemap) {
-    Status = gBS->AllocatePages (
-                    AllocateMaxAddress,
-                    EfiBootServicesData,
-                    MapInfo->NumberOfPages,
-                    &MapInfo->DeviceAddress
-                    );
+    Status = AllocateBounceBuffer (
+               MapInfo->NumberOfPages,
+               DmaMemoryTop,
+               &MapInfo->BounceBufferClass,
+               &MapInfo->DeviceAddress
+               );
     if (EFI_ERROR (Status)) {
       FreePool (MapInfo);
       *NumberOfBytes = 0;
@@ -274,6 +439,14 @@ IoMmuMap (
         (VOID *) (UINTN) MapInfo->HostAddress,
         MapInfo->NumberOfBytes
         );
+      //
+      // A recycled buffer holds the data of a previous transfer, do not
+      // expose it to the Bus Master in the tail of the last page.
+      //
+      ZeroMem (
+        (VOID *) (UINTN) (MapInfo->DeviceAddress + MapInfo->NumberOfBytes),
+        EFI_PAGES_TO_SIZE (MapInfo->NumberOfPages) - MapInfo->NumberOfBytes
+        );
     }
   } else {
     MapInfo->DeviceAddress = MapInfo->HostAddress;
@@ -377,7 +550,7 @@ IoMmuUnmap (
     //
     // Free the mapped buffer and the MAP_INFO structure.
     //
-    gBS->FreePages (MapInfo->DeviceAddress, MapInfo->NumberOfPages);
+    FreeBounceBuffer (MapInfo->NumberOfPages, MapInfo->BounceBufferClass, MapInfo->DeviceAddress);
   }
 
   VTdLogAddEvent (VTDLOG_DXE_IOMMU_UNMAP, MapInfo->NumberOfBytes, MapInfo->DeviceAddress);
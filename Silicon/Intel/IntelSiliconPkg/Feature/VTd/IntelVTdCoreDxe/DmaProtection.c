@@ -16,6 +16,8 @@ VTD_ACCESS_REQUEST                      *mAccessRequest = NULL;
 UINTN                                   mAccessRequestCount = 0;
 UINTN                                   mAccessRequestMaxCount = 0;
 
+EFI_EVENT                               mVtdDeferredInvalidationEvent = NULL;
+
 /**
   Append VTd Access Request to global.
 
@@ -608,6 +610,8 @@ OnExitBootServices (
 
   DumpVtdRegsAll ();
 
+  DumpBounceBufferStatistics ();
+
   DEBUG ((DEBUG_INFO, "Invalidate all\n"));
   for (VtdIndex = 0; VtdIndex < mVtdUnitNumber; VtdIndex++) {
     VtdLibFlushWriteBuffer (mVtdUnitInformation[VtdIndex].VtdUnitBaseAddress);
@@ -642,6 +646,26 @@ OnLegacyBoot (
   DumpVtdRegsAll ();
 }
 
+/**
+  Deferred invalidation callback function.
+
+  It is signaled when a DMA access revocation is deferred, and runs once the
+  caller restores the TPL below TPL_CALLBACK. The flush itself runs at
+  VTD_TPL_LEVEL, like every other path that touches the VTd engines.
+
+  @param[in]  Event    The event handle.
+  @param[in]  Context  The event content.
+**/
+VOID
+EFIAPI
+OnDeferredInvalidation (
+  IN EFI_EVENT                               Event,
+  IN VOID                                    *Context
+  )
+{
+  FlushDeferredInvalidation ();
+}
+
 /**
   Initialize DMA protection.
 **/
@@ -701,5 +725,18 @@ InitializeDmaProtection (
              );
   ASSERT_EFI_ERROR (Status);
 
+  if (PcdGet32 (PcdVTdDeferredInvalidationThreshold) != 0) {
+    Status = gBS->CreateEvent (
+                    EVT_NOTIFY_SIGNAL,
+                    TPL_CALLBACK,
+                    OnDeferredInvalidation,
+                    NULL,
+                    &mVtdDeferredInvalidationEvent
+                    );
+    if (EFI_ERROR (Status)) {
+      mVtdDeferredInvalidationEvent = NULL;
+    }
+  }
+
   return ;
 }
@@ -74,6 +74,8 @@ typedef struct {
   VTD_SECOND_LEVEL_PAGING_ENTRY    *FixedSecondLevelPagingEntry;
   BOOLEAN                          HasDirtyContext;
   BOOLEAN                          HasDirtyPages;
+  BOOLEAN                          HasDeferredPages;
+  UINT32                           DeferredInvalidationCount;
   PCI_DEVICE_INFORMATION           *PciDeviceInfo;
   BOOLEAN                          Is5LevelPaging;
   UINT8                            EnableQueuedInvalidation;
@@ -129,6 +131,8 @@ extern UINT64                           mAbove4GMemoryLimit;
 
 extern EDKII_PLATFORM_VTD_POLICY_PROTOCOL   *mPlatformVTdPolicy;
 
+extern EFI_EVENT                        mVtdDeferredInvalidationEvent;
+
 /**
   Prepare VTD configuration.
 **/
@@ -350,6 +354,7 @@ ScanAllPciBus (
   @param[in]  SourceId              The SourceId of the source.
   @param[out] ExtContextEntry       The ExtContextEntry of the source.
   @param[out] ContextEntry          The ContextEntry of the source.
+  @param[out] PciDataIndex          The index of the PCI data of the source. Optional.
 
   @return The index of the VTd engine.
   @retval (UINTN)-1  The VTd engine is not found.
@@ -359,7 +364,16 @@ FindVtdIndexByPciDevice (
   IN  UINT16                  Segment,
   IN  VTD_SOURCE_ID           SourceId,
   OUT VTD_EXT_CONTEXT_ENTRY   **ExtContextEntry,
-  OUT VTD_CONTEXT_ENTRY       **ContextEntry
+  OUT VTD_CONTEXT_ENTRY       **ContextEntry,
+  OUT UINTN                   *PciDataIndex OPTIONAL
+  );
+
+/**
+  Drop all of the cached PCI device lookup results.
+**/
+VOID
+ResetPciDeviceLookupCache (
+  VOID
   );
 
 /**
@@ -452,6 +466,22 @@ SetAccessAttribute (
   IN UINT64                IoMmuAccess
   );
 
+/**
+  Dump the statistics of the remap buffers.
+**/
+VOID
+DumpBounceBufferStatistics (
+  VOID
+  );
+
+/**
+  Invalidate the IOTLB for the deferred DMA access revocations of all VTd engines.
+**/
+VOID
+FlushDeferredInvalidation (
+  VOID
+  );
+
 /**
   Return the index of PCI data.
 
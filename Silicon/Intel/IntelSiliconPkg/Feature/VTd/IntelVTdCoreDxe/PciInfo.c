@@ -7,6 +7,54 @@
 
 #include "DmaProtection.h"
 
+//
+// The PCI device lookup cache is direct mapped, the size must be a power of 2.
+//
+#define VTD_PCI_DEVICE_LOOKUP_CACHE_SIZE  0x40
+
+typedef struct {
+  BOOLEAN                  Valid;
+  UINT16                   Segment;
+  VTD_SOURCE_ID            SourceId;
+  UINTN                    VtdIndex;
+  UINTN                    PciDataIndex;
+  VTD_EXT_CONTEXT_ENTRY    *ExtContextEntry;
+  VTD_CONTEXT_ENTRY        *ContextEntry;
+} VTD_PCI_DEVICE_LOOKUP_CACHE_ENTRY;
+
+VTD_PCI_DEVICE_LOOKUP_CACHE_ENTRY  mPciDeviceLookupCache[VTD_PCI_DEVICE_LOOKUP_CACHE_SIZE];
+
+/**
+  Drop all of the cached PCI device lookup results.
+**/
+VOID
+ResetPciDeviceLookupCache (
+  VOID
+  )
+{
+  ZeroMem (mPciDeviceLookupCache, sizeof (mPciDeviceLookupCache));
+}
+
+/**
+  Return the PCI device lookup cache entry of the Segment and SourceId.
+
+  @param[in]  Segment               The segment of the source.
+  @param[in]  SourceId              The SourceId of the source.
+
+  @return The cache entry the source is hashed to.
+**/
+VTD_PCI_DEVICE_LOOKUP_CACHE_ENTRY *
+GetPciDeviceLookupCacheEntry (
+  IN UINT16         Segment,
+  IN VTD_SOURCE_ID  SourceId
+  )
+{
+  UINTN  Hash;
+
+  Hash = (UINTN)SourceId.Uint16 ^ ((UINTN)SourceId.Uint16 >> 6) ^ ((UINTN)Segment * 0x1F);
+  return &mPciDeviceLookupCache[Hash & (VTD_PCI_DEVICE_LOOKUP_CACHE_SIZE - 1)];
+}
+
 /**
   Return the index of PCI data.
 
@@ -146,6 +194,11 @@ RegisterPciDevice (
     DEBUG ((DEBUG_INFO, "\n"));
 
     PciDeviceInfo->PciDeviceDataNumber++;
+
+    //
+    // The new device may take over a source which is cached for another VTd engine.
+    //
+    ResetPciDeviceLookupCache ();
   } else {
     if (CheckExist) {
       DEBUG ((DEBUG_INFO, "  RegisterPciDevice: PCI S%04x B%02x D%02x F%02x already registered\n", Segment, SourceId.Bits.Bus, SourceId.Bits.Device, SourceId.Bits.Function));
@@ -357,6 +410,7 @@ ScanAllPciBus (
   @param[in]  SourceId              The SourceId of the source.
   @param[out] ExtContextEntry       The ExtContextEntry of the source.
   @param[out] ContextEntry          The ContextEntry of the source.
+  @param[out] PciDataIndex          The index of the PCI data of the source. Optional.
 
   @return The index of the VTd engine.
   @retval (UINTN)-1  The VTd engine is not found.
@@ -366,25 +420,43 @@ FindVtdIndexByPciDevice (
   IN  UINT16                  Segment,
   IN  VTD_SOURCE_ID           SourceId,
   OUT VTD_EXT_CONTEXT_ENTRY   **ExtContextEntry,
-  OUT VTD_CONTEXT_ENTRY       **ContextEntry
+  OUT VTD_CONTEXT_ENTRY       **ContextEntry,
+  OUT UINTN                   *PciDataIndex OPTIONAL
   )
 {
-  UINTN                   VtdIndex;
-  VTD_ROOT_ENTRY          *RootEntry;
-  VTD_CONTEXT_ENTRY       *ContextEntryTable;
-  VTD_CONTEXT_ENTRY       *ThisContextEntry;
-  VTD_EXT_ROOT_ENTRY      *ExtRootEntry;
-  VTD_EXT_CONTEXT_ENTRY   *ExtContextEntryTable;
-  VTD_EXT_CONTEXT_ENTRY   *ThisExtContextEntry;
-  UINTN                   PciDataIndex;
+  UINTN                              VtdIndex;
+  VTD_ROOT_ENTRY                     *RootEntry;
+  VTD_CONTEXT_ENTRY                  *ContextEntryTable;
+  VTD_CONTEXT_ENTRY                  *ThisContextEntry;
+  VTD_EXT_ROOT_ENTRY                 *ExtRootEntry;
+  VTD_EXT_CONTEXT_ENTRY              *ExtContextEntryTable;
+  VTD_EXT_CONTEXT_ENTRY              *ThisExtContextEntry;
+  UINTN                              ThisPciDataIndex;
+  VTD_PCI_DEVICE_LOOKUP_CACHE_ENTRY  *CacheEntry;
+
+  //
+  // SetAccessAttribute() is called for every DMA mapping, look up the recent
+  // sources in the cache before scanning the device list of all VTd engines.
+  //
+  CacheEntry = GetPciDeviceLookupCacheEntry (Segment, SourceId);
+  if (CacheEntry->Valid &&
+      (CacheEntry->Segment == Segment) &&
+      (CacheEntry->SourceId.Uint16 == SourceId.Uint16)) {
+    *ExtContextEntry = CacheEntry->ExtContextEntry;
+    *ContextEntry    = CacheEntry->ContextEntry;
+    if (PciDataIndex != NULL) {
+      *PciDataIndex = CacheEntry->PciDataIndex;
+    }
+    return CacheEntry->VtdIndex;
+  }
 
   for (VtdIndex = 0; VtdIndex < mVtdUnitNumber; VtdIndex++) {
     if (Segment != mVtdUnitInformation[VtdIndex].Segment) {
       continue;
     }
 
-    PciDataIndex = GetPciDataIndex (VtdIndex, Segment, SourceId);
-    if (PciDataIndex == (UINTN)-1) {
+    ThisPciDataIndex = GetPciDataIndex (VtdIndex, Segment, SourceId);
+    if (ThisPciDataIndex == (UINTN)-1) {
       continue;
     }
 
@@ -410,6 +482,17 @@ FindVtdIndexByPciDevice (
       *ContextEntry    = ThisContextEntry;
     }
 
+    CacheEntry->Valid           = TRUE;
+    CacheEntry->Segment         = Segment;
+    CacheEntry->SourceId.Uint16 = SourceId.Uint16;
+    CacheEntry->VtdIndex        = VtdIndex;
+    CacheEntry->PciDataIndex    = ThisPciDataIndex;
+    CacheEntry->ExtContextEntry = *ExtContextEntry;
+    CacheEntry->ContextEntry    = *ContextEntry;
+
+    if (PciDataIndex != NULL) {
+      *PciDataIndex = ThisPciDataIndex;
+    }
     return VtdIndex;
   }
 
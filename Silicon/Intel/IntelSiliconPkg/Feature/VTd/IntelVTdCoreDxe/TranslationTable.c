@@ -496,6 +496,10 @@ DumpSecondLevelPagingEntry (
 /**
   Invalid page entry.
 
+  If only DMA access revocations are pending, the invalidation is deferred until
+  PcdVTdDeferredInvalidationThreshold revocations are accumulated or the caller
+  restores the TPL below TPL_CALLBACK, whichever comes first.
+
   @param VtdIndex  The VTd engine index.
 **/
 VOID
@@ -503,11 +507,52 @@ InvalidatePageEntry (
   IN UINTN                 VtdIndex
   )
 {
-  if (mVtdUnitInformation[VtdIndex].HasDirtyContext || mVtdUnitInformation[VtdIndex].HasDirtyPages) {
+  VTD_UNIT_INFORMATION  *VtdUnitInfo;
+
+  VtdUnitInfo = &mVtdUnitInformation[VtdIndex];
+
+  if (VtdUnitInfo->HasDeferredPages && !VtdUnitInfo->HasDirtyContext && !VtdUnitInfo->HasDirtyPages &&
+      (mVtdDeferredInvalidationEvent != NULL)) {
+    VtdUnitInfo->DeferredInvalidationCount++;
+    if (VtdUnitInfo->DeferredInvalidationCount < PcdGet32 (PcdVTdDeferredInvalidationThreshold)) {
+      gBS->SignalEvent (mVtdDeferredInvalidationEvent);
+      return;
+    }
+  }
+
+  if (VtdUnitInfo->HasDirtyContext || VtdUnitInfo->HasDirtyPages || VtdUnitInfo->HasDeferredPages) {
     InvalidateVtdIOTLBGlobal (VtdIndex);
   }
-  mVtdUnitInformation[VtdIndex].HasDirtyContext = FALSE;
-  mVtdUnitInformation[VtdIndex].HasDirtyPages = FALSE;
+  VtdUnitInfo->HasDirtyContext = FALSE;
+  VtdUnitInfo->HasDirtyPages = FALSE;
+  VtdUnitInfo->HasDeferredPages = FALSE;
+  VtdUnitInfo->DeferredInvalidationCount = 0;
+}
+
+/**
+  Invalidate the IOTLB for the deferred DMA access revocations of all VTd engines.
+
+  The TPL is raised to VTD_TPL_LEVEL, so that VTdSetAttribute can't defer a new
+  revocation or submit to the invalidation queue in the middle of the flush.
+**/
+VOID
+FlushDeferredInvalidation (
+  VOID
+  )
+{
+  UINTN    VtdIndex;
+  EFI_TPL  OriginalTpl;
+
+  OriginalTpl = gBS->RaiseTPL (VTD_TPL_LEVEL);
+
+  for (VtdIndex = 0; VtdIndex < mVtdUnitNumber; VtdIndex++) {
+    if (mVtdUnitInformation[VtdIndex].HasDeferredPages) {
+      mVtdUnitInformation[VtdIndex].HasDirtyPages = TRUE;
+      InvalidatePageEntry (VtdIndex);
+    }
+  }
+
+  gBS->RestoreTPL (OriginalTpl);
 }
 
 #define VTD_PG_R                   BIT0
@@ -824,6 +869,45 @@ SplitSecondLevelPage (
   }
 }
 
+/**
+  Record the modification of a second level page entry.
+
+  With CM clear the VTd engine does not cache not-present entries, so granting
+  access to a not-present entry needs no invalidation unless a revocation of the
+  same VTd engine is still deferred. A revocation may be deferred, the stale IOTLB
+  entry only grants access the device had before. Any other modification must be
+  invalidated before the device uses the entry.
+
+  @param[in]  VtdIndex          The index used to identify a VTd engine.
+  @param[in]  OldAccess         The R/W bits of the page entry before the modification.
+  @param[in]  NewAccess         The R/W bits of the page entry after the modification.
+**/
+VOID
+MarkPageEntryDirty (
+  IN UINTN   VtdIndex,
+  IN UINT64  OldAccess,
+  IN UINT64  NewAccess
+  )
+{
+  VTD_UNIT_INFORMATION  *VtdUnitInfo;
+
+  VtdUnitInfo = &mVtdUnitInformation[VtdIndex];
+
+  if ((OldAccess == 0) && (VtdUnitInfo->CapReg.Bits.CM == 0) && (VtdUnitInfo->CapReg.Bits.RWBF == 0)) {
+    if (VtdUnitInfo->HasDeferredPages) {
+      VtdUnitInfo->HasDirtyPages = TRUE;
+    }
+    return;
+  }
+
+  if (((NewAccess & ~OldAccess) == 0) && (PcdGet32 (PcdVTdDeferredInvalidationThreshold) != 0)) {
+    VtdUnitInfo->HasDeferredPages = TRUE;
+    return;
+  }
+
+  VtdUnitInfo->HasDirtyPages = TRUE;
+}
+
 /**
   Set VTd attribute for a system memory on second level page entry
 
@@ -860,6 +944,7 @@ SetSecondLevelPagingAttribute (
   PAGE_ATTRIBUTE                 SplitAttribute;
   EFI_STATUS                     Status;
   BOOLEAN                        IsEntryModified;
+  UINT64                         OldAccess;
 
   DEBUG ((DEBUG_VERBOSE,"SetSecondLevelPagingAttribute (%d) (0x%016lx - 0x%016lx : %x) \n", VtdIndex, BaseAddress, Length, IoMmuAccess));
   DEBUG ((DEBUG_VERBOSE,"  SecondLevelPagingEntry Base - 0x%x\n", SecondLevelPagingEntry));
@@ -882,9 +967,10 @@ SetSecondLevelPagingAttribute (
     PageEntryLength = PageAttributeToLength (PageAttribute);
     SplitAttribute = NeedSplitPage (BaseAddress, Length, PageAttribute);
     if (SplitAttribute == PageNone) {
+      OldAccess = PageEntry->Uint64 & (VTD_PG_R | VTD_PG_W);
       ConvertSecondLevelPageEntryAttribute (VtdIndex, PageEntry, IoMmuAccess, &IsEntryModified);
       if (IsEntryModified) {
-        mVtdUnitInformation[VtdIndex].HasDirtyPages = TRUE;
+        MarkPageEntryDirty (VtdIndex, OldAccess, PageEntry->Uint64 & (VTD_PG_R | VTD_PG_W));
       }
       //
       // Convert success, move to next
@@ -987,13 +1073,12 @@ SetAccessAttribute (
 
   DEBUG ((DEBUG_VERBOSE,"SetAccessAttribute (S%04x B%02x D%02x F%02x) (0x%016lx - 0x%08x, %x)\n", Segment, SourceId.Bits.Bus, SourceId.Bits.Device, SourceId.Bits.Function, BaseAddress, (UINTN)Length, IoMmuAccess));
 
-  VtdIndex = FindVtdIndexByPciDevice (Segment, SourceId, &ExtContextEntry, &ContextEntry);
+  VtdIndex = FindVtdIndexByPciDevice (Segment, SourceId, &ExtContextEntry, &ContextEntry, &PciDataIndex);
   if (VtdIndex == (UINTN)-1) {
     DEBUG ((DEBUG_ERROR,"SetAccessAttribute - Pci device (S%04x B%02x D%02x F%02x) not found!\n", Segment, SourceId.Bits.Bus, SourceId.Bits.Device, SourceId.Bits.Function));
     return EFI_DEVICE_ERROR;
   }
 
-  PciDataIndex = GetPciDataIndex (VtdIndex, Segment, SourceId);
   mVtdUnitInformation[VtdIndex].PciDeviceInfo->PciDeviceData[PciDataIndex].AccessCount++;
   //
   // DomainId should not be 0.
@@ -1081,7 +1166,7 @@ AlwaysEnablePageAttribute (
 
   DEBUG ((DEBUG_INFO,"AlwaysEnablePageAttribute (S%04x B%02x D%02x F%02x)\n", Segment, SourceId.Bits.Bus, SourceId.Bits.Device, SourceId.Bits.Function));
 
-  VtdIndex = FindVtdIndexByPciDevice (Segment, SourceId, &ExtContextEntry, &ContextEntry);
+  VtdIndex = FindVtdIndexByPciDevice (Segment, SourceId, &ExtContextEntry, &ContextEntry, NULL);
   if (VtdIndex == (UINTN)-1) {
     DEBUG ((DEBUG_ERROR,"AlwaysEnablePageAttribute - Pci device (S%04x B%02x D%02x F%02x) not found!\n", Segment, SourceId.Bits.Bus, SourceId.Bits.Device, SourceId.Bits.Function));
     return EFI_DEVICE_ERROR;
@@ -281,7 +281,8 @@ InvalidateVtdIOTLBGlobal (
   //
   // Invalidate the IOTLB cache
   //
-  if (mVtdUnitInformation[VtdIndex].HasDirtyContext || mVtdUnitInformation[VtdIndex].HasDirtyPages) {
+  if (mVtdUnitInformation[VtdIndex].HasDirtyContext || mVtdUnitInformation[VtdIndex].HasDirtyPages ||
+      mVtdUnitInformation[VtdIndex].HasDeferredPages) {
     InvalidateIOTLB (VtdIndex);
   }
 
@@ -465,6 +465,12 @@ struct _DATABASE_RECORD {
   /// Indicate the PCH SMI types.
   ///
   PCH_SMI_TYPES                 PchSmiType;
+  ///
+  /// Dispatch statistics. The cycles are counted in TSC ticks.
+  ///
+  UINT64                        DispatchCount;
+  UINT64                        DispatchCycles;
+  UINT64                        MaxDispatchCycles;
 };
 
 #define DATABASE_RECORD_FROM_LINK(_record)  CR (_record, DATABASE_RECORD, Link, DATABASE_RECORD_SIGNATURE)
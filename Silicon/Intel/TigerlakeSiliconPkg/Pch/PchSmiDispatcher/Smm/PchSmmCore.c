@@ -14,6 +14,38 @@
 #include <Register/RtcRegs.h>
 
 #define PROGRESS_CODE_S3_SUSPEND_START  PcdGet32 (PcdProgressCodeS3SuspendStart)
+
+//
+// The source index has a bucket for each bit of SMI_STS, and one more bucket
+// for the sources whose top level status is not in SMI_STS.
+//
+#define SOURCE_INDEX_SMI_STS_BUCKETS    32
+#define SOURCE_INDEX_UNINDEXED_BUCKET   SOURCE_INDEX_SMI_STS_BUCKETS
+#define SOURCE_INDEX_BUCKETS            (SOURCE_INDEX_SMI_STS_BUCKETS + 1)
+
+///
+/// The records with identical source descriptions, in database order.
+/// They are dispatched together when the source is active.
+///
+typedef struct {
+  DATABASE_RECORD     **Records;
+  UINTN               RecordCount;
+} SOURCE_GROUP;
+
+///
+/// Index from the SMI status bits to the source groups that can fire on them.
+/// It is built at SmmReadyToLock, when the database can no longer change.
+///
+typedef struct {
+  BOOLEAN             Valid;
+  UINT32              SmiStsMask;
+  UINTN               GroupCount;
+  SOURCE_GROUP        *Groups;
+  DATABASE_RECORD     **Records;
+  UINTN               *BucketGroups;
+  UINTN               BucketStart[SOURCE_INDEX_BUCKETS + 1];
+} SOURCE_INDEX;
+
 //
 // MODULE / GLOBAL DATA
 //
@@ -24,6 +56,7 @@ GLOBAL_REMOVE_IF_UNREFERENCED UINT16                mAcpiBaseAddr;
 GLOBAL_REMOVE_IF_UNREFERENCED UINT16                mTcoBaseAddr;
 GLOBAL_REMOVE_IF_UNREFERENCED BOOLEAN               mReadyToLock;
 GLOBAL_REMOVE_IF_UNREFERENCED BOOLEAN               mS3SusStart;
+GLOBAL_REMOVE_IF_UNREFERENCED SOURCE_INDEX          mSourceIndex;
 
 GLOBAL_REMOVE_IF_UNREFERENCED PRIVATE_DATA          mPrivateData = {
   {
@@ -146,6 +179,156 @@ PchSmmCoreDispatcher (
 //
 // FUNCTIONS
 //
+/**
+  Return the source index bucket of a source description.
+
+  @param[in] SrcDesc              Pointer to the PCH SMI source description
+
+  @return The bit of the top level status in SMI_STS, or SOURCE_INDEX_UNINDEXED_BUCKET.
+**/
+STATIC
+UINTN
+GetSourceIndexBucket (
+  CONST PCH_SMM_SOURCE_DESC  *SrcDesc
+  )
+{
+  if (!IS_BIT_DESC_NULL (SrcDesc->PmcSmiSts) &&
+      (SrcDesc->PmcSmiSts.Reg.Type == ACPI_ADDR_TYPE) &&
+      (SrcDesc->PmcSmiSts.Reg.Data.acpi == R_ACPI_IO_SMI_STS) &&
+      (SrcDesc->PmcSmiSts.Bit < SOURCE_INDEX_SMI_STS_BUCKETS)) {
+    return SrcDesc->PmcSmiSts.Bit;
+  }
+  return SOURCE_INDEX_UNINDEXED_BUCKET;
+}
+
+/**
+  Build the source index of the callback database.
+  The dispatcher walks the database instead if the index cannot be built.
+**/
+STATIC
+VOID
+BuildSourceIndex (
+  VOID
+  )
+{
+  EFI_STATUS          Status;
+  LIST_ENTRY          *LinkInDb;
+  DATABASE_RECORD     **RecordArray;
+  UINTN               *GroupOfRecord;
+  UINTN               RecordCount;
+  UINTN               RecordIndex;
+  UINTN               GroupIndex;
+  UINTN               Offset;
+  UINTN               Bucket;
+  SOURCE_GROUP        *Group;
+
+  mSourceIndex.Valid = FALSE;
+
+  RecordCount = 0;
+  for (LinkInDb = GetFirstNode (&mPrivateData.CallbackDataBase);
+       !IsNull (&mPrivateData.CallbackDataBase, LinkInDb);
+       LinkInDb = GetNextNode (&mPrivateData.CallbackDataBase, LinkInDb)) {
+    RecordCount++;
+  }
+  if (RecordCount == 0) {
+    return;
+  }
+
+  RecordArray   = NULL;
+  GroupOfRecord = NULL;
+  Status = gSmst->SmmAllocatePool (EfiRuntimeServicesData, RecordCount * sizeof (SOURCE_GROUP), (VOID **) &mSourceIndex.Groups);
+  if (!EFI_ERROR (Status)) {
+    Status = gSmst->SmmAllocatePool (EfiRuntimeServicesData, RecordCount * sizeof (DATABASE_RECORD *), (VOID **) &mSourceIndex.Records);
+  }
+  if (!EFI_ERROR (Status)) {
+    Status = gSmst->SmmAllocatePool (EfiRuntimeServicesData, RecordCount * sizeof (UINTN), (VOID **) &mSourceIndex.BucketGroups);
+  }
+  if (!EFI_ERROR (Status)) {
+    Status = gSmst->SmmAllocatePool (EfiRuntimeServicesData, RecordCount * sizeof (DATABASE_RECORD *), (VOID **) &RecordArray);
+  }
+  if (!EFI_ERROR (Status)) {
+    Status = gSmst->SmmAllocatePool (EfiRuntimeServicesData, RecordCount * sizeof (UINTN), (VOID **) &GroupOfRecord);
+  }
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "PchSmiDispatcher: Failed to build the source index - %r\n", Status));
+    goto Done;
+  }
+
+  //
+  // Group the records with identical source descriptions. The groups are
+  // ordered by their first record, so the index keeps the database order.
+  //
+  ZeroMem (mSourceIndex.Groups, RecordCount * sizeof (SOURCE_GROUP));
+  mSourceIndex.GroupCount = 0;
+  RecordIndex = 0;
+  for (LinkInDb = GetFirstNode (&mPrivateData.CallbackDataBase);
+       !IsNull (&mPrivateData.CallbackDataBase, LinkInDb);
+       LinkInDb = GetNextNode (&mPrivateData.CallbackDataBase, LinkInDb)) {
+    RecordArray[RecordIndex] = DATABASE_RECORD_FROM_LINK (LinkInDb);
+    for (GroupIndex = 0; GroupIndex < mSourceIndex.GroupCount; GroupIndex++) {
+      if (CompareSources (&mSourceIndex.Groups[GroupIndex].Records[0]->SrcDesc, &RecordArray[RecordIndex]->SrcDesc)) {
+        break;
+      }
+    }
+    if (GroupIndex == mSourceIndex.GroupCount) {
+      mSourceIndex.Groups[GroupIndex].Records = &RecordArray[RecordIndex];
+      mSourceIndex.GroupCount++;
+    }
+    mSourceIndex.Groups[GroupIndex].RecordCount++;
+    GroupOfRecord[RecordIndex] = GroupIndex;
+    RecordIndex++;
+  }
+
+  Offset = 0;
+  for (GroupIndex = 0; GroupIndex < mSourceIndex.GroupCount; GroupIndex++) {
+    Group              = &mSourceIndex.Groups[GroupIndex];
+    Group->Records     = &mSourceIndex.Records[Offset];
+    Offset            += Group->RecordCount;
+    Group->RecordCount = 0;
+  }
+  for (RecordIndex = 0; RecordIndex < RecordCount; RecordIndex++) {
+    Group = &mSourceIndex.Groups[GroupOfRecord[RecordIndex]];
+    Group->Records[Group->RecordCount] = RecordArray[RecordIndex];
+    Group->RecordCount++;
+  }
+
+  //
+  // Sort the groups into the buckets, keeping the group order in each bucket.
+  //
+  ZeroMem (mSourceIndex.BucketStart, sizeof (mSourceIndex.BucketStart));
+  mSourceIndex.SmiStsMask = 0;
+  for (GroupIndex = 0; GroupIndex < mSourceIndex.GroupCount; GroupIndex++) {
+    Bucket = GetSourceIndexBucket (&mSourceIndex.Groups[GroupIndex].Records[0]->SrcDesc);
+    if (Bucket != SOURCE_INDEX_UNINDEXED_BUCKET) {
+      mSourceIndex.SmiStsMask |= (1u << Bucket);
+    }
+    mSourceIndex.BucketStart[Bucket + 1]++;
+  }
+  for (Bucket = 0; Bucket < SOURCE_INDEX_BUCKETS; Bucket++) {
+    mSourceIndex.BucketStart[Bucket + 1] += mSourceIndex.BucketStart[Bucket];
+  }
+  for (GroupIndex = 0; GroupIndex < mSourceIndex.GroupCount; GroupIndex++) {
+    Bucket = GetSourceIndexBucket (&mSourceIndex.Groups[GroupIndex].Records[0]->SrcDesc);
+    mSourceIndex.BucketGroups[mSourceIndex.BucketStart[Bucket]] = GroupIndex;
+    mSourceIndex.BucketStart[Bucket]++;
+  }
+  for (Bucket = SOURCE_INDEX_BUCKETS; Bucket > 0; Bucket--) {
+    mSourceIndex.BucketStart[Bucket] = mSourceIndex.BucketStart[Bucket - 1];
+  }
+  mSourceIndex.BucketStart[0] = 0;
+
+  mSourceIndex.Valid = TRUE;
+  DEBUG ((DEBUG_INFO, "PchSmiDispatcher: %d records in %d sources indexed\n", RecordCount, mSourceIndex.GroupCount));
+
+Done:
+  if (RecordArray != NULL) {
+    gSmst->SmmFreePool (RecordArray);
+  }
+  if (GroupOfRecord != NULL) {
+    gSmst->SmmFreePool (GroupOfRecord);
+  }
+}
+
 /**
   SMM ready to lock notification event handler.
 
@@ -166,6 +349,8 @@ SmmReadyToLockCallback (
 {
   mReadyToLock = TRUE;
 
+  BuildSourceIndex ();
+
   return EFI_SUCCESS;
 }
 
@@ -310,6 +495,7 @@ SmmCoreInsertRecord (
   // After ensuring the source of event is not null, we will insert the record into the database
   //
   InsertTailList (&mPrivateData.CallbackDataBase, &Record->Link);
+  mSourceIndex.Valid = FALSE;
 
   //
   // Child's handle will be the address linked list link in the record
@@ -583,6 +769,7 @@ PchSmmCoreUnRegister (
   }
 
   RemoveEntryList (&RecordToDelete->Link);
+  mSourceIndex.Valid = FALSE;
 
   //
   // Loop through all the souces in record linked list to see if any source enable is equal.
@@ -659,6 +846,214 @@ ClearPendingSmiStatus (
   }
 }
 
+/**
+  Dispatch a database record whose source is active, and account the cycles
+  spent in its callback function.
+
+  @param[in]      Record                The record to dispatch.
+  @param[in, out] SxChildWasDispatched  Set to TRUE if a child of SmmSxDispatch protocol is dispatched.
+**/
+STATIC
+VOID
+DispatchRecord (
+  IN     DATABASE_RECORD  *Record,
+  IN OUT BOOLEAN          *SxChildWasDispatched
+  )
+{
+  BOOLEAN             ContextsMatch;
+  PCH_SMM_CONTEXT     Context;
+  VOID                *CommBuffer;
+  UINTN               CommBufferSize;
+  UINT64              StartTsc;
+  UINT64              Cycles;
+
+  if (Record->ContextFunctions.GetContext != NULL) {
+    //
+    // This child requires that we get a calling context from
+    // hardware and compare that context to the one supplied
+    // by the child.
+    //
+    ASSERT (Record->ContextFunctions.CmpContext != NULL);
+
+    //
+    // Make sure contexts match before dispatching event to child
+    //
+    Record->ContextFunctions.GetContext (Record, &Context);
+    ContextsMatch = Record->ContextFunctions.CmpContext (&Context, &Record->ChildContext);
+
+  } else {
+    //
+    // This child doesn't require any more calling context beyond what
+    // it supplied in registration.  Simply pass back what it gave us.
+    //
+    Context       = Record->ChildContext;
+    ContextsMatch = TRUE;
+  }
+
+  if (!ContextsMatch) {
+    return;
+  }
+
+  StartTsc = AsmReadTsc ();
+  if (Record->ProtocolType == PchSmiDispatchType) {
+    //
+    // For PCH SMI dispatch protocols
+    //
+    PchSmiTypeCallbackDispatcher (Record);
+  } else {
+    if ((Record->ProtocolType == SxType) && (Context.Sx.Type == SxS3) && (Context.Sx.Phase == SxEntry) && !mS3SusStart) {
+      REPORT_STATUS_CODE (EFI_PROGRESS_CODE, PROGRESS_CODE_S3_SUSPEND_START);
+      mS3SusStart = TRUE;
+    }
+    //
+    // For EFI standard SMI dispatch protocols
+    //
+    if (Record->Callback != NULL) {
+      if (Record->ContextFunctions.GetCommBuffer != NULL) {
+        //
+        // This callback function needs CommBuffer and CommBufferSize.
+        // Get those from child and then pass to callback function.
+        //
+        Record->ContextFunctions.GetCommBuffer (Record, &CommBuffer, &CommBufferSize);
+      } else {
+        //
+        // Child doesn't support the CommBuffer and CommBufferSize.
+        // Just pass NULL value to callback function.
+        //
+        CommBuffer     = NULL;
+        CommBufferSize = 0;
+      }
+
+      PERF_START_EX (NULL, "SmmFunction", NULL, AsmReadTsc (), Record->ProtocolType);
+      Record->Callback ((EFI_HANDLE) & Record->Link, &Context, CommBuffer, &CommBufferSize);
+      PERF_END_EX (NULL, "SmmFunction", NULL, AsmReadTsc (), Record->ProtocolType);
+      if (Record->ProtocolType == SxType) {
+        *SxChildWasDispatched = TRUE;
+      }
+    } else {
+      ASSERT (FALSE);
+    }
+  }
+
+  Cycles = AsmReadTsc () - StartTsc;
+  Record->DispatchCount++;
+  Record->DispatchCycles += Cycles;
+  if (Cycles > Record->MaxDispatchCycles) {
+    Record->MaxDispatchCycles = Cycles;
+  }
+}
+
+/**
+  Look for the first active source group of a source index bucket.
+
+  @param[in] Bucket               The source index bucket.
+  @param[in] FirstActiveGroup     The first active source group found so far, or MAX_UINTN.
+  @param[in] SciEn                Indicate if SCI is enabled or not
+  @param[in] SmiEnValue           Value from R_ACPI_IO_SMI_EN
+  @param[in] SmiStsValue          Value from R_ACPI_IO_SMI_STS
+
+  @return The index of the first active source group found so far, or MAX_UINTN.
+**/
+STATIC
+UINTN
+FindActiveGroupInBucket (
+  IN UINTN    Bucket,
+  IN UINTN    FirstActiveGroup,
+  IN BOOLEAN  SciEn,
+  IN UINT32   SmiEnValue,
+  IN UINT32   SmiStsValue
+  )
+{
+  UINTN  Index;
+  UINTN  GroupIndex;
+
+  for (Index = mSourceIndex.BucketStart[Bucket]; Index < mSourceIndex.BucketStart[Bucket + 1]; Index++) {
+    GroupIndex = mSourceIndex.BucketGroups[Index];
+    if (GroupIndex >= FirstActiveGroup) {
+      //
+      // The groups are in database order, a source found in another bucket comes first.
+      //
+      break;
+    }
+    if (SourceIsActive (&mSourceIndex.Groups[GroupIndex].Records[0]->SrcDesc, SciEn, SmiEnValue, SmiStsValue)) {
+      return GroupIndex;
+    }
+  }
+  return FirstActiveGroup;
+}
+
+/**
+  Look for the first active source group in database order. Only the groups
+  whose top level status is set in SMI_STS, and the unindexed ones, are checked.
+
+  @param[in] SciEn                Indicate if SCI is enabled or not
+  @param[in] SmiEnValue           Value from R_ACPI_IO_SMI_EN
+  @param[in] SmiStsValue          Value from R_ACPI_IO_SMI_STS
+
+  @return The first active source group, or NULL if no source is active.
+**/
+STATIC
+SOURCE_GROUP *
+FindActiveSourceGroup (
+  IN BOOLEAN  SciEn,
+  IN UINT32   SmiEnValue,
+  IN UINT32   SmiStsValue
+  )
+{
+  UINT32  PendingSts;
+  UINTN   Bit;
+  UINTN   FirstActiveGroup;
+
+  FirstActiveGroup = MAX_UINTN;
+  PendingSts       = SmiStsValue & mSourceIndex.SmiStsMask;
+  while (PendingSts != 0) {
+    Bit              = (UINTN) LowBitSet32 (PendingSts);
+    PendingSts      &= ~(1u << Bit);
+    FirstActiveGroup = FindActiveGroupInBucket (Bit, FirstActiveGroup, SciEn, SmiEnValue, SmiStsValue);
+  }
+  FirstActiveGroup = FindActiveGroupInBucket (SOURCE_INDEX_UNINDEXED_BUCKET, FirstActiveGroup, SciEn, SmiEnValue, SmiStsValue);
+
+  if (FirstActiveGroup == MAX_UINTN) {
+    return NULL;
+  }
+  return &mSourceIndex.Groups[FirstActiveGroup];
+}
+
+/**
+  Dump the dispatch statistics of the records. The callback addresses match
+  the handler addresses reported by the SMI handler profile.
+**/
+STATIC
+VOID
+DumpDispatchStatistics (
+  VOID
+  )
+{
+  LIST_ENTRY          *LinkInDb;
+  DATABASE_RECORD     *RecordInDb;
+
+  DEBUG_CODE_BEGIN ();
+  DEBUG ((DEBUG_INFO, "PchSmiDispatcher: Type Callback Count TotalCycles MaxCycles\n"));
+  for (LinkInDb = GetFirstNode (&mPrivateData.CallbackDataBase);
+       !IsNull (&mPrivateData.CallbackDataBase, LinkInDb);
+       LinkInDb = GetNextNode (&mPrivateData.CallbackDataBase, LinkInDb)) {
+    RecordInDb = DATABASE_RECORD_FROM_LINK (LinkInDb);
+    if (RecordInDb->DispatchCount == 0) {
+      continue;
+    }
+    DEBUG ((
+      DEBUG_INFO,
+      "  %d 0x%p %ld %ld %ld\n",
+      RecordInDb->ProtocolType,
+      (RecordInDb->ProtocolType == PchSmiDispatchType) ? (VOID *) RecordInDb->PchSmiCallback : (VOID *) RecordInDb->Callback,
+      RecordInDb->DispatchCount,
+      RecordInDb->DispatchCycles,
+      RecordInDb->MaxDispatchCycles
+      ));
+  }
+  DEBUG_CODE_END ();
+}
+
 /**
   The callback function to handle subsequent SMIs.  This callback will be called by SmmCoreDispatcher.
 
@@ -683,7 +1078,6 @@ PchSmmCoreDispatcher (
   //
   UINTN               EscapeCount;
 
-  BOOLEAN             ContextsMatch;
   BOOLEAN             EosSet;
   BOOLEAN             SxChildWasDispatched;
 
@@ -691,10 +1085,8 @@ PchSmmCoreDispatcher (
   LIST_ENTRY          *LinkInDb;
   DATABASE_RECORD     *RecordToExhaust;
   LIST_ENTRY          *LinkToExhaust;
-
-  PCH_SMM_CONTEXT     Context;
-  VOID                *CommBuffer;
-  UINTN               CommBufferSize;
+  SOURCE_GROUP        *ActiveGroup;
+  UINTN               RecordIndex;
 
   EFI_STATUS          Status;
   BOOLEAN             SciEn;
@@ -711,7 +1103,6 @@ PchSmmCoreDispatcher (
   NullInitSourceDesc (&ActiveSource);
 
   EscapeCount           = 3;
-  ContextsMatch         = FALSE;
   EosSet                = FALSE;
   SxChildWasDispatched  = FALSE;
   Status                = EFI_SUCCESS;
@@ -725,7 +1116,66 @@ PchSmmCoreDispatcher (
   Port76Save = IoRead8 (R_RTC_IO_EXT_INDEX_ALT);
   Port74Save = IoRead8 (R_RTC_IO_INDEX_ALT);
 
-  if (!IsListEmpty (&mPrivateData.CallbackDataBase)) {
+  if (!IsListEmpty (&mPrivateData.CallbackDataBase) && mSourceIndex.Valid) {
+    //
+    // The database is locked and indexed, only the sources whose top level
+    // status is set are checked.
+    //
+    while ((!EosSet) && (EscapeCount > 0)) {
+      EscapeCount--;
+
+      //
+      // Cache SciEn, SmiEnValue and SmiStsValue to determine if source is active
+      //
+      SciEn       = PchSmmGetSciEn ();
+      SmiEnValue  = IoRead32 ((UINTN) (mAcpiBaseAddr + R_ACPI_IO_SMI_EN));
+      SmiStsValue = IoRead32 ((UINTN) (mAcpiBaseAddr + R_ACPI_IO_SMI_STS));
+
+      ActiveGroup = FindActiveSourceGroup (SciEn, SmiEnValue, SmiStsValue);
+      if (ActiveGroup != NULL) {
+        RecordInDb = ActiveGroup->Records[0];
+        //
+        // We found a source. If this is a sleep type, we have to go to
+        // appropriate sleep state anyway.No matter there is sleep child or not
+        //
+        if (RecordInDb->ProtocolType == SxType) {
+          SxChildWasDispatched = TRUE;
+        }
+        CopyMem ((VOID *) &ActiveSource, (VOID *) &(RecordInDb->SrcDesc), sizeof (PCH_SMM_SOURCE_DESC));
+
+        for (RecordIndex = 0; RecordIndex < ActiveGroup->RecordCount; RecordIndex++) {
+          //
+          // A callback function that unregisters a child invalidates the index,
+          // the remaining records of the group might have been freed.
+          //
+          if (!mSourceIndex.Valid) {
+            break;
+          }
+          DispatchRecord (ActiveGroup->Records[RecordIndex], &SxChildWasDispatched);
+        }
+
+        if (RecordInDb->ClearSource == NULL) {
+          //
+          // Clear the SMI associated w/ the source using the default function
+          //
+          PchSmmClearSource (&ActiveSource);
+        } else {
+          //
+          // This source requires special handling to clear
+          //
+          RecordInDb->ClearSource (&ActiveSource);
+        }
+      }
+      //
+      // Clear pending SMI status before EOS
+      //
+      ClearPendingSmiStatus (SmiStsValue, SciEn);
+      //
+      // Also, try to clear EOS
+      //
+      EosSet = PchSmmSetAndCheckEos ();
+    }
+  } else if (!IsListEmpty (&mPrivateData.CallbackDataBase)) {
     //
     // We have children registered w/ us -- continue
     //
@@ -794,70 +1244,7 @@ PchSmmCoreDispatcher (
               // These source descriptions are equal, so this callback should be
               // dispatched.
               //
-              if (RecordToExhaust->ContextFunctions.GetContext != NULL) {
-                //
-                // This child requires that we get a calling context from
-                // hardware and compare that context to the one supplied
-                // by the child.
-                //
-                ASSERT (RecordToExhaust->ContextFunctions.CmpContext != NULL);
-
-                //
-                // Make sure contexts match before dispatching event to child
-                //
-                RecordToExhaust->ContextFunctions.GetContext (RecordToExhaust, &Context);
-                ContextsMatch = RecordToExhaust->ContextFunctions.CmpContext (&Context, &RecordToExhaust->ChildContext);
-
-              } else {
-                //
-                // This child doesn't require any more calling context beyond what
-                // it supplied in registration.  Simply pass back what it gave us.
-                //
-                Context       = RecordToExhaust->ChildContext;
-                ContextsMatch = TRUE;
-              }
-
-              if (ContextsMatch) {
-                if (RecordToExhaust->ProtocolType == PchSmiDispatchType) {
-                  //
-                  // For PCH SMI dispatch protocols
-                  //
-                  PchSmiTypeCallbackDispatcher (RecordToExhaust);
-                } else {
-                  if ((RecordToExhaust->ProtocolType == SxType) && (Context.Sx.Type == SxS3) && (Context.Sx.Phase == SxEntry) && !mS3SusStart) {
-                    REPORT_STATUS_CODE (EFI_PROGRESS_CODE, PROGRESS_CODE_S3_SUSPEND_START);
-                    mS3SusStart = TRUE;
-                  }
-                  //
-                  // For EFI standard SMI dispatch protocols
-                  //
-                  if (RecordToExhaust->Callback != NULL) {
-                    if (RecordToExhaust->ContextFunctions.GetCommBuffer != NULL) {
-                      //
-                      // This callback function needs CommBuffer and CommBufferSize.
-                      // Get those from child and then pass to callback function.
-                      //
-                      RecordToExhaust->ContextFunctions.GetCommBuffer (RecordToExhaust, &CommBuffer, &CommBufferSize);
-                    } else {
-                      //
-                      // Child doesn't support the CommBuffer and CommBufferSize.
-                      // Just pass NULL value to callback function.
-                      //
-                      CommBuffer     = NULL;
-                      CommBufferSize = 0;
-                    }
-
-                    PERF_START_EX (NULL, "SmmFunction", NULL, AsmReadTsc (), RecordToExhaust->ProtocolType);
-                    RecordToExhaust->Callback ((EFI_HANDLE) & RecordToExhaust->Link, &Context, CommBuffer, &CommBufferSize);
-                    PERF_END_EX (NULL, "SmmFunction", NULL, AsmReadTsc (), RecordToExhaust->ProtocolType);
-                    if (RecordToExhaust->ProtocolType == SxType) {
-                      SxChildWasDispatched = TRUE;
-                    }
-                  } else {
-                    ASSERT (FALSE);
-                  }
-                }
-              }
+              DispatchRecord (RecordToExhaust, &SxChildWasDispatched);
             }
           }
 
@@ -908,6 +1295,7 @@ PchSmmCoreDispatcher (
   //  ASSERT (EscapeCount > 0);
   //
   if (SxChildWasDispatched) {
+    DumpDispatchStatistics ();
     //
     // A child of the SmmSxDispatch protocol was dispatched during this call;
     // put the system to sleep.
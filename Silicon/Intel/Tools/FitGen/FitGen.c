@@ -341,6 +341,42 @@ typedef struct {
 
 FIT_TABLE_CONTEXT   gFitTableContext = {0};
 
+//
+// Index of the FFS files in the FD, so a file is looked up by GUID
+// without scanning all the FVs again.
+//
+typedef struct {
+  BOOLEAN    Used;
+  EFI_GUID   Name;
+  UINT8      *Data;
+  UINT32     Size;
+} FFS_FILE_INDEX_ENTRY;
+
+typedef struct {
+  UINT8                   *Buffer;
+  UINT32                  BufferSize;
+  UINTN                   EntryMask;
+  FFS_FILE_INDEX_ENTRY    *Entry;
+} FFS_FILE_INDEX;
+
+FFS_FILE_INDEX      gFfsFileIndex = {0};
+
+//
+// Input files mapped to memory, which are unmapped instead of freed.
+//
+#define MAX_MAPPED_INPUT_FILE  4
+
+typedef struct {
+  UINT8   *Buffer;
+  UINTN   Size;
+  UINT8   *Data;
+  UINT32  DataSize;
+  UINT64  Device;
+  UINT64  Inode;
+} MAPPED_INPUT_FILE;
+
+MAPPED_INPUT_FILE   gMappedInputFile[MAX_MAPPED_INPUT_FILE] = {0};
+
 unsigned int
 xtoi (
   char  *str
@@ -623,13 +659,162 @@ GetFixedFitLocation (
   return FitLocation;
 }
 
+/**
+  Map input file to memory.
+
+  The file is mapped copy-on-write, so the data can be modified without
+  changing the file. As in the buffer allocated by ReadInputFile, the data
+  is 64K aligned and 0x10000 bytes follow it.
+
+  @param FpIn                        The input file.
+  @param FileSize                    The input file size.
+  @param FileData                    The mapped file data.
+  @param FileBufferRaw               The mapped memory.
+
+  @return STATUS_SUCCESS             The file is mapped.
+  @return STATUS_ERROR               The file is not mapped.
+**/
+STATUS
+MapInputFile (
+  IN FILE     *FpIn,
+  IN UINT32   FileSize,
+  OUT UINT8   **FileData,
+  OUT UINT8   **FileBufferRaw
+  )
+{
+#ifndef _WIN32
+  VOID                        *Map;
+  UINT8                       *Data;
+  UINTN                       MapSize;
+  UINTN                       Index;
+  struct stat                 FileStat;
+
+  if ((FileSize == 0) || (fstat (fileno (FpIn), &FileStat) != 0)) {
+    return STATUS_ERROR;
+  }
+
+  for (Index = 0; Index < MAX_MAPPED_INPUT_FILE; Index++) {
+    if (gMappedInputFile[Index].Buffer == NULL) {
+      break;
+    }
+  }
+  if (Index == MAX_MAPPED_INPUT_FILE) {
+    return STATUS_ERROR;
+  }
+
+  //
+  // Reserve an extra 64K to align the data like the malloc'ed buffer.
+  //
+  MapSize = (UINTN)FileSize + 0x20000;
+  Map = mmap (NULL, MapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (Map == MAP_FAILED) {
+    return STATUS_ERROR;
+  }
+  Data = (UINT8 *)(((UINTN)Map + 0xFFFF) & ~(UINTN)0xFFFF);
+  if (mmap (Data, FileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fileno (FpIn), 0) == MAP_FAILED) {
+    munmap (Map, MapSize);
+    return STATUS_ERROR;
+  }
+
+  gMappedInputFile[Index].Buffer   = (UINT8 *)Map;
+  gMappedInputFile[Index].Size     = MapSize;
+  gMappedInputFile[Index].Data     = Data;
+  gMappedInputFile[Index].DataSize = FileSize;
+  gMappedInputFile[Index].Device   = (UINT64)FileStat.st_dev;
+  gMappedInputFile[Index].Inode    = (UINT64)FileStat.st_ino;
+  *FileData      = Data;
+  *FileBufferRaw = (UINT8 *)Map;
+  return STATUS_SUCCESS;
+#else
+  return STATUS_ERROR;
+#endif
+}
+
+/**
+  Detach the memory of the input files mapped from a file from the file.
+
+  The file is about to be rewritten, which would change or discard the data
+  of a mapping that has not been copied yet. The data is copied to anonymous
+  memory at the same address, so the pointers into it stay valid.
+
+  @param FileName                    The file to be rewritten.
+
+  @return STATUS_SUCCESS             No mapped input file refers to the file any more.
+  @return STATUS_ERROR               The memory could not be detached from the file.
+**/
+STATUS
+DetachMappedInputFile (
+  IN CHAR8    *FileName
+  )
+{
+#ifndef _WIN32
+  struct stat                 FileStat;
+  UINTN                       Index;
+  UINT8                       *Copy;
+
+  if (stat (FileName, &FileStat) != 0) {
+    return STATUS_SUCCESS;
+  }
+
+  for (Index = 0; Index < MAX_MAPPED_INPUT_FILE; Index++) {
+    if ((gMappedInputFile[Index].Buffer == NULL) ||
+        (gMappedInputFile[Index].Device != (UINT64)FileStat.st_dev) ||
+        (gMappedInputFile[Index].Inode != (UINT64)FileStat.st_ino)) {
+      continue;
+    }
+
+    Copy = (UINT8 *) malloc (gMappedInputFile[Index].DataSize);
+    if (Copy == NULL) {
+      return STATUS_ERROR;
+    }
+    memcpy (Copy, gMappedInputFile[Index].Data, gMappedInputFile[Index].DataSize);
+    if (mmap (gMappedInputFile[Index].Data, gMappedInputFile[Index].DataSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) == MAP_FAILED) {
+      free (Copy);
+      return STATUS_ERROR;
+    }
+    memcpy (gMappedInputFile[Index].Data, Copy, gMappedInputFile[Index].DataSize);
+    free (Copy);
+
+    gMappedInputFile[Index].Device = 0;
+    gMappedInputFile[Index].Inode  = 0;
+  }
+#endif
+  return STATUS_SUCCESS;
+}
+
+/**
+  Free the memory holding input file data.
+
+  @param FileBufferRaw               The memory returned by ReadInputFile.
+**/
+VOID
+FreeInputFile (
+  IN UINT8    *FileBufferRaw
+  )
+{
+  UINTN                       Index;
+
+  for (Index = 0; Index < MAX_MAPPED_INPUT_FILE; Index++) {
+    if ((FileBufferRaw != NULL) && (gMappedInputFile[Index].Buffer == FileBufferRaw)) {
+#ifndef _WIN32
+      munmap (FileBufferRaw, gMappedInputFile[Index].Size);
+#endif
+      memset (&gMappedInputFile[Index], 0, sizeof (MAPPED_INPUT_FILE));
+      return;
+    }
+  }
+
+  free ((VOID *)FileBufferRaw);
+}
+
 /**
   Read input file.
 
   @param FileName                    The input file name.
   @param FileData                    The input file data, the memory is aligned.
   @param FileSize                    The input file size.
-  @param FileBufferRaw               The memory to hold input file data. The caller must free the memory.
+  @param FileBufferRaw               The memory to hold input file data. The caller must free the memory
+                                     with FreeInputFile. The file is mapped to memory if it is supported.
 
   @return STATUS_SUCCESS             The file found and data read.
   @return STATUS_ERROR               The file data is not read.
@@ -670,6 +855,14 @@ ReadInputFile (
   //
   fseek (FpIn, 0, SEEK_END);
   *FileSize = ftell (FpIn);
+  //
+  // Map the input file to memory, the data doesn't need to be copied
+  //
+  if ((FileBufferRaw != NULL) && (MapInputFile (FpIn, *FileSize, FileData, FileBufferRaw) == STATUS_SUCCESS)) {
+    fclose (FpIn);
+    return STATUS_SUCCESS;
+  }
+
   //
   // Read the contents of input file to memory buffer
   //
@@ -774,6 +967,150 @@ FindNextFvHeader (
   return NULL;
 }
 
+/**
+  Calculate the hash of a GUID for the FFS file index.
+
+  @param Guid             The GUID.
+
+  @return The hash value.
+**/
+UINTN
+HashGuid (
+  IN EFI_GUID  *Guid
+  )
+{
+  UINT32                      *Data;
+
+  Data = (UINT32 *)Guid;
+  return (UINTN)(Data[0] ^ Data[1] ^ Data[2] ^ Data[3]);
+}
+
+/**
+  Walk the FFS files in all the FVs of a buffer, and add them to an FFS file index.
+
+  @param Buffer           The binary buffer.
+  @param BufferSize       The buffer size.
+  @param Index            The FFS file index to fill, NULL to only count the files.
+
+  @return The number of FFS files found.
+**/
+UINTN
+IndexFfsFiles (
+  IN UINT8           *Buffer,
+  IN UINT32          BufferSize,
+  IN FFS_FILE_INDEX  *Index OPTIONAL
+  )
+{
+  EFI_FIRMWARE_VOLUME_HEADER  *FvHeader;
+  EFI_FFS_FILE_HEADER         *FileHeader;
+  UINT64                      FvLength;
+  UINTN                       Offset;
+  UINTN                       FileLength;
+  UINTN                       FileOccupiedSize;
+  UINTN                       FileCount;
+  UINTN                       Slot;
+
+  FileCount = 0;
+  FvHeader = (EFI_FIRMWARE_VOLUME_HEADER *)FindNextFvHeader (Buffer, BufferSize);
+  while (FvHeader != NULL) {
+    FvLength   = FvHeader->FvLength;
+    FileHeader = (EFI_FFS_FILE_HEADER *)((UINTN)FvHeader + FvHeader->HeaderLength);
+    Offset     = (UINTN) FileHeader - (UINTN) FvHeader;
+
+    while (Offset < FvLength) {
+      FileLength = (*(UINT32 *)(FileHeader->Size)) & 0x00FFFFFF;
+      if (FileLength < sizeof (EFI_FFS_FILE_HEADER)) {
+        break;
+      }
+      FileOccupiedSize = GETOCCUPIEDSIZE(FileLength, 8);
+
+      if (Index != NULL) {
+        Slot = HashGuid (&FileHeader->Name) & Index->EntryMask;
+        while (Index->Entry[Slot].Used && (CompareGuid (&Index->Entry[Slot].Name, &FileHeader->Name) != 0)) {
+          Slot = (Slot + 1) & Index->EntryMask;
+        }
+        //
+        // Keep the first file with the GUID, as the FV scan finds it first.
+        //
+        if (!Index->Entry[Slot].Used) {
+          Index->Entry[Slot].Used = TRUE;
+          memcpy (&Index->Entry[Slot].Name, &FileHeader->Name, sizeof (EFI_GUID));
+          Index->Entry[Slot].Data = (UINT8 *)FileHeader + sizeof(EFI_FFS_FILE_HEADER);
+          Index->Entry[Slot].Size = (UINT32)(FileLength - sizeof(EFI_FFS_FILE_HEADER));
+        }
+      }
+      FileCount++;
+
+      FileHeader = (EFI_FFS_FILE_HEADER *)((UINTN)FileHeader + FileOccupiedSize);
+      Offset = (UINTN) FileHeader - (UINTN) FvHeader;
+    }
+
+    //
+    // Check next FV
+    //
+    if ((UINTN)Buffer + BufferSize > (UINTN)FvHeader + FvLength) {
+      FvHeader = (EFI_FIRMWARE_VOLUME_HEADER *)FindNextFvHeader ((UINT8 *)FvHeader + (UINTN)FvLength, (UINTN)Buffer + BufferSize - ((UINTN)FvHeader + (UINTN)FvLength));
+    } else {
+      break;
+    }
+  }
+
+  return FileCount;
+}
+
+/**
+  Build the index of the FFS files in all the FVs of an FD.
+
+  FindFileFromFvByGuid uses the index for the lookups in the same buffer.
+  If the index can't be built, the FVs are scanned for each lookup.
+
+  @param FdBuffer         FD binary buffer.
+  @param FdSize           FD size.
+**/
+VOID
+BuildFfsFileIndex (
+  IN UINT8     *FdBuffer,
+  IN UINT32    FdSize
+  )
+{
+  UINTN                       FileCount;
+  UINTN                       EntryCount;
+
+  FileCount = IndexFfsFiles (FdBuffer, FdSize, NULL);
+
+  //
+  // Keep the index at most half full
+  //
+  EntryCount = 1;
+  while (EntryCount < FileCount * 2) {
+    EntryCount <<= 1;
+  }
+
+  gFfsFileIndex.Entry = (FFS_FILE_INDEX_ENTRY *) calloc (EntryCount, sizeof (FFS_FILE_INDEX_ENTRY));
+  if (gFfsFileIndex.Entry == NULL) {
+    return;
+  }
+  gFfsFileIndex.EntryMask = EntryCount - 1;
+  IndexFfsFiles (FdBuffer, FdSize, &gFfsFileIndex);
+
+  gFfsFileIndex.Buffer     = FdBuffer;
+  gFfsFileIndex.BufferSize = FdSize;
+}
+
+/**
+  Free the index of the FFS files.
+**/
+VOID
+FreeFfsFileIndex (
+  VOID
+  )
+{
+  if (gFfsFileIndex.Entry != NULL) {
+    free (gFfsFileIndex.Entry);
+  }
+  memset (&gFfsFileIndex, 0, sizeof (gFfsFileIndex));
+}
+
 /**
   Find File with GUID in an FV.
 
@@ -802,6 +1139,21 @@ FindFileFromFvByGuid (
   UINTN                       FileLength;
   UINTN                       FileOccupiedSize;
 
+  //
+  // Look up the FFS file index of the FD
+  //
+  if ((gFfsFileIndex.Entry != NULL) && (FvBuffer == gFfsFileIndex.Buffer) && (FvSize == gFfsFileIndex.BufferSize)) {
+    Offset = HashGuid (Guid) & gFfsFileIndex.EntryMask;
+    while (gFfsFileIndex.Entry[Offset].Used) {
+      if ((CompareGuid (&gFfsFileIndex.Entry[Offset].Name, Guid)) == 0) {
+        *FileSize = gFfsFileIndex.Entry[Offset].Size;
+        return gFfsFileIndex.Entry[Offset].Data;
+      }
+      Offset = (Offset + 1) & gFfsFileIndex.EntryMask;
+    }
+    return NULL;
+  }
+
   //
   // Find the FFS file
   //
@@ -1821,7 +2173,7 @@ GetFitEntryNumber (
     }
 
     if (MicrocodeFileBufferRaw != NULL) {
-      free ((VOID *)MicrocodeFileBufferRaw);
+      FreeInputFile (MicrocodeFileBufferRaw);
       MicrocodeFileBufferRaw = NULL;
     }
   }
@@ -3303,6 +3655,15 @@ WriteOutputFile (
     return STATUS_ERROR;
   }
 
+  //
+  // The output file may be one of the mapped input files, which must not be
+  // truncated under the mapping.
+  //
+  if (DetachMappedInputFile (FileName) != STATUS_SUCCESS) {
+    Error (NULL, 0, 0, "Unable to detach the input file from the output file", "%s", FileName);
+    return STATUS_ERROR;
+  }
+
   //
   // Open the output FvRecovery.fv file
   //
@@ -3682,6 +4043,7 @@ FitGen (
   //
   // Step 2: Calculate FIT entry number.
   //
+  BuildFfsFileIndex (FdFileBuffer, FdFileSize);
   FitEntryNumber = GetFitEntryNumber (argc, argv, FdFileBuffer, FdFileSize);
   if (!gFitTableContext.Clear) {
     if (FitEntryNumber == 0) {
@@ -3807,8 +4169,9 @@ FitGen (
   }
 
 exitFunc:
+  FreeFfsFileIndex ();
   if (FileBufferRaw != NULL) {
-    free ((VOID *)FileBufferRaw);
+    FreeInputFile (FileBufferRaw);
   }
   return Status;
 }
@@ -3920,7 +4283,7 @@ FitView (
 
 exitFunc:
   if (FileBufferRaw != NULL) {
-    free ((VOID *)FileBufferRaw);
+    FreeInputFile (FileBufferRaw);
   }
   return Status;
 }
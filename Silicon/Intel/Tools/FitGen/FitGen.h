@@ -11,6 +11,10 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include <stdio.h>
 #include <stdlib.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 #define PI_SPECIFICATION_VERSION  0x00010000
 #define EFI_FVH_PI_REVISION       EFI_FVH_REVISION
 #include <Common/UefiBaseTypes.h>